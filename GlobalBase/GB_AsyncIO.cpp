@@ -0,0 +1,813 @@
+﻿#include "GB_AsyncIO.h"
+#include "GB_ThreadPool.h"
+#include "GB_Utf8String.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+// 需要 5.7 及以上的内核头文件（OPENAT/READ/WRITE/CLOSE 操作码与 probe）；运行时还会再探测内核是否支持
+#define GB_HAS_IO_URING 0
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    if defined(IORING_FEAT_FAST_POLL)
+#      include <sys/mman.h>
+#      include <sys/syscall.h>
+#      undef GB_HAS_IO_URING
+#      define GB_HAS_IO_URING 1
+#    endif
+#  endif
+#endif
+
+using namespace std;
+
+/*
+    实现要点：
+      - 每个请求包装成堆上的 PendingOp，io_uring 以其地址作为 user_data，线程池后端直接捕获指针；完成后统一走 Impl::Complete。
+      - inFlightCount 在回调执行完之后才递减，WaitIdle 因此也等待回调。
+      - 回调执行期间置 tlsInCallback：此时的 Submit 不等待在途配额，避免完成线程（或回调线程池）自己把自己堵住。
+      - io_uring 的 CQ 容量是 SQ 的两倍，且要求内核支持 IORING_FEAT_NODROP，超出配额的少量请求不会丢失完成事件。
+      - 提交失败时撤回尚未被内核取走的 SQE，对应请求以错误码完成，不会悬空导致 WaitIdle 永远等待。
+      - io_uring_enter 返回 EBUSY（CQ 溢出尚未回收）时不持锁自旋：SQE 留在 SQ 中，由完成线程回收一轮完成事件后再提交。
+*/
+
+namespace internal
+{
+    struct PendingOp
+    {
+        GB_AsyncIoRequest request;
+    };
+
+    static thread_local bool tlsInCallback = false;
+
+    // 单次读写的上限，与 Linux read()/write() 的 MAX_RW_COUNT 一致
+    static const size_t maxSingleIoBytes = 0x7FFFF000;
+
+    static int64_t LastErrorResult()
+    {
+#ifdef _WIN32
+        return -static_cast<int64_t>(::GetLastError());
+#else
+        return -static_cast<int64_t>(errno);
+#endif
+    }
+
+    // 同步执行一个请求（线程池后端）
+    static int64_t ExecuteRequestSync(const GB_AsyncIoRequest& request)
+    {
+        const size_t bytes = std::min(request.bytes, maxSingleIoBytes);
+#ifdef _WIN32
+        switch (request.type)
+        {
+        case GB_AsyncIoOpType::Open:
+        {
+            const std::wstring pathW = GB_Utf8ToWString(request.filePathUtf8);
+            const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+            HANDLE handle = ::CreateFileW(pathW.c_str(), request.openForWrite ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, shareMode, nullptr,
+                request.openForWrite ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE)
+            {
+                return LastErrorResult();
+            }
+            return static_cast<int64_t>(reinterpret_cast<intptr_t>(handle));
+        }
+        case GB_AsyncIoOpType::Read:
+        case GB_AsyncIoOpType::Write:
+        {
+            OVERLAPPED overlapped;
+            memset(&overlapped, 0, sizeof(overlapped));
+            overlapped.Offset = static_cast<DWORD>(request.offset & 0xFFFFFFFFull);
+            overlapped.OffsetHigh = static_cast<DWORD>(request.offset >> 32);
+            HANDLE handle = reinterpret_cast<HANDLE>(static_cast<intptr_t>(request.file));
+            DWORD transferred = 0;
+            const BOOL ok = request.type == GB_AsyncIoOpType::Read
+                ? ::ReadFile(handle, request.buffer, static_cast<DWORD>(bytes), &transferred, &overlapped)
+                : ::WriteFile(handle, request.buffer, static_cast<DWORD>(bytes), &transferred, &overlapped);
+            if (!ok)
+            {
+                if (::GetLastError() == ERROR_HANDLE_EOF)
+                {
+                    return 0;
+                }
+                return LastErrorResult();
+            }
+            return static_cast<int64_t>(transferred);
+        }
+        case GB_AsyncIoOpType::Close:
+            return ::CloseHandle(reinterpret_cast<HANDLE>(static_cast<intptr_t>(request.file))) ? 0 : LastErrorResult();
+        }
+        return -static_cast<int64_t>(ERROR_INVALID_PARAMETER);
+#else
+        switch (request.type)
+        {
+        case GB_AsyncIoOpType::Open:
+        {
+            int openFlags = request.openForWrite ? (O_RDWR | O_CREAT) : O_RDONLY;
+#ifdef O_CLOEXEC
+            openFlags |= O_CLOEXEC;
+#endif
+            const int fd = ::open(request.filePathUtf8.c_str(), openFlags, 0644);
+            return fd >= 0 ? fd : LastErrorResult();
+        }
+        case GB_AsyncIoOpType::Read:
+        case GB_AsyncIoOpType::Write:
+            for (;;)
+            {
+                const ssize_t n = request.type == GB_AsyncIoOpType::Read
+                    ? ::pread(static_cast<int>(request.file), request.buffer, bytes, static_cast<off_t>(request.offset))
+                    : ::pwrite(static_cast<int>(request.file), request.buffer, bytes, static_cast<off_t>(request.offset));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return n >= 0 ? static_cast<int64_t>(n) : LastErrorResult();
+            }
+        case GB_AsyncIoOpType::Close:
+            // close() 被信号中断时 fd 状态不确定，不重试
+            return ::close(static_cast<int>(request.file)) == 0 ? 0 : LastErrorResult();
+        }
+        return -EINVAL;
+#endif
+    }
+
+    static bool GetFileSizeById(GB_AsyncFileId file, uint64_t& size)
+    {
+#ifdef _WIN32
+        LARGE_INTEGER fileSizeLi;
+        if (!::GetFileSizeEx(reinterpret_cast<HANDLE>(static_cast<intptr_t>(file)), &fileSizeLi) || fileSizeLi.QuadPart < 0)
+        {
+            return false;
+        }
+        size = static_cast<uint64_t>(fileSizeLi.QuadPart);
+        return true;
+#else
+        struct stat st;
+        if (::fstat(static_cast<int>(file), &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            return false;
+        }
+        size = static_cast<uint64_t>(st.st_size);
+        return true;
+#endif
+    }
+
+#if GB_HAS_IO_URING
+    static int IoUringSetup(unsigned int entries, io_uring_params* params)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    static int IoUringEnter(int ringFd, unsigned int toSubmit, unsigned int minComplete, unsigned int flags)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    static int IoUringRegister(int ringFd, unsigned int opcode, void* arg, unsigned int argCount)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_register, ringFd, opcode, arg, argCount));
+    }
+
+    /*
+        io_uring 环：
+          - SQ 的尾指针只由本进程（持 submitMtx）推进，内核推进头指针；CQ 反之，头指针只由完成线程推进。
+          - 与内核共享的索引用 __atomic 的 acquire/release 访问。
+    */
+    class IoUringRing
+    {
+    public:
+        ~IoUringRing()
+        {
+            if (sqes != nullptr)
+            {
+                ::munmap(sqes, sqesBytes);
+            }
+            if (cqRing != nullptr && cqRing != sqRing)
+            {
+                ::munmap(cqRing, cqRingBytes);
+            }
+            if (sqRing != nullptr)
+            {
+                ::munmap(sqRing, sqRingBytes);
+            }
+            if (ringFd >= 0)
+            {
+                ::close(ringFd);
+            }
+        }
+
+        bool Init(unsigned int entries)
+        {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            ringFd = IoUringSetup(entries, &params);
+            if (ringFd < 0)
+            {
+                ringFd = -1;
+                return false;
+            }
+            if ((params.features & IORING_FEAT_NODROP) == 0 || !ProbeOps())
+            {
+                return false;
+            }
+
+            sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMmap)
+            {
+                sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+            }
+
+            void* sqPtr = ::mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+            if (sqPtr == MAP_FAILED)
+            {
+                return false;
+            }
+            sqRing = static_cast<unsigned char*>(sqPtr);
+
+            if (singleMmap)
+            {
+                cqRing = sqRing;
+            }
+            else
+            {
+                void* cqPtr = ::mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+                if (cqPtr == MAP_FAILED)
+                {
+                    return false;
+                }
+                cqRing = static_cast<unsigned char*>(cqPtr);
+            }
+
+            sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqesPtr = ::mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+            if (sqesPtr == MAP_FAILED)
+            {
+                return false;
+            }
+            sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+            sqEntries = params.sq_entries;
+            sqHead = reinterpret_cast<unsigned int*>(sqRing + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned int*>(sqRing + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned int*>(sqRing + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned int*>(sqRing + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned int*>(cqRing + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned int*>(cqRing + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned int*>(cqRing + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cqRing + params.cq_off.cqes);
+            return true;
+        }
+
+        /*
+            把请求写入 SQ（userData 为 0 表示 NOP 唤醒）；调用方需持有提交锁。
+            SQ 已满且无法提交时返回负的错误码（含 -EBUSY），请求未写入；提交出错时被撤回的请求追加到 failed。
+        */
+        int64_t Enqueue(const GB_AsyncIoRequest* request, uint64_t userData, std::vector<std::pair<uint64_t, int64_t>>& failed)
+        {
+            unsigned int tail = *sqTail;
+            while (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+            {
+                // SQ 已满：先提交，内核在 io_uring_enter 返回前消费 SQE
+                const int64_t result = SubmitPending(failed);
+                if (result < 0)
+                {
+                    return result;
+                }
+                tail = *sqTail;
+            }
+
+            const unsigned int index = tail & sqMask;
+            io_uring_sqe* sqe = &sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->user_data = userData;
+            if (request == nullptr)
+            {
+                sqe->opcode = IORING_OP_NOP;
+            }
+            else
+            {
+                switch (request->type)
+                {
+                case GB_AsyncIoOpType::Open:
+                    sqe->opcode = IORING_OP_OPENAT;
+                    sqe->fd = AT_FDCWD;
+                    sqe->addr = reinterpret_cast<uint64_t>(request->filePathUtf8.c_str());
+                    sqe->len = 0644;
+                    sqe->open_flags = (request->openForWrite ? (O_RDWR | O_CREAT) : O_RDONLY) | O_CLOEXEC;
+                    break;
+                case GB_AsyncIoOpType::Read:
+                case GB_AsyncIoOpType::Write:
+                    sqe->opcode = request->type == GB_AsyncIoOpType::Read ? IORING_OP_READ : IORING_OP_WRITE;
+                    sqe->fd = static_cast<int>(request->file);
+                    sqe->addr = reinterpret_cast<uint64_t>(request->buffer);
+                    sqe->len = static_cast<uint32_t>(std::min(request->bytes, maxSingleIoBytes));
+                    sqe->off = request->offset;
+                    break;
+                case GB_AsyncIoOpType::Close:
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->fd = static_cast<int>(request->file);
+                    break;
+                }
+            }
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            pendingSubmitCount++;
+            return 0;
+        }
+
+        bool HasPendingSubmit() const
+        {
+            return pendingSubmitCount > 0;
+        }
+
+        /*
+            提交 SQ 中尚未提交的请求；调用方需持有提交锁。返回 0 表示全部提交。
+            - -EBUSY：CQ 溢出尚未回收。剩余 SQE 保留在 SQ 中，持锁等待会与需要同一把锁的完成线程互相卡住，
+              因此直接返回，由完成线程回收完成事件后重新提交。
+            - 其它错误：撤回内核尚未取走的 SQE（回退尾指针），其 user_data 与错误码追加到 failed，由调用方以错误完成。
+        */
+        int64_t SubmitPending(std::vector<std::pair<uint64_t, int64_t>>& failed)
+        {
+            int againRetries = 0;
+            while (pendingSubmitCount > 0)
+            {
+                const int submitted = IoUringEnter(ringFd, pendingSubmitCount, 0, 0);
+                if (submitted >= 0)
+                {
+                    pendingSubmitCount -= std::min(pendingSubmitCount, static_cast<unsigned int>(submitted));
+                    continue;
+                }
+
+                const int error = errno;
+                if (error == EINTR || (error == EAGAIN && ++againRetries < maxSubmitAgainRetries))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (error == EBUSY)
+                {
+                    return -EBUSY;
+                }
+
+                // 未提交的 SQE 一定是 SQ 尾部的最后 pendingSubmitCount 个，内核只在 io_uring_enter 中读取它们
+                const unsigned int tail = *sqTail;
+                for (unsigned int position = tail - pendingSubmitCount; position != tail; position++)
+                {
+                    failed.push_back(std::make_pair(sqes[sqArray[position & sqMask]].user_data, -static_cast<int64_t>(error)));
+                }
+                __atomic_store_n(sqTail, tail - pendingSubmitCount, __ATOMIC_RELEASE);
+                pendingSubmitCount = 0;
+                return -static_cast<int64_t>(error);
+            }
+            return 0;
+        }
+
+        // 取走当前所有完成事件；没有时阻塞等待至少一个
+        template <typename Handler>
+        void WaitAndReap(Handler&& handler)
+        {
+            unsigned int head = *cqHead;
+            unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            if (head == tail)
+            {
+                (void)IoUringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+                tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            }
+            while (head != tail)
+            {
+                const io_uring_cqe cqe = cqes[head & cqMask];
+                head++;
+                // 先归还 CQ 槽位，回调里可能继续提交
+                __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+                handler(cqe.user_data, static_cast<int64_t>(cqe.res));
+            }
+        }
+
+    private:
+        bool ProbeOps()
+        {
+            const unsigned int opCount = 256;
+            std::vector<unsigned char> storage(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op), 0);
+            io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+            if (IoUringRegister(ringFd, IORING_REGISTER_PROBE, probe, opCount) < 0)
+            {
+                return false; // 5.6 之前的内核没有 probe，也没有 OPENAT/READ/WRITE/CLOSE
+            }
+            const unsigned int requiredOps[] = { IORING_OP_NOP, IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE };
+            for (unsigned int op : requiredOps)
+            {
+                if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        int ringFd = -1;
+        unsigned char* sqRing = nullptr;
+        unsigned char* cqRing = nullptr;
+        size_t sqRingBytes = 0;
+        size_t cqRingBytes = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqesBytes = 0;
+
+        unsigned int sqEntries = 0;
+        unsigned int* sqHead = nullptr;
+        unsigned int* sqTail = nullptr;
+        unsigned int sqMask = 0;
+        unsigned int* sqArray = nullptr;
+        unsigned int* cqHead = nullptr;
+        unsigned int* cqTail = nullptr;
+        unsigned int cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        unsigned int pendingSubmitCount = 0;
+
+        static const int maxSubmitAgainRetries = 64;
+    };
+#endif
+}
+
+struct GB_AsyncFileIO::Impl
+{
+    Backend backend = Backend::ThreadPool;
+    unsigned int queueDepth = 128;
+    GB_ThreadPool* callbackPool = nullptr;
+
+    std::mutex inFlightMtx;
+    std::condition_variable inFlightCv;
+    size_t inFlightCount = 0;
+
+    std::unique_ptr<GB_ThreadPool> ioPool; // 线程池后端
+
+#if GB_HAS_IO_URING
+    std::unique_ptr<internal::IoUringRing> ring;
+    std::mutex submitMtx;
+    std::thread completionThread;
+#endif
+
+    void AcquireSlots(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(inFlightMtx);
+        if (!internal::tlsInCallback)
+        {
+            inFlightCv.wait(lock, [&]() {
+                return inFlightCount == 0 || inFlightCount + count <= queueDepth;
+            });
+        }
+        inFlightCount += count;
+    }
+
+    void ReleaseSlot()
+    {
+        {
+            std::lock_guard<std::mutex> lock(inFlightMtx);
+            inFlightCount--;
+        }
+        inFlightCv.notify_all();
+    }
+
+    void RunCallback(internal::PendingOp* op, int64_t result)
+    {
+        const bool wasInCallback = internal::tlsInCallback;
+        internal::tlsInCallback = true;
+        if (op->request.callback)
+        {
+            op->request.callback(result);
+        }
+        internal::tlsInCallback = wasInCallback;
+        delete op;
+        ReleaseSlot();
+    }
+
+    void Complete(internal::PendingOp* op, int64_t result)
+    {
+        if (callbackPool != nullptr)
+        {
+            callbackPool->Post([this, op, result]() {
+                RunCallback(op, result);
+            });
+            return;
+        }
+        RunCallback(op, result);
+    }
+
+    void SubmitOps(std::vector<internal::PendingOp*>& ops)
+    {
+        AcquireSlots(ops.size());
+#if GB_HAS_IO_URING
+        if (ring)
+        {
+            std::vector<std::pair<uint64_t, int64_t>> failedOps;
+            {
+                std::lock_guard<std::mutex> lock(submitMtx);
+                for (internal::PendingOp* op : ops)
+                {
+                    const uint64_t userData = reinterpret_cast<uint64_t>(op);
+                    const int64_t result = ring->Enqueue(&op->request, userData, failedOps);
+                    if (result < 0)
+                    {
+                        failedOps.push_back(std::make_pair(userData, result));
+                    }
+                }
+                (void)ring->SubmitPending(failedOps);
+            }
+            CompleteFailedOps(failedOps);
+            return;
+        }
+#endif
+        for (internal::PendingOp* op : ops)
+        {
+            ioPool->Post([this, op]() {
+                Complete(op, internal::ExecuteRequestSync(op->request));
+            });
+        }
+    }
+
+#if GB_HAS_IO_URING
+    // 未能提交的请求以错误码完成；返回其中是否有析构时投递的 NOP
+    bool CompleteFailedOps(const std::vector<std::pair<uint64_t, int64_t>>& failedOps)
+    {
+        bool hasStopNop = false;
+        for (const std::pair<uint64_t, int64_t>& failedOp : failedOps)
+        {
+            if (failedOp.first == 0)
+            {
+                hasStopNop = true;
+                continue;
+            }
+            Complete(reinterpret_cast<internal::PendingOp*>(failedOp.first), failedOp.second);
+        }
+        return hasStopNop;
+    }
+
+    void CompletionThreadFunc()
+    {
+        bool stopping = false;
+        std::vector<std::pair<uint64_t, int64_t>> failedOps;
+        while (!stopping)
+        {
+            ring->WaitAndReap([&](uint64_t userData, int64_t result) {
+                if (userData == 0)
+                {
+                    stopping = true; // 析构时投递的 NOP
+                    return;
+                }
+                Complete(reinterpret_cast<internal::PendingOp*>(userData), result);
+            });
+
+            // 之前因 EBUSY 留在 SQ 中的请求：刚回收过完成事件，此时重新提交
+            failedOps.clear();
+            {
+                std::lock_guard<std::mutex> lock(submitMtx);
+                if (ring->HasPendingSubmit())
+                {
+                    (void)ring->SubmitPending(failedOps);
+                }
+            }
+            if (CompleteFailedOps(failedOps))
+            {
+                stopping = true;
+            }
+        }
+    }
+#endif
+};
+
+GB_AsyncFileIO::GB_AsyncFileIO(Backend backend, unsigned int queueDepth, size_t fallbackThreadCount, GB_ThreadPool* callbackPool) : impl(new Impl())
+{
+    impl->queueDepth = queueDepth == 0 ? 1 : queueDepth;
+    impl->callbackPool = callbackPool;
+
+#if GB_HAS_IO_URING
+    if (backend != Backend::ThreadPool)
+    {
+        std::unique_ptr<internal::IoUringRing> ring(new internal::IoUringRing());
+        if (ring->Init(impl->queueDepth))
+        {
+            impl->ring = std::move(ring);
+            impl->backend = Backend::IoUring;
+            impl->completionThread = std::thread(&Impl::CompletionThreadFunc, impl.get());
+            return;
+        }
+    }
+#else
+    (void)backend;
+#endif
+
+    impl->backend = Backend::ThreadPool;
+    impl->ioPool.reset(new GB_ThreadPool(fallbackThreadCount == 0 ? 1 : fallbackThreadCount));
+}
+
+GB_AsyncFileIO::~GB_AsyncFileIO()
+{
+    WaitIdle();
+#if GB_HAS_IO_URING
+    if (impl->ring)
+    {
+        std::vector<std::pair<uint64_t, int64_t>> failedOps;
+        {
+            std::lock_guard<std::mutex> lock(impl->submitMtx);
+            if (impl->ring->Enqueue(nullptr, 0, failedOps) == 0)
+            {
+                (void)impl->ring->SubmitPending(failedOps);
+            }
+        }
+        impl->CompleteFailedOps(failedOps);
+        if (impl->completionThread.joinable())
+        {
+            impl->completionThread.join();
+        }
+    }
+#endif
+    impl->ioPool.reset();
+}
+
+GB_AsyncFileIO::Backend GB_AsyncFileIO::GetBackend() const
+{
+    return impl->backend;
+}
+
+void GB_AsyncFileIO::Submit(GB_AsyncIoRequest&& request)
+{
+    std::vector<internal::PendingOp*> ops(1, new internal::PendingOp{ std::move(request) });
+    impl->SubmitOps(ops);
+}
+
+void GB_AsyncFileIO::Submit(std::vector<GB_AsyncIoRequest>&& requests)
+{
+    // 超过队列深度的批次分段提交，避免一次申请的配额永远无法满足
+    size_t begin = 0;
+    while (begin < requests.size())
+    {
+        const size_t end = std::min(requests.size(), begin + impl->queueDepth);
+        std::vector<internal::PendingOp*> ops;
+        ops.reserve(end - begin);
+        for (size_t i = begin; i < end; i++)
+        {
+            ops.push_back(new internal::PendingOp{ std::move(requests[i]) });
+        }
+        impl->SubmitOps(ops);
+        begin = end;
+    }
+    requests.clear();
+}
+
+std::future<int64_t> GB_AsyncFileIO::SubmitWithFuture(GB_AsyncIoRequest&& request)
+{
+    std::shared_ptr<std::promise<int64_t>> promise = std::make_shared<std::promise<int64_t>>();
+    std::future<int64_t> future = promise->get_future();
+    std::function<void(int64_t)> userCallback = std::move(request.callback);
+    request.callback = [promise, userCallback](int64_t result) {
+        if (userCallback)
+        {
+            userCallback(result);
+        }
+        promise->set_value(result);
+    };
+    Submit(std::move(request));
+    return future;
+}
+
+namespace internal
+{
+    // 整文件读取的串联状态：open → 获取大小 → read（直到读满）→ close → 用户回调
+    struct AsyncReadFileState
+    {
+        GB_AsyncFileIO* engine = nullptr;
+        std::string filePathUtf8;
+        GB_AsyncFileId file = -1;
+        GB_ByteBuffer data;
+        size_t readBytes = 0;
+        std::function<void(bool, GB_ByteBuffer&&)> callback;
+    };
+
+    static void FinishAsyncReadFile(const std::shared_ptr<AsyncReadFileState>& state, bool ok)
+    {
+        if (!ok)
+        {
+            GB_ByteBuffer().swap(state->data);
+        }
+        if (state->file < 0)
+        {
+            state->callback(ok, std::move(state->data));
+            return;
+        }
+
+        GB_AsyncIoRequest closeRequest;
+        closeRequest.type = GB_AsyncIoOpType::Close;
+        closeRequest.file = state->file;
+        closeRequest.callback = [state, ok](int64_t) {
+            state->callback(ok, std::move(state->data));
+        };
+        state->engine->Submit(std::move(closeRequest));
+    }
+
+    static void SubmitAsyncReadChunk(const std::shared_ptr<AsyncReadFileState>& state)
+    {
+        GB_AsyncIoRequest readRequest;
+        readRequest.type = GB_AsyncIoOpType::Read;
+        readRequest.file = state->file;
+        readRequest.offset = state->readBytes;
+        readRequest.buffer = state->data.data() + state->readBytes;
+        readRequest.bytes = state->data.size() - state->readBytes;
+        readRequest.callback = [state](int64_t result) {
+            if (result <= 0)
+            {
+                // 出错，或文件在读取过程中被截断
+                FinishAsyncReadFile(state, false);
+                return;
+            }
+            state->readBytes += static_cast<size_t>(result);
+            if (state->readBytes < state->data.size())
+            {
+                SubmitAsyncReadChunk(state);
+                return;
+            }
+            FinishAsyncReadFile(state, true);
+        };
+        state->engine->Submit(std::move(readRequest));
+    }
+}
+
+void GB_AsyncFileIO::ReadFile(const std::string& filePathUtf8, std::function<void(bool ok, GB_ByteBuffer&& data)> callback)
+{
+    std::shared_ptr<internal::AsyncReadFileState> state = std::make_shared<internal::AsyncReadFileState>();
+    state->engine = this;
+    state->filePathUtf8 = filePathUtf8;
+    state->callback = std::move(callback);
+
+    if (filePathUtf8.empty())
+    {
+        internal::FinishAsyncReadFile(state, false);
+        return;
+    }
+
+    GB_AsyncIoRequest openRequest;
+    openRequest.type = GB_AsyncIoOpType::Open;
+    openRequest.filePathUtf8 = filePathUtf8;
+    openRequest.callback = [state](int64_t result) {
+        if (result < 0)
+        {
+            internal::FinishAsyncReadFile(state, false);
+            return;
+        }
+        state->file = result;
+
+        uint64_t fileSize = 0;
+        if (!internal::GetFileSizeById(state->file, fileSize) || fileSize > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+        {
+            internal::FinishAsyncReadFile(state, false);
+            return;
+        }
+        if (fileSize == 0)
+        {
+            internal::FinishAsyncReadFile(state, true);
+            return;
+        }
+        state->data.resize(static_cast<size_t>(fileSize));
+        internal::SubmitAsyncReadChunk(state);
+    };
+    Submit(std::move(openRequest));
+}
+
+std::future<GB_ByteBuffer> GB_AsyncFileIO::ReadFile(const std::string& filePathUtf8)
+{
+    std::shared_ptr<std::promise<GB_ByteBuffer>> promise = std::make_shared<std::promise<GB_ByteBuffer>>();
+    std::future<GB_ByteBuffer> future = promise->get_future();
+    ReadFile(filePathUtf8, [promise](bool, GB_ByteBuffer&& data) {
+        promise->set_value(std::move(data));
+    });
+    return future;
+}
+
+void GB_AsyncFileIO::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(impl->inFlightMtx);
+    impl->inFlightCv.wait(lock, [&]() {
+        return impl->inFlightCount == 0;
+    });
+}
+
+size_t GB_AsyncFileIO::GetInFlightCount() const
+{
+    std::lock_guard<std::mutex> lock(impl->inFlightMtx);
+    return impl->inFlightCount;
+}
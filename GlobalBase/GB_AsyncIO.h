@@ -0,0 +1,104 @@
+﻿#ifndef GLOBALBASE_ASYNC_IO_H_H
+#define GLOBALBASE_ASYNC_IO_H_H
+
+#include "GlobalBasePort.h"
+#include "GB_BaseTypes.h"
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GB_ThreadPool;
+
+// 异步 I/O 中的文件标识：POSIX 为 fd，Windows 为 HANDLE 的整数值；-1 表示无效
+using GB_AsyncFileId = int64_t;
+
+enum class GB_AsyncIoOpType
+{
+    Open,
+    Read,
+    Write,
+    Close
+};
+
+/*
+    一个异步 I/O 请求。各字段按 type 取用：
+      - Open ：filePathUtf8、openForWrite（true 时以写方式打开，不存在则创建，不截断）
+      - Read ：file、offset、buffer（目标）、bytes
+      - Write：file、offset、buffer（源）、bytes
+      - Close：file
+    buffer 所指内存必须保持有效直到回调返回。单次 Read/Write 可能少于 bytes（文件末尾或单次上限约 2 GiB），由调用方续做。
+    callback 的 result：>= 0 表示成功（Open 为文件标识，Read/Write 为实际字节数，Close 为 0）；< 0 为 -errno（Windows 为 -GetLastError()）。
+*/
+struct GB_AsyncIoRequest
+{
+    GB_AsyncIoOpType type = GB_AsyncIoOpType::Read;
+    std::string filePathUtf8;
+    bool openForWrite = false;
+    GB_AsyncFileId file = -1;
+    uint64_t offset = 0;
+    void* buffer = nullptr;
+    size_t bytes = 0;
+    std::function<void(int64_t result)> callback;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+/*
+    异步文件 I/O 引擎：批量提交 open/read/write/close，完成后回调。
+    - Linux 上优先使用 io_uring（直接走系统调用，不依赖 liburing）：提交线程把请求写入 SQ 后一次 io_uring_enter，
+      由一个完成线程收割 CQ，少量线程即可让设备保持较深的队列。
+    - 内核不支持（或被禁用）io_uring、以及 Windows 上，回退为 GB_ThreadPool + pread/pwrite（ReadFile/WriteFile）。
+    - 回调默认在完成线程上执行，应尽量轻量且不得抛出异常；构造时传入 callbackPool 则回调被投递到该线程池执行。
+    - 在途请求达到 queueDepth 时 Submit 会阻塞（在回调里提交的后续请求不受此限，以免阻塞完成线程）。
+    - 析构时等待所有已提交的请求完成。
+*/
+class GLOBALBASE_PORT GB_AsyncFileIO
+{
+public:
+    enum class Backend
+    {
+        Auto,       // 能用 io_uring 就用，否则线程池
+        IoUring,    // 只在构造参数中表示"优先 io_uring"，不可用时同样回退
+        ThreadPool
+    };
+
+    explicit GB_AsyncFileIO(Backend backend = Backend::Auto, unsigned int queueDepth = 128, size_t fallbackThreadCount = 4, GB_ThreadPool* callbackPool = nullptr);
+    ~GB_AsyncFileIO();
+
+    GB_AsyncFileIO(const GB_AsyncFileIO&) = delete;
+    GB_AsyncFileIO& operator=(const GB_AsyncFileIO&) = delete;
+
+    // 实际使用的后端（IoUring 或 ThreadPool）
+    Backend GetBackend() const;
+
+    void Submit(GB_AsyncIoRequest&& request);
+    // 批量提交：io_uring 后端只做一次 io_uring_enter
+    void Submit(std::vector<GB_AsyncIoRequest>&& requests);
+    // request.callback（若有）先执行，之后 future 就绪
+    std::future<int64_t> SubmitWithFuture(GB_AsyncIoRequest&& request);
+
+    // 异步读取整个文件：open、read（必要时多次）、close 串联执行。失败时 ok 为 false、data 为空
+    void ReadFile(const std::string& filePathUtf8, std::function<void(bool ok, GB_ByteBuffer&& data)> callback);
+    // 与 GB_ReadFileToBinary 一致：失败时得到空缓冲
+    std::future<GB_ByteBuffer> ReadFile(const std::string& filePathUtf8);
+
+    // 等待当前所有在途请求（含其回调）完成
+    void WaitIdle();
+    size_t GetInFlightCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
+#endif
@@ -2,10 +2,74 @@
 #define GLOBALBASE_BASE_TYPES_H_H
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 using GB_ByteBuffer = std::vector<unsigned char>;
 
+// 只读字节视图：不拥有内存，调用方保证所指内存在使用期间有效。
+// 可由 GB_ByteBuffer 隐式构造，用于从内存映射文件等外部内存零拷贝解析。
+class GB_ByteSpan
+{
+public:
+    GB_ByteSpan() : ptr(nullptr), length(0)
+    {
+    }
+
+    GB_ByteSpan(const unsigned char* data, size_t size) : ptr(data), length(size)
+    {
+    }
+
+    GB_ByteSpan(const GB_ByteBuffer& buffer) : ptr(buffer.data()), length(buffer.size())
+    {
+    }
+
+    const unsigned char* data() const
+    {
+        return ptr;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    const unsigned char* begin() const
+    {
+        return ptr;
+    }
+
+    const unsigned char* end() const
+    {
+        return ptr + length;
+    }
+
+    const unsigned char& operator[](size_t index) const
+    {
+        return ptr[index];
+    }
+
+    // 取 [offset, offset + count) 子视图，越界部分被截掉
+    GB_ByteSpan SubSpan(size_t offset, size_t count = static_cast<size_t>(-1)) const
+    {
+        if (offset >= length)
+        {
+            return GB_ByteSpan(ptr + length, 0);
+        }
+        const size_t available = length - offset;
+        return GB_ByteSpan(ptr + offset, count < available ? count : available);
+    }
+
+private:
+    const unsigned char* ptr;
+    size_t length;
+};
+
 constexpr static uint32_t GB_ClassMagicNumber = 827540039;
 
 
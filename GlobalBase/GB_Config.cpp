@@ -1,4 +1,5 @@
 ﻿#include "GB_Config.h"
+#include "GB_IO.h"
 #include "GB_Utf8String.h"
 #include <cstdio>
 #include <cstdlib>
@@ -508,81 +509,6 @@ namespace internal
         return true;
     }
 
-    static string Dirname(const string& path)
-    {
-        const size_t pos = path.find_last_of('/');
-        if (pos == string::npos) return string(".");
-        if (pos == 0) return string("/");
-        return path.substr(0, pos);
-    }
-
-    static bool AtomicWriteFile(const string& path, const string& content)
-    {
-        const string dir = Dirname(path);
-        if (!MkdirsRecursively(dir))
-        {
-            return false;
-        }
-
-        // 临时文件名：同目录，确保 rename 原子
-        ostringstream oss;
-        oss << path << ".tmp." << ::getpid() << "." << ::time(nullptr);
-        const string tmp = oss.str();
-
-        // O_CREAT|O_EXCL 防止覆盖其他进程的临时文件
-        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
-        if (fd < 0)
-        {
-            return false;
-        }
-
-        const char* data = content.data();
-        size_t left = content.size();
-        while (left > 0)
-        {
-            const ssize_t n = ::write(fd, data, left);
-            if (n < 0)
-            {
-                const int e = errno;
-                ::close(fd);
-                ::unlink(tmp.c_str());
-                (void)e;
-                return false;
-            }
-            data += n;
-            left -= static_cast<size_t>(n);
-        }
-
-        // 持久化数据
-        if (::fsync(fd) != 0)
-        {
-            ::close(fd);
-            ::unlink(tmp.c_str());
-            return false;
-        }
-        if (::close(fd) != 0)
-        {
-            ::unlink(tmp.c_str());
-            return false;
-        }
-
-        // 原子替换
-        if (::rename(tmp.c_str(), path.c_str()) != 0)
-        {
-            ::unlink(tmp.c_str());
-            return false;
-        }
-
-        // 刷新目录项（更强的崩溃一致性习惯做法）
-        int dfd = ::open(dir.c_str(), O_DIRECTORY | O_RDONLY);
-        if (dfd >= 0)
-        {
-            (void)::fsync(dfd);
-            ::close(dfd);
-        }
-        return true;
-    }
-
     static bool LoadAllKv(const string& filePath,
         unordered_map<string, string>& m)
     {
@@ -620,7 +546,11 @@ namespace internal
             oss << line;
         }
         const string content = oss.str();
-        return AtomicWriteFile(filePath, content);
+
+        // 写临时文件 + fsync + rename + 目录 fsync；配置中可能有敏感信息，仅属主可读写
+        GB_AtomicWriteOptions options;
+        options.permissions = 0600;
+        return GB_AtomicFileWriter::WriteFile(filePath, content.data(), content.size(), options);
     }
 
     static string NormalizePosixDir(const string& pathUtf8)
@@ -655,7 +585,7 @@ string GB_GetGbConfigPath()
     // 提示性的“注册表路径”描述字符串
     return GB_STR("计算机\\HKEY_CURRENT_USER\\Software\\GlobalBase");
 #else
-    return GetLinuxConfigFile();
+    return internal::GetLinuxConfigFile();
 #endif
 }
 
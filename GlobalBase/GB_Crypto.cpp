@@ -1,4 +1,5 @@
 ﻿#include "GB_Crypto.h"
+#include "GB_IO.h"
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -8,6 +9,9 @@
 #include <random>
 #include <cassert>
 #include <sstream>
+#include <istream>
+#include <cstring>
+#include <atomic>
 
 #if defined(_WIN32)
 #  include <windows.h>
@@ -17,6 +21,43 @@
 #  endif
 #endif
 
+// 硬件加速内核：编译期只决定“能否生成”，运行期再按 CPU 特性决定“是否使用”
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define GB_CRYPTO_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#  if defined(__GNUC__) || defined(__clang__)
+#    define GB_CRYPTO_TARGET_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+#    define GB_CRYPTO_TARGET_AESNI __attribute__((target("aes,sse4.1")))
+#    define GB_CRYPTO_TARGET_AVX2 __attribute__((target("avx2")))
+#    define GB_CRYPTO_TARGET_AVX512 __attribute__((target("avx512f")))
+#  else
+#    define GB_CRYPTO_TARGET_SHANI
+#    define GB_CRYPTO_TARGET_AESNI
+#    define GB_CRYPTO_TARGET_AVX2
+#    define GB_CRYPTO_TARGET_AVX512
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// clang 只有在编译选项已开启 crypto 扩展时才声明相关 intrinsic
+#  if defined(_MSC_VER) || (defined(__GNUC__) && !defined(__clang__)) || defined(__ARM_FEATURE_CRYPTO) || (defined(__ARM_FEATURE_SHA2) && defined(__ARM_FEATURE_AES))
+#    define GB_CRYPTO_ARMV8 1
+#    include <arm_neon.h>
+#    if defined(__linux__)
+#      include <sys/auxv.h>
+#      include <asm/hwcap.h>
+#    endif
+#    if defined(__GNUC__) && !defined(__clang__)
+#      define GB_CRYPTO_TARGET_ARMV8 __attribute__((target("+crypto")))
+#    else
+#      define GB_CRYPTO_TARGET_ARMV8
+#    endif
+#  endif
+#endif
+
 using namespace std;
 
 namespace internal
@@ -175,6 +216,56 @@ namespace internal
         0x748f82eeu,0x78a5636fu,0x84c87814u,0x8cc70208u,0x90befffau,0xa4506cebu,0xbef9a3f7u,0xc67178f2u
     };
 
+    // 对 blockCount 个连续的 64 字节块做 SHA-256 压缩，结果累加进 state（可移植实现，也是加速内核的对照基准）
+    static void Sha256CompressPortable(uint32_t state[8], const uint8_t* blocks, size_t blockCount)
+    {
+        uint32_t w[64];
+        for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            const uint8_t* block = blocks + blockIndex * 64;
+            for (int t = 0; t < 16; ++t)
+            {
+                w[t] = LoadBE32(block + t * 4);
+            }
+            for (int t = 16; t < 64; ++t)
+            {
+                w[t] = SmallSigma1_32(w[t - 2]) + w[t - 7] + SmallSigma0_32(w[t - 15]) + w[t - 16];
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+            for (int t = 0; t < 64; ++t)
+            {
+                uint32_t t1 = h + BigSigma1_32(e) + Ch32(e, f, g) + K256[t] + w[t];
+                uint32_t t2 = BigSigma0_32(a) + Maj32(a, b, c);
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    }
+
+    static string BytesToLowerHex(const uint8_t* bytes, size_t size)
+    {
+        static const char* hexDigits = "0123456789abcdef";
+        string hex(size * 2, '\0');
+        for (size_t i = 0; i < size; ++i)
+        {
+            hex[2 * i + 0] = hexDigits[bytes[i] >> 4];
+            hex[2 * i + 1] = hexDigits[bytes[i] & 0x0F];
+        }
+        return hex;
+    }
+
     // -------- SHA-512 专用 --------
     static inline uint64_t Ch64(uint64_t x, uint64_t y, uint64_t z) { return (x & y) ^ (~x & z); }
     static inline uint64_t Maj64(uint64_t x, uint64_t y, uint64_t z) { return (x & y) ^ (x & z) ^ (y & z); }
@@ -207,6 +298,192 @@ namespace internal
         0x4cc5d4becb3e42b6ULL,0x597f299cfc657e2aULL,0x5fcb6fab3ad6faecULL,0x6c44198c4a475817ULL
     };
 
+    static void Md5Compress(uint32_t state[4], const uint8_t* blocks, size_t blockCount)
+    {
+        for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            const uint8_t* block = blocks + blockIndex * 64;
+            uint32_t m[16];
+            for (int j = 0; j < 16; ++j)
+            {
+                m[j] = LoadLE32(block + j * 4);
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                uint32_t f, g;
+
+                if (i < 16)
+                {
+                    f = (b & c) | (~b & d);
+                    g = i;
+                }
+                else if (i < 32)
+                {
+                    f = (d & b) | (~d & c);
+                    g = (5u * i + 1u) & 0x0Fu;
+                }
+                else if (i < 48)
+                {
+                    f = b ^ c ^ d;
+                    g = (3u * i + 5u) & 0x0Fu;
+                }
+                else
+                {
+                    f = c ^ (b | ~d);
+                    g = (7u * i) & 0x0Fu;
+                }
+
+                uint32_t temp = d;
+                f = f + a + K[i] + m[g];
+                d = c;
+                c = b;
+                b = b + RotL32(f, S[i]);
+                a = temp;
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+        }
+    }
+
+    static void Sha512Compress(uint64_t state[8], const uint8_t* blocks, size_t blockCount)
+    {
+        uint64_t w[80];
+        for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            const uint8_t* block = blocks + blockIndex * 128;
+            for (int t = 0; t < 16; ++t)
+            {
+                w[t] = LoadBE64(block + t * 8);
+            }
+            for (int t = 16; t < 80; ++t)
+            {
+                w[t] = SmallSigma1_64(w[t - 2]) + w[t - 7] + SmallSigma0_64(w[t - 15]) + w[t - 16];
+            }
+
+            uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+            for (int t = 0; t < 80; ++t)
+            {
+                uint64_t t1 = h + BigSigma1_64(e) + Ch64(e, f, g) + K512[t] + w[t];
+                uint64_t t2 = BigSigma0_64(a) + Maj64(a, b, c);
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    }
+
+    // 增量哈希的公共部分：先补满内部缓冲，整块直接从调用方内存压缩，余下的存入缓冲
+    template<typename Word, size_t BlockSize>
+    static void HashUpdateBuffered(Word* state, unsigned char* buffer, size_t& bufferSize, const uint8_t* bytes, size_t size, void (*compress)(Word*, const uint8_t*, size_t))
+    {
+        if (bufferSize > 0)
+        {
+            const size_t space = BlockSize - bufferSize;
+            const size_t take = size < space ? size : space;
+            memcpy(buffer + bufferSize, bytes, take);
+            bufferSize += take;
+            bytes += take;
+            size -= take;
+            if (bufferSize < BlockSize)
+            {
+                return;
+            }
+            compress(state, buffer, 1);
+            bufferSize = 0;
+        }
+
+        const size_t fullBlocks = size / BlockSize;
+        if (fullBlocks > 0)
+        {
+            compress(state, bytes, fullBlocks);
+            bytes += fullBlocks * BlockSize;
+            size -= fullBlocks * BlockSize;
+        }
+
+        if (size > 0)
+        {
+            memcpy(buffer, bytes, size);
+            bufferSize = size;
+        }
+    }
+
+    // 追加 0x80 与若干 0x00，使剩余空间恰好放下 lengthBytes 字节的长度字段，返回长度字段在 buffer 中的偏移
+    template<typename Word, size_t BlockSize>
+    static size_t HashPadBuffered(Word* state, unsigned char* buffer, size_t& bufferSize, size_t lengthBytes, void (*compress)(Word*, const uint8_t*, size_t))
+    {
+        buffer[bufferSize++] = 0x80u;
+        if (bufferSize > BlockSize - lengthBytes)
+        {
+            memset(buffer + bufferSize, 0, BlockSize - bufferSize);
+            compress(state, buffer, 1);
+            bufferSize = 0;
+        }
+        memset(buffer + bufferSize, 0, BlockSize - lengthBytes - bufferSize);
+        bufferSize = 0;
+        return BlockSize - lengthBytes;
+    }
+
+    static const size_t hashReadBufferBytes = 1024 * 1024;
+
+    template<typename Hasher>
+    static bool HashUpdateFromFile(Hasher& hasher, const string& filePathUtf8)
+    {
+        GB_FileReader reader;
+        if (!reader.Open(filePathUtf8, GB_FileReader::AccessHint::Sequential, 0))
+        {
+            return false;
+        }
+
+        // 不经过 GB_FileReader 的内部缓冲，每次直接读满一大块
+        vector<unsigned char> buffer(hashReadBufferBytes);
+        const uint64_t fileSize = reader.GetFileSize();
+        uint64_t total = 0;
+        for (;;)
+        {
+            const size_t n = reader.Read(buffer.data(), buffer.size());
+            if (n == 0)
+            {
+                break;
+            }
+            hasher.Update(buffer.data(), n);
+            total += n;
+        }
+        return total == fileSize;
+    }
+
+    template<typename Hasher>
+    static bool HashUpdateFromStream(Hasher& hasher, istream& stream)
+    {
+        vector<char> buffer(hashReadBufferBytes);
+        while (stream)
+        {
+            stream.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+            const streamsize n = stream.gcount();
+            if (n <= 0)
+            {
+                break;
+            }
+            hasher.Update(buffer.data(), static_cast<size_t>(n));
+        }
+        return !stream.bad();
+    }
+
     // ---------- CSPRNG：优先系统随机，失败退回 random_device ----------
     static bool GetSecureRandom(uint8_t* buf, size_t len)
     {
@@ -403,79 +680,1018 @@ namespace internal
         s[2] = s[10]; s[6] = s[14]; s[10] = t0; s[14] = t1;
         t = s[15]; s[15] = s[11]; s[11] = s[7]; s[7] = s[3]; s[3] = t;
     }
-    static void InvShiftRows(uint8_t* s)
+    static void InvShiftRows(uint8_t* s)
+    {
+        uint8_t t;
+        t = s[13]; s[13] = s[9];  s[9] = s[5];  s[5] = s[1];  s[1] = t;
+        uint8_t t0 = s[2], t1 = s[6];
+        s[2] = s[10]; s[6] = s[14]; s[10] = t0; s[14] = t1;
+        t = s[3];  s[3] = s[7];  s[7] = s[11]; s[11] = s[15]; s[15] = t;
+    }
+    static void MixColumns(uint8_t* s)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            const int i = 4 * c;
+            const uint8_t a0 = s[i + 0], a1 = s[i + 1], a2 = s[i + 2], a3 = s[i + 3];
+            s[i + 0] = (uint8_t)(GFMul(a0, 2) ^ GFMul(a1, 3) ^ a2 ^ a3);
+            s[i + 1] = (uint8_t)(a0 ^ GFMul(a1, 2) ^ GFMul(a2, 3) ^ a3);
+            s[i + 2] = (uint8_t)(a0 ^ a1 ^ GFMul(a2, 2) ^ GFMul(a3, 3));
+            s[i + 3] = (uint8_t)(GFMul(a0, 3) ^ a1 ^ a2 ^ GFMul(a3, 2));
+        }
+    }
+    static void InvMixColumns(uint8_t* s)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            const int i = 4 * c;
+            const uint8_t a0 = s[i + 0], a1 = s[i + 1], a2 = s[i + 2], a3 = s[i + 3];
+            s[i + 0] = (uint8_t)(GFMul(a0, 14) ^ GFMul(a1, 11) ^ GFMul(a2, 13) ^ GFMul(a3, 9));
+            s[i + 1] = (uint8_t)(GFMul(a0, 9) ^ GFMul(a1, 14) ^ GFMul(a2, 11) ^ GFMul(a3, 13));
+            s[i + 2] = (uint8_t)(GFMul(a0, 13) ^ GFMul(a1, 9) ^ GFMul(a2, 14) ^ GFMul(a3, 11));
+            s[i + 3] = (uint8_t)(GFMul(a0, 11) ^ GFMul(a1, 13) ^ GFMul(a2, 9) ^ GFMul(a3, 14));
+        }
+    }
+    static void EncryptBlock(const uint8_t* in, uint8_t* out, const vector<uint8_t>& rk)
+    {
+        uint8_t s[16];
+        for (int i = 0; i < 16; i++) { s[i] = in[i]; }
+        const int nr = 14;
+
+        AddRoundKey(s, &rk[0]);
+        for (int r = 1; r < nr; r++)
+        {
+            SubBytes(s);
+            ShiftRows(s);
+            MixColumns(s);
+            AddRoundKey(s, &rk[16 * r]);
+        }
+        SubBytes(s);
+        ShiftRows(s);
+        AddRoundKey(s, &rk[16 * nr]);
+
+        for (int i = 0; i < 16; i++) { out[i] = s[i]; }
+    }
+    static void DecryptBlock(const uint8_t* in, uint8_t* out, const vector<uint8_t>& rk)
+    {
+        uint8_t s[16];
+        for (int i = 0; i < 16; i++) { s[i] = in[i]; }
+        const int nr = 14;
+
+        AddRoundKey(s, &rk[16 * nr]);
+        for (int r = nr - 1; r >= 1; r--)
+        {
+            InvShiftRows(s);
+            InvSubBytes(s);
+            AddRoundKey(s, &rk[16 * r]);
+            InvMixColumns(s);
+        }
+        InvShiftRows(s);
+        InvSubBytes(s);
+        AddRoundKey(s, &rk[0]);
+
+        for (int i = 0; i < 16; i++) { out[i] = s[i]; }
+    }
+
+    // ---------- 硬件加速（运行时分派） ----------
+    typedef void (*Sha256CompressFn)(uint32_t state[8], const uint8_t* blocks, size_t blockCount);
+    // CBC：iv 输入为前一个密文块，返回时更新为最后一个密文块；in 与 out 可以相同
+    typedef void (*AesCbcFn)(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount);
+
+    static void AesCbcEncryptPortable(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            uint8_t block[16];
+            for (int i = 0; i < 16; i++) { block[i] = in[16 * b + i] ^ iv[i]; }
+            EncryptBlock(block, iv, roundKeys);
+            memcpy(out + 16 * b, iv, 16);
+        }
+    }
+
+    static void AesCbcDecryptPortable(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            uint8_t cipher[16];
+            uint8_t plain[16];
+            memcpy(cipher, in + 16 * b, 16);
+            DecryptBlock(cipher, plain, roundKeys);
+            for (int i = 0; i < 16; i++) { out[16 * b + i] = plain[i] ^ iv[i]; }
+            memcpy(iv, cipher, 16);
+        }
+    }
+
+#if defined(GB_CRYPTO_X86)
+    GB_CRYPTO_TARGET_SHANI
+    static void Sha256CompressShaNi(uint32_t state[8], const uint8_t* blocks, size_t blockCount)
+    {
+        const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // SHA-NI 的状态布局为 ABEF / CDGH
+        __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);   // CDAB
+        __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B); // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+
+        for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            const uint8_t* block = blocks + blockIndex * 64;
+            const __m128i abefSave = state0;
+            const __m128i cdghSave = state1;
+
+            // msg[j] 为 W[4j..4j+3]
+            __m128i msg[16];
+            for (int j = 0; j < 16; j++)
+            {
+                if (j < 4)
+                {
+                    msg[j] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * j)), byteSwapMask);
+                }
+                else
+                {
+                    const __m128i partial = _mm_add_epi32(_mm_sha256msg1_epu32(msg[j - 4], msg[j - 3]), _mm_alignr_epi8(msg[j - 1], msg[j - 2], 4));
+                    msg[j] = _mm_sha256msg2_epu32(partial, msg[j - 1]);
+                }
+
+                __m128i wk = _mm_add_epi32(msg[j], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K256[4 * j])));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+                wk = _mm_shuffle_epi32(wk, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+            }
+
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);          // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);       // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);    // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);       // HGFE
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+    }
+
+    GB_CRYPTO_TARGET_AESNI
+    static void AesCbcEncryptAesNi(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        __m128i rk[15];
+        for (int i = 0; i < 15; i++)
+        {
+            rk[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&roundKeys[16 * i]));
+        }
+
+        // CBC 加密前后块相互依赖，只能逐块进行
+        __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b)), prev);
+            s = _mm_xor_si128(s, rk[0]);
+            for (int r = 1; r < 14; r++)
+            {
+                s = _mm_aesenc_si128(s, rk[r]);
+            }
+            prev = _mm_aesenclast_si128(s, rk[14]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), prev);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+    }
+
+    GB_CRYPTO_TARGET_AESNI
+    static void AesCbcDecryptAesNi(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        // 等价逆密码：轮密钥倒序，中间各轮做 InvMixColumns
+        __m128i dk[15];
+        dk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&roundKeys[16 * 14]));
+        for (int i = 1; i < 14; i++)
+        {
+            dk[i] = _mm_aesimc_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&roundKeys[16 * (14 - i)])));
+        }
+        dk[14] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&roundKeys[0]));
+
+        // CBC 解密各块互不依赖，4 块交错以填满 AESDEC 的流水线
+        __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+        size_t b = 0;
+        for (; b + 4 <= blockCount; b += 4)
+        {
+            const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 0)));
+            const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 1)));
+            const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 2)));
+            const __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * (b + 3)));
+            __m128i s0 = _mm_xor_si128(c0, dk[0]);
+            __m128i s1 = _mm_xor_si128(c1, dk[0]);
+            __m128i s2 = _mm_xor_si128(c2, dk[0]);
+            __m128i s3 = _mm_xor_si128(c3, dk[0]);
+            for (int r = 1; r < 14; r++)
+            {
+                s0 = _mm_aesdec_si128(s0, dk[r]);
+                s1 = _mm_aesdec_si128(s1, dk[r]);
+                s2 = _mm_aesdec_si128(s2, dk[r]);
+                s3 = _mm_aesdec_si128(s3, dk[r]);
+            }
+            s0 = _mm_aesdeclast_si128(s0, dk[14]);
+            s1 = _mm_aesdeclast_si128(s1, dk[14]);
+            s2 = _mm_aesdeclast_si128(s2, dk[14]);
+            s3 = _mm_aesdeclast_si128(s3, dk[14]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 0)), _mm_xor_si128(s0, prev));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 1)), _mm_xor_si128(s1, c0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 2)), _mm_xor_si128(s2, c1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * (b + 3)), _mm_xor_si128(s3, c2));
+            prev = c3;
+        }
+        for (; b < blockCount; b++)
+        {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * b));
+            __m128i s = _mm_xor_si128(c, dk[0]);
+            for (int r = 1; r < 14; r++)
+            {
+                s = _mm_aesdec_si128(s, dk[r]);
+            }
+            s = _mm_aesdeclast_si128(s, dk[14]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * b), _mm_xor_si128(s, prev));
+            prev = c;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+    }
+#endif
+
+#if defined(GB_CRYPTO_ARMV8)
+    GB_CRYPTO_TARGET_ARMV8
+    static void Sha256CompressArmv8(uint32_t state[8], const uint8_t* blocks, size_t blockCount)
+    {
+        uint32x4_t state0 = vld1q_u32(&state[0]);   // ABCD
+        uint32x4_t state1 = vld1q_u32(&state[4]);   // EFGH
+
+        for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            const uint8_t* block = blocks + blockIndex * 64;
+            const uint32x4_t abcdSave = state0;
+            const uint32x4_t efghSave = state1;
+
+            uint32x4_t msg[16];
+            for (int j = 0; j < 16; j++)
+            {
+                if (j < 4)
+                {
+                    msg[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + 16 * j)));
+                }
+                else
+                {
+                    msg[j] = vsha256su1q_u32(vsha256su0q_u32(msg[j - 4], msg[j - 3]), msg[j - 2], msg[j - 1]);
+                }
+
+                const uint32x4_t wk = vaddq_u32(msg[j], vld1q_u32(&K256[4 * j]));
+                const uint32x4_t abcd = state0;
+                state0 = vsha256hq_u32(state0, state1, wk);
+                state1 = vsha256h2q_u32(state1, abcd, wk);
+            }
+
+            state0 = vaddq_u32(state0, abcdSave);
+            state1 = vaddq_u32(state1, efghSave);
+        }
+
+        vst1q_u32(&state[0], state0);
+        vst1q_u32(&state[4], state1);
+    }
+
+    GB_CRYPTO_TARGET_ARMV8
+    static void AesCbcEncryptArmv8(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        uint8x16_t rk[15];
+        for (int i = 0; i < 15; i++)
+        {
+            rk[i] = vld1q_u8(&roundKeys[16 * i]);
+        }
+
+        uint8x16_t prev = vld1q_u8(iv);
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            // AESE = AddRoundKey + SubBytes + ShiftRows，AESMC = MixColumns
+            uint8x16_t s = veorq_u8(vld1q_u8(in + 16 * b), prev);
+            for (int r = 0; r < 13; r++)
+            {
+                s = vaesmcq_u8(vaeseq_u8(s, rk[r]));
+            }
+            s = vaeseq_u8(s, rk[13]);
+            prev = veorq_u8(s, rk[14]);
+            vst1q_u8(out + 16 * b, prev);
+        }
+        vst1q_u8(iv, prev);
+    }
+
+    GB_CRYPTO_TARGET_ARMV8
+    static void AesCbcDecryptArmv8(const vector<uint8_t>& roundKeys, uint8_t iv[16], const uint8_t* in, uint8_t* out, size_t blockCount)
+    {
+        uint8x16_t dk[15];
+        dk[0] = vld1q_u8(&roundKeys[16 * 14]);
+        for (int i = 1; i < 14; i++)
+        {
+            dk[i] = vaesimcq_u8(vld1q_u8(&roundKeys[16 * (14 - i)]));
+        }
+        dk[14] = vld1q_u8(&roundKeys[0]);
+
+        uint8x16_t prev = vld1q_u8(iv);
+        for (size_t b = 0; b < blockCount; b++)
+        {
+            // AESD = AddRoundKey + InvShiftRows + InvSubBytes，AESIMC = InvMixColumns
+            const uint8x16_t c = vld1q_u8(in + 16 * b);
+            uint8x16_t s = c;
+            for (int r = 0; r < 13; r++)
+            {
+                s = vaesimcq_u8(vaesdq_u8(s, dk[r]));
+            }
+            s = veorq_u8(vaesdq_u8(s, dk[13]), dk[14]);
+            vst1q_u8(out + 16 * b, veorq_u8(s, prev));
+            prev = c;
+        }
+        vst1q_u8(iv, prev);
+    }
+#endif
+
+    // ---------- 多缓冲（多条消息并行压缩，SIMD 每个 32 位通道一条消息） ----------
+    // state 按 [字][通道] 排列；blocks[lane] 为该通道本次要压缩的 64 字节块
+    typedef void (*HashLanesFn)(uint32_t* state, const uint8_t* const* blocks);
+    typedef void (*BlockCompressFn)(uint32_t* state, const uint8_t* blocks, size_t blockCount);
+
+    static inline void GatherLaneWords(uint32_t* words, const uint8_t* const* blocks, size_t lanes, bool bigEndian)
+    {
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            for (size_t t = 0; t < 16; t++)
+            {
+                words[t * lanes + lane] = bigEndian ? LoadBE32(blocks[lane] + 4 * t) : LoadLE32(blocks[lane] + 4 * t);
+            }
+        }
+    }
+
+#if defined(GB_CRYPTO_X86)
+    // 算法主体只写一次，由各指令集的 MB_* 宏展开
+#define GB_MD5_LANES_BODY(LANES)                                                                \
+    {                                                                                           \
+        uint32_t words[16 * (LANES)];                                                           \
+        GatherLaneWords(words, blocks, (LANES), false);                                         \
+        MB_VEC m[16];                                                                           \
+        for (int t = 0; t < 16; t++) { m[t] = MB_LOAD(&words[t * (LANES)]); }                  \
+        const MB_VEC ones = MB_SET1(-1);                                                        \
+        MB_VEC a = MB_LOAD(&state[0 * (LANES)]);                                                \
+        MB_VEC b = MB_LOAD(&state[1 * (LANES)]);                                                \
+        MB_VEC c = MB_LOAD(&state[2 * (LANES)]);                                                \
+        MB_VEC d = MB_LOAD(&state[3 * (LANES)]);                                                \
+        for (int i = 0; i < 64; i++)                                                            \
+        {                                                                                       \
+            MB_VEC f;                                                                           \
+            int g;                                                                              \
+            if (i < 16) { f = MB_OR(MB_AND(b, c), MB_ANDNOT(b, d)); g = i; }                    \
+            else if (i < 32) { f = MB_OR(MB_AND(d, b), MB_ANDNOT(d, c)); g = (5 * i + 1) & 15; }\
+            else if (i < 48) { f = MB_XOR(MB_XOR(b, c), d); g = (3 * i + 5) & 15; }             \
+            else { f = MB_XOR(c, MB_OR(b, MB_XOR(d, ones))); g = (7 * i) & 15; }                \
+            f = MB_ADD(MB_ADD(f, a), MB_ADD(MB_SET1(static_cast<int>(K[i])), m[g]));            \
+            a = d;                                                                              \
+            d = c;                                                                              \
+            c = b;                                                                              \
+            b = MB_ADD(b, MB_ROTL(f, static_cast<int>(S[i])));                                  \
+        }                                                                                       \
+        MB_STORE(&state[0 * (LANES)], MB_ADD(MB_LOAD(&state[0 * (LANES)]), a));                 \
+        MB_STORE(&state[1 * (LANES)], MB_ADD(MB_LOAD(&state[1 * (LANES)]), b));                 \
+        MB_STORE(&state[2 * (LANES)], MB_ADD(MB_LOAD(&state[2 * (LANES)]), c));                 \
+        MB_STORE(&state[3 * (LANES)], MB_ADD(MB_LOAD(&state[3 * (LANES)]), d));                 \
+    }
+
+#define GB_SHA256_LANES_BODY(LANES)                                                             \
+    {                                                                                           \
+        uint32_t words[16 * (LANES)];                                                           \
+        GatherLaneWords(words, blocks, (LANES), true);                                          \
+        MB_VEC w[16];                                                                           \
+        for (int t = 0; t < 16; t++) { w[t] = MB_LOAD(&words[t * (LANES)]); }                  \
+        MB_VEC v[8];                                                                            \
+        for (int i = 0; i < 8; i++) { v[i] = MB_LOAD(&state[i * (LANES)]); }                    \
+        for (int t = 0; t < 64; t++)                                                            \
+        {                                                                                       \
+            if (t >= 16)                                                                        \
+            {                                                                                   \
+                const MB_VEC w15 = w[(t - 15) & 15];                                            \
+                const MB_VEC w2 = w[(t - 2) & 15];                                              \
+                const MB_VEC s0 = MB_XOR(MB_XOR(MB_ROTR(w15, 7), MB_ROTR(w15, 18)), MB_SHR(w15, 3)); \
+                const MB_VEC s1 = MB_XOR(MB_XOR(MB_ROTR(w2, 17), MB_ROTR(w2, 19)), MB_SHR(w2, 10)); \
+                w[t & 15] = MB_ADD(MB_ADD(w[t & 15], s0), MB_ADD(w[(t - 7) & 15], s1));         \
+            }                                                                                   \
+            const MB_VEC e = v[4];                                                              \
+            const MB_VEC a = v[0];                                                              \
+            const MB_VEC bigSigma1 = MB_XOR(MB_XOR(MB_ROTR(e, 6), MB_ROTR(e, 11)), MB_ROTR(e, 25)); \
+            const MB_VEC ch = MB_XOR(MB_AND(e, v[5]), MB_ANDNOT(e, v[6]));                      \
+            const MB_VEC t1 = MB_ADD(MB_ADD(MB_ADD(v[7], bigSigma1), MB_ADD(ch, MB_SET1(static_cast<int>(K256[t])))), w[t & 15]); \
+            const MB_VEC bigSigma0 = MB_XOR(MB_XOR(MB_ROTR(a, 2), MB_ROTR(a, 13)), MB_ROTR(a, 22)); \
+            const MB_VEC maj = MB_OR(MB_AND(a, v[1]), MB_AND(v[2], MB_OR(a, v[1])));            \
+            v[7] = v[6];                                                                        \
+            v[6] = v[5];                                                                        \
+            v[5] = e;                                                                           \
+            v[4] = MB_ADD(v[3], t1);                                                            \
+            v[3] = v[2];                                                                        \
+            v[2] = v[1];                                                                        \
+            v[1] = a;                                                                           \
+            v[0] = MB_ADD(t1, MB_ADD(bigSigma0, maj));                                          \
+        }                                                                                       \
+        for (int i = 0; i < 8; i++) { MB_STORE(&state[i * (LANES)], MB_ADD(MB_LOAD(&state[i * (LANES)]), v[i])); } \
+    }
+
+    // SSE2：4 通道（x86-64 基线）
+#define MB_VEC __m128i
+#define MB_LOAD(p) _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+#define MB_STORE(p, x) _mm_storeu_si128(reinterpret_cast<__m128i*>(p), (x))
+#define MB_SET1(x) _mm_set1_epi32(x)
+#define MB_ADD(x, y) _mm_add_epi32((x), (y))
+#define MB_XOR(x, y) _mm_xor_si128((x), (y))
+#define MB_AND(x, y) _mm_and_si128((x), (y))
+#define MB_OR(x, y) _mm_or_si128((x), (y))
+#define MB_ANDNOT(x, y) _mm_andnot_si128((x), (y))
+#define MB_SHR(x, n) _mm_srl_epi32((x), _mm_cvtsi32_si128(n))
+#define MB_ROTL(x, n) _mm_or_si128(_mm_sll_epi32((x), _mm_cvtsi32_si128(n)), _mm_srl_epi32((x), _mm_cvtsi32_si128(32 - (n))))
+#define MB_ROTR(x, n) _mm_or_si128(_mm_srl_epi32((x), _mm_cvtsi32_si128(n)), _mm_sll_epi32((x), _mm_cvtsi32_si128(32 - (n))))
+    static void Md5LanesSse2(uint32_t* state, const uint8_t* const* blocks) GB_MD5_LANES_BODY(4)
+    static void Sha256LanesSse2(uint32_t* state, const uint8_t* const* blocks) GB_SHA256_LANES_BODY(4)
+#undef MB_VEC
+#undef MB_LOAD
+#undef MB_STORE
+#undef MB_SET1
+#undef MB_ADD
+#undef MB_XOR
+#undef MB_AND
+#undef MB_OR
+#undef MB_ANDNOT
+#undef MB_SHR
+#undef MB_ROTL
+#undef MB_ROTR
+
+    // AVX2：8 通道
+#define MB_VEC __m256i
+#define MB_LOAD(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define MB_STORE(p, x) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), (x))
+#define MB_SET1(x) _mm256_set1_epi32(x)
+#define MB_ADD(x, y) _mm256_add_epi32((x), (y))
+#define MB_XOR(x, y) _mm256_xor_si256((x), (y))
+#define MB_AND(x, y) _mm256_and_si256((x), (y))
+#define MB_OR(x, y) _mm256_or_si256((x), (y))
+#define MB_ANDNOT(x, y) _mm256_andnot_si256((x), (y))
+#define MB_SHR(x, n) _mm256_srl_epi32((x), _mm_cvtsi32_si128(n))
+#define MB_ROTL(x, n) _mm256_or_si256(_mm256_sll_epi32((x), _mm_cvtsi32_si128(n)), _mm256_srl_epi32((x), _mm_cvtsi32_si128(32 - (n))))
+#define MB_ROTR(x, n) _mm256_or_si256(_mm256_srl_epi32((x), _mm_cvtsi32_si128(n)), _mm256_sll_epi32((x), _mm_cvtsi32_si128(32 - (n))))
+    GB_CRYPTO_TARGET_AVX2
+    static void Md5LanesAvx2(uint32_t* state, const uint8_t* const* blocks) GB_MD5_LANES_BODY(8)
+    GB_CRYPTO_TARGET_AVX2
+    static void Sha256LanesAvx2(uint32_t* state, const uint8_t* const* blocks) GB_SHA256_LANES_BODY(8)
+#undef MB_VEC
+#undef MB_LOAD
+#undef MB_STORE
+#undef MB_SET1
+#undef MB_ADD
+#undef MB_XOR
+#undef MB_AND
+#undef MB_OR
+#undef MB_ANDNOT
+#undef MB_SHR
+#undef MB_ROTL
+#undef MB_ROTR
+
+    // AVX-512F：16 通道，带原生循环移位。
+    // 移位与 andnot 用全 1 掩码的 maskz 形式：GCC 的非掩码版本以 _mm512_undefined 作为直通操作数，-Wall 下会报 -Wuninitialized
+#define MB_FULL_MASK static_cast<__mmask16>(0xFFFF)
+#define MB_VEC __m512i
+#define MB_LOAD(p) _mm512_loadu_si512(reinterpret_cast<const void*>(p))
+#define MB_STORE(p, x) _mm512_storeu_si512(reinterpret_cast<void*>(p), (x))
+#define MB_SET1(x) _mm512_set1_epi32(x)
+#define MB_ADD(x, y) _mm512_add_epi32((x), (y))
+#define MB_XOR(x, y) _mm512_xor_si512((x), (y))
+#define MB_AND(x, y) _mm512_and_si512((x), (y))
+#define MB_OR(x, y) _mm512_or_si512((x), (y))
+#define MB_ANDNOT(x, y) _mm512_maskz_andnot_epi32(MB_FULL_MASK, (x), (y))
+#define MB_SHR(x, n) _mm512_maskz_srlv_epi32(MB_FULL_MASK, (x), _mm512_set1_epi32(n))
+#define MB_ROTL(x, n) _mm512_maskz_rolv_epi32(MB_FULL_MASK, (x), _mm512_set1_epi32(n))
+#define MB_ROTR(x, n) _mm512_maskz_rorv_epi32(MB_FULL_MASK, (x), _mm512_set1_epi32(n))
+    GB_CRYPTO_TARGET_AVX512
+    static void Md5LanesAvx512(uint32_t* state, const uint8_t* const* blocks) GB_MD5_LANES_BODY(16)
+    GB_CRYPTO_TARGET_AVX512
+    static void Sha256LanesAvx512(uint32_t* state, const uint8_t* const* blocks) GB_SHA256_LANES_BODY(16)
+#undef MB_FULL_MASK
+#undef MB_VEC
+#undef MB_LOAD
+#undef MB_STORE
+#undef MB_SET1
+#undef MB_ADD
+#undef MB_XOR
+#undef MB_AND
+#undef MB_OR
+#undef MB_ANDNOT
+#undef MB_SHR
+#undef MB_ROTL
+#undef MB_ROTR
+
+#undef GB_MD5_LANES_BODY
+#undef GB_SHA256_LANES_BODY
+#endif
+
+    struct CryptoKernels
+    {
+        Sha256CompressFn sha256Compress = &Sha256CompressPortable;
+        const char* sha256Name = "portable";
+        AesCbcFn aesCbcEncrypt = &AesCbcEncryptPortable;
+        AesCbcFn aesCbcDecrypt = &AesCbcDecryptPortable;
+        const char* aesName = "portable";
+        // 多缓冲内核；为空表示逐条调用单消息实现
+        HashLanesFn md5Lanes = nullptr;
+        HashLanesFn sha256Lanes = nullptr;
+        size_t lanes = 0;
+        const char* lanesName = "none";
+    };
+
+    struct CryptoCpuFeatures
+    {
+        bool sha256 = false;
+        bool aes = false;
+        bool sse2 = false;
+        bool avx2 = false;
+        bool avx512 = false;
+    };
+
+    static CryptoCpuFeatures DetectCryptoCpuFeatures()
+    {
+        CryptoCpuFeatures features;
+#if defined(GB_CRYPTO_X86)
+        unsigned maxLeaf = 0;
+        unsigned leaf1Ecx = 0;
+        unsigned leaf1Edx = 0;
+        unsigned leaf7Ebx = 0;
+#  if defined(_MSC_VER)
+        int regs[4] = { 0 };
+        __cpuid(regs, 0);
+        maxLeaf = static_cast<unsigned>(regs[0]);
+        __cpuid(regs, 1);
+        leaf1Ecx = static_cast<unsigned>(regs[2]);
+        leaf1Edx = static_cast<unsigned>(regs[3]);
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(regs, 7, 0);
+            leaf7Ebx = static_cast<unsigned>(regs[1]);
+        }
+#  else
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+        {
+            maxLeaf = eax;
+        }
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        {
+            leaf1Ecx = ecx;
+            leaf1Edx = edx;
+        }
+        if (maxLeaf >= 7)
+        {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            leaf7Ebx = ebx;
+        }
+#  endif
+        const bool ssse3 = (leaf1Ecx & (1u << 9)) != 0;
+        const bool sse41 = (leaf1Ecx & (1u << 19)) != 0;
+        features.sse2 = (leaf1Edx & (1u << 26)) != 0;
+        features.aes = sse41 && (leaf1Ecx & (1u << 25)) != 0;
+        features.sha256 = ssse3 && sse41 && (leaf7Ebx & (1u << 29)) != 0;
+
+        // AVX 寄存器还需要操作系统在 XCR0 中开启保存（OSXSAVE）
+        if ((leaf1Ecx & (1u << 27)) != 0)
+        {
+#  if defined(_MSC_VER)
+            const uint64_t xcr0 = _xgetbv(0);
+#  else
+            unsigned xcr0Low = 0, xcr0High = 0;
+            __asm__ __volatile__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            const uint64_t xcr0 = (static_cast<uint64_t>(xcr0High) << 32) | xcr0Low;
+#  endif
+            const bool osAvx = (xcr0 & 0x06) == 0x06;
+            const bool osAvx512 = osAvx && (xcr0 & 0xE0) == 0xE0;
+            features.avx2 = osAvx && (leaf7Ebx & (1u << 5)) != 0;
+            features.avx512 = osAvx512 && (leaf7Ebx & (1u << 16)) != 0;
+        }
+#elif defined(GB_CRYPTO_ARMV8)
+#  if defined(__linux__)
+        const unsigned long hwcap = getauxval(AT_HWCAP);
+        features.sha256 = (hwcap & HWCAP_SHA2) != 0;
+        features.aes = (hwcap & HWCAP_AES) != 0;
+#  elif defined(_WIN32)
+        features.sha256 = features.aes = IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+#  elif defined(__APPLE__)
+        features.sha256 = features.aes = true;
+#  endif
+#endif
+        return features;
+    }
+
+    // 已知答案 + 与可移植实现的对照：任一不一致就不启用该内核
+    static bool VerifySha256Kernel(Sha256CompressFn fn)
+    {
+        // SHA-256("abc") 的唯一填充块（FIPS 180-4 附录示例）
+        uint8_t block[64] = { 0 };
+        block[0] = 'a'; block[1] = 'b'; block[2] = 'c'; block[3] = 0x80; block[63] = 24;
+        static const uint32_t expected[8] =
+        {
+            0xba7816bfu, 0x8f01cfeau, 0x414140deu, 0x5dae2223u, 0xb00361a3u, 0x96177a9cu, 0xb410ff61u, 0xf20015adu
+        };
+        uint32_t state[8] = { 0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u };
+        fn(state, block, 1);
+        if (memcmp(state, expected, sizeof(state)) != 0)
+        {
+            return false;
+        }
+
+        uint8_t data[64 * 5];
+        for (size_t i = 0; i < sizeof(data); i++) { data[i] = static_cast<uint8_t>(i * 167 + 13); }
+        uint32_t reference[8];
+        memcpy(reference, state, sizeof(state));
+        Sha256CompressPortable(reference, data, 5);
+        fn(state, data, 5);
+        return memcmp(state, reference, sizeof(state)) == 0;
+    }
+
+    static bool VerifyAesKernels(AesCbcFn encrypt, AesCbcFn decrypt)
+    {
+        // FIPS-197 附录 C.3（AES-256），单块 CBC 且 IV 为 0 时等同 ECB
+        string key(32, '\0');
+        for (int i = 0; i < 32; i++) { key[i] = static_cast<char>(i); }
+        vector<uint8_t> rk;
+        if (!ExpandKey256(key, rk))
+        {
+            return false;
+        }
+        static const uint8_t plain[16] = { 0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff };
+        static const uint8_t cipher[16] = { 0x8e,0xa2,0xb7,0xca,0x51,0x67,0x45,0xbf,0xea,0xfc,0x49,0x90,0x4b,0x49,0x60,0x89 };
+        uint8_t iv[16] = { 0 };
+        uint8_t out[16];
+        encrypt(rk, iv, plain, out, 1);
+        if (memcmp(out, cipher, 16) != 0)
+        {
+            return false;
+        }
+        memset(iv, 0, sizeof(iv));
+        decrypt(rk, iv, cipher, out, 1);
+        if (memcmp(out, plain, 16) != 0)
+        {
+            return false;
+        }
+
+        // 7 块：覆盖解密的 4 块交错路径与尾部
+        uint8_t data[16 * 7];
+        for (size_t i = 0; i < sizeof(data); i++) { data[i] = static_cast<uint8_t>(i * 89 + 7); }
+        uint8_t ivA[16], ivB[16];
+        for (int i = 0; i < 16; i++) { ivA[i] = ivB[i] = static_cast<uint8_t>(0xA5 ^ i); }
+        uint8_t encA[sizeof(data)], encB[sizeof(data)];
+        AesCbcEncryptPortable(rk, ivA, data, encA, 7);
+        encrypt(rk, ivB, data, encB, 7);
+        if (memcmp(encA, encB, sizeof(data)) != 0 || memcmp(ivA, ivB, 16) != 0)
+        {
+            return false;
+        }
+        for (int i = 0; i < 16; i++) { ivB[i] = static_cast<uint8_t>(0xA5 ^ i); }
+        decrypt(rk, ivB, encB, encB, 7);   // 原地解密
+        return memcmp(encB, data, sizeof(data)) == 0;
+    }
+
+    static const uint32_t kMd5Iv[4] = { 0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u };
+    static const uint32_t kSha256Iv[8] = { 0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u };
+
+#if defined(GB_CRYPTO_X86)
+    // 与单消息实现逐条对照：长度覆盖单块/双块填充边界与多块消息，条数多于通道数以覆盖通道复用
+    static bool VerifyHashLanesKernel(HashLanesFn kernel, size_t lanes, size_t stateWords, const uint32_t* iv, bool bigEndian, BlockCompressFn compress)
+    {
+        static const size_t sizes[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 200, 3, 1000, 17, 64, 128, 0, 300, 5, 9, 250 };
+        const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+        uint8_t data[1000];
+        for (size_t i = 0; i < sizeof(data); i++) { data[i] = static_cast<uint8_t>(i * 73 + 11); }
+
+        vector<uint32_t> state(stateWords * lanes);
+        for (size_t i = 0; i < count; i += lanes)
+        {
+            const size_t batch = (count - i < lanes) ? count - i : lanes;
+            // 每个通道各自做一次完整填充，按最长消息的块数推进，短消息用零块补齐后舍弃
+            vector<uint8_t> padded[16];
+            size_t maxBlocks = 0;
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                const size_t size = (lane < batch) ? sizes[i + lane] : 0;
+                vector<uint8_t>& buf = padded[lane];
+                const size_t blockCount = (size + 9 + 63) / 64;
+                buf.assign(blockCount * 64, 0);
+                memcpy(buf.data(), data, size);
+                buf[size] = 0x80;
+                const uint64_t bits = static_cast<uint64_t>(size) * 8;
+                for (int k = 0; k < 8; k++)
+                {
+                    buf[buf.size() - 8 + k] = static_cast<uint8_t>(bigEndian ? (bits >> (56 - 8 * k)) : (bits >> (8 * k)));
+                }
+                maxBlocks = (std::max)(maxBlocks, blockCount);
+                for (size_t w = 0; w < stateWords; w++) { state[w * lanes + lane] = iv[w]; }
+            }
+
+            vector<uint32_t> laneResult(stateWords * lanes);
+            vector<bool> done(lanes, false);
+            const uint8_t zeroBlock[64] = { 0 };
+            for (size_t blockIndex = 0; blockIndex < maxBlocks; blockIndex++)
+            {
+                const uint8_t* blocks[16];
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    blocks[lane] = (blockIndex * 64 < padded[lane].size()) ? padded[lane].data() + blockIndex * 64 : zeroBlock;
+                }
+                kernel(state.data(), blocks);
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    if (!done[lane] && (blockIndex + 1) * 64 == padded[lane].size())
+                    {
+                        for (size_t w = 0; w < stateWords; w++) { laneResult[w * lanes + lane] = state[w * lanes + lane]; }
+                        done[lane] = true;
+                    }
+                }
+            }
+
+            for (size_t lane = 0; lane < batch; lane++)
+            {
+                uint32_t reference[8];
+                memcpy(reference, iv, stateWords * sizeof(uint32_t));
+                compress(reference, padded[lane].data(), padded[lane].size() / 64);
+                for (size_t w = 0; w < stateWords; w++)
+                {
+                    if (laneResult[w * lanes + lane] != reference[w])
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    static bool TrySelectHashLanes(CryptoKernels& kernels, HashLanesFn md5Lanes, HashLanesFn sha256Lanes, size_t lanes, const char* name)
+    {
+        if (!VerifyHashLanesKernel(md5Lanes, lanes, 4, kMd5Iv, false, &Md5Compress) ||
+            !VerifyHashLanesKernel(sha256Lanes, lanes, 8, kSha256Iv, true, &Sha256CompressPortable))
+        {
+            return false;
+        }
+        kernels.md5Lanes = md5Lanes;
+        kernels.sha256Lanes = sha256Lanes;
+        kernels.lanes = lanes;
+        kernels.lanesName = name;
+        return true;
+    }
+#endif
+
+    static CryptoKernels ResolveAcceleratedKernels()
+    {
+        CryptoKernels kernels;
+        const CryptoCpuFeatures features = DetectCryptoCpuFeatures();
+#if defined(GB_CRYPTO_X86)
+        if (features.sha256 && VerifySha256Kernel(&Sha256CompressShaNi))
+        {
+            kernels.sha256Compress = &Sha256CompressShaNi;
+            kernels.sha256Name = "SHA-NI";
+        }
+        if (features.aes && VerifyAesKernels(&AesCbcEncryptAesNi, &AesCbcDecryptAesNi))
+        {
+            kernels.aesCbcEncrypt = &AesCbcEncryptAesNi;
+            kernels.aesCbcDecrypt = &AesCbcDecryptAesNi;
+            kernels.aesName = "AES-NI";
+        }
+        // 通道越多越好；校验失败时退到下一档
+        if (!(features.avx512 && TrySelectHashLanes(kernels, &Md5LanesAvx512, &Sha256LanesAvx512, 16, "AVX-512 x16")) &&
+            !(features.avx2 && TrySelectHashLanes(kernels, &Md5LanesAvx2, &Sha256LanesAvx2, 8, "AVX2 x8")) &&
+            features.sse2)
+        {
+            TrySelectHashLanes(kernels, &Md5LanesSse2, &Sha256LanesSse2, 4, "SSE2 x4");
+        }
+        // 实测 SHA-NI 单条压缩快于 8 路及以下的多缓冲，只有 16 路才略胜
+        if (kernels.sha256Compress != &Sha256CompressPortable && kernels.lanes < 16)
+        {
+            kernels.sha256Lanes = nullptr;
+        }
+#elif defined(GB_CRYPTO_ARMV8)
+        if (features.sha256 && VerifySha256Kernel(&Sha256CompressArmv8))
+        {
+            kernels.sha256Compress = &Sha256CompressArmv8;
+            kernels.sha256Name = "ARMv8-SHA2";
+        }
+        if (features.aes && VerifyAesKernels(&AesCbcEncryptArmv8, &AesCbcDecryptArmv8))
+        {
+            kernels.aesCbcEncrypt = &AesCbcEncryptArmv8;
+            kernels.aesCbcDecrypt = &AesCbcDecryptArmv8;
+            kernels.aesName = "ARMv8-AES";
+        }
+#else
+        (void)features;
+#endif
+        return kernels;
+    }
+
+    static atomic<bool> cryptoAccelerationEnabled(true);
+
+    static const CryptoKernels& GetCryptoKernels()
+    {
+        static const CryptoKernels portable;
+        static const CryptoKernels accelerated = ResolveAcceleratedKernels();
+        return cryptoAccelerationEnabled.load(memory_order_relaxed) ? accelerated : portable;
+    }
+
+    static void Sha256Compress(uint32_t state[8], const uint8_t* blocks, size_t blockCount)
+    {
+        GetCryptoKernels().sha256Compress(state, blocks, blockCount);
+    }
+
+    // ---------- 批量哈希的通道调度 ----------
+    struct HashManySpec
+    {
+        HashLanesFn lanesKernel;
+        size_t lanes;
+        BlockCompressFn compress;   // 单消息压缩，用于收尾
+        const uint32_t* iv;
+        size_t stateWords;
+        bool bigEndian;             // 长度字段与摘要的字节序
+    };
+
+    struct HashLane
+    {
+        const uint8_t* data = nullptr;
+        size_t messageIndex = 0;
+        size_t fullBlocks = 0;      // 直接从原消息读取的整块数
+        size_t totalBlocks = 0;     // 加上填充块（1 或 2 个）
+        size_t nextBlock = 0;
+        uint8_t tail[128];
+    };
+
+    static void StartHashLane(const HashManySpec& spec, HashLane& lane, size_t messageIndex, const uint8_t* data, size_t size)
+    {
+        lane.data = data;
+        lane.messageIndex = messageIndex;
+        lane.fullBlocks = size / 64;
+        lane.nextBlock = 0;
+
+        const size_t remain = size - lane.fullBlocks * 64;
+        const size_t tailBlocks = (remain + 9 <= 64) ? 1 : 2;
+        lane.totalBlocks = lane.fullBlocks + tailBlocks;
+        if (remain > 0)
+        {
+            memcpy(lane.tail, data + lane.fullBlocks * 64, remain);
+        }
+        lane.tail[remain] = 0x80;
+        memset(lane.tail + remain + 1, 0, tailBlocks * 64 - remain - 1);
+        const uint64_t bits = static_cast<uint64_t>(size) * 8;
+        uint8_t* lengthField = lane.tail + tailBlocks * 64 - 8;
+        for (int k = 0; k < 8; k++)
+        {
+            lengthField[k] = static_cast<uint8_t>(spec.bigEndian ? (bits >> (56 - 8 * k)) : (bits >> (8 * k)));
+        }
+    }
+
+    static inline const uint8_t* HashLaneBlock(const HashLane& lane, size_t blockIndex)
     {
-        uint8_t t;
-        t = s[13]; s[13] = s[9];  s[9] = s[5];  s[5] = s[1];  s[1] = t;
-        uint8_t t0 = s[2], t1 = s[6];
-        s[2] = s[10]; s[6] = s[14]; s[10] = t0; s[14] = t1;
-        t = s[3];  s[3] = s[7];  s[7] = s[11]; s[11] = s[15]; s[15] = t;
+        return (blockIndex < lane.fullBlocks) ? lane.data + blockIndex * 64 : lane.tail + (blockIndex - lane.fullBlocks) * 64;
     }
-    static void MixColumns(uint8_t* s)
+
+    static void StoreHashDigest(const HashManySpec& spec, const uint32_t* state, uint8_t* digest)
     {
-        for (int c = 0; c < 4; c++)
+        for (size_t w = 0; w < spec.stateWords; w++)
         {
-            const int i = 4 * c;
-            const uint8_t a0 = s[i + 0], a1 = s[i + 1], a2 = s[i + 2], a3 = s[i + 3];
-            s[i + 0] = (uint8_t)(GFMul(a0, 2) ^ GFMul(a1, 3) ^ a2 ^ a3);
-            s[i + 1] = (uint8_t)(a0 ^ GFMul(a1, 2) ^ GFMul(a2, 3) ^ a3);
-            s[i + 2] = (uint8_t)(a0 ^ a1 ^ GFMul(a2, 2) ^ GFMul(a3, 3));
-            s[i + 3] = (uint8_t)(GFMul(a0, 3) ^ a1 ^ a2 ^ GFMul(a3, 2));
+            if (spec.bigEndian)
+            {
+                StoreBE32(state[w], digest + 4 * w);
+            }
+            else
+            {
+                StoreLE32(state[w], digest + 4 * w);
+            }
         }
     }
-    static void InvMixColumns(uint8_t* s)
+
+    // 单条消息：不分配内存，整块直接压缩，只有最后 1~2 块经过 tail 缓冲
+    static void HashOneMessage(const HashManySpec& spec, const uint8_t* data, size_t size, uint8_t* digest)
     {
-        for (int c = 0; c < 4; c++)
+        HashLane lane;
+        StartHashLane(spec, lane, 0, data, size);
+        uint32_t state[8];
+        memcpy(state, spec.iv, spec.stateWords * sizeof(uint32_t));
+        if (lane.fullBlocks > 0)
         {
-            const int i = 4 * c;
-            const uint8_t a0 = s[i + 0], a1 = s[i + 1], a2 = s[i + 2], a3 = s[i + 3];
-            s[i + 0] = (uint8_t)(GFMul(a0, 14) ^ GFMul(a1, 11) ^ GFMul(a2, 13) ^ GFMul(a3, 9));
-            s[i + 1] = (uint8_t)(GFMul(a0, 9) ^ GFMul(a1, 14) ^ GFMul(a2, 11) ^ GFMul(a3, 13));
-            s[i + 2] = (uint8_t)(GFMul(a0, 13) ^ GFMul(a1, 9) ^ GFMul(a2, 14) ^ GFMul(a3, 11));
-            s[i + 3] = (uint8_t)(GFMul(a0, 11) ^ GFMul(a1, 13) ^ GFMul(a2, 9) ^ GFMul(a3, 14));
+            spec.compress(state, data, lane.fullBlocks);
         }
+        spec.compress(state, lane.tail, lane.totalBlocks - lane.fullBlocks);
+        StoreHashDigest(spec, state, digest);
     }
-    static void EncryptBlock(const uint8_t* in, uint8_t* out, const vector<uint8_t>& rk)
+
+    /*
+        每个 SIMD 通道独立处理一条消息：某通道的消息压缩完后立即换入下一条，各通道不必等齐。
+        超过 maxLaneMessageBytes 的长消息直接走单消息路径（多数通道会空等它）；
+        没有新消息可换入且活跃通道不足 1/4 时，剩余通道也改走单消息压缩收尾。
+    */
+    static void HashManyWithLanes(const HashManySpec& spec, const uint8_t* const* messages, const size_t* sizes, size_t count, uint8_t* digests)
     {
-        uint8_t s[16];
-        for (int i = 0; i < 16; i++) { s[i] = in[i]; }
-        const int nr = 14;
+        static const size_t maxLaneMessageBytes = 4096;
+        const size_t lanes = spec.lanes;
+        const size_t digestSize = spec.stateWords * 4;
 
-        AddRoundKey(s, &rk[0]);
-        for (int r = 1; r < nr; r++)
+        vector<uint32_t> state(spec.stateWords * lanes);
+        HashLane laneSlots[16];
+        bool active[16] = { false };
+        size_t activeCount = 0;
+        size_t next = 0;
+
+        auto refill = [&](size_t lane)
+            {
+                while (next < count && sizes[next] > maxLaneMessageBytes)
+                {
+                    HashOneMessage(spec, messages[next], sizes[next], digests + next * digestSize);
+                    next++;
+                }
+                if (next >= count)
+                {
+                    active[lane] = false;
+                    return;
+                }
+                StartHashLane(spec, laneSlots[lane], next, messages[next], sizes[next]);
+                for (size_t w = 0; w < spec.stateWords; w++) { state[w * lanes + lane] = spec.iv[w]; }
+                active[lane] = true;
+                next++;
+            };
+
+        for (size_t lane = 0; lane < lanes; lane++)
         {
-            SubBytes(s);
-            ShiftRows(s);
-            MixColumns(s);
-            AddRoundKey(s, &rk[16 * r]);
+            refill(lane);
+            activeCount += active[lane] ? 1 : 0;
         }
-        SubBytes(s);
-        ShiftRows(s);
-        AddRoundKey(s, &rk[16 * nr]);
 
-        for (int i = 0; i < 16; i++) { out[i] = s[i]; }
-    }
-    static void DecryptBlock(const uint8_t* in, uint8_t* out, const vector<uint8_t>& rk)
-    {
-        uint8_t s[16];
-        for (int i = 0; i < 16; i++) { s[i] = in[i]; }
-        const int nr = 14;
+        static const uint8_t idleBlock[64] = { 0 };
+        const uint8_t* blocks[16];
+        while (activeCount > 0)
+        {
+            if (next >= count && activeCount * 4 <= lanes)
+            {
+                break;
+            }
 
-        AddRoundKey(s, &rk[16 * nr]);
-        for (int r = nr - 1; r >= 1; r--)
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                blocks[lane] = active[lane] ? HashLaneBlock(laneSlots[lane], laneSlots[lane].nextBlock) : idleBlock;
+            }
+            spec.lanesKernel(state.data(), blocks);
+
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                if (!active[lane])
+                {
+                    continue;
+                }
+                HashLane& slot = laneSlots[lane];
+                if (++slot.nextBlock < slot.totalBlocks)
+                {
+                    continue;
+                }
+
+                uint32_t laneState[8];
+                for (size_t w = 0; w < spec.stateWords; w++) { laneState[w] = state[w * lanes + lane]; }
+                StoreHashDigest(spec, laneState, digests + slot.messageIndex * digestSize);
+                refill(lane);
+                activeCount -= active[lane] ? 0 : 1;
+            }
+        }
+
+        // 收尾：把剩余通道的中间状态取出，逐条压缩完
+        for (size_t lane = 0; lane < lanes; lane++)
         {
-            InvShiftRows(s);
-            InvSubBytes(s);
-            AddRoundKey(s, &rk[16 * r]);
-            InvMixColumns(s);
+            if (!active[lane])
+            {
+                continue;
+            }
+            HashLane& slot = laneSlots[lane];
+            uint32_t laneState[8];
+            for (size_t w = 0; w < spec.stateWords; w++) { laneState[w] = state[w * lanes + lane]; }
+            if (slot.nextBlock < slot.fullBlocks)
+            {
+                spec.compress(laneState, slot.data + slot.nextBlock * 64, slot.fullBlocks - slot.nextBlock);
+                slot.nextBlock = slot.fullBlocks;
+            }
+            spec.compress(laneState, slot.tail + (slot.nextBlock - slot.fullBlocks) * 64, slot.totalBlocks - slot.nextBlock);
+            StoreHashDigest(spec, laneState, digests + slot.messageIndex * digestSize);
         }
-        InvShiftRows(s);
-        InvSubBytes(s);
-        AddRoundKey(s, &rk[0]);
+    }
 
-        for (int i = 0; i < 16; i++) { out[i] = s[i]; }
+    static void HashMany(const HashManySpec& spec, const uint8_t* const* messages, const size_t* sizes, size_t count, uint8_t* digests)
+    {
+        if (spec.lanesKernel == nullptr || count < 2)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                HashOneMessage(spec, messages[i], sizes[i], digests + i * spec.stateWords * 4);
+            }
+            return;
+        }
+        HashManyWithLanes(spec, messages, sizes, count, digests);
     }
 
+
     // ---------- 规范化 ----------
     static bool NormalizeKey32(const string& keyMaterial, bool flexible, string& keyOut)
     {
@@ -1876,249 +3092,312 @@ string GB_Base64Decode(const string& base64Info, bool strictMode, bool urlSafe,
 
 string GB_GetMd5(const string& input)
 {
-    // 1) 拷贝并填充：追加 0x80，再补 0x00 至 (len % 64 == 56)
-    vector<uint8_t> buf;
-    buf.reserve(input.size() + 64);
-    buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(input.data()),
-        reinterpret_cast<const uint8_t*>(input.data()) + input.size());
+    GB_Md5Hasher hasher;
+    hasher.Update(input.data(), input.size());
+    return hasher.FinalHex();
+}
+
+GB_Md5Hasher::GB_Md5Hasher()
+{
+    Init();
+}
+
+void GB_Md5Hasher::Init()
+{
+    state[0] = 0x67452301u;
+    state[1] = 0xefcdab89u;
+    state[2] = 0x98badcfeu;
+    state[3] = 0x10325476u;
+    totalBytes = 0;
+    bufferSize = 0;
+}
+
+void GB_Md5Hasher::Update(const void* data, size_t size)
+{
+    totalBytes += size;
+    internal::HashUpdateBuffered<uint32_t, 64>(state, buffer, bufferSize, static_cast<const uint8_t*>(data), size, &internal::Md5Compress);
+}
+
+void GB_Md5Hasher::Update(const string& data)
+{
+    Update(data.data(), data.size());
+}
+
+bool GB_Md5Hasher::UpdateFromFile(const string& filePathUtf8)
+{
+    return internal::HashUpdateFromFile(*this, filePathUtf8);
+}
+
+bool GB_Md5Hasher::UpdateFromStream(istream& stream)
+{
+    return internal::HashUpdateFromStream(*this, stream);
+}
 
-    buf.push_back(0x80u);
-    while ((buf.size() % 64u) != 56u)
+void GB_Md5Hasher::Final(unsigned char digest[16])
+{
+    // 填充后追加原消息长度（比特数）的小端 64 位（按 2^64 取模）
+    const uint64_t bitLen = totalBytes * 8ull;
+    const size_t lengthOffset = internal::HashPadBuffered<uint32_t, 64>(state, buffer, bufferSize, 8, &internal::Md5Compress);
+    for (int i = 0; i < 8; ++i)
     {
-        buf.push_back(0x00u);
+        buffer[lengthOffset + i] = static_cast<uint8_t>((bitLen >> (8 * i)) & 0xFFu);
     }
+    internal::Md5Compress(state, buffer, 1);
 
-    // 2) 追加原消息长度（比特数）的小端 64 位（按 2^64 取模）
-    const uint64_t bitLen = static_cast<uint64_t>(input.size()) * 8ull;
-    for (int i = 0; i < 8; ++i)
+    // A||B||C||D 的小端字节序
+    for (int i = 0; i < 4; ++i)
     {
-        buf.push_back(static_cast<uint8_t>((bitLen >> (8 * i)) & 0xFFu));
+        internal::StoreLE32(state[i], digest + i * 4);
     }
+    Init();
+}
+
+string GB_Md5Hasher::FinalHex()
+{
+    uint8_t digest[16];
+    Final(digest);
+    return internal::BytesToLowerHex(digest, sizeof(digest));
+}
 
-    // 3) 初始化 IV
-    uint32_t a0 = 0x67452301u;
-    uint32_t b0 = 0xefcdab89u;
-    uint32_t c0 = 0x98badcfeu;
-    uint32_t d0 = 0x10325476u;
+string GB_GetSha256(const string& input)
+{
+    GB_Sha256Hasher hasher;
+    hasher.Update(input.data(), input.size());
+    return hasher.FinalHex();
+}
 
-    // 4) 逐块（64 字节）压缩
-    for (size_t off = 0; off < buf.size(); off += 64)
-    {
-        uint32_t m[16];
-        for (int j = 0; j < 16; ++j)
-        {
-            m[j] = internal::LoadLE32(&buf[off + j * 4]);
-        }
+GB_Sha256Hasher::GB_Sha256Hasher()
+{
+    Init();
+}
 
-        uint32_t a = a0, b = b0, c = c0, d = d0;
+void GB_Sha256Hasher::Init()
+{
+    // 初始向量（FIPS 180-4）
+    state[0] = 0x6a09e667u; state[1] = 0xbb67ae85u; state[2] = 0x3c6ef372u; state[3] = 0xa54ff53au;
+    state[4] = 0x510e527fu; state[5] = 0x9b05688cu; state[6] = 0x1f83d9abu; state[7] = 0x5be0cd19u;
+    totalBytes = 0;
+    bufferSize = 0;
+}
 
-        for (uint32_t i = 0; i < 64; ++i)
-        {
-            uint32_t f, g;
+void GB_Sha256Hasher::Update(const void* data, size_t size)
+{
+    totalBytes += size;
+    internal::HashUpdateBuffered<uint32_t, 64>(state, buffer, bufferSize, static_cast<const uint8_t*>(data), size, &internal::Sha256Compress);
+}
 
-            if (i < 16)
-            {
-                f = (b & c) | (~b & d);
-                g = i;
-            }
-            else if (i < 32)
-            {
-                f = (d & b) | (~d & c);
-                g = (5u * i + 1u) & 0x0Fu;
-            }
-            else if (i < 48)
-            {
-                f = b ^ c ^ d;
-                g = (3u * i + 5u) & 0x0Fu;
-            }
-            else
-            {
-                f = c ^ (b | ~d);
-                g = (7u * i) & 0x0Fu;
-            }
+void GB_Sha256Hasher::Update(const string& data)
+{
+    Update(data.data(), data.size());
+}
 
-            uint32_t temp = d;
-            f = f + a + internal::K[i] + m[g];
-            d = c;
-            c = b;
-            b = b + internal::RotL32(f, internal::S[i]);
-            a = temp;
-        }
+bool GB_Sha256Hasher::UpdateFromFile(const string& filePathUtf8)
+{
+    return internal::HashUpdateFromFile(*this, filePathUtf8);
+}
 
-        a0 += a;
-        b0 += b;
-        c0 += c;
-        d0 += d;
-    }
+bool GB_Sha256Hasher::UpdateFromStream(istream& stream)
+{
+    return internal::HashUpdateFromStream(*this, stream);
+}
 
-    // 5) 输出：A||B||C||D 的小端字节序，再转十六进制小写
-    uint8_t digest[16];
-    internal::StoreLE32(a0, &digest[0]);
-    internal::StoreLE32(b0, &digest[4]);
-    internal::StoreLE32(c0, &digest[8]);
-    internal::StoreLE32(d0, &digest[12]);
+void GB_Sha256Hasher::Final(unsigned char digest[32])
+{
+    // 填充后追加 64 位“比特长度”的大端
+    const uint64_t bitLen = totalBytes * 8ull;
+    const size_t lengthOffset = internal::HashPadBuffered<uint32_t, 64>(state, buffer, bufferSize, 8, &internal::Sha256Compress);
+    internal::StoreBE64(bitLen, buffer + lengthOffset);
+    internal::Sha256Compress(state, buffer, 1);
 
-    static const char* hexDigits = "0123456789abcdef";
-    string hex(32, '\0');
-    for (int i = 0; i < 16; ++i)
+    for (int i = 0; i < 8; ++i)
     {
-        hex[2 * i + 0] = hexDigits[digest[i] >> 4];
-        hex[2 * i + 1] = hexDigits[digest[i] & 0x0F];
+        internal::StoreBE32(state[i], digest + i * 4);
     }
-    return hex;
+    Init();
 }
 
-string GB_GetSha256(const string& input)
+string GB_Sha256Hasher::FinalHex()
+{
+    uint8_t digest[32];
+    Final(digest);
+    return internal::BytesToLowerHex(digest, sizeof(digest));
+}
+
+string GB_GetSha512(const string& input)
+{
+    GB_Sha512Hasher hasher;
+    hasher.Update(input.data(), input.size());
+    return hasher.FinalHex();
+}
+
+GB_Sha512Hasher::GB_Sha512Hasher()
+{
+    Init();
+}
+
+void GB_Sha512Hasher::Init()
 {
-    // 1) 填充：追加 0x80，再补 0x00 直至 (len % 64 == 56)，随后追加 64 位“比特长度”的大端
-    vector<uint8_t> buf;
-    buf.reserve(input.size() + 64);
-    buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(input.data()), reinterpret_cast<const uint8_t*>(input.data()) + input.size());
-    buf.push_back(0x80u);
-    while ((buf.size() % 64u) != 56u)
+    // 初始向量（FIPS 180-4）
+    state[0] = 0x6a09e667f3bcc908ULL; state[1] = 0xbb67ae8584caa73bULL;
+    state[2] = 0x3c6ef372fe94f82bULL; state[3] = 0xa54ff53a5f1d36f1ULL;
+    state[4] = 0x510e527fade682d1ULL; state[5] = 0x9b05688c2b3e6c1fULL;
+    state[6] = 0x1f83d9abfb41bd6bULL; state[7] = 0x5be0cd19137e2179ULL;
+    totalBytes = 0;
+    bufferSize = 0;
+}
+
+void GB_Sha512Hasher::Update(const void* data, size_t size)
+{
+    totalBytes += size;
+    internal::HashUpdateBuffered<uint64_t, 128>(state, buffer, bufferSize, static_cast<const uint8_t*>(data), size, &internal::Sha512Compress);
+}
+
+void GB_Sha512Hasher::Update(const string& data)
+{
+    Update(data.data(), data.size());
+}
+
+bool GB_Sha512Hasher::UpdateFromFile(const string& filePathUtf8)
+{
+    return internal::HashUpdateFromFile(*this, filePathUtf8);
+}
+
+bool GB_Sha512Hasher::UpdateFromStream(istream& stream)
+{
+    return internal::HashUpdateFromStream(*this, stream);
+}
+
+void GB_Sha512Hasher::Final(unsigned char digest[64])
+{
+    // 填充后追加 128 位“比特长度”的大端：high(64) || low(64)，输入长度 < 2^61 字节时高位为 0
+    const uint64_t bitLenLow = totalBytes << 3;
+    const uint64_t bitLenHigh = totalBytes >> 61;
+    const size_t lengthOffset = internal::HashPadBuffered<uint64_t, 128>(state, buffer, bufferSize, 16, &internal::Sha512Compress);
+    internal::StoreBE64(bitLenHigh, buffer + lengthOffset);
+    internal::StoreBE64(bitLenLow, buffer + lengthOffset + 8);
+    internal::Sha512Compress(state, buffer, 1);
+
+    for (int i = 0; i < 8; ++i)
     {
-        buf.push_back(0x00u);
+        internal::StoreBE64(state[i], digest + i * 8);
     }
-    const uint64_t bitLen = static_cast<uint64_t>(input.size()) * 8ull;
-    uint8_t len64[8];
-    internal::StoreBE64(bitLen, len64);
-    buf.insert(buf.end(), len64, len64 + 8);
+    Init();
+}
 
-    // 2) 初始向量（FIPS 180-4）
-    uint32_t h0 = 0x6a09e667u, h1 = 0xbb67ae85u, h2 = 0x3c6ef372u, h3 = 0xa54ff53au;
-    uint32_t h4 = 0x510e527fu, h5 = 0x9b05688cu, h6 = 0x1f83d9abu, h7 = 0x5be0cd19u;
+string GB_Sha512Hasher::FinalHex()
+{
+    uint8_t digest[64];
+    Final(digest);
+    return internal::BytesToLowerHex(digest, sizeof(digest));
+}
 
-    // 3) 逐块压缩
-    uint32_t w[64];
-    for (size_t off = 0; off < buf.size(); off += 64)
+namespace internal
+{
+    template<typename Hasher>
+    static string HashFileToHex(const string& filePathUtf8)
     {
-        for (int t = 0; t < 16; ++t)
-        {
-            w[t] = internal::LoadBE32(&buf[off + t * 4]);
-        }
-        for (int t = 16; t < 64; ++t)
+        Hasher hasher;
+        if (!hasher.UpdateFromFile(filePathUtf8))
         {
-            w[t] = internal::SmallSigma1_32(w[t - 2]) + w[t - 7] + internal::SmallSigma0_32(w[t - 15]) + w[t - 16];
+            return string();
         }
+        return hasher.FinalHex();
+    }
+}
 
-        uint32_t a = h0, b = h1, c = h2, d = h3, e = h4, f = h5, g = h6, h = h7;
+string GB_GetFileMd5(const string& filePathUtf8)
+{
+    return internal::HashFileToHex<GB_Md5Hasher>(filePathUtf8);
+}
 
-        for (int t = 0; t < 64; ++t)
-        {
-            uint32_t t1 = h + internal::BigSigma1_32(e) + internal::Ch32(e, f, g) + internal::K256[t] + w[t];
-            uint32_t t2 = internal::BigSigma0_32(a) + internal::Maj32(a, b, c);
-            h = g;
-            g = f;
-            f = e;
-            e = d + t1;
-            d = c;
-            c = b;
-            b = a;
-            a = t1 + t2;
-        }
+string GB_GetFileSha256(const string& filePathUtf8)
+{
+    return internal::HashFileToHex<GB_Sha256Hasher>(filePathUtf8);
+}
 
-        h0 += a; h1 += b; h2 += c; h3 += d; h4 += e; h5 += f; h6 += g; h7 += h;
-    }
+string GB_GetFileSha512(const string& filePathUtf8)
+{
+    return internal::HashFileToHex<GB_Sha512Hasher>(filePathUtf8);
+}
 
-    // 4) 输出（大端序）-> 小写十六进制
-    uint8_t digest[32];
-    internal::StoreBE32(h0, &digest[0]);
-    internal::StoreBE32(h1, &digest[4]);
-    internal::StoreBE32(h2, &digest[8]);
-    internal::StoreBE32(h3, &digest[12]);
-    internal::StoreBE32(h4, &digest[16]);
-    internal::StoreBE32(h5, &digest[20]);
-    internal::StoreBE32(h6, &digest[24]);
-    internal::StoreBE32(h7, &digest[28]);
-
-    static const char* hexDigits = "0123456789abcdef";
-    string hex(64, '\0');
-    for (int i = 0; i < 32; ++i)
-    {
-        hex[2 * i + 0] = hexDigits[digest[i] >> 4];
-        hex[2 * i + 1] = hexDigits[digest[i] & 0x0F];
-    }
-    return hex;
+void GB_SetCryptoAccelerationEnabled(bool enabled)
+{
+    internal::cryptoAccelerationEnabled.store(enabled, memory_order_relaxed);
 }
 
-string GB_GetSha512(const string& input)
+string GB_GetCryptoAccelerationInfo()
+{
+    const internal::CryptoKernels& kernels = internal::GetCryptoKernels();
+    return string("SHA-256: ") + kernels.sha256Name + ", AES: " + kernels.aesName + ", batch: " + kernels.lanesName;
+}
+
+size_t GB_GetHashDigestSize(GB_HashAlgorithm algorithm)
 {
-    // 1) 填充：追加 0x80，再补 0x00 直至 (len % 128 == 112)，随后追加 128 位“比特长度”的大端
-    vector<uint8_t> buf;
-    buf.reserve(input.size() + 128);
-    buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(input.data()),
-        reinterpret_cast<const uint8_t*>(input.data()) + input.size());
-    buf.push_back(0x80u);
-    while ((buf.size() % 128u) != 112u)
+    switch (algorithm)
     {
-        buf.push_back(0x00u);
+    case GB_HashAlgorithm::Md5:
+        return 16;
+    case GB_HashAlgorithm::Sha256:
+        return 32;
     }
-    // 128-bit length = high(64) || low(64). 对于一般应用，输入长度 < 2^61 字节，故：
-    const uint64_t bytes = static_cast<uint64_t>(input.size());
-    const uint64_t bitLenLow = bytes << 3;         // 低 64 位
-    const uint64_t bitLenHigh = bytes >> 61;        // 左移3越界的高位（通常为0）
-    uint8_t len128[16];
-    internal::StoreBE64(bitLenHigh, &len128[0]);
-    internal::StoreBE64(bitLenLow, &len128[8]);
-    buf.insert(buf.end(), len128, len128 + 16);
-
-    // 2) 初始向量（FIPS 180-4）
-    uint64_t h0 = 0x6a09e667f3bcc908ULL, h1 = 0xbb67ae8584caa73bULL;
-    uint64_t h2 = 0x3c6ef372fe94f82bULL, h3 = 0xa54ff53a5f1d36f1ULL;
-    uint64_t h4 = 0x510e527fade682d1ULL, h5 = 0x9b05688c2b3e6c1fULL;
-    uint64_t h6 = 0x1f83d9abfb41bd6bULL, h7 = 0x5be0cd19137e2179ULL;
+    return 0;
+}
 
-    // 3) 逐块压缩
-    uint64_t w[80];
-    for (size_t off = 0; off < buf.size(); off += 128)
+bool GB_HashMany(GB_HashAlgorithm algorithm, const void* const* messages, const size_t* sizes, size_t count, unsigned char* digests)
+{
+    if (count == 0)
     {
-        for (int t = 0; t < 16; ++t)
-        {
-            w[t] = internal::LoadBE64(&buf[off + t * 8]);
-        }
-        for (int t = 16; t < 80; ++t)
+        return true;
+    }
+    if (messages == nullptr || sizes == nullptr || digests == nullptr)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (messages[i] == nullptr && sizes[i] != 0)
         {
-            w[t] = internal::SmallSigma1_64(w[t - 2]) + w[t - 7] + internal::SmallSigma0_64(w[t - 15]) + w[t - 16];
+            return false;
         }
+    }
 
-        uint64_t a = h0, b = h1, c = h2, d = h3, e = h4, f = h5, g = h6, h = h7;
+    const internal::CryptoKernels& kernels = internal::GetCryptoKernels();
+    internal::HashManySpec spec;
+    switch (algorithm)
+    {
+    case GB_HashAlgorithm::Md5:
+        spec = { kernels.md5Lanes, kernels.lanes, &internal::Md5Compress, internal::kMd5Iv, 4, false };
+        break;
+    case GB_HashAlgorithm::Sha256:
+        spec = { kernels.sha256Lanes, kernels.lanes, kernels.sha256Compress, internal::kSha256Iv, 8, true };
+        break;
+    default:
+        return false;
+    }
 
-        for (int t = 0; t < 80; ++t)
-        {
-            uint64_t t1 = h + internal::BigSigma1_64(e) + internal::Ch64(e, f, g) + internal::K512[t] + w[t];
-            uint64_t t2 = internal::BigSigma0_64(a) + internal::Maj64(a, b, c);
-            h = g;
-            g = f;
-            f = e;
-            e = d + t1;
-            d = c;
-            c = b;
-            b = a;
-            a = t1 + t2;
-        }
+    internal::HashMany(spec, reinterpret_cast<const uint8_t* const*>(messages), sizes, count, digests);
+    return true;
+}
 
-        h0 += a; h1 += b; h2 += c; h3 += d; h4 += e; h5 += f; h6 += g; h7 += h;
+bool GB_HashMany(GB_HashAlgorithm algorithm, const string* messages, size_t count, unsigned char* digests)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    if (messages == nullptr)
+    {
+        return false;
     }
 
-    // 4) 输出（大端序）-> 小写十六进制
-    uint8_t digest[64];
-    internal::StoreBE64(h0, &digest[0]);
-    internal::StoreBE64(h1, &digest[8]);
-    internal::StoreBE64(h2, &digest[16]);
-    internal::StoreBE64(h3, &digest[24]);
-    internal::StoreBE64(h4, &digest[32]);
-    internal::StoreBE64(h5, &digest[40]);
-    internal::StoreBE64(h6, &digest[48]);
-    internal::StoreBE64(h7, &digest[56]);
-
-    static const char* hexDigits = "0123456789abcdef";
-    string hex(128, '\0');
-    for (int i = 0; i < 64; ++i)
-    {
-        hex[2 * i + 0] = hexDigits[digest[i] >> 4];
-        hex[2 * i + 1] = hexDigits[digest[i] & 0x0F];
-    }
-    return hex;
+    vector<const void*> pointers(count);
+    vector<size_t> sizes(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        pointers[i] = messages[i].data();
+        sizes[i] = messages[i].size();
+    }
+    return GB_HashMany(algorithm, pointers.data(), sizes.data(), count, digests);
 }
 
 string GB_Aes256Encrypt(const string& plainBytes, const string& keyMaterial, const string& ivMaterial, bool urlSafe, bool noPadding, bool flexibleKeyIv)
@@ -2150,25 +3429,11 @@ string GB_Aes256Encrypt(const string& plainBytes, const string& keyMaterial, con
     // 4) CBC 加密（IV 前缀）
     string out;
     out.resize(iv16.size() + buf.size());
-
-    // 前 16 字节写入 IV
-    for (int i = 0; i < 16; i++) { out[i] = iv16[i]; }
+    memcpy(&out[0], iv16.data(), 16);
 
     uint8_t prev[16];
-    for (int i = 0; i < 16; i++) { prev[i] = (uint8_t)iv16[i]; }
-
-    for (size_t off = 0; off < buf.size(); off += 16)
-    {
-        uint8_t block[16];
-        for (int i = 0; i < 16; i++) { block[i] = (uint8_t)buf[off + i] ^ prev[i]; }
-        uint8_t enc[16];
-        internal::EncryptBlock(block, enc, rk);
-        for (int i = 0; i < 16; i++)
-        {
-            out[16 + off + i] = (char)enc[i];
-            prev[i] = enc[i];
-        }
-    }
+    memcpy(prev, iv16.data(), 16);
+    internal::GetCryptoKernels().aesCbcEncrypt(rk, prev, reinterpret_cast<const uint8_t*>(buf.data()), reinterpret_cast<uint8_t*>(&out[16]), buf.size() / 16);
 
     // 5) Base64 输出
     return GB_Base64Encode(out, urlSafe, noPadding);
@@ -2182,9 +3447,9 @@ string GB_Aes256Decrypt(const string& base64CipherWithIv, const string& keyMater
         return {};
     }
 
-    // 1) 取回前缀 IV
-    string iv16(all.data(), all.data() + 16);
-    const string cipher(all.data() + 16, all.data() + all.size());
+    // 1) 前 16 字节为 IV，其后为密文（直接在 all 上读取，不另行拷贝）
+    const uint8_t* cipher = reinterpret_cast<const uint8_t*>(all.data()) + 16;
+    const size_t cipherSize = all.size() - 16;
 
     // 2) 规范化 key
     string key32;
@@ -2202,20 +3467,13 @@ string GB_Aes256Decrypt(const string& base64CipherWithIv, const string& keyMater
 
     // 4) CBC 解密
     string out;
-    out.resize(cipher.size());
+    out.resize(cipherSize);
 
     uint8_t prev[16];
-    for (int i = 0; i < 16; i++) { prev[i] = (uint8_t)iv16[i]; }
-
-    for (size_t off = 0; off < cipher.size(); off += 16)
+    memcpy(prev, all.data(), 16);
+    if (cipherSize > 0)
     {
-        uint8_t dec[16];
-        internal::DecryptBlock(reinterpret_cast<const uint8_t*>(cipher.data() + off), dec, rk);
-        for (int i = 0; i < 16; i++)
-        {
-            out[off + i] = (char)(dec[i] ^ prev[i]);
-        }
-        for (int i = 0; i < 16; i++) { prev[i] = (uint8_t)cipher[off + i]; }
+        internal::GetCryptoKernels().aesCbcDecrypt(rk, prev, cipher, reinterpret_cast<uint8_t*>(&out[0]), cipherSize / 16);
     }
 
     // 5) 去 PKCS#7
@@ -2,6 +2,9 @@
 #define GLOBALBASE_CRYPTO_H_H
 
 #include <string>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
 #include "GlobalBasePort.h"
 
 /**
@@ -48,13 +51,144 @@ GLOBALBASE_PORT std::string GB_Base64Encode(const std::string& bytes, bool urlSa
  */
 GLOBALBASE_PORT std::string GB_Base64Decode(const std::string& base64Info, bool strictMode = false, bool urlSafe = false, bool noPadding = false);
 
-// 计算字符串的 MD5 哈希值
+// 计算字符串的 MD5 哈希值（返回小写十六进制）
 GLOBALBASE_PORT std::string GB_GetMd5(const std::string& input);
 
 // SHA-256 / SHA-512（一次性输入，返回小写十六进制）
 GLOBALBASE_PORT std::string GB_GetSha256(const std::string& input);
 GLOBALBASE_PORT std::string GB_GetSha512(const std::string& input);
 
+/**
+ * @brief 增量哈希：可分多次 Update，适合边读文件边计算，内存占用固定（不拷贝输入）。
+ *
+ * 用法：Init()（构造时已调用）-> 任意次 Update() -> Final()（原始摘要）或 FinalHex()（小写十六进制）。
+ * Final 之后对象回到初始状态，可直接复用。对象非线程安全。
+ *
+ * UpdateFromFile / UpdateFromStream 以 1 MiB 的块边读边算；读取失败（或文件在读取期间长度变化）时返回 false，
+ * 此时已读入的部分仍计入状态，应调用 Init() 重新开始。
+ */
+class GLOBALBASE_PORT GB_Md5Hasher
+{
+public:
+    static const size_t digestSize = 16;
+    static const size_t blockSize = 64;
+
+    GB_Md5Hasher();
+
+    void Init();
+    void Update(const void* data, size_t size);
+    void Update(const std::string& data);
+    bool UpdateFromFile(const std::string& filePathUtf8);
+    bool UpdateFromStream(std::istream& stream);
+
+    void Final(unsigned char digest[16]);
+    std::string FinalHex();
+
+private:
+    uint32_t state[4];
+    uint64_t totalBytes;
+    unsigned char buffer[64];
+    size_t bufferSize;
+};
+
+class GLOBALBASE_PORT GB_Sha256Hasher
+{
+public:
+    static const size_t digestSize = 32;
+    static const size_t blockSize = 64;
+
+    GB_Sha256Hasher();
+
+    void Init();
+    void Update(const void* data, size_t size);
+    void Update(const std::string& data);
+    bool UpdateFromFile(const std::string& filePathUtf8);
+    bool UpdateFromStream(std::istream& stream);
+
+    void Final(unsigned char digest[32]);
+    std::string FinalHex();
+
+private:
+    uint32_t state[8];
+    uint64_t totalBytes;
+    unsigned char buffer[64];
+    size_t bufferSize;
+};
+
+class GLOBALBASE_PORT GB_Sha512Hasher
+{
+public:
+    static const size_t digestSize = 64;
+    static const size_t blockSize = 128;
+
+    GB_Sha512Hasher();
+
+    void Init();
+    void Update(const void* data, size_t size);
+    void Update(const std::string& data);
+    bool UpdateFromFile(const std::string& filePathUtf8);
+    bool UpdateFromStream(std::istream& stream);
+
+    void Final(unsigned char digest[64]);
+    std::string FinalHex();
+
+private:
+    uint64_t state[8];
+    uint64_t totalBytes;
+    unsigned char buffer[128];
+    size_t bufferSize;
+};
+
+// 计算文件内容的哈希（流式读取，不整体载入内存），返回小写十六进制；打开或读取失败返回空串
+GLOBALBASE_PORT std::string GB_GetFileMd5(const std::string& filePathUtf8);
+GLOBALBASE_PORT std::string GB_GetFileSha256(const std::string& filePathUtf8);
+GLOBALBASE_PORT std::string GB_GetFileSha512(const std::string& filePathUtf8);
+
+/**
+ * @brief 开启或关闭 SHA-256 / AES 的硬件加速（默认开启）。
+ *
+ * 开启时，首次使用前按 CPU 特性选择内核：x86 上为 SHA-NI 与 AES-NI，aarch64 上为 ARMv8 加密扩展；
+ * 每个内核启用前都会用已知答案向量并对照可移植实现进行校验，不一致时回退到可移植实现。
+ * 关闭后始终使用可移植实现，可用于对照测试与性能比较。输出结果与是否加速无关。
+ */
+GLOBALBASE_PORT void GB_SetCryptoAccelerationEnabled(bool enabled);
+
+/**
+ * @brief 返回当前实际使用的内核，例如 "SHA-256: SHA-NI, AES: AES-NI, batch: AVX2 x8"；未加速的项为 "portable"，
+ *        没有可用的多缓冲内核时 batch 为 "none"。
+ */
+GLOBALBASE_PORT std::string GB_GetCryptoAccelerationInfo();
+
+enum class GB_HashAlgorithm
+{
+    Md5,
+    Sha256
+};
+
+// 原始摘要的字节数：MD5 为 16，SHA-256 为 32
+GLOBALBASE_PORT size_t GB_GetHashDigestSize(GB_HashAlgorithm algorithm);
+
+/**
+ * @brief 批量计算多条互相独立的消息的哈希，适合大量短消息（缓存键、指纹等）。
+ *
+ * 多条消息同时在 SIMD 的各个通道中压缩（x86 上按 CPU 选择 AVX-512 16 路、AVX2 8 路或 SSE2 4 路），
+ * 某条消息算完后该通道立即换入下一条，因此消息长度可以各不相同。长消息（超过 4 KiB）与无可用内核时逐条计算；
+ * 支持 SHA-NI 的 CPU 上 SHA-256 只在 16 路时使用多缓冲，否则逐条走 SHA-NI。
+ * 整个过程不分配与消息长度相关的内存，也不做十六进制转换。结果与逐条调用 GB_GetMd5 / GB_GetSha256 一致。
+ *
+ * @param messages
+ *     count 个消息指针；长度为 0 的消息可以传 nullptr。
+ * @param sizes
+ *     count 个消息长度（字节）。
+ * @param digests
+ *     调用方提供的连续输出区，至少 count * GB_GetHashDigestSize(algorithm) 字节；第 i 条消息的原始摘要写在
+ *     digests + i * GB_GetHashDigestSize(algorithm)。
+ *
+ * @return 参数非法时返回 false，此时不写 digests。
+ */
+GLOBALBASE_PORT bool GB_HashMany(GB_HashAlgorithm algorithm, const void* const* messages, const size_t* sizes, size_t count, unsigned char* digests);
+GLOBALBASE_PORT bool GB_HashMany(GB_HashAlgorithm algorithm, const std::string* messages, size_t count, unsigned char* digests);
+
 /**
  * @brief 使用 AES-256-CBC（PKCS#7 填充）加密字节序列并输出 Base64(IV||Cipher)。
  *
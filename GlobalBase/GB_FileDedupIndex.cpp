@@ -0,0 +1,673 @@
+﻿#include "GB_FileDedupIndex.h"
+#include "GB_Crypto.h"
+#include "GB_FileSystem.h"
+#include "GB_IO.h"
+#include "GB_ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+
+using namespace std;
+
+namespace internal
+{
+    // 索引文件格式（小端）：
+    //   uint32 magic | uint32 version | varuint 条目数 |
+    //   每条：varuint device, varuint inode, varint mtimeNs, varuint size, varuint sampleBlockBytes, uint8 hasFullHash,
+    //         [16 字节预筛哈希（sampleBlockBytes > 0）], [32 字节完整哈希（hasFullHash）] |
+    //   8 字节校验（之前全部字节的 SHA-256 前 8 字节）
+    static const uint32_t dedupIndexMagic = 0x58444247u; // "GBDX"
+    static const uint32_t dedupIndexVersion = 1;
+    static const size_t dedupChecksumBytes = 8;
+    static const size_t dedupReadBufferBytes = 1024 * 1024;
+
+    static uint64_t HashPathForInode(const string& pathUtf8)
+    {
+        // FNV-1a；最高位置 1，避免与真实的文件索引冲突
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < pathUtf8.size(); i++)
+        {
+            hash ^= static_cast<unsigned char>(pathUtf8[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash | (1ull << 63);
+    }
+
+    struct DedupFile
+    {
+        string pathUtf8;
+        GB_FileStat stat;
+        size_t nodeIndex = 0;
+    };
+
+    // 同一 (设备, inode) 的文件（硬链接）只读一次
+    struct DedupNode
+    {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        int64_t modifiedTimeNs = 0;
+        uint64_t sizeBytes = 0;
+        vector<size_t> fileIndices;
+        bool hasSample = false;
+        bool hasFullHash = false;
+        bool failed = false;
+        bool updated = false;       // 本次新算出了哈希，需要写回索引
+        unsigned char sampleHash[16] = {};
+        unsigned char fullHash[32] = {};
+    };
+
+    struct DedupHashJob
+    {
+        DedupNode* node = nullptr;
+        const string* pathUtf8 = nullptr;
+        bool full = false;
+    };
+
+    static bool HashFileSample(const string& pathUtf8, uint64_t expectedSize, uint32_t blockBytes, vector<unsigned char>& buffer, unsigned char out[16], uint64_t& bytesRead)
+    {
+        GB_FileReader reader;
+        if (!reader.Open(pathUtf8, GB_FileReader::AccessHint::Random, 0) || reader.GetFileSize() != expectedSize)
+        {
+            return false;
+        }
+
+        buffer.resize((std::max)(buffer.size(), static_cast<size_t>(blockBytes)));
+        GB_Sha256Hasher hasher;
+        const uint64_t offsets[2] = { 0, expectedSize - blockBytes };
+        for (int i = 0; i < 2; i++)
+        {
+            if (reader.ReadAt(offsets[i], buffer.data(), blockBytes) != blockBytes)
+            {
+                return false;
+            }
+            hasher.Update(buffer.data(), blockBytes);
+            bytesRead += blockBytes;
+        }
+
+        unsigned char digest[32];
+        hasher.Final(digest);
+        memcpy(out, digest, 16);
+        return true;
+    }
+
+    static bool HashFileFull(const string& pathUtf8, uint64_t expectedSize, vector<unsigned char>& buffer, unsigned char out[32], uint64_t& bytesRead)
+    {
+        GB_FileReader reader;
+        if (!reader.Open(pathUtf8, GB_FileReader::AccessHint::Sequential, 0) || reader.GetFileSize() != expectedSize)
+        {
+            return false;
+        }
+
+        buffer.resize((std::max)(buffer.size(), dedupReadBufferBytes));
+        GB_Sha256Hasher hasher;
+        uint64_t total = 0;
+        for (;;)
+        {
+            const size_t n = reader.Read(buffer.data(), buffer.size());
+            if (n == 0)
+            {
+                break;
+            }
+            hasher.Update(buffer.data(), n);
+            total += n;
+        }
+        bytesRead += total;
+        if (total != expectedSize)
+        {
+            return false;
+        }
+
+        hasher.Final(out);
+        return true;
+    }
+
+    static void RunHashJobs(const vector<DedupHashJob>& jobs, uint32_t sampleBlockBytes, atomic<size_t>& nextJob, atomic<uint64_t>& totalBytesRead)
+    {
+        // 每个线程一块读缓冲，整批任务共用
+        vector<unsigned char> buffer;
+        uint64_t bytesRead = 0;
+        for (;;)
+        {
+            const size_t index = nextJob.fetch_add(1, memory_order_relaxed);
+            if (index >= jobs.size())
+            {
+                break;
+            }
+
+            const DedupHashJob& job = jobs[index];
+            DedupNode& node = *job.node;
+            const bool ok = job.full
+                ? HashFileFull(*job.pathUtf8, node.sizeBytes, buffer, node.fullHash, bytesRead)
+                : HashFileSample(*job.pathUtf8, node.sizeBytes, sampleBlockBytes, buffer, node.sampleHash, bytesRead);
+            if (!ok)
+            {
+                node.failed = true;
+                continue;
+            }
+            if (job.full)
+            {
+                node.hasFullHash = true;
+            }
+            else
+            {
+                node.hasSample = true;
+            }
+            node.updated = true;
+        }
+        totalBytesRead.fetch_add(bytesRead, memory_order_relaxed);
+    }
+
+    static void RunHashJobsParallel(const vector<DedupHashJob>& jobs, uint32_t sampleBlockBytes, GB_ThreadPool* threadPool, atomic<uint64_t>& totalBytesRead)
+    {
+        if (jobs.empty())
+        {
+            return;
+        }
+
+        atomic<size_t> nextJob(0);
+        vector<future<void>> helpers;
+        if (threadPool && jobs.size() > 1)
+        {
+            const size_t helperCount = (std::min)(threadPool->GetThreadCount(), jobs.size() - 1);
+            helpers.reserve(helperCount);
+            for (size_t i = 0; i < helperCount; i++)
+            {
+                pair<bool, future<void>> posted = threadPool->TryEnqueue(&RunHashJobs, cref(jobs), sampleBlockBytes, ref(nextJob), ref(totalBytesRead));
+                if (!posted.first)
+                {
+                    break;
+                }
+                helpers.push_back(std::move(posted.second));
+            }
+        }
+
+        RunHashJobs(jobs, sampleBlockBytes, nextJob, totalBytesRead);
+        for (size_t i = 0; i < helpers.size(); i++)
+        {
+            helpers[i].wait();
+        }
+    }
+
+    static string DigestToHex(const unsigned char digest[32])
+    {
+        static const char* hexDigits = "0123456789abcdef";
+        string hex(64, '\0');
+        for (int i = 0; i < 32; i++)
+        {
+            hex[2 * i + 0] = hexDigits[digest[i] >> 4];
+            hex[2 * i + 1] = hexDigits[digest[i] & 0x0F];
+        }
+        return hex;
+    }
+
+    static void ComputeIndexChecksum(const unsigned char* data, size_t size, unsigned char out[dedupChecksumBytes])
+    {
+        GB_Sha256Hasher hasher;
+        hasher.Update(data, size);
+        unsigned char digest[32];
+        hasher.Final(digest);
+        memcpy(out, digest, dedupChecksumBytes);
+    }
+}
+
+bool GB_FileDedupIndex::Key::operator==(const Key& other) const
+{
+    return device == other.device && inode == other.inode && modifiedTimeNs == other.modifiedTimeNs && sizeBytes == other.sizeBytes;
+}
+
+size_t GB_FileDedupIndex::KeyHash::operator()(const Key& key) const
+{
+    uint64_t hash = key.inode * 0x9E3779B97F4A7C15ull;
+    hash ^= key.device + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<uint64_t>(key.modifiedTimeNs) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= key.sizeBytes + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return static_cast<size_t>(hash);
+}
+
+GB_FileDedupIndex::GB_FileDedupIndex()
+{
+}
+
+bool GB_FileDedupIndex::Load(const string& indexPathUtf8)
+{
+    const GB_ByteBuffer content = GB_ReadFileToBinary(indexPathUtf8);
+
+    lock_guard<std::mutex> lock(entriesMutex);
+    entries.clear();
+    if (content.size() < internal::dedupChecksumBytes)
+    {
+        return false;
+    }
+
+    const size_t bodySize = content.size() - internal::dedupChecksumBytes;
+    unsigned char checksum[internal::dedupChecksumBytes];
+    internal::ComputeIndexChecksum(content.data(), bodySize, checksum);
+    if (memcmp(checksum, content.data() + bodySize, internal::dedupChecksumBytes) != 0)
+    {
+        return false;
+    }
+
+    GB_ByteReader reader(GB_ByteSpan(content.data(), bodySize));
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (!reader.ReadUInt32LE(magic) || magic != internal::dedupIndexMagic ||
+        !reader.ReadUInt32LE(version) || version != internal::dedupIndexVersion ||
+        !reader.ReadVarUInt64(count))
+    {
+        return false;
+    }
+
+    // 每条至少 6 字节，防止损坏的计数导致巨量 reserve
+    entries.reserve(static_cast<size_t>((std::min)(count, static_cast<uint64_t>(reader.GetRemaining() / 6))));
+    for (uint64_t i = 0; i < count; i++)
+    {
+        Key key;
+        Entry entry;
+        uint64_t sampleBlockBytes = 0;
+        uint8_t hasFullHash = 0;
+        if (!reader.ReadVarUInt64(key.device) || !reader.ReadVarUInt64(key.inode) ||
+            !reader.ReadVarInt64(key.modifiedTimeNs) || !reader.ReadVarUInt64(key.sizeBytes) ||
+            !reader.ReadVarUInt64(sampleBlockBytes) || !reader.ReadUInt8(hasFullHash))
+        {
+            entries.clear();
+            return false;
+        }
+        entry.sampleBlockBytes = static_cast<uint32_t>(sampleBlockBytes);
+        entry.hasFullHash = hasFullHash != 0;
+        if ((entry.sampleBlockBytes > 0 && !reader.ReadBytes(entry.sampleHash, sizeof(entry.sampleHash))) ||
+            (entry.hasFullHash && !reader.ReadBytes(entry.fullHash, sizeof(entry.fullHash))))
+        {
+            entries.clear();
+            return false;
+        }
+        entries[key] = entry;
+    }
+    return reader.GetRemaining() == 0;
+}
+
+bool GB_FileDedupIndex::Save(const string& indexPathUtf8) const
+{
+    GB_ByteBuffer content;
+    {
+        lock_guard<std::mutex> lock(entriesMutex);
+        GB_ByteWriter writer(content, 16 + entries.size() * 64);
+        writer.AppendUInt32LE(internal::dedupIndexMagic);
+        writer.AppendUInt32LE(internal::dedupIndexVersion);
+        writer.AppendVarUInt64(entries.size());
+        for (unordered_map<Key, Entry, KeyHash>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            const Key& key = it->first;
+            const Entry& entry = it->second;
+            writer.AppendVarUInt64(key.device);
+            writer.AppendVarUInt64(key.inode);
+            writer.AppendVarInt64(key.modifiedTimeNs);
+            writer.AppendVarUInt64(key.sizeBytes);
+            writer.AppendVarUInt64(entry.sampleBlockBytes);
+            writer.AppendUInt8(entry.hasFullHash ? 1 : 0);
+            if (entry.sampleBlockBytes > 0)
+            {
+                writer.AppendBytes(entry.sampleHash, sizeof(entry.sampleHash));
+            }
+            if (entry.hasFullHash)
+            {
+                writer.AppendBytes(entry.fullHash, sizeof(entry.fullHash));
+            }
+        }
+        writer.Finish();
+    }
+
+    unsigned char checksum[internal::dedupChecksumBytes];
+    internal::ComputeIndexChecksum(content.data(), content.size(), checksum);
+    content.insert(content.end(), checksum, checksum + internal::dedupChecksumBytes);
+
+    GB_AtomicWriteOptions options;
+    options.syncMode = GB_FileSyncMode::DataOnly;
+    return GB_AtomicFileWriter::WriteFile(indexPathUtf8, content.data(), content.size(), options);
+}
+
+void GB_FileDedupIndex::Clear()
+{
+    lock_guard<std::mutex> lock(entriesMutex);
+    entries.clear();
+}
+
+size_t GB_FileDedupIndex::GetEntryCount() const
+{
+    lock_guard<std::mutex> lock(entriesMutex);
+    return entries.size();
+}
+
+vector<GB_FileDedupGroup> GB_FileDedupIndex::Scan(const string& rootDirUtf8, const GB_FileDedupOptions& options, GB_FileDedupStats* stats)
+{
+    return Scan(vector<string>(1, rootDirUtf8), options, stats);
+}
+
+vector<GB_FileDedupGroup> GB_FileDedupIndex::Scan(const vector<string>& rootDirsUtf8, const GB_FileDedupOptions& options, GB_FileDedupStats* stats)
+{
+    lock_guard<std::mutex> scanLock(scanMutex);
+    GB_FileDedupStats localStats;
+    const uint32_t sampleBlockBytes = options.sampleBlockBytes;
+
+    // 1) 遍历，只收集常规文件及其元数据
+    vector<internal::DedupFile> files;
+    {
+        GB_DirectoryWalkOptions walkOptions;
+        walkOptions.includeGlobs = options.includeGlobs;
+        walkOptions.excludeGlobs = options.excludeGlobs;
+        walkOptions.followSymlinks = options.followSymlinks;
+        walkOptions.needStat = true;
+        walkOptions.threadPool = options.threadPool;
+
+        std::mutex filesMutex;
+        const uint64_t minFileSize = options.minFileSize;
+        for (size_t i = 0; i < rootDirsUtf8.size(); i++)
+        {
+            GB_DirectoryWalker(walkOptions).Walk(rootDirsUtf8[i], [&files, &filesMutex, minFileSize](const GB_DirectoryEntry& entry) {
+                if (!entry.hasStat || !entry.stat.IsRegularFile() || entry.stat.sizeBytes < minFileSize)
+                {
+                    return true;
+                }
+                internal::DedupFile file;
+                file.pathUtf8 = entry.pathUtf8;
+                file.stat = entry.stat;
+                lock_guard<std::mutex> lock(filesMutex);
+                files.push_back(std::move(file));
+                return true;
+            });
+        }
+
+        // 根目录互相重叠时同一路径会出现多次
+        sort(files.begin(), files.end(), [](const internal::DedupFile& a, const internal::DedupFile& b) {
+            return a.pathUtf8 < b.pathUtf8;
+        });
+        files.erase(unique(files.begin(), files.end(), [](const internal::DedupFile& a, const internal::DedupFile& b) {
+            return a.pathUtf8 == b.pathUtf8;
+        }), files.end());
+    }
+    localStats.filesScanned = files.size();
+
+    // 2) 按 (设备, inode) 合并硬链接
+    vector<internal::DedupNode> nodes;
+    {
+        unordered_map<Key, size_t, KeyHash> nodeByIdentity;
+        nodeByIdentity.reserve(files.size());
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            Key identity;
+            identity.device = files[i].stat.device;
+            identity.inode = files[i].stat.inode != 0 ? files[i].stat.inode : internal::HashPathForInode(files[i].pathUtf8);
+            pair<unordered_map<Key, size_t, KeyHash>::iterator, bool> inserted = nodeByIdentity.insert(make_pair(identity, nodes.size()));
+            if (inserted.second)
+            {
+                internal::DedupNode node;
+                node.device = identity.device;
+                node.inode = identity.inode;
+                node.modifiedTimeNs = files[i].stat.modifiedTimeNs;
+                node.sizeBytes = files[i].stat.sizeBytes;
+                nodes.push_back(std::move(node));
+            }
+            files[i].nodeIndex = inserted.first->second;
+            nodes[files[i].nodeIndex].fileIndices.push_back(i);
+        }
+    }
+
+    // 3) 按大小分组，只保留存在同大小其它文件的节点
+    vector<size_t> candidates(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        candidates[i] = i;
+    }
+    sort(candidates.begin(), candidates.end(), [&nodes](size_t a, size_t b) {
+        return nodes[a].sizeBytes < nodes[b].sizeBytes;
+    });
+    {
+        vector<size_t> kept;
+        for (size_t begin = 0; begin < candidates.size();)
+        {
+            size_t end = begin + 1;
+            while (end < candidates.size() && nodes[candidates[end]].sizeBytes == nodes[candidates[begin]].sizeBytes)
+            {
+                end++;
+            }
+            if (end - begin > 1)
+            {
+                kept.insert(kept.end(), candidates.begin() + begin, candidates.begin() + end);
+            }
+            begin = end;
+        }
+        candidates.swap(kept);
+    }
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        localStats.sizeCandidates += nodes[candidates[i]].fileIndices.size();
+    }
+
+    // 4) 取出缓存；所有本次见到的条目都标记为 seen
+    {
+        lock_guard<std::mutex> lock(entriesMutex);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            internal::DedupNode& node = nodes[i];
+            Key key;
+            key.device = node.device;
+            key.inode = node.inode;
+            key.modifiedTimeNs = node.modifiedTimeNs;
+            key.sizeBytes = node.sizeBytes;
+            unordered_map<Key, Entry, KeyHash>::iterator it = entries.find(key);
+            if (it == entries.end())
+            {
+                continue;
+            }
+            it->second.seen = true;
+            if (it->second.sampleBlockBytes == sampleBlockBytes && sampleBlockBytes > 0)
+            {
+                memcpy(node.sampleHash, it->second.sampleHash, sizeof(node.sampleHash));
+                node.hasSample = true;
+            }
+            if (it->second.hasFullHash)
+            {
+                memcpy(node.fullHash, it->second.fullHash, sizeof(node.fullHash));
+                node.hasFullHash = true;
+            }
+        }
+    }
+
+    const auto needsSample = [sampleBlockBytes](const internal::DedupNode& node) {
+        return sampleBlockBytes > 0 && node.sizeBytes > 2ull * sampleBlockBytes;
+    };
+    const auto firstPath = [&files](const internal::DedupNode& node) -> const string* {
+        return &files[node.fileIndices[0]].pathUtf8;
+    };
+    atomic<uint64_t> bytesRead(0);
+
+    // 5) 预筛：大文件读头尾块
+    {
+        vector<internal::DedupHashJob> jobs;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            internal::DedupNode& node = nodes[candidates[i]];
+            if (!needsSample(node))
+            {
+                continue;
+            }
+            if (node.hasSample)
+            {
+                localStats.cacheHits++;
+                continue;
+            }
+            internal::DedupHashJob job;
+            job.node = &node;
+            job.pathUtf8 = firstPath(node);
+            job.full = false;
+            jobs.push_back(job);
+        }
+        localStats.sampleHashed = jobs.size();
+        internal::RunHashJobsParallel(jobs, sampleBlockBytes, options.threadPool, bytesRead);
+    }
+
+    // 6) 同大小且预筛相同（小文件只看大小）的节点做完整哈希
+    {
+        vector<size_t> fullCandidates;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            if (!nodes[candidates[i]].failed)
+            {
+                fullCandidates.push_back(candidates[i]);
+            }
+        }
+        stable_sort(fullCandidates.begin(), fullCandidates.end(), [&nodes, &needsSample](size_t a, size_t b) {
+            const internal::DedupNode& na = nodes[a];
+            const internal::DedupNode& nb = nodes[b];
+            if (na.sizeBytes != nb.sizeBytes)
+            {
+                return na.sizeBytes < nb.sizeBytes;
+            }
+            return needsSample(na) && memcmp(na.sampleHash, nb.sampleHash, sizeof(na.sampleHash)) < 0;
+        });
+
+        vector<internal::DedupHashJob> jobs;
+        for (size_t begin = 0; begin < fullCandidates.size();)
+        {
+            const internal::DedupNode& first = nodes[fullCandidates[begin]];
+            size_t end = begin + 1;
+            while (end < fullCandidates.size())
+            {
+                const internal::DedupNode& node = nodes[fullCandidates[end]];
+                if (node.sizeBytes != first.sizeBytes || (needsSample(node) && memcmp(node.sampleHash, first.sampleHash, sizeof(node.sampleHash)) != 0))
+                {
+                    break;
+                }
+                end++;
+            }
+            if (end - begin > 1)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    internal::DedupNode& node = nodes[fullCandidates[i]];
+                    if (node.hasFullHash)
+                    {
+                        localStats.cacheHits++;
+                        continue;
+                    }
+                    internal::DedupHashJob job;
+                    job.node = &node;
+                    job.pathUtf8 = firstPath(node);
+                    job.full = true;
+                    jobs.push_back(job);
+                }
+            }
+            begin = end;
+        }
+        // 大文件先开始，减少并行时的尾部等待
+        sort(jobs.begin(), jobs.end(), [](const internal::DedupHashJob& a, const internal::DedupHashJob& b) {
+            return a.node->sizeBytes > b.node->sizeBytes;
+        });
+        localStats.fullHashed = jobs.size();
+        internal::RunHashJobsParallel(jobs, sampleBlockBytes, options.threadPool, bytesRead);
+    }
+    localStats.bytesRead = bytesRead.load();
+
+    // 7) 按 (大小, 完整哈希) 分组
+    vector<GB_FileDedupGroup> groups;
+    {
+        vector<size_t> hashed;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            const internal::DedupNode& node = nodes[candidates[i]];
+            if (node.failed)
+            {
+                localStats.unreadableFiles += node.fileIndices.size();
+            }
+            else if (node.hasFullHash)
+            {
+                hashed.push_back(candidates[i]);
+            }
+        }
+        sort(hashed.begin(), hashed.end(), [&nodes](size_t a, size_t b) {
+            const internal::DedupNode& na = nodes[a];
+            const internal::DedupNode& nb = nodes[b];
+            if (na.sizeBytes != nb.sizeBytes)
+            {
+                return na.sizeBytes > nb.sizeBytes;
+            }
+            return memcmp(na.fullHash, nb.fullHash, sizeof(na.fullHash)) < 0;
+        });
+
+        for (size_t begin = 0; begin < hashed.size();)
+        {
+            const internal::DedupNode& first = nodes[hashed[begin]];
+            size_t end = begin + 1;
+            while (end < hashed.size() && nodes[hashed[end]].sizeBytes == first.sizeBytes &&
+                memcmp(nodes[hashed[end]].fullHash, first.fullHash, sizeof(first.fullHash)) == 0)
+            {
+                end++;
+            }
+            if (end - begin > 1)
+            {
+                GB_FileDedupGroup group;
+                group.sizeBytes = first.sizeBytes;
+                group.sha256Hex = internal::DigestToHex(first.fullHash);
+                for (size_t i = begin; i < end; i++)
+                {
+                    const internal::DedupNode& node = nodes[hashed[i]];
+                    for (size_t j = 0; j < node.fileIndices.size(); j++)
+                    {
+                        group.pathsUtf8.push_back(files[node.fileIndices[j]].pathUtf8);
+                    }
+                }
+                sort(group.pathsUtf8.begin(), group.pathsUtf8.end());
+                groups.push_back(std::move(group));
+            }
+            begin = end;
+        }
+    }
+
+    // 8) 写回新算出的哈希，并按需清理本次未见到的条目
+    {
+        lock_guard<std::mutex> lock(entriesMutex);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            const internal::DedupNode& node = nodes[i];
+            if (!node.updated || node.failed)
+            {
+                continue;
+            }
+            Key key;
+            key.device = node.device;
+            key.inode = node.inode;
+            key.modifiedTimeNs = node.modifiedTimeNs;
+            key.sizeBytes = node.sizeBytes;
+            Entry& entry = entries[key];
+            entry.seen = true;
+            if (node.hasSample)
+            {
+                entry.sampleBlockBytes = sampleBlockBytes;
+                memcpy(entry.sampleHash, node.sampleHash, sizeof(entry.sampleHash));
+            }
+            if (node.hasFullHash)
+            {
+                entry.hasFullHash = true;
+                memcpy(entry.fullHash, node.fullHash, sizeof(entry.fullHash));
+            }
+        }
+
+        for (unordered_map<Key, Entry, KeyHash>::iterator it = entries.begin(); it != entries.end();)
+        {
+            if (options.pruneUnseen && !it->second.seen)
+            {
+                it = entries.erase(it);
+                continue;
+            }
+            it->second.seen = false;
+            ++it;
+        }
+    }
+
+    if (stats)
+    {
+        *stats = localStats;
+    }
+    return groups;
+}
@@ -0,0 +1,125 @@
+﻿#ifndef GLOBALBASE_FILE_DEDUP_INDEX_H_H
+#define GLOBALBASE_FILE_DEDUP_INDEX_H_H
+
+#include "GlobalBasePort.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GB_ThreadPool;
+
+/**
+ * @brief GB_FileDedupIndex::Scan 的选项。
+ *
+ * @details includeGlobs / excludeGlobs 的规则同 GB_DirectoryWalkOptions。
+ */
+struct GB_FileDedupOptions
+{
+    std::vector<std::string> includeGlobs;
+    std::vector<std::string> excludeGlobs;
+    bool followSymlinks = false;            // 是否进入指向目录的符号链接
+    uint64_t minFileSize = 1;               // 小于该大小的文件不参与查重（默认跳过空文件）
+    uint32_t sampleBlockBytes = 64 * 1024;  // 预筛时头、尾各读取的字节数
+    bool pruneUnseen = true;                // 扫描结束后从索引中删除本次没有见到的条目
+    GB_ThreadPool* threadPool = nullptr;    // 非空时目录遍历与哈希在该线程池上并行；不要在其 worker 线程中调用 Scan
+};
+
+/**
+ * @brief 一组内容完全相同的文件。
+ */
+struct GB_FileDedupGroup
+{
+    uint64_t sizeBytes = 0;
+    std::string sha256Hex;
+    std::vector<std::string> pathsUtf8;     // 按字典序排列；硬链接到同一文件的路径也会列出
+};
+
+/**
+ * @brief 一次 Scan 的统计信息。
+ */
+struct GB_FileDedupStats
+{
+    size_t filesScanned = 0;        // 参与查重的常规文件数
+    size_t sizeCandidates = 0;      // 存在同大小文件的文件数
+    size_t sampleHashed = 0;        // 实际读取头尾块的文件数
+    size_t fullHashed = 0;          // 实际完整读取的文件数
+    size_t cacheHits = 0;           // 直接使用索引中已有哈希的次数
+    size_t unreadableFiles = 0;     // 打开失败或读取期间大小变化的文件数
+    uint64_t bytesRead = 0;
+};
+
+/**
+ * @brief 基于内容哈希（SHA-256）的文件查重索引。
+ *
+ * @details
+ *  - 分三级筛选：先按大小分组；同大小的文件只读头尾各 sampleBlockBytes 做预筛；预筛仍相同的才完整读取并计算 SHA-256。
+ *    不大于 2 × sampleBlockBytes 的文件直接完整哈希。完整哈希在 threadPool 上并行进行。
+ *  - 每个文件以 (设备, inode, 修改时间, 大小) 为键缓存预筛与完整哈希；这四项都不变的文件再次扫描时不再读取。
+ *    Windows 上取不到文件索引时以路径的哈希代替 inode。
+ *  - Save / Load 把缓存持久化为紧凑的二进制索引（变长整数编码，带校验和），Save 通过 GB_AtomicFileWriter 原子替换。
+ *  - 同一对象上的各成员函数可以从多个线程调用，但 Scan 之间会互相等待。
+ */
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+class GLOBALBASE_PORT GB_FileDedupIndex
+{
+public:
+    GB_FileDedupIndex();
+
+    /**
+     * @brief 从文件加载索引，替换当前内容。
+     * @return 文件不存在、格式不对或校验失败时返回 false，此时索引被清空。
+     */
+    bool Load(const std::string& indexPathUtf8);
+
+    bool Save(const std::string& indexPathUtf8) const;
+
+    void Clear();
+    size_t GetEntryCount() const;
+
+    /**
+     * @brief 遍历 rootDirsUtf8 下的全部常规文件，返回内容相同（至少两个路径）的文件组，并更新索引。
+     *
+     * @return 按大小降序、同大小按哈希排序的文件组。
+     */
+    std::vector<GB_FileDedupGroup> Scan(const std::vector<std::string>& rootDirsUtf8, const GB_FileDedupOptions& options = GB_FileDedupOptions(), GB_FileDedupStats* stats = nullptr);
+    std::vector<GB_FileDedupGroup> Scan(const std::string& rootDirUtf8, const GB_FileDedupOptions& options = GB_FileDedupOptions(), GB_FileDedupStats* stats = nullptr);
+
+private:
+    struct Key
+    {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        int64_t modifiedTimeNs = 0;
+        uint64_t sizeBytes = 0;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        uint32_t sampleBlockBytes = 0;  // 0 表示没有预筛哈希
+        bool hasFullHash = false;
+        unsigned char sampleHash[16] = {};
+        unsigned char fullHash[32] = {};
+        bool seen = false;
+    };
+
+    mutable std::mutex entriesMutex;
+    std::mutex scanMutex;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+};
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -1,6 +1,13 @@
 ﻿#include "GB_FileSystem.h"
 #include "GB_Utf8String.h"
+#include "GB_ThreadPool.h"
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <limits>
+#include <mutex>
 #include <cstdio>
 #include <cstdlib>
 #include <cerrno>
@@ -16,6 +23,15 @@
 #   include <fcntl.h>
 #   include <sys/types.h>
 #   include <utime.h>
+#   if defined(__linux__)
+#       include <sys/ioctl.h>
+#       include <sys/sendfile.h>
+#       include <sys/syscall.h>
+#       include <sys/sysmacros.h>
+#       ifndef FICLONE
+#           define FICLONE _IOW(0x94, 9, int)
+#       endif
+#   endif
 #endif
 
 using namespace std;
@@ -339,82 +355,6 @@ namespace internal
 #endif
     }
 
-    // 递归列举文件（仅文件），结果用 forward slash，文件不带末尾 '/'
-    inline void ListFilesRecursive(const string& dirUtf8, bool recursive, vector<string>& out)
-    {
-#if defined(_WIN32)
-        // Windows: FindFirstFileExW + FindNextFileW  :contentReference[oaicite:3]{index=3}
-        string pattern = EnsureTrailingSlash(dirUtf8) + "*";
-        wstring wpat = Utf8ToWide(pattern);
-        if (wpat.empty())
-        {
-            return;
-        }
-        WIN32_FIND_DATAW fd;
-        HANDLE h = FindFirstFileExW(wpat.c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, nullptr, 0);
-        if (h == INVALID_HANDLE_VALUE)
-        {
-            return;
-        }
-        do
-        {
-            const wchar_t* name = fd.cFileName;
-            if (name[0] == L'.' && (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0')))
-            {
-                continue; // skip . and ..
-            }
-            const bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-            string item = EnsureTrailingSlash(dirUtf8) + WideToUtf8(name);
-            item = ToOutputNorm(item);
-            if (isDir)
-            {
-                if (recursive)
-                {
-                    ListFilesRecursive(EnsureTrailingSlash(item), true, out);
-                }
-            }
-            else
-            {
-                out.push_back(item);
-            }
-        } while (FindNextFileW(h, &fd));
-        FindClose(h);
-#else
-        string nativeDir = EnsureTrailingSlash(dirUtf8);
-        DIR* d = ::opendir(nativeDir.c_str()); // opendir/readdir 约定  :contentReference[oaicite:4]{index=4}
-        if (!d)
-        {
-            return;
-        }
-        while (dirent* ent = ::readdir(d))
-        {
-            const char* name = ent->d_name;
-            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
-            {
-                continue;
-            }
-            string item = nativeDir + name;
-            struct stat st;
-            if (stat(item.c_str(), &st) != 0)
-            {
-                continue;
-            }
-            if (S_ISDIR(st.st_mode))
-            {
-                if (recursive)
-                {
-                    ListFilesRecursive(EnsureTrailingSlash(item), true, out);
-                }
-            }
-            else if (S_ISREG(st.st_mode))
-            {
-                out.push_back(ToOutputNorm(item));
-            }
-        }
-        ::closedir(d);
-#endif
-    }
-
     // 递归删除目录内容（目录本身不删），仅内部使用
     inline bool DeleteDirContents(const string& dirUtf8)
     {
@@ -579,7 +519,6 @@ namespace internal
         }
         sizeOut = static_cast<uint64_t>(st.st_size);
         return true;
-    }
 #endif
     }
 
@@ -1164,530 +1103,1952 @@ bool GB_DeleteFile(const string& filePathUtf8)
     return internal::DeleteOneFile(filePathUtf8);
 }
 
-bool GB_CopyFile(const string& srcFilePathUtf8, const string& dstFilePathUtf8)
+#if !defined(_WIN32)
+namespace internal
 {
-#if defined(_WIN32)
-    // 使用 CopyFileW（会覆盖由第三参数决定；这里选择覆盖 false -> 允许覆盖）
-    wstring wsrc = internal::Utf8ToWide(srcFilePathUtf8);
-    wstring wdst = internal::Utf8ToWide(dstFilePathUtf8);
-    if (wsrc.empty() || wdst.empty())
+    // 用户态兜底：pread/pwrite 按 1MB 块复制 [offset, offset + length)
+    static bool CopyRangeBuffered(int inFd, int outFd, off_t offset, off_t length)
     {
-        return false;
-    }
-    // 官方：CopyFile/FindFirstFile 系列文档（与 GetFileAttributesW 同系列）
-    return ::CopyFileW(wsrc.c_str(), wdst.c_str(), FALSE) != 0;
-#else
-    // 纯 C++11 实现：ifstream/ofstream 流式复制（覆盖）。
-    string src = internal::ReplaceSlashes(srcFilePathUtf8, '/');
-    string dst = internal::ReplaceSlashes(dstFilePathUtf8, '/');
+        const size_t bufSize = 1 << 20; // 1 MB
+        vector<char> buf(static_cast<size_t>((std::min)(static_cast<off_t>(bufSize), (std::max)(length, static_cast<off_t>(1)))));
+        while (length > 0)
+        {
+            const size_t want = static_cast<size_t>((std::min)(static_cast<off_t>(buf.size()), length));
+            const ssize_t n = ::pread(inFd, buf.data(), want, offset);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (n == 0)
+            {
+                return true; // 源文件被截短
+            }
 
-    FILE* in = ::fopen(src.c_str(), "rb");
-    if (!in)
-    {
-        return false;
+            size_t written = 0;
+            while (written < static_cast<size_t>(n))
+            {
+                const ssize_t w = ::pwrite(outFd, buf.data() + written, static_cast<size_t>(n) - written, offset + static_cast<off_t>(written));
+                if (w < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                written += static_cast<size_t>(w);
+            }
+            offset += n;
+            length -= n;
+        }
+        return true;
     }
-    FILE* out = ::fopen(dst.c_str(), "wb");
-    if (!out)
+
+#if defined(__linux__)
+    // 这些 errno 表示“此路不通，换下一种方式”，而不是真正的 I/O 错误
+    static inline bool IsCopyUnsupportedErrno(int err)
     {
-        ::fclose(in);
-        return false;
+        return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP || err == ENOTSUP || err == EPERM || err == EBADF;
     }
-    const size_t bufSize = 1 << 20; // 1 MB
-    vector<char> buf(bufSize);
-    bool ok = true;
-    while (ok)
+
+    // 复制 [offset, offset + length)：copy_file_range（同一文件系统内由内核/存储完成，NFS/CIFS 可服务端复制）
+    // -> sendfile（页缓存内搬运）-> 用户态缓冲。useCopyFileRange / useSendfile 记录不支持的方式，避免逐块重试
+    static bool CopyRangeKernel(int inFd, int outFd, off_t offset, off_t length, bool& useCopyFileRange, bool& useSendfile)
     {
-        size_t n = ::fread(buf.data(), 1, buf.size(), in);
-        if (n > 0)
+        const size_t maxChunk = 1u << 30;
+#if defined(__NR_copy_file_range)
+        while (useCopyFileRange && length > 0)
         {
-            if (::fwrite(buf.data(), 1, n, out) != n)
+            loff_t inOff = offset;
+            loff_t outOff = offset;
+            const size_t want = static_cast<size_t>((std::min)(static_cast<off_t>(maxChunk), length));
+            const ssize_t n = static_cast<ssize_t>(::syscall(__NR_copy_file_range, inFd, &inOff, outFd, &outOff, want, 0u));
+            if (n > 0)
             {
-                ok = false;
-                break;
+                offset += n;
+                length -= n;
+                continue;
+            }
+            if (n == 0)
+            {
+                return true;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (!IsCopyUnsupportedErrno(errno))
+            {
+                return false;
             }
+            useCopyFileRange = false;
         }
-        if (n < buf.size())
+#else
+        useCopyFileRange = false;
+#endif
+
+        if (useSendfile && length > 0)
         {
-            if (::ferror(in))
+            if (::lseek(outFd, offset, SEEK_SET) < 0)
             {
-                ok = false;
+                return false;
+            }
+            while (length > 0)
+            {
+                off_t inOff = offset;
+                const size_t want = static_cast<size_t>((std::min)(static_cast<off_t>(maxChunk), length));
+                const ssize_t n = ::sendfile(outFd, inFd, &inOff, want);
+                if (n > 0)
+                {
+                    offset += n;
+                    length -= n;
+                    continue;
+                }
+                if (n == 0)
+                {
+                    return true;
+                }
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (!IsCopyUnsupportedErrno(errno))
+                {
+                    return false;
+                }
+                useSendfile = false;
+                break;
             }
-            break; // EOF
         }
-    }
-    ::fclose(in);
-    if (::fclose(out) != 0)
-    {
-        ok = false;
-    }
-    return ok;
-#endif
-}
 
-vector<string> GB_GetFilesList(const string& dirPathUtf8, bool recursive)
-{
-    vector<string> out;
-    if (!GB_IsDirectoryExists(dirPathUtf8))
-    {
-        return out;
+        return length <= 0 || CopyRangeBuffered(inFd, outFd, offset, length);
     }
-    internal::ListFilesRecursive(internal::EnsureTrailingSlash(dirPathUtf8), recursive, out);
-    return out;
-}
+#endif
 
-string GB_GetFileName(const string& rawFilePathUtf8, bool withExt)
-{
-    string filePathUtf8 = GB_Utf8Replace(rawFilePathUtf8, GB_STR("\\\\"), GB_STR("\\"));
-    filePathUtf8 = GB_Utf8Replace(filePathUtf8, GB_STR("\\"), GB_STR("/"));
-    const int64_t pos1 = GB_Utf8FindLast(filePathUtf8, GB_STR("/"));
-    if (pos1 < 0)
-    {
-        return filePathUtf8;
-	}
-    const string fileNameWithExt = GB_Utf8Substr(filePathUtf8, pos1 + 1);
-    if (withExt)
+    static bool CopyFileContents(int inFd, int outFd, const struct stat& srcStat)
     {
-        return fileNameWithExt;
-	}
+        const off_t fileSize = srcStat.st_size;
+#if defined(__linux__)
+        // 1) reflink：btrfs/XFS/bcachefs 等支持时只复制元数据，与文件大小无关
+        if (::ioctl(outFd, FICLONE, inFd) == 0)
+        {
+            return true;
+        }
 
-    const int64_t pos2 = GB_Utf8FindLast(fileNameWithExt, GB_STR("."));
-    if (pos2 < 0)
-    {
-        return fileNameWithExt;
+        bool useCopyFileRange = true;
+        bool useSendfile = true;
+        // 2) 已分配块明显少于逻辑大小时视为稀疏文件：按 SEEK_DATA/SEEK_HOLE 只复制数据区，洞由 ftruncate 补齐
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        if (static_cast<off_t>(srcStat.st_blocks) * 512 < fileSize)
+        {
+            off_t dataStart = ::lseek(inFd, 0, SEEK_DATA);
+            bool sparseOk = true;
+            while (dataStart >= 0 && dataStart < fileSize)
+            {
+                off_t dataEnd = ::lseek(inFd, dataStart, SEEK_HOLE);
+                if (dataEnd < 0 || dataEnd > fileSize)
+                {
+                    dataEnd = fileSize;
+                }
+                if (!CopyRangeKernel(inFd, outFd, dataStart, dataEnd - dataStart, useCopyFileRange, useSendfile))
+                {
+                    return false;
+                }
+                if (dataEnd >= fileSize)
+                {
+                    break;
+                }
+                dataStart = ::lseek(inFd, dataEnd, SEEK_DATA);
+            }
+            if (dataStart < 0 && errno != ENXIO)
+            {
+                sparseOk = false; // 文件系统不支持 SEEK_DATA，下面整体复制
+            }
+            if (sparseOk)
+            {
+                return ::ftruncate(outFd, fileSize) == 0;
+            }
+        }
+#endif
+        // 3) 常规文件整体交给内核；st_size 为 0 的伪文件（/proc 等）走缓冲读到 EOF
+        if (fileSize > 0 && CopyRangeKernel(inFd, outFd, 0, fileSize, useCopyFileRange, useSendfile))
+        {
+            return true;
+        }
+        if (fileSize > 0)
+        {
+            return false;
+        }
+#endif
+        return CopyRangeBuffered(inFd, outFd, 0, fileSize > 0 ? fileSize : numeric_limits<off_t>::max());
     }
-	return GB_Utf8Substr(fileNameWithExt, 0, pos2);
 }
+#endif
 
-string GB_GetFileExt(const string& filePathUtf8)
+bool GB_CopyFile(const string& srcFilePathUtf8, const string& dstFilePathUtf8)
 {
-    const int64_t pos = GB_Utf8FindLast(filePathUtf8, GB_STR("."));
-    if (pos < 0)
+#if defined(_WIN32)
+    // 使用 CopyFileW（会覆盖由第三参数决定；这里选择覆盖 false -> 允许覆盖）
+    wstring wsrc = internal::Utf8ToWide(srcFilePathUtf8);
+    wstring wdst = internal::Utf8ToWide(dstFilePathUtf8);
+    if (wsrc.empty() || wdst.empty())
     {
-        return "";
+        return false;
     }
+    // 官方：CopyFile/FindFirstFile 系列文档（与 GetFileAttributesW 同系列）
+    return ::CopyFileW(wsrc.c_str(), wdst.c_str(), FALSE) != 0;
+#else
+    string src = internal::ReplaceSlashes(srcFilePathUtf8, '/');
+    string dst = internal::ReplaceSlashes(dstFilePathUtf8, '/');
 
-	return GB_Utf8Substr(filePathUtf8, pos);
-}
-
-string GB_GetDirectoryPath(const string& rawFilePathUtf8)
-{
-    string filePathUtf8 = GB_Utf8Replace(rawFilePathUtf8, GB_STR("\\\\"), GB_STR("\\"));
-    filePathUtf8 = GB_Utf8Replace(filePathUtf8, GB_STR("\\"), GB_STR("/"));
-    const int64_t pos = GB_Utf8FindLast(filePathUtf8, GB_STR("/"));
-    if (pos < 0)
+    const int inFd = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd < 0)
     {
-        return "";
+        return false;
     }
-
-	return GB_Utf8Substr(filePathUtf8, 0, pos + 1);
-}
-
-size_t GB_GetFileSizeByte(const string& filePathUtf8)
-{
-    uint64_t size64 = 0;
-    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    struct stat srcStat;
+    if (::fstat(inFd, &srcStat) != 0 || S_ISDIR(srcStat.st_mode))
     {
-        return 0;
+        ::close(inFd);
+        return false;
     }
-    constexpr static uint64_t maxSizeT = static_cast<uint64_t>(numeric_limits<size_t>::max());
-    if (size64 > maxSizeT)
+
+    // 源与目标是同一个文件时 O_TRUNC 会清空源数据
+    struct stat dstStat;
+    if (::stat(dst.c_str(), &dstStat) == 0 && dstStat.st_dev == srcStat.st_dev && dstStat.st_ino == srcStat.st_ino)
     {
-        return static_cast<size_t>(maxSizeT); // 截断以适配 32 位构建
+        ::close(inFd);
+        return false;
     }
-    return static_cast<size_t>(size64);
-}
 
-double GB_GetFileSizeKB(const string& filePathUtf8)
-{
-    uint64_t size64 = 0;
-    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    const mode_t permissions = srcStat.st_mode & 07777;
+    const int outFd = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, permissions | S_IWUSR);
+    if (outFd < 0)
     {
-        return 0.0;
+        ::close(inFd);
+        return false;
     }
-    constexpr static double oneKB = 1024.0; // KiB
-    return static_cast<double>(size64) / oneKB;
-}
 
-double GB_GetFileSizeMB(const string& filePathUtf8)
-{
-    uint64_t size64 = 0;
-    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    bool ok = internal::CopyFileContents(inFd, outFd, srcStat);
+    // open 的 mode 只在新建时生效且受 umask 影响，这里显式同步权限位
+    if (ok && ::fchmod(outFd, permissions) != 0)
     {
-        return 0.0;
+        ok = false;
     }
-    constexpr static double oneMB = 1024.0 * 1024.0; // MiB
-    return static_cast<double>(size64) / oneMB;
-}
-
-double GB_GetFileSizeGB(const string& filePathUtf8)
-{
-    uint64_t size64 = 0;
-    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    ::close(inFd);
+    if (::close(outFd) != 0)
     {
-        return 0.0;
+        ok = false;
     }
-    constexpr static double oneGB = 1024.0 * 1024.0 * 1024.0; // GiB
-    return static_cast<double>(size64) / oneGB;
+    return ok;
+#endif
 }
 
-string GB_GetExeDirectory()
+namespace internal
 {
-#if defined(_WIN32)
-    // 处理可能超出 MAX_PATH 的路径：循环扩容
-    vector<wchar_t> buf(512);
-    for (;;)
+    // 去掉最后一级路径；已经是最后一级时返回空串（代表当前目录）
+    static string RemoveLastPathComponent(const string& path)
     {
-        DWORD len = ::GetModuleFileNameW(nullptr, buf.data(), static_cast<DWORD>(buf.size()));
-        if (len == 0)
+        const size_t sepPos = path.find_last_of('/');
+        if (sepPos == string::npos)
         {
-            return string(); // 失败
+            return string();
         }
-        if (len < buf.size() - 1)
+        if (sepPos == 0)
         {
-            buf[len] = L'\0';
-            break; // 成功
+            return path.size() > 1 ? string("/") : string();
         }
-        // len == nSize（被截断），扩大缓冲区
-        buf.resize(buf.size() * 2);
-    }
+#if defined(_WIN32)
+        if (sepPos == 2 && path[1] == ':')
+        {
+            return path.size() > 3 ? path.substr(0, 3) : string();
+        }
+#endif
+        return path.substr(0, sepPos);
+    }
 
-    wstring fullWs(buf.data());
-    // 去掉文件名，得到目录
-    size_t pos = fullWs.find_last_of(L"\\/");
-    if (pos == wstring::npos)
+    // 目标路径上最近的已存在的一级（目标本身不存在时取它的祖先），都不存在时为空串（当前目录）
+    static string FindExistingAncestor(const string& pathUtf8)
     {
-        return string();
+        string current = StripTrailingSlashes(pathUtf8);
+        while (!current.empty())
+        {
+#if defined(_WIN32)
+            const wstring w = Utf8ToWide(current);
+            if (!w.empty() && ::GetFileAttributesW(w.c_str()) != INVALID_FILE_ATTRIBUTES)
+            {
+                return current;
+            }
+#else
+            struct stat st;
+            if (::stat(current.c_str(), &st) == 0)
+            {
+                return current;
+            }
+#endif
+            current = RemoveLastPathComponent(current);
+        }
+        return current;
     }
-    wstring dirWs = fullWs.substr(0, pos);
-    string dirUtf8 = internal::WideToUtf8(dirWs);
-    internal::NormalizeToUnixDir(dirUtf8);
-    return dirUtf8;
 
-#else
-    // Linux: readlink("/proc/self/exe")，注意：返回长度不含NUL，需要手动补
-    vector<char> buf(256);
-    for (;;)
+#if defined(_WIN32)
+    // 打开句柄取最终路径（解析符号链接/挂载点，大小写按磁盘上的实际名称），失败返回空串
+    static wstring GetFinalPathW(const wstring& path)
     {
-        ssize_t n = ::readlink("/proc/self/exe", buf.data(), buf.size() - 1);
-        if (n < 0)
+        HANDLE h = ::CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (h == INVALID_HANDLE_VALUE)
         {
-            return string(); // 失败
+            return wstring();
         }
-        if (static_cast<size_t>(n) < buf.size() - 1)
+        wstring result(MAX_PATH, L'\0');
+        DWORD n = ::GetFinalPathNameByHandleW(h, &result[0], static_cast<DWORD>(result.size()), FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
+        if (n >= result.size())
         {
-            buf[static_cast<size_t>(n)] = '\0';
-            break; // 成功
+            result.resize(n);
+            n = ::GetFinalPathNameByHandleW(h, &result[0], static_cast<DWORD>(result.size()), FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
         }
-        // 缓冲区被截断，扩容重试
-        buf.resize(buf.size() * 2);
-    }
-
-    string full(buf.data());
-    // 某些发行版在可执行文件被删除时，路径末尾可能带" (deleted)"标记，这里去掉
-    const string deletedTag = " (deleted)";
-    if (full.size() > deletedTag.size() && full.compare(full.size() - deletedTag.size(), deletedTag.size(), deletedTag) == 0)
-    {
-        full.erase(full.size() - deletedTag.size());
+        ::CloseHandle(h);
+        if (n == 0 || n >= result.size())
+        {
+            return wstring();
+        }
+        result.resize(n);
+        return result;
     }
+#endif
 
-    // 去掉文件名，得到目录
-    size_t pos = full.find_last_of('/');
-    if (pos == string::npos)
+    // dstPathUtf8 是否就是 srcDirPathUtf8 或位于其内。不做字符串比较，免受符号链接、大小写、"."/".." 等不同写法的影响：
+    // POSIX 从目标最近的已存在一级起沿 ".." 逐级上溯，按设备号 + inode 与源目录比较；Windows 比较两者的最终路径
+    static bool IsSameOrInsideDirectory(const string& srcDirPathUtf8, const string& dstPathUtf8)
     {
-        return string();
-    }
-    string dir = full.substr(0, pos);
-    NormalizeToUnixDir(dir);
-    return dir;
+        string existing = FindExistingAncestor(dstPathUtf8);
+        if (existing.empty())
+        {
+            existing = ".";
+        }
+#if defined(_WIN32)
+        const wstring srcFinal = GetFinalPathW(Utf8ToWide(StripTrailingSlashes(srcDirPathUtf8)));
+        const wstring dstFinal = GetFinalPathW(Utf8ToWide(existing));
+        if (srcFinal.empty() || dstFinal.empty() || dstFinal.size() < srcFinal.size())
+        {
+            return false;
+        }
+        if (::CompareStringOrdinal(dstFinal.c_str(), static_cast<int>(srcFinal.size()), srcFinal.c_str(), static_cast<int>(srcFinal.size()), TRUE) != CSTR_EQUAL)
+        {
+            return false;
+        }
+        return dstFinal.size() == srcFinal.size() || dstFinal[srcFinal.size()] == L'\\' || srcFinal.back() == L'\\';
+#else
+        struct stat srcStat;
+        struct stat currentStat;
+        if (::stat(srcDirPathUtf8.c_str(), &srcStat) != 0 || ::stat(existing.c_str(), &currentStat) != 0)
+        {
+            return false;
+        }
+        string current = existing;
+        while (true)
+        {
+            if (currentStat.st_dev == srcStat.st_dev && currentStat.st_ino == srcStat.st_ino)
+            {
+                return true;
+            }
+            current += "/..";
+            struct stat parentStat;
+            if (::stat(current.c_str(), &parentStat) != 0)
+            {
+                return false;
+            }
+            if (parentStat.st_dev == currentStat.st_dev && parentStat.st_ino == currentStat.st_ino)
+            {
+                return false; // 已到根目录
+            }
+            currentStat = parentStat;
+        }
 #endif
+    }
 }
 
-bool GB_CreateFileRecursive(const string& filePathUtf8, bool overwriteIfExists)
+bool GB_CopyDirectory(const string& srcDirPathUtf8, const string& dstDirPathUtf8, GB_ThreadPool* threadPool)
 {
-    if (filePathUtf8.empty())
+    const string srcRoot = internal::EnsureTrailingSlash(srcDirPathUtf8);
+    const string dstRoot = internal::EnsureTrailingSlash(dstDirPathUtf8);
+    if (srcDirPathUtf8.empty() || dstDirPathUtf8.empty() || !GB_IsDirectoryExists(srcRoot))
     {
         return false;
     }
-
-    // 统一分隔符
-    string normPath = filePathUtf8;
-    for (size_t i = 0; i < normPath.size(); i++)
+    // 目标位于源目录之内会把新建的内容再次遍历进来
+    if (internal::IsSameOrInsideDirectory(srcRoot, dstRoot))
     {
-        if (normPath[i] == '\\')
-        {
-            normPath[i] = '/';
-        }
+        return false;
     }
-
-    // 末尾是分隔符 => 视为目录，拒绝
+    if (!GB_CreateDirectory(dstRoot))
     {
-        const char lastCh = normPath.back();
-        if (lastCh == '/' || lastCh == '\\')
-        {
-            return false;
-        }
+        return false;
     }
 
-    // 先确保父目录存在
-    const string dirPathUtf8 = GB_GetDirectoryPath(normPath);
-    if (!dirPathUtf8.empty())
+    atomic<bool> ok(true);
+    mutex pendingMutex;
+    condition_variable pendingCond;
+    size_t pendingCopies = 0;
+    const size_t maxPendingCopies = threadPool ? threadPool->GetThreadCount() * 4 : 0;
+
+    struct PendingCopyTask
     {
-        if (!GB_CreateDirectory(dirPathUtf8))
+        static void Run(const string& src, const string& dst, atomic<bool>* ok, mutex* pendingMutex, condition_variable* pendingCond, size_t* pendingCopies)
         {
-            return false;
+            bool copied = false;
+            try
+            {
+                copied = GB_CopyFile(src, dst);
+            }
+            catch (...)
+            {
+            }
+            if (!copied)
+            {
+                ok->store(false, memory_order_relaxed);
+            }
+
+            lock_guard<mutex> lock(*pendingMutex);
+            (*pendingCopies)--;
+            pendingCond->notify_all();
         }
-    }
+    };
 
-    // 存在性与非覆盖策略
-    if (!overwriteIfExists)
+#if !defined(_WIN32)
+    // 目录权限在全部内容复制完之后再设置（只读目录先设会导致无法写入其中的文件）
+    vector<pair<string, mode_t>> directoryModes;
+    struct stat rootStat;
+    if (::stat(srcRoot.c_str(), &rootStat) == 0)
     {
-        if (GB_IsFileExists(normPath))
-        {
-            const size_t sizeByte = GB_GetFileSizeByte(normPath);
-            return sizeByte == 0; // 已存在且已为空 ⇒ OK；否则拒绝
-        }
+        directoryModes.push_back(make_pair(dstRoot, rootStat.st_mode & 07777));
     }
+#endif
 
-#if defined(_WIN32)
-    // UTF-8 -> UTF-16
-    auto Utf8ToWide = [](const string& utf8) -> wstring
+    GB_DirectoryWalkOptions options;
+    options.includeDirectories = true;
+    // 遍历本身在调用线程串行进行（父目录一定先于其内容被回调），线程池只用于复制文件数据
+    GB_DirectoryWalker walker(options);
+    const auto waitPendingCopies = [&]() {
+        if (threadPool)
         {
-            if (utf8.empty())
+            unique_lock<mutex> lock(pendingMutex);
+            pendingCond.wait(lock, [&]() {
+                return pendingCopies == 0;
+            });
+        }
+    };
+
+    bool walked = false;
+    try
+    {
+        walked = walker.Walk(srcRoot, [&](const GB_DirectoryEntry& entry) {
+            const string dstPath = dstRoot + entry.GetRelativePath();
+            if (entry.type == GB_FileType::Directory)
             {
-                return wstring();
+                if (!GB_CreateDirectory(dstPath))
+                {
+                    ok.store(false, memory_order_relaxed);
+                }
+#if !defined(_WIN32)
+                struct stat dirStat;
+                if (::stat(entry.pathUtf8.c_str(), &dirStat) == 0)
+                {
+                    directoryModes.push_back(make_pair(dstPath, dirStat.st_mode & 07777));
+                }
+#endif
+                return true;
             }
-            const int need = ::MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(),
-                static_cast<int>(utf8.size()),
-                nullptr, 0);
-            if (need <= 0)
+
+#if !defined(_WIN32)
+            if (entry.type == GB_FileType::Symlink)
             {
-                return wstring();
+                // 符号链接按链接本身复制
+                vector<char> target(4096);
+                const ssize_t n = ::readlink(entry.pathUtf8.c_str(), target.data(), target.size() - 1);
+                if (n < 0)
+                {
+                    ok.store(false, memory_order_relaxed);
+                    return true;
+                }
+                target[static_cast<size_t>(n)] = '\0';
+                ::unlink(dstPath.c_str());
+                if (::symlink(target.data(), dstPath.c_str()) != 0)
+                {
+                    ok.store(false, memory_order_relaxed);
+                }
+                return true;
             }
-            wstring ws(static_cast<size_t>(need), L'\0');
-            const int wrote = ::MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(),
-                static_cast<int>(utf8.size()),
-                &ws[0], need);
-            if (wrote != need)
+            if (entry.type != GB_FileType::Regular)
             {
-                return wstring();
+                return true; // 设备、管道、套接字不复制
             }
-            return ws;
-        };
+#else
+            if (entry.type == GB_FileType::Symlink)
+            {
+                // 符号链接按链接本身复制（CopyFileW 会复制链接指向的内容）
+                const wstring srcW = internal::Utf8ToWide(entry.pathUtf8);
+                const wstring dstW = internal::Utf8ToWide(dstPath);
+                if (srcW.empty() || dstW.empty() || !::CopyFileExW(srcW.c_str(), dstW.c_str(), nullptr, nullptr, nullptr, COPY_FILE_COPY_SYMLINK))
+                {
+                    ok.store(false, memory_order_relaxed);
+                }
+                return true;
+            }
+#endif
 
-    const wstring wPath = Utf8ToWide(normPath);
-    if (wPath.empty())
-    {
-        return false;
-    }
+            if (threadPool)
+            {
+                unique_lock<mutex> lock(pendingMutex);
+                pendingCond.wait(lock, [&]() {
+                    return pendingCopies < maxPendingCopies;
+                });
+                pendingCopies++;
+                lock.unlock();
+
+                bool posted = false;
+                try
+                {
+                    posted = threadPool->TryPost(&PendingCopyTask::Run, entry.pathUtf8, dstPath, &ok, &pendingMutex, &pendingCond, &pendingCopies);
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    pendingCopies--;
+                    throw;
+                }
+                if (posted)
+                {
+                    return true;
+                }
 
-    const DWORD creationDisposition = overwriteIfExists ? CREATE_ALWAYS : CREATE_NEW; // 见备注
-    HANDLE h = ::CreateFileW(
-        wPath.c_str(),
-        GENERIC_WRITE,
-        FILE_SHARE_READ,        // 允许其他进程读
-        nullptr,
-        creationDisposition,
-        FILE_ATTRIBUTE_NORMAL,
-        nullptr);
+                lock.lock();
+                pendingCopies--;
+            }
 
-    if (h == INVALID_HANDLE_VALUE)
+            if (!GB_CopyFile(entry.pathUtf8, dstPath))
+            {
+                ok.store(false, memory_order_relaxed);
+            }
+            return true;
+        });
+    }
+    catch (...)
     {
-        return false;
+        // 已投递的复制任务引用着本函数栈上的计数与互斥量，必须等它们结束才能展开
+        waitPendingCopies();
+        throw;
     }
-    ::CloseHandle(h);
-    return true;
+    waitPendingCopies();
 
-#else
-    // Linux/Unix：确保只在“不存在时创建”或“截断创建”
-    int flags = O_WRONLY | O_CREAT | (overwriteIfExists ? O_TRUNC : O_EXCL);
-    const int fd = ::open(normPath.c_str(), flags, 0644); // 最终权限受 umask 影响
-    if (fd < 0)
+#if !defined(_WIN32)
+    for (size_t i = directoryModes.size(); i > 0; i--)
     {
-        return false;
+        ::chmod(directoryModes[i - 1].first.c_str(), directoryModes[i - 1].second);
     }
-    (void)::close(fd);
-    return true;
 #endif
+
+    return walked && ok.load(memory_order_relaxed);
 }
 
-string GB_GetRelativePath(const string& pathAUtf8, const string& pathBUtf8)
+vector<string> GB_GetFilesList(const string& dirPathUtf8, bool recursive)
 {
-    if (pathAUtf8.empty())
+    vector<string> out;
+    if (!GB_IsDirectoryExists(dirPathUtf8))
     {
-        return "";
+        return out;
     }
 
-    // 1) 判定 A 是否目录：优先相信用户输入形态（末尾分隔符），其次才查文件系统。
-    bool pathAIsDir = false;
-    if (!pathAUtf8.empty() && (pathAUtf8.back() == '/' || pathAUtf8.back() == '\\'))
-    {
-        pathAIsDir = true;
-    }
-    else
+    GB_DirectoryWalkOptions options;
+    options.maxDepth = recursive ? -1 : 0;
+    options.followSymlinks = true;
+    options.filter = [](const GB_DirectoryEntry& entry) {
+        return entry.type == GB_FileType::Regular || entry.type == GB_FileType::Directory;
+    };
+    GB_DirectoryWalker(options).Walk(dirPathUtf8, [&out](const GB_DirectoryEntry& entry) {
+        out.push_back(entry.pathUtf8);
+        return true;
+    });
+    return out;
+}
+
+string GB_GetFileName(const string& rawFilePathUtf8, bool withExt)
+{
+    // 文件名部分不含分隔符，直接按字节找最后一个分隔符即可，无需先整体替换反斜杠
+    const size_t sepPos = rawFilePathUtf8.find_last_of("/\\");
+    if (sepPos == string::npos)
     {
-        pathAIsDir = GB_IsDirectoryExists(pathAUtf8);
+        // 与原实现一致：不含分隔符时原样返回，withExt 为 false 也不去掉扩展名
+        return rawFilePathUtf8;
     }
 
-    // 2) 基准路径：若 B 是文件，则以其父目录作为 base；若 B 是目录，则以 B 本身作为 base。
-    bool pathBIsDir = false;
-    if (!pathBUtf8.empty() && (pathBUtf8.back() == '/' || pathBUtf8.back() == '\\'))
+    const size_t nameBegin = sepPos + 1;
+    if (withExt)
     {
-        pathBIsDir = true;
+        return rawFilePathUtf8.substr(nameBegin);
     }
-    else
+
+    const size_t dotPos = rawFilePathUtf8.rfind('.');
+    if (dotPos == string::npos || dotPos < nameBegin)
     {
-        pathBIsDir = GB_IsDirectoryExists(pathBUtf8);
+        return rawFilePathUtf8.substr(nameBegin);
     }
+    return rawFilePathUtf8.substr(nameBegin, dotPos - nameBegin);
+}
 
-    string baseDirUtf8 = "";
-    if (pathBUtf8.empty())
+string GB_GetFileExt(const string& filePathUtf8)
+{
+    const size_t pos = filePathUtf8.rfind('.');
+    if (pos == string::npos)
     {
-        baseDirUtf8 = ".";
+        return "";
     }
-    else if (pathBIsDir)
+
+    return filePathUtf8.substr(pos);
+}
+
+string GB_GetDirectoryPath(const string& rawFilePathUtf8)
+{
+    const size_t sepPos = rawFilePathUtf8.find_last_of("/\\");
+    if (sepPos == string::npos)
     {
-        baseDirUtf8 = pathBUtf8;
+        return "";
     }
-    else
+
+    // 单趟完成原先的两次替换：连续两个反斜杠折叠为一个“/”，其余反斜杠换成“/”
+    string result;
+    result.reserve(sepPos + 1);
+    for (size_t i = 0; i <= sepPos; i++)
     {
-        baseDirUtf8 = GB_GetDirectoryPath(pathBUtf8);
-        if (baseDirUtf8.empty())
+        const char ch = rawFilePathUtf8[i];
+        if (ch != '\\')
         {
-            baseDirUtf8 = ".";
+            result.push_back(ch);
+            continue;
+        }
+        result.push_back('/');
+        if (i + 1 <= sepPos && rawFilePathUtf8[i + 1] == '\\')
+        {
+            i++;
         }
     }
+    return result;
+}
 
-    // 3) 纯字符串（lexical）解析与标准化
-    const internal::ParsedPath target = internal::ParseAndNormalizePathLexical(pathAUtf8);
-    const internal::ParsedPath base = internal::ParseAndNormalizePathLexical(baseDirUtf8);
+size_t GB_GetFileSizeByte(const string& filePathUtf8)
+{
+    uint64_t size64 = 0;
+    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    {
+        return 0;
+    }
+    constexpr static uint64_t maxSizeT = static_cast<uint64_t>(numeric_limits<size_t>::max());
+    if (size64 > maxSizeT)
+    {
+        return static_cast<size_t>(maxSizeT); // 截断以适配 32 位构建
+    }
+    return static_cast<size_t>(size64);
+}
 
-    // Windows：不同盘符/不同 UNC share 无法构造相对路径；此处回退为“规范化后的 A”。
-    // 参考：Win32 PathRelativePathToW 要求两者有共同前缀，否则失败。
-    if (!internal::EqualRoot(target.root, base.root) || target.isAbsolute != base.isAbsolute)
+double GB_GetFileSizeKB(const string& filePathUtf8)
+{
+    uint64_t size64 = 0;
+    if (!internal::TryGetFileSize64(filePathUtf8, size64))
     {
-        string out = internal::ToOutputNorm(pathAUtf8);
-        if (pathAIsDir)
-        {
-            out = internal::EnsureTrailingSlash(out);
-        }
-        return out;
+        return 0.0;
     }
+    constexpr static double oneKB = 1024.0; // KiB
+    return static_cast<double>(size64) / oneKB;
+}
 
-    // 4) 计算公共前缀
-    size_t common = 0;
-    const size_t minCount = min(target.segments.size(), base.segments.size());
-    for (; common < minCount; common++)
+double GB_GetFileSizeMB(const string& filePathUtf8)
+{
+    uint64_t size64 = 0;
+    if (!internal::TryGetFileSize64(filePathUtf8, size64))
     {
-        if (!internal::EqualSegment(target.segments[common], base.segments[common]))
-        {
-            break;
-        }
+        return 0.0;
     }
+    constexpr static double oneMB = 1024.0 * 1024.0; // MiB
+    return static_cast<double>(size64) / oneMB;
+}
 
-    // 5) base -> common：补 ".."；common -> target：补余下片段
-    vector<string> relSegments;
-    relSegments.reserve((base.segments.size() - common) + (target.segments.size() - common));
+double GB_GetFileSizeGB(const string& filePathUtf8)
+{
+    uint64_t size64 = 0;
+    if (!internal::TryGetFileSize64(filePathUtf8, size64))
+    {
+        return 0.0;
+    }
+    constexpr static double oneGB = 1024.0 * 1024.0 * 1024.0; // GiB
+    return static_cast<double>(size64) / oneGB;
+}
 
-    for (size_t i = common; i < base.segments.size(); i++)
+string GB_GetExeDirectory()
+{
+#if defined(_WIN32)
+    // 处理可能超出 MAX_PATH 的路径：循环扩容
+    vector<wchar_t> buf(512);
+    for (;;)
     {
-        relSegments.push_back("..");
+        DWORD len = ::GetModuleFileNameW(nullptr, buf.data(), static_cast<DWORD>(buf.size()));
+        if (len == 0)
+        {
+            return string(); // 失败
+        }
+        if (len < buf.size() - 1)
+        {
+            buf[len] = L'\0';
+            break; // 成功
+        }
+        // len == nSize（被截断），扩大缓冲区
+        buf.resize(buf.size() * 2);
     }
-    for (size_t i = common; i < target.segments.size(); i++)
+
+    wstring fullWs(buf.data());
+    // 去掉文件名，得到目录
+    size_t pos = fullWs.find_last_of(L"\\/");
+    if (pos == wstring::npos)
     {
-        relSegments.push_back(target.segments[i]);
+        return string();
     }
+    wstring dirWs = fullWs.substr(0, pos);
+    string dirUtf8 = internal::WideToUtf8(dirWs);
+    internal::NormalizeToUnixDir(dirUtf8);
+    return dirUtf8;
 
-    string relPath = internal::JoinSegmentsWithSlash(relSegments);
-    if (relPath.empty())
+#else
+    // Linux: readlink("/proc/self/exe")，注意：返回长度不含NUL，需要手动补
+    vector<char> buf(256);
+    for (;;)
     {
-        relPath = ".";
+        ssize_t n = ::readlink("/proc/self/exe", buf.data(), buf.size() - 1);
+        if (n < 0)
+        {
+            return string(); // 失败
+        }
+        if (static_cast<size_t>(n) < buf.size() - 1)
+        {
+            buf[static_cast<size_t>(n)] = '\0';
+            break; // 成功
+        }
+        // 缓冲区被截断，扩容重试
+        buf.resize(buf.size() * 2);
     }
 
-    // 6) 若 A 为目录，保证结果末尾带 '/'
-    if (pathAIsDir)
+    string full(buf.data());
+    // 某些发行版在可执行文件被删除时，路径末尾可能带" (deleted)"标记，这里去掉
+    const string deletedTag = " (deleted)";
+    if (full.size() > deletedTag.size() && full.compare(full.size() - deletedTag.size(), deletedTag.size(), deletedTag) == 0)
     {
-        relPath = internal::EnsureTrailingSlash(relPath);
+        full.erase(full.size() - deletedTag.size());
     }
 
-    return relPath;
+    // 去掉文件名，得到目录
+    size_t pos = full.find_last_of('/');
+    if (pos == string::npos)
+    {
+        return string();
+    }
+    string dir = full.substr(0, pos);
+    internal::NormalizeToUnixDir(dir);
+    return dir;
+#endif
 }
 
-string GB_JoinPath(const string& leftPathUtf8, const string& rightPathUtf8)
+bool GB_CreateFileRecursive(const string& filePathUtf8, bool overwriteIfExists)
 {
-    bool outputIsDir = false;
-    if (!rightPathUtf8.empty())
+    if (filePathUtf8.empty())
     {
-        outputIsDir = internal::IsSlash(rightPathUtf8.back()) || internal::EndsWithDotOrDotDot(rightPathUtf8);
+        return false;
     }
-    else
+
+    // 统一分隔符
+    string normPath = filePathUtf8;
+    for (size_t i = 0; i < normPath.size(); i++)
     {
-        if (!leftPathUtf8.empty() && internal::IsSlash(leftPathUtf8.back()))
+        if (normPath[i] == '\\')
         {
-            outputIsDir = true;
+            normPath[i] = '/';
         }
-        else if (GB_IsDirectoryExists(leftPathUtf8))
+    }
+
+    // 末尾是分隔符 => 视为目录，拒绝
+    {
+        const char lastCh = normPath.back();
+        if (lastCh == '/' || lastCh == '\\')
         {
-            outputIsDir = true;
+            return false;
         }
     }
 
-    // 统一分隔符
-    string leftNorm = leftPathUtf8;
-    string rightNorm = rightPathUtf8;
-    internal::ReplaceBackslashWithSlash(leftNorm);
-    internal::ReplaceBackslashWithSlash(rightNorm);
-
-    // right 为空：直接规范化 left
-    if (rightNorm.empty())
+    // 先确保父目录存在
+    const string dirPathUtf8 = GB_GetDirectoryPath(normPath);
+    if (!dirPathUtf8.empty())
     {
-        internal::LexicalPath path = internal::ParseLexicalPath(leftNorm);
-        internal::NormalizeDotSegments(path);
-
-        // 若文件系统中存在且为目录，也认为是目录
-        if (!outputIsDir)
+        if (!GB_CreateDirectory(dirPathUtf8))
         {
-            const string tmp = internal::BuildPathString(path, false);
-            bool exists = false;
-            bool isDir = false;
-            if (internal::IsDirByStat(tmp, exists, isDir) && exists && isDir)
-            {
-                outputIsDir = true;
-            }
+            return false;
         }
-        return internal::BuildPathString(path, outputIsDir);
     }
 
-    // left + right：尽量把 left 当作目录（除非明确是文件）
-    string base = leftNorm;
-    if (!base.empty())
+    // 存在性与非覆盖策略
+    if (!overwriteIfExists)
     {
-        bool leftExists = false;
-        bool leftIsDir = false;
-        if (internal::IsDirByStat(base, leftExists, leftIsDir) && leftExists && !leftIsDir)
+        if (GB_IsFileExists(normPath))
         {
-            base = GB_GetDirectoryPath(base);
+            const size_t sizeByte = GB_GetFileSizeByte(normPath);
+            return sizeByte == 0; // 已存在且已为空 ⇒ OK；否则拒绝
         }
+    }
 
-        // 作为目录拼接时，确保 base 末尾有 '/'
-        if (!base.empty() && base.back() != '/')
+#if defined(_WIN32)
+    // UTF-8 -> UTF-16
+    auto Utf8ToWide = [](const string& utf8) -> wstring
         {
-            base.push_back('/');
-        }
+            if (utf8.empty())
+            {
+                return wstring();
+            }
+            const int need = ::MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(),
+                static_cast<int>(utf8.size()),
+                nullptr, 0);
+            if (need <= 0)
+            {
+                return wstring();
+            }
+            wstring ws(static_cast<size_t>(need), L'\0');
+            const int wrote = ::MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(),
+                static_cast<int>(utf8.size()),
+                &ws[0], need);
+            if (wrote != need)
+            {
+                return wstring();
+            }
+            return ws;
+        };
+
+    const wstring wPath = Utf8ToWide(normPath);
+    if (wPath.empty())
+    {
+        return false;
     }
 
-    const string combined = base + rightNorm;
-    internal::LexicalPath combinedParsed = internal::ParseLexicalPath(combined);
-    internal::NormalizeDotSegments(combinedParsed);
+    const DWORD creationDisposition = overwriteIfExists ? CREATE_ALWAYS : CREATE_NEW; // 见备注
+    HANDLE h = ::CreateFileW(
+        wPath.c_str(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ,        // 允许其他进程读
+        nullptr,
+        creationDisposition,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
 
-    if (!outputIsDir)
+    if (h == INVALID_HANDLE_VALUE)
     {
-        const string tmp = internal::BuildPathString(combinedParsed, false);
-        bool exists = false;
-        bool isDir = false;
-        if (internal::IsDirByStat(tmp, exists, isDir) && exists && isDir)
-        {
-            outputIsDir = true;
-        }
+        return false;
     }
-    return internal::BuildPathString(combinedParsed, outputIsDir);
+    ::CloseHandle(h);
+    return true;
+
+#else
+    // Linux/Unix：确保只在“不存在时创建”或“截断创建”
+    int flags = O_WRONLY | O_CREAT | (overwriteIfExists ? O_TRUNC : O_EXCL);
+    const int fd = ::open(normPath.c_str(), flags, 0644); // 最终权限受 umask 影响
+    if (fd < 0)
+    {
+        return false;
+    }
+    (void)::close(fd);
+    return true;
+#endif
+}
+
+string GB_GetRelativePath(const string& pathAUtf8, const string& pathBUtf8)
+{
+    if (pathAUtf8.empty())
+    {
+        return "";
+    }
+
+    // 1) 判定 A 是否目录：优先相信用户输入形态（末尾分隔符），其次才查文件系统。
+    bool pathAIsDir = false;
+    if (!pathAUtf8.empty() && (pathAUtf8.back() == '/' || pathAUtf8.back() == '\\'))
+    {
+        pathAIsDir = true;
+    }
+    else
+    {
+        pathAIsDir = GB_IsDirectoryExists(pathAUtf8);
+    }
+
+    // 2) 基准路径：若 B 是文件，则以其父目录作为 base；若 B 是目录，则以 B 本身作为 base。
+    bool pathBIsDir = false;
+    if (!pathBUtf8.empty() && (pathBUtf8.back() == '/' || pathBUtf8.back() == '\\'))
+    {
+        pathBIsDir = true;
+    }
+    else
+    {
+        pathBIsDir = GB_IsDirectoryExists(pathBUtf8);
+    }
+
+    string baseDirUtf8 = "";
+    if (pathBUtf8.empty())
+    {
+        baseDirUtf8 = ".";
+    }
+    else if (pathBIsDir)
+    {
+        baseDirUtf8 = pathBUtf8;
+    }
+    else
+    {
+        baseDirUtf8 = GB_GetDirectoryPath(pathBUtf8);
+        if (baseDirUtf8.empty())
+        {
+            baseDirUtf8 = ".";
+        }
+    }
+
+    // 3) 纯字符串（lexical）解析与标准化
+    const internal::ParsedPath target = internal::ParseAndNormalizePathLexical(pathAUtf8);
+    const internal::ParsedPath base = internal::ParseAndNormalizePathLexical(baseDirUtf8);
+
+    // Windows：不同盘符/不同 UNC share 无法构造相对路径；此处回退为“规范化后的 A”。
+    // 参考：Win32 PathRelativePathToW 要求两者有共同前缀，否则失败。
+    if (!internal::EqualRoot(target.root, base.root) || target.isAbsolute != base.isAbsolute)
+    {
+        string out = internal::ToOutputNorm(pathAUtf8);
+        if (pathAIsDir)
+        {
+            out = internal::EnsureTrailingSlash(out);
+        }
+        return out;
+    }
+
+    // 4) 计算公共前缀
+    size_t common = 0;
+    const size_t minCount = min(target.segments.size(), base.segments.size());
+    for (; common < minCount; common++)
+    {
+        if (!internal::EqualSegment(target.segments[common], base.segments[common]))
+        {
+            break;
+        }
+    }
+
+    // 5) base -> common：补 ".."；common -> target：补余下片段
+    vector<string> relSegments;
+    relSegments.reserve((base.segments.size() - common) + (target.segments.size() - common));
+
+    for (size_t i = common; i < base.segments.size(); i++)
+    {
+        relSegments.push_back("..");
+    }
+    for (size_t i = common; i < target.segments.size(); i++)
+    {
+        relSegments.push_back(target.segments[i]);
+    }
+
+    string relPath = internal::JoinSegmentsWithSlash(relSegments);
+    if (relPath.empty())
+    {
+        relPath = ".";
+    }
+
+    // 6) 若 A 为目录，保证结果末尾带 '/'
+    if (pathAIsDir)
+    {
+        relPath = internal::EnsureTrailingSlash(relPath);
+    }
+
+    return relPath;
+}
+
+string GB_JoinPath(const string& leftPathUtf8, const string& rightPathUtf8)
+{
+    bool outputIsDir = false;
+    if (!rightPathUtf8.empty())
+    {
+        outputIsDir = internal::IsSlash(rightPathUtf8.back()) || internal::EndsWithDotOrDotDot(rightPathUtf8);
+    }
+    else
+    {
+        if (!leftPathUtf8.empty() && internal::IsSlash(leftPathUtf8.back()))
+        {
+            outputIsDir = true;
+        }
+        else if (GB_IsDirectoryExists(leftPathUtf8))
+        {
+            outputIsDir = true;
+        }
+    }
+
+    // 统一分隔符
+    string leftNorm = leftPathUtf8;
+    string rightNorm = rightPathUtf8;
+    internal::ReplaceBackslashWithSlash(leftNorm);
+    internal::ReplaceBackslashWithSlash(rightNorm);
+
+    // right 为空：直接规范化 left
+    if (rightNorm.empty())
+    {
+        internal::LexicalPath path = internal::ParseLexicalPath(leftNorm);
+        internal::NormalizeDotSegments(path);
+
+        // 若文件系统中存在且为目录，也认为是目录
+        if (!outputIsDir)
+        {
+            const string tmp = internal::BuildPathString(path, false);
+            bool exists = false;
+            bool isDir = false;
+            if (internal::IsDirByStat(tmp, exists, isDir) && exists && isDir)
+            {
+                outputIsDir = true;
+            }
+        }
+        return internal::BuildPathString(path, outputIsDir);
+    }
+
+    // left + right：尽量把 left 当作目录（除非明确是文件）
+    string base = leftNorm;
+    if (!base.empty())
+    {
+        bool leftExists = false;
+        bool leftIsDir = false;
+        if (internal::IsDirByStat(base, leftExists, leftIsDir) && leftExists && !leftIsDir)
+        {
+            base = GB_GetDirectoryPath(base);
+        }
+
+        // 作为目录拼接时，确保 base 末尾有 '/'
+        if (!base.empty() && base.back() != '/')
+        {
+            base.push_back('/');
+        }
+    }
+
+    const string combined = base + rightNorm;
+    internal::LexicalPath combinedParsed = internal::ParseLexicalPath(combined);
+    internal::NormalizeDotSegments(combinedParsed);
+
+    if (!outputIsDir)
+    {
+        const string tmp = internal::BuildPathString(combinedParsed, false);
+        bool exists = false;
+        bool isDir = false;
+        if (internal::IsDirByStat(tmp, exists, isDir) && exists && isDir)
+        {
+            outputIsDir = true;
+        }
+    }
+    return internal::BuildPathString(combinedParsed, outputIsDir);
+}
+
+
+namespace internal
+{
+#if defined(_WIN32)
+    static inline int64_t FileTimeToUnixNs(const FILETIME& ft)
+    {
+        const int64_t ticks = (static_cast<int64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+        return (ticks - 116444736000000000LL) * 100;
+    }
+
+    static void FillStatFromAttributes(DWORD attrs, DWORD sizeHigh, DWORD sizeLow, const FILETIME& lastWrite, GB_FileStat& out)
+    {
+        const bool isDir = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        out.exists = true;
+        if ((attrs & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+        {
+            out.type = GB_FileType::Symlink;
+        }
+        else if (isDir)
+        {
+            out.type = GB_FileType::Directory;
+        }
+        else if ((attrs & FILE_ATTRIBUTE_DEVICE) != 0)
+        {
+            out.type = GB_FileType::Other;
+        }
+        else
+        {
+            out.type = GB_FileType::Regular;
+        }
+        out.sizeBytes = isDir ? 0 : ((static_cast<uint64_t>(sizeHigh) << 32) | sizeLow);
+        out.modifiedTimeNs = FileTimeToUnixNs(lastWrite);
+        out.mode = (isDir ? _S_IFDIR : _S_IFREG) | (((attrs & FILE_ATTRIBUTE_READONLY) != 0) ? 0444 : 0666);
+        out.inode = 0;
+        out.device = 0;
+    }
+
+    static bool StatPath(const string& pathUtf8, bool followSymlinks, GB_FileStat& out)
+    {
+        out = GB_FileStat();
+        const wstring w = Utf8ToWide(StripTrailingSlashes(pathUtf8));
+        if (w.empty())
+        {
+            return false;
+        }
+
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(w.c_str(), GetFileExInfoStandard, &data))
+        {
+            return false;
+        }
+        if (!followSymlinks || (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0)
+        {
+            FillStatFromAttributes(data.dwFileAttributes, data.nFileSizeHigh, data.nFileSizeLow, data.ftLastWriteTime, out);
+            return true;
+        }
+
+        // 跟随链接需要打开目标；顺带拿到卷序列号与文件索引
+        HANDLE h = CreateFileW(w.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (h == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        BY_HANDLE_FILE_INFORMATION info;
+        const BOOL ok = GetFileInformationByHandle(h, &info);
+        CloseHandle(h);
+        if (!ok)
+        {
+            return false;
+        }
+        FillStatFromAttributes(info.dwFileAttributes & ~static_cast<DWORD>(FILE_ATTRIBUTE_REPARSE_POINT), info.nFileSizeHigh, info.nFileSizeLow, info.ftLastWriteTime, out);
+        out.inode = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+        out.device = info.dwVolumeSerialNumber;
+        return true;
+    }
+#else
+    static GB_FileType FileTypeFromMode(mode_t mode)
+    {
+        if (S_ISREG(mode))
+        {
+            return GB_FileType::Regular;
+        }
+        if (S_ISDIR(mode))
+        {
+            return GB_FileType::Directory;
+        }
+        if (S_ISLNK(mode))
+        {
+            return GB_FileType::Symlink;
+        }
+        return GB_FileType::Other;
+    }
+
+    static void FillStatFromStat(const struct stat& st, GB_FileStat& out)
+    {
+        out.exists = true;
+        out.type = FileTypeFromMode(st.st_mode);
+        out.sizeBytes = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+        out.modifiedTimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+        out.modifiedTimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+        out.mode = static_cast<uint32_t>(st.st_mode);
+        out.inode = static_cast<uint64_t>(st.st_ino);
+        out.device = static_cast<uint64_t>(st.st_dev);
+    }
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    // 内核或 seccomp 不支持 statx 时（ENOSYS/EPERM）退回 fstatat，且之后不再尝试
+    static atomic<bool> statxUnavailable(false);
+#endif
+
+    // dirFd 可为 AT_FDCWD；path 为相对 dirFd 的路径
+    static bool StatAt(int dirFd, const char* path, bool followSymlinks, GB_FileStat& out)
+    {
+        out = GB_FileStat();
+        const int linkFlag = followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW;
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+        if (!statxUnavailable.load(memory_order_relaxed))
+        {
+            struct statx stx;
+            const unsigned int mask = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME | STATX_INO;
+            if (::statx(dirFd, path, linkFlag | AT_STATX_SYNC_AS_STAT, mask, &stx) == 0)
+            {
+                out.exists = true;
+                out.type = FileTypeFromMode(static_cast<mode_t>(stx.stx_mode));
+                out.sizeBytes = stx.stx_size;
+                out.modifiedTimeNs = static_cast<int64_t>(stx.stx_mtime.tv_sec) * 1000000000LL + stx.stx_mtime.tv_nsec;
+                out.mode = stx.stx_mode;
+                out.inode = stx.stx_ino;
+                out.device = static_cast<uint64_t>(makedev(stx.stx_dev_major, stx.stx_dev_minor));
+                return true;
+            }
+            if (errno != ENOSYS && errno != EPERM)
+            {
+                return false;
+            }
+            statxUnavailable.store(true, memory_order_relaxed);
+        }
+#endif
+        struct stat st;
+        if (::fstatat(dirFd, path, &st, linkFlag) != 0)
+        {
+            return false;
+        }
+        FillStatFromStat(st, out);
+        return true;
+    }
+
+    static bool StatPath(const string& pathUtf8, bool followSymlinks, GB_FileStat& out)
+    {
+        if (pathUtf8.empty())
+        {
+            out = GB_FileStat();
+            return false;
+        }
+        const string native = ReplaceSlashes(pathUtf8, '/');
+        return StatAt(AT_FDCWD, native.c_str(), followSymlinks, out);
+    }
+#endif
+
+    static void StatRange(const vector<string>& paths, bool followSymlinks, vector<GB_FileStat>& results, atomic<size_t>& nextChunk, size_t chunkSize)
+    {
+        for (;;)
+        {
+            const size_t begin = nextChunk.fetch_add(1, memory_order_relaxed) * chunkSize;
+            if (begin >= paths.size())
+            {
+                return;
+            }
+            const size_t end = (std::min)(paths.size(), begin + chunkSize);
+            for (size_t i = begin; i < end; i++)
+            {
+                StatPath(paths[i], followSymlinks, results[i]);
+            }
+        }
+    }
+}
+
+bool GB_GetFileStat(const string& pathUtf8, GB_FileStat& statOut, bool followSymlinks)
+{
+    return internal::StatPath(pathUtf8, followSymlinks, statOut);
+}
+
+vector<GB_FileStat> GB_StatMany(const vector<string>& pathsUtf8, bool followSymlinks, GB_ThreadPool* threadPool)
+{
+    vector<GB_FileStat> results(pathsUtf8.size());
+    if (pathsUtf8.empty())
+    {
+        return results;
+    }
+
+    // 按块领取，块足够大以摊薄原子操作，又足够小以在慢路径（网络盘）上均衡负载
+    const size_t chunkSize = 64;
+    const size_t chunkCount = (pathsUtf8.size() + chunkSize - 1) / chunkSize;
+    atomic<size_t> nextChunk(0);
+
+    vector<future<void>> helpers;
+    if (threadPool && chunkCount > 1)
+    {
+        const size_t helperCount = (std::min)(threadPool->GetThreadCount(), chunkCount - 1);
+        helpers.reserve(helperCount);
+        for (size_t i = 0; i < helperCount; i++)
+        {
+            pair<bool, future<void>> posted = threadPool->TryEnqueue(&internal::StatRange, cref(pathsUtf8), followSymlinks, ref(results), ref(nextChunk), chunkSize);
+            if (!posted.first)
+            {
+                break;
+            }
+            helpers.push_back(std::move(posted.second));
+        }
+    }
+
+    internal::StatRange(pathsUtf8, followSymlinks, results, nextChunk, chunkSize);
+    for (size_t i = 0; i < helpers.size(); i++)
+    {
+        helpers[i].wait();
+    }
+    return results;
+}
+
+namespace internal
+{
+#if defined(_WIN32)
+    static inline bool GlobCharEqual(char a, char b)
+    {
+        // Windows 文件系统大小写不敏感，ASCII 部分按大小写不敏感比较
+        if (a >= 'A' && a <= 'Z')
+        {
+            a = static_cast<char>(a - 'A' + 'a');
+        }
+        if (b >= 'A' && b <= 'Z')
+        {
+            b = static_cast<char>(b - 'A' + 'a');
+        }
+        return a == b;
+    }
+#else
+    static inline bool GlobCharEqual(char a, char b)
+    {
+        return a == b;
+    }
+#endif
+
+    // 解析 [...] 字符类，成功时 classEnd 指向 ']' 之后
+    static bool MatchGlobClass(const char* p, const char* pe, char ch, bool& matched, const char*& classEnd)
+    {
+        const char* q = p + 1;
+        bool negate = false;
+        if (q < pe && (*q == '!' || *q == '^'))
+        {
+            negate = true;
+            q++;
+        }
+
+        bool hit = false;
+        bool first = true;
+        while (q < pe && (*q != ']' || first))
+        {
+            first = false;
+            const char lo = *q;
+            if (q + 2 < pe && q[1] == '-' && q[2] != ']')
+            {
+                const char hi = q[2];
+                if (static_cast<unsigned char>(ch) >= static_cast<unsigned char>(lo) &&
+                    static_cast<unsigned char>(ch) <= static_cast<unsigned char>(hi))
+                {
+                    hit = true;
+                }
+                q += 3;
+            }
+            else
+            {
+                if (GlobCharEqual(lo, ch))
+                {
+                    hit = true;
+                }
+                q++;
+            }
+        }
+        if (q >= pe)
+        {
+            return false; // 没有闭合的 ']'，按普通字符处理
+        }
+
+        matched = (hit != negate) && ch != '/';
+        classEnd = q + 1;
+        return true;
+    }
+
+    static bool MatchGlobRange(const char* p, const char* pe, const char* s, const char* se)
+    {
+        while (p < pe)
+        {
+            if (*p == '*')
+            {
+                if (p + 1 < pe && p[1] == '*')
+                {
+                    // "**"：可跨越 '/'；"**/" 还可匹配零层目录
+                    p += 2;
+                    if (p < pe && *p == '/' && MatchGlobRange(p + 1, pe, s, se))
+                    {
+                        return true;
+                    }
+                    for (const char* k = s; ; k++)
+                    {
+                        if (MatchGlobRange(p, pe, k, se))
+                        {
+                            return true;
+                        }
+                        if (k == se)
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                p++;
+                for (const char* k = s; ; k++)
+                {
+                    if (MatchGlobRange(p, pe, k, se))
+                    {
+                        return true;
+                    }
+                    if (k == se || *k == '/')
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            if (s == se)
+            {
+                return false;
+            }
+
+            if (*p == '?')
+            {
+                if (*s == '/')
+                {
+                    return false;
+                }
+                p++;
+                s++;
+                continue;
+            }
+
+            if (*p == '[')
+            {
+                bool matched = false;
+                const char* classEnd = nullptr;
+                if (MatchGlobClass(p, pe, *s, matched, classEnd))
+                {
+                    if (!matched)
+                    {
+                        return false;
+                    }
+                    p = classEnd;
+                    s++;
+                    continue;
+                }
+            }
+
+            if (!GlobCharEqual(*p, *s))
+            {
+                return false;
+            }
+            p++;
+            s++;
+        }
+        return s == se;
+    }
+
+    // 不含 '/' 的模式匹配文件名，否则匹配相对路径
+    static bool MatchAnyGlob(const vector<string>& patterns, const GB_DirectoryEntry& entry)
+    {
+        const char* pathBegin = entry.pathUtf8.data();
+        const char* pathEnd = pathBegin + entry.pathUtf8.size();
+        for (size_t i = 0; i < patterns.size(); i++)
+        {
+            const string& pattern = patterns[i];
+            const char* s = pattern.find('/') == string::npos ? pathBegin + entry.nameOffset : pathBegin + entry.relativeOffset;
+            if (MatchGlobRange(pattern.data(), pattern.data() + pattern.size(), s, pathEnd))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct DirectoryWalkContext
+    {
+        const GB_DirectoryWalkOptions* options = nullptr;
+        const GB_DirectoryWalker::Callback* callback = nullptr;
+        size_t relativeOffset = 0;
+        atomic<bool> stopRequested{ false };
+
+        // 以下仅在并行模式下使用
+        GB_ThreadPool* threadPool = nullptr;
+        size_t maxPendingTasks = 0;
+        mutex pendingMutex;
+        condition_variable pendingCond;
+        size_t pendingTasks = 0;
+        exception_ptr firstException;
+    };
+
+#if !defined(_WIN32)
+    struct DirIdentity
+    {
+        dev_t device;
+        ino_t inode;
+    };
+
+    class DirStreamGuard
+    {
+    public:
+        explicit DirStreamGuard(DIR* dir) : dir(dir)
+        {
+        }
+
+        ~DirStreamGuard()
+        {
+            if (dir)
+            {
+                ::closedir(dir);
+            }
+        }
+
+        DirStreamGuard(const DirStreamGuard&) = delete;
+        DirStreamGuard& operator=(const DirStreamGuard&) = delete;
+
+    private:
+        DIR* dir;
+    };
+
+    static void ScheduleDirectory(DirectoryWalkContext& ctx, int dirFd, string dirPath, int depth, vector<DirIdentity> ancestors);
+
+    // 遍历一个已打开的目录（接管 dirFd），dirPath 以 '/' 结尾，depth 为其子项的深度
+    static void WalkDirectoryFd(DirectoryWalkContext& ctx, int dirFd, const string& dirPath, int depth, const vector<DirIdentity>& ancestors)
+    {
+        DIR* dir = ::fdopendir(dirFd);
+        if (!dir)
+        {
+            ::close(dirFd);
+            return;
+        }
+        DirStreamGuard guard(dir);
+
+        const GB_DirectoryWalkOptions& options = *ctx.options;
+        const bool canDescend = options.maxDepth < 0 || depth < options.maxDepth;
+        const size_t nameOffset = dirPath.size();
+
+        GB_DirectoryEntry entry;
+        entry.pathUtf8.reserve(nameOffset + 64);
+        entry.pathUtf8 = dirPath;
+        entry.nameOffset = nameOffset;
+        entry.relativeOffset = ctx.relativeOffset;
+        entry.depth = depth;
+
+        while (!ctx.stopRequested.load(memory_order_relaxed))
+        {
+            const dirent* ent = ::readdir(dir);
+            if (!ent)
+            {
+                break;
+            }
+            const char* name = ent->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+            {
+                continue;
+            }
+
+            entry.pathUtf8.resize(nameOffset);
+            entry.pathUtf8.append(name);
+            entry.hasStat = false;
+            entry.type = GB_FileType::Unknown;
+
+#if defined(DT_UNKNOWN)
+            switch (ent->d_type)
+            {
+            case DT_REG:
+                entry.type = GB_FileType::Regular;
+                break;
+            case DT_DIR:
+                entry.type = GB_FileType::Directory;
+                break;
+            case DT_LNK:
+                entry.type = GB_FileType::Symlink;
+                break;
+            case DT_UNKNOWN:
+                break;
+            default:
+                entry.type = GB_FileType::Other;
+                break;
+            }
+#endif
+
+            // d_type 可信时不再 stat；只有文件系统不提供类型、需要跟随符号链接或调用方要求元数据时才 statx
+            const bool resolveLink = entry.type == GB_FileType::Symlink && options.followSymlinks;
+            if (entry.type == GB_FileType::Unknown || resolveLink || options.needStat)
+            {
+                bool ok = StatAt(::dirfd(dir), name, options.followSymlinks, entry.stat);
+                if (!ok && options.followSymlinks)
+                {
+                    ok = StatAt(::dirfd(dir), name, false, entry.stat); // 悬空链接
+                }
+                if (!ok)
+                {
+                    continue;
+                }
+                entry.type = entry.stat.type;
+                entry.hasStat = true;
+            }
+
+            const bool isDir = entry.type == GB_FileType::Directory;
+            if (!options.excludeGlobs.empty() && MatchAnyGlob(options.excludeGlobs, entry))
+            {
+                continue;
+            }
+            if (!isDir && !options.includeGlobs.empty() && !MatchAnyGlob(options.includeGlobs, entry))
+            {
+                continue;
+            }
+            if (options.filter && !options.filter(entry))
+            {
+                continue;
+            }
+            if (isDir ? options.includeDirectories : options.includeFiles)
+            {
+                if (!(*ctx.callback)(entry))
+                {
+                    ctx.stopRequested.store(true, memory_order_relaxed);
+                    break;
+                }
+            }
+
+            if (!isDir || !canDescend)
+            {
+                continue;
+            }
+
+            const int childFd = ::openat(::dirfd(dir), name, O_RDONLY | O_DIRECTORY | O_CLOEXEC | (options.followSymlinks ? 0 : O_NOFOLLOW));
+            if (childFd < 0)
+            {
+                continue;
+            }
+
+            vector<DirIdentity> childAncestors;
+            if (options.followSymlinks)
+            {
+                // 跟随符号链接时用 (dev, ino) 检测环路
+                struct stat st;
+                if (::fstat(childFd, &st) != 0)
+                {
+                    ::close(childFd);
+                    continue;
+                }
+                bool isLoop = false;
+                for (size_t i = 0; i < ancestors.size(); i++)
+                {
+                    if (ancestors[i].device == st.st_dev && ancestors[i].inode == st.st_ino)
+                    {
+                        isLoop = true;
+                        break;
+                    }
+                }
+                if (isLoop)
+                {
+                    ::close(childFd);
+                    continue;
+                }
+                childAncestors = ancestors;
+                childAncestors.push_back(DirIdentity{ st.st_dev, st.st_ino });
+            }
+
+            ScheduleDirectory(ctx, childFd, entry.pathUtf8 + '/', depth + 1, std::move(childAncestors));
+        }
+    }
+
+    static void RunDirectoryTask(DirectoryWalkContext* ctx, int dirFd, const string& dirPath, int depth, const vector<DirIdentity>& ancestors)
+    {
+        try
+        {
+            WalkDirectoryFd(*ctx, dirFd, dirPath, depth, ancestors);
+        }
+        catch (...)
+        {
+            ctx->stopRequested.store(true, memory_order_relaxed);
+            lock_guard<mutex> lock(ctx->pendingMutex);
+            if (!ctx->firstException)
+            {
+                ctx->firstException = current_exception();
+            }
+        }
+
+        lock_guard<mutex> lock(ctx->pendingMutex);
+        ctx->pendingTasks--;
+        if (ctx->pendingTasks == 0)
+        {
+            ctx->pendingCond.notify_all();
+        }
+    }
+
+    static void ScheduleDirectory(DirectoryWalkContext& ctx, int dirFd, string dirPath, int depth, vector<DirIdentity> ancestors)
+    {
+        if (ctx.threadPool)
+        {
+            bool reserved = false;
+            {
+                lock_guard<mutex> lock(ctx.pendingMutex);
+                if (ctx.pendingTasks < ctx.maxPendingTasks)
+                {
+                    ctx.pendingTasks++;
+                    reserved = true;
+                }
+            }
+
+            if (reserved)
+            {
+                if (ctx.threadPool->TryPost(&RunDirectoryTask, &ctx, dirFd, std::move(dirPath), depth, std::move(ancestors)))
+                {
+                    return;
+                }
+
+                lock_guard<mutex> lock(ctx.pendingMutex);
+                ctx.pendingTasks--;
+                if (ctx.pendingTasks == 0)
+                {
+                    ctx.pendingCond.notify_all();
+                }
+            }
+        }
+
+        // 串行模式，或排队任务已足够多：在当前线程内递归，限制同时打开的目录数
+        WalkDirectoryFd(ctx, dirFd, dirPath, depth, ancestors);
+    }
+#else
+    static void ScheduleDirectory(DirectoryWalkContext& ctx, string dirPath, int depth);
+
+    // dirPath 以 '/' 结尾，depth 为其子项的深度
+    static void WalkDirectoryWin(DirectoryWalkContext& ctx, const string& dirPath, int depth)
+    {
+        const wstring pattern = Utf8ToWide(dirPath + "*");
+        if (pattern.empty())
+        {
+            return;
+        }
+
+        WIN32_FIND_DATAW fd;
+        HANDLE h = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (h == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        struct FindGuard
+        {
+            HANDLE handle;
+            ~FindGuard()
+            {
+                FindClose(handle);
+            }
+        } guard = { h };
+
+        const GB_DirectoryWalkOptions& options = *ctx.options;
+        const bool canDescend = options.maxDepth < 0 || depth < options.maxDepth;
+        const size_t nameOffset = dirPath.size();
+
+        GB_DirectoryEntry entry;
+        entry.pathUtf8 = dirPath;
+        entry.nameOffset = nameOffset;
+        entry.relativeOffset = ctx.relativeOffset;
+        entry.depth = depth;
+
+        do
+        {
+            if (ctx.stopRequested.load(memory_order_relaxed))
+            {
+                break;
+            }
+
+            const wchar_t* name = fd.cFileName;
+            if (name[0] == L'.' && (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0')))
+            {
+                continue;
+            }
+
+            entry.pathUtf8.resize(nameOffset);
+            entry.pathUtf8.append(WideToUtf8(name));
+
+            const DWORD attrs = fd.dwFileAttributes;
+            const bool isLink = (attrs & FILE_ATTRIBUTE_REPARSE_POINT) != 0 &&
+                (fd.dwReserved0 == IO_REPARSE_TAG_SYMLINK || fd.dwReserved0 == IO_REPARSE_TAG_MOUNT_POINT);
+            if (isLink && !options.followSymlinks)
+            {
+                entry.type = GB_FileType::Symlink;
+            }
+            else if ((attrs & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            {
+                entry.type = GB_FileType::Directory;
+            }
+            else if ((attrs & FILE_ATTRIBUTE_DEVICE) != 0)
+            {
+                entry.type = GB_FileType::Other;
+            }
+            else
+            {
+                entry.type = GB_FileType::Regular;
+            }
+            // FindExInfoBasic 本身就带大小与时间（对符号链接而言是链接自身的）
+            entry.hasStat = true;
+            FillStatFromAttributes(attrs, fd.nFileSizeHigh, fd.nFileSizeLow, fd.ftLastWriteTime, entry.stat);
+            entry.stat.type = entry.type;
+
+            const bool isDir = entry.type == GB_FileType::Directory;
+            if (!options.excludeGlobs.empty() && MatchAnyGlob(options.excludeGlobs, entry))
+            {
+                continue;
+            }
+            if (!isDir && !options.includeGlobs.empty() && !MatchAnyGlob(options.includeGlobs, entry))
+            {
+                continue;
+            }
+            if (options.filter && !options.filter(entry))
+            {
+                continue;
+            }
+            if (isDir ? options.includeDirectories : options.includeFiles)
+            {
+                if (!(*ctx.callback)(entry))
+                {
+                    ctx.stopRequested.store(true, memory_order_relaxed);
+                    break;
+                }
+            }
+
+            if (isDir && canDescend)
+            {
+                ScheduleDirectory(ctx, entry.pathUtf8 + '/', depth + 1);
+            }
+        } while (FindNextFileW(h, &fd));
+    }
+
+    static void RunDirectoryTask(DirectoryWalkContext* ctx, const string& dirPath, int depth)
+    {
+        try
+        {
+            WalkDirectoryWin(*ctx, dirPath, depth);
+        }
+        catch (...)
+        {
+            ctx->stopRequested.store(true, memory_order_relaxed);
+            lock_guard<mutex> lock(ctx->pendingMutex);
+            if (!ctx->firstException)
+            {
+                ctx->firstException = current_exception();
+            }
+        }
+
+        lock_guard<mutex> lock(ctx->pendingMutex);
+        ctx->pendingTasks--;
+        if (ctx->pendingTasks == 0)
+        {
+            ctx->pendingCond.notify_all();
+        }
+    }
+
+    static void ScheduleDirectory(DirectoryWalkContext& ctx, string dirPath, int depth)
+    {
+        if (ctx.threadPool)
+        {
+            bool reserved = false;
+            {
+                lock_guard<mutex> lock(ctx.pendingMutex);
+                if (ctx.pendingTasks < ctx.maxPendingTasks)
+                {
+                    ctx.pendingTasks++;
+                    reserved = true;
+                }
+            }
+
+            if (reserved)
+            {
+                if (ctx.threadPool->TryPost(&RunDirectoryTask, &ctx, std::move(dirPath), depth))
+                {
+                    return;
+                }
+
+                lock_guard<mutex> lock(ctx.pendingMutex);
+                ctx.pendingTasks--;
+                if (ctx.pendingTasks == 0)
+                {
+                    ctx.pendingCond.notify_all();
+                }
+            }
+        }
+
+        WalkDirectoryWin(ctx, dirPath, depth);
+    }
+#endif
+}
+
+bool GB_MatchGlob(const string& patternUtf8, const string& pathUtf8)
+{
+    const string pattern = internal::ToOutputNorm(patternUtf8);
+    const string path = internal::ToOutputNorm(pathUtf8);
+    return internal::MatchGlobRange(pattern.data(), pattern.data() + pattern.size(), path.data(), path.data() + path.size());
+}
+
+GB_DirectoryWalker::GB_DirectoryWalker()
+{
+}
+
+GB_DirectoryWalker::GB_DirectoryWalker(const GB_DirectoryWalkOptions& options) : options(options)
+{
+}
+
+const GB_DirectoryWalkOptions& GB_DirectoryWalker::GetOptions() const
+{
+    return options;
+}
+
+bool GB_DirectoryWalker::Walk(const string& rootDirUtf8, const Callback& callback) const
+{
+    if (rootDirUtf8.empty() || !callback)
+    {
+        return false;
+    }
+
+    const string rootDir = internal::EnsureTrailingSlash(rootDirUtf8);
+
+    internal::DirectoryWalkContext ctx;
+    ctx.options = &options;
+    ctx.callback = &callback;
+    ctx.relativeOffset = rootDir.size();
+    if (options.threadPool && options.threadPool->GetThreadCount() > 0)
+    {
+        ctx.threadPool = options.threadPool;
+        ctx.maxPendingTasks = options.threadPool->GetThreadCount() * 4;
+    }
+
+#if defined(_WIN32)
+    bool exists = false;
+    bool isDir = false;
+    if (!internal::IsDirByStat(rootDir, exists, isDir) || !exists || !isDir)
+    {
+        return false;
+    }
+#else
+    const int rootFd = ::open(rootDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0)
+    {
+        return false;
+    }
+
+    vector<internal::DirIdentity> ancestors;
+    if (options.followSymlinks)
+    {
+        struct stat st;
+        if (::fstat(rootFd, &st) == 0)
+        {
+            ancestors.push_back(internal::DirIdentity{ st.st_dev, st.st_ino });
+        }
+    }
+#endif
+
+    // 根目录在调用线程上遍历，子目录按需投递到线程池；无论成败都必须等所有已投递任务结束，它们引用了 ctx
+    exception_ptr callerException;
+    try
+    {
+#if defined(_WIN32)
+        internal::WalkDirectoryWin(ctx, rootDir, 0);
+#else
+        internal::WalkDirectoryFd(ctx, rootFd, rootDir, 0, ancestors);
+#endif
+    }
+    catch (...)
+    {
+        ctx.stopRequested.store(true, memory_order_relaxed);
+        callerException = current_exception();
+    }
+
+    if (ctx.threadPool)
+    {
+        unique_lock<mutex> lock(ctx.pendingMutex);
+        ctx.pendingCond.wait(lock, [&]() {
+            return ctx.pendingTasks == 0;
+        });
+    }
+
+    if (callerException)
+    {
+        rethrow_exception(callerException);
+    }
+    if (ctx.firstException)
+    {
+        rethrow_exception(ctx.firstException);
+    }
+    return !ctx.stopRequested.load(memory_order_relaxed);
 }
\ No newline at end of file
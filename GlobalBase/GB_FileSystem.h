@@ -2,9 +2,13 @@
 #define GLOBALBASE_FILESYSTEM_H_H
 
 #include "GlobalBasePort.h"
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
+class GB_ThreadPool;
+
 /**
  * @brief 判断给定 UTF-8 路径是否存在且为“常规文件”（非目录）。
  *
@@ -81,11 +85,26 @@ GLOBALBASE_PORT bool GB_DeleteFile(const std::string& filePathUtf8);
  * @return true  复制成功；
  * @return false 任一端打开失败、读写错误或系统调用失败。
  *
- * @notes Windows 使用 CopyFileW（允许覆盖）；Linux 使用标准 C I/O 流式复制（1MB 缓冲），
- *        不保证保留权限、时间戳、ACL 或扩展属性；不处理稀疏文件/洞洞文件、备用数据流等高级特性。
+ * @notes Windows 使用 CopyFileW（允许覆盖）。
+ *        Linux 依次尝试 FICLONE 引用复制（reflink）、copy_file_range、sendfile，均不可用时才退回用户态 1MB 缓冲复制；
+ *        稀疏文件按 SEEK_DATA/SEEK_HOLE 只复制数据区以保留空洞；保留权限位，不保留时间戳、属主、ACL 或扩展属性。
+ *        源与目标为同一文件时返回 false。
  */
 GLOBALBASE_PORT bool GB_CopyFile(const std::string& srcFilePathUtf8, const std::string& dstFilePathUtf8);
 
+/**
+ * @brief 递归复制目录（允许覆盖已存在的文件）。
+ *
+ * @param srcDirPathUtf8 源目录（UTF-8）。
+ * @param dstDirPathUtf8 目标目录（UTF-8），不存在时自动创建；不能位于源目录之内。
+ * @param threadPool 非空时文件数据在该线程池上并发复制（目录遍历仍在调用线程）；不要在该线程池的 worker 线程中调用。
+ * @return true  全部条目复制成功；
+ * @return false 源目录不存在、目标位于源目录内，或任一条目复制失败（其余条目仍会尽量复制）。
+ *
+ * @remarks 每个文件通过 GB_CopyFile 复制；POSIX 上符号链接按链接本身复制、设备/管道/套接字被跳过，目录权限在内容复制完成后设置。
+ */
+GLOBALBASE_PORT bool GB_CopyDirectory(const std::string& srcDirPathUtf8, const std::string& dstDirPathUtf8, GB_ThreadPool* threadPool = nullptr);
+
 /**
  * @brief 列出目录下所有“文件”的完整路径（不含目录），可选递归。
  *
@@ -104,6 +123,7 @@ GLOBALBASE_PORT std::vector<std::string> GB_GetFilesList(const std::string& dirP
  * @param withExt      true 返回包含扩展名的文件名；false 返回去掉“最后一个点”之后扩展的文件名。
  * @return std::string 文件名（不含路径）。特殊情况：以点开头的隐藏文件（如 ".bashrc"），
  *         当 withExt=false 时将返回空串（因为首个字符即为“最后一个点”）。
+ *         不含任何分隔符的输入（如 "report.pdf"、".bashrc"）原样返回，withExt=false 时也不去掉扩展名。
  *
  * @remarks 内部将反斜杠标准化为“/”后再截取。
  */
@@ -212,5 +232,157 @@ GLOBALBASE_PORT std::string GB_GetRelativePath(const std::string& pathAUtf8, con
  */
 GLOBALBASE_PORT std::string GB_JoinPath(const std::string& leftPathUtf8, const std::string& rightPathUtf8);
 
+enum class GB_FileType
+{
+    Unknown,
+    Regular,
+    Directory,
+    Symlink,
+    Other      // 设备、管道、套接字等
+};
+
+/**
+ * @brief 一次系统调用得到的文件元数据。
+ *
+ * @remarks
+ *  - mode 在 POSIX 上为 st_mode；Windows 上按属性合成（S_IFDIR/S_IFREG | 0444 或 0666）。
+ *  - inode / device 在 Windows 上只有跟随符号链接（需要打开句柄）时才填充，其余情况为 0。
+ */
+struct GB_FileStat
+{
+    bool exists = false;            // 为 false 时其余字段无效
+    GB_FileType type = GB_FileType::Unknown;
+    uint64_t sizeBytes = 0;
+    int64_t modifiedTimeNs = 0;     // Unix 纪元起的纳秒数
+    uint32_t mode = 0;
+    uint64_t inode = 0;
+    uint64_t device = 0;
+
+    bool IsRegularFile() const
+    {
+        return exists && type == GB_FileType::Regular;
+    }
+
+    bool IsDirectory() const
+    {
+        return exists && type == GB_FileType::Directory;
+    }
+};
+
+/**
+ * @brief 获取文件或目录的元数据（Linux 上使用 statx，只请求需要的字段）。
+ *
+ * @param pathUtf8 路径（UTF-8）。
+ * @param statOut 输出；失败时 exists 为 false。
+ * @param followSymlinks 是否跟随符号链接；为 false 时返回链接本身的信息。
+ * @return 路径存在且获取成功返回 true。
+ *
+ * @remarks 需要同时判断存在性、类型、大小、修改时间时，用它代替 GB_IsFileExists + GB_IsDirectoryExists + GB_GetFileSizeByte 等多次调用。
+ */
+GLOBALBASE_PORT bool GB_GetFileStat(const std::string& pathUtf8, GB_FileStat& statOut, bool followSymlinks = true);
+
+/**
+ * @brief 批量获取元数据，结果与 pathsUtf8 一一对应。
+ *
+ * @param pathsUtf8 路径列表（UTF-8）。
+ * @param followSymlinks 是否跟随符号链接。
+ * @param threadPool 非空时分块在该线程池上并行执行（调用线程同样参与）；不要在该线程池的 worker 线程中调用。
+ * @return 与输入等长的结果数组；不存在或无法访问的路径 exists 为 false。
+ */
+GLOBALBASE_PORT std::vector<GB_FileStat> GB_StatMany(const std::vector<std::string>& pathsUtf8, bool followSymlinks = true, GB_ThreadPool* threadPool = nullptr);
+
+/**
+ * @brief 目录遍历得到的一个条目。
+ *
+ * @remarks hasStat 为 false 时 stat 无效：Linux 上只有 d_type 不可用（或开启 needStat、跟随符号链接）时才会额外调用 statx；
+ *          Windows 的 FindNextFileW 本身就带大小与时间，总是有效（inode / device 为 0）。
+ */
+struct GB_DirectoryEntry
+{
+    std::string pathUtf8;           // 完整路径，统一使用“/”，目录不以“/”结尾
+    size_t nameOffset = 0;          // 文件名在 pathUtf8 中的起始位置
+    size_t relativeOffset = 0;      // 相对根目录的路径在 pathUtf8 中的起始位置
+    GB_FileType type = GB_FileType::Unknown;
+    int depth = 0;                  // 根目录的直接子项为 0
+    bool hasStat = false;
+    GB_FileStat stat;
+
+    std::string GetName() const
+    {
+        return pathUtf8.substr(nameOffset);
+    }
+
+    std::string GetRelativePath() const
+    {
+        return pathUtf8.substr(relativeOffset);
+    }
+};
+
+/**
+ * @brief GB_DirectoryWalker 的选项。
+ *
+ * @details
+ *  - 通配符支持 “*”（不跨“/”）、“**”（可跨“/”）、“?” 与 “[abc]”/“[a-z]”；
+ *    不含“/”的模式只与文件名匹配，含“/”的模式与相对根目录的路径匹配。
+ *  - includeGlobs 只作用于文件（为空表示全部）；excludeGlobs 对文件与目录都生效，命中的目录整棵子树被跳过。
+ *  - filter 在通配符之后调用，只能使用条目中已有的信息；对目录返回 false 同样会跳过整棵子树。
+ */
+struct GB_DirectoryWalkOptions
+{
+    std::vector<std::string> includeGlobs;
+    std::vector<std::string> excludeGlobs;
+    int maxDepth = -1;                  // -1 不限；0 只列出根目录的直接子项
+    bool includeFiles = true;           // 是否回调文件（含符号链接、设备等非目录条目）
+    bool includeDirectories = false;    // 是否回调目录
+    bool followSymlinks = false;        // 是否进入指向目录的符号链接
+    bool needStat = false;              // 是否为每个条目获取完整元数据（GB_DirectoryEntry::stat）
+    std::function<bool(const GB_DirectoryEntry&)> filter;
+    GB_ThreadPool* threadPool = nullptr; // 非空时各子目录在该线程池上并行遍历
+};
+
+/**
+ * @brief 目录遍历器：流式回调每个条目，不构造完整的路径列表。
+ *
+ * @details
+ *  - Linux：openat/fdopendir 打开子目录、fstatat 相对目录 fd 取元数据；readdir 的 d_type 有效时不再 stat。
+ *  - Windows：FindFirstFileExW（FindExInfoBasic + FIND_FIRST_EX_LARGE_FETCH）。
+ *  - 提供 threadPool 时，子目录作为任务投递到线程池（排队任务过多时改为在当前线程内递归，以限制同时打开的目录数）。
+ *    此时回调会在多个线程上并发执行，需自行保证线程安全；各条目的回调顺序不确定。
+ *    不要在该线程池的 worker 线程中调用 Walk。
+ *  - 无法打开的子目录会被跳过。
+ */
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+class GLOBALBASE_PORT GB_DirectoryWalker
+{
+public:
+    // 回调返回 false 时尽快停止遍历
+    using Callback = std::function<bool(const GB_DirectoryEntry& entry)>;
+
+    GB_DirectoryWalker();
+    explicit GB_DirectoryWalker(const GB_DirectoryWalkOptions& options);
+
+    const GB_DirectoryWalkOptions& GetOptions() const;
+
+    /**
+     * @return true  遍历完成；
+     * @return false 根目录无法打开，或被回调中止。
+     */
+    bool Walk(const std::string& rootDirUtf8, const Callback& callback) const;
+
+private:
+    GB_DirectoryWalkOptions options;
+};
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+/**
+ * @brief 通配符匹配（规则同 GB_DirectoryWalkOptions），pathUtf8 使用“/”分隔。
+ */
+GLOBALBASE_PORT bool GB_MatchGlob(const std::string& patternUtf8, const std::string& pathUtf8);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,1289 @@
+﻿#include "GB_FileWatcher.h"
+#include "GB_FileSystem.h"
+#include "GB_ThreadPool.h"
+#include "GB_Utf8String.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/*
+    实现要点：
+      - 一个后台监视线程：Linux 上 poll(inotify fd, 唤醒管道)，Windows 上 WaitForMultipleObjects(唤醒事件, 各目录的 OVERLAPPED 事件)。
+      - 内核事件先进入各 watch 的 pending（只由监视线程访问）做合并，时间窗到期后由 Flush 成批交给 Dispatch。
+      - Dispatch：无 callbackPool 时直接在监视线程回调；否则进入 watch 自己的队列，同一时刻每个 watch 至多一个 DrainQueue 任务在跑，
+        因此同一 watch 的回调保持顺序且不会并发。
+      - stateMutex 保护 watches 以及各平台的 watch 表；回调一律在不持有 stateMutex 时执行，回调里可以 AddWatch/RemoveWatch。
+      - Linux 递归监视时遍历目录树（添加内核 watch）不持有 stateMutex，遍历完成后再持锁登记到 dirsByWd。
+      - 回调执行期间持有该 watch 的 callbackMutex，RemoveWatch 置 removed 后获取一次它，即可保证返回后不再回调。
+*/
+
+namespace internal
+{
+    struct PendingFileEvent
+    {
+        GB_FileEvent event;
+        bool dropped = false;
+    };
+
+    struct FileWatchState
+    {
+        int64_t id = 0;
+        string rootDir;     // 被监视的目录，以 '/' 结尾
+        string rootPath;    // 用户传入路径的规范形式，Overflow 等事件使用
+        string fileName;    // 非空时只关心 rootDir 下的该文件
+        bool recursive = false;
+        GB_FileWatcher::Callback callback;
+
+        // 以下仅由监视线程访问
+        vector<PendingFileEvent> pending;
+        unordered_map<string, size_t> pendingIndex;
+        size_t pendingLive = 0;
+        bool pendingOverflowed = false;
+
+        // 等待回调的批次（仅 callbackPool 模式）
+        mutex queueMutex;
+        deque<vector<GB_FileEvent>> queue;
+        size_t queuedEvents = 0;
+        bool dispatching = false;
+
+        mutex callbackMutex;
+        atomic<bool> removed{ false };
+
+        bool MatchesName(const string& name) const
+        {
+            return fileName.empty() || name == fileName;
+        }
+    };
+
+    static thread_local int64_t tlsCallbackWatchId = 0;
+
+    static string NormalizeWatchPath(const string& pathUtf8)
+    {
+        string s = pathUtf8;
+        replace(s.begin(), s.end(), '\\', '/');
+        while (s.size() > 1 && s.back() == '/')
+        {
+            s.pop_back();
+        }
+        return s;
+    }
+
+    static GB_FileEvent MakeOverflowEvent(const FileWatchState& watch)
+    {
+        GB_FileEvent event;
+        event.type = GB_FileEventType::Overflow;
+        event.pathUtf8 = watch.rootPath;
+        event.isDirectory = watch.fileName.empty();
+        event.watchId = watch.id;
+        return event;
+    }
+
+    static void PushPendingEvent(FileWatchState& watch, GB_FileEvent&& event, bool indexed)
+    {
+        event.watchId = watch.id;
+        if (indexed)
+        {
+            watch.pendingIndex[event.pathUtf8] = watch.pending.size();
+        }
+        PendingFileEvent pendingEvent;
+        pendingEvent.event = std::move(event);
+        watch.pending.push_back(std::move(pendingEvent));
+        watch.pendingLive++;
+    }
+
+    static void DropPendingEvent(FileWatchState& watch, unordered_map<string, size_t>::iterator it)
+    {
+        watch.pending[it->second].dropped = true;
+        watch.pendingLive--;
+        watch.pendingIndex.erase(it);
+    }
+
+    // 把事件并入 pending：同一路径在时间窗内的事件按“最终效果”合并
+    static void CoalesceEvent(FileWatchState& watch, GB_FileEvent&& event, size_t maxQueuedEvents)
+    {
+        if (watch.pendingOverflowed)
+        {
+            return;
+        }
+        if (event.type == GB_FileEventType::Overflow || watch.pendingLive >= maxQueuedEvents)
+        {
+            watch.pending.clear();
+            watch.pendingIndex.clear();
+            watch.pendingLive = 0;
+            watch.pendingOverflowed = true;
+            PushPendingEvent(watch, MakeOverflowEvent(watch), false);
+            return;
+        }
+
+        if (event.type == GB_FileEventType::Renamed)
+        {
+            unordered_map<string, size_t>::iterator oldIt = watch.pendingIndex.find(event.oldPathUtf8);
+            if (oldIt != watch.pendingIndex.end() && watch.pending[oldIt->second].event.type == GB_FileEventType::Created)
+            {
+                // 刚创建就被改名（典型的“写临时文件再 rename”）：对调用方而言只是新路径上出现了条目
+                DropPendingEvent(watch, oldIt);
+                event.type = GB_FileEventType::Created;
+                event.oldPathUtf8.clear();
+            }
+            else
+            {
+                if (oldIt != watch.pendingIndex.end())
+                {
+                    watch.pendingIndex.erase(oldIt);
+                }
+                watch.pendingIndex.erase(event.pathUtf8);
+                PushPendingEvent(watch, std::move(event), false);
+                return;
+            }
+        }
+
+        unordered_map<string, size_t>::iterator it = watch.pendingIndex.find(event.pathUtf8);
+        if (it == watch.pendingIndex.end())
+        {
+            PushPendingEvent(watch, std::move(event), true);
+            return;
+        }
+
+        const GB_FileEventType previousType = watch.pending[it->second].event.type;
+        if (previousType == GB_FileEventType::Created)
+        {
+            if (event.type == GB_FileEventType::Deleted)
+            {
+                DropPendingEvent(watch, it);
+            }
+            return; // Created + Modified / Created 仍是 Created
+        }
+        if (previousType == GB_FileEventType::Modified)
+        {
+            if (event.type == GB_FileEventType::Modified)
+            {
+                return;
+            }
+            DropPendingEvent(watch, it);
+        }
+        else if (previousType == GB_FileEventType::Deleted && event.type == GB_FileEventType::Created)
+        {
+            // 删除后重建（部分编辑器的保存方式）：视为内容被修改
+            DropPendingEvent(watch, it);
+            event.type = GB_FileEventType::Modified;
+        }
+        PushPendingEvent(watch, std::move(event), true);
+    }
+
+    static vector<GB_FileEvent> TakePendingEvents(FileWatchState& watch)
+    {
+        vector<GB_FileEvent> batch;
+        batch.reserve(watch.pendingLive);
+        for (size_t i = 0; i < watch.pending.size(); i++)
+        {
+            if (!watch.pending[i].dropped)
+            {
+                batch.push_back(std::move(watch.pending[i].event));
+            }
+        }
+        watch.pending.clear();
+        watch.pendingIndex.clear();
+        watch.pendingLive = 0;
+        watch.pendingOverflowed = false;
+        return batch;
+    }
+
+#if defined(__linux__)
+    static const uint32_t inotifyWatchMask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    struct InotifyDirOwner
+    {
+        int64_t watchId = 0;
+        string dirPath;             // 该 watch 所用写法下的目录路径，以 '/' 结尾
+    };
+
+    struct InotifyWatchedDir
+    {
+        // 关心该目录的 watch。同一目录经不同写法（符号链接、"./" 等）被多个 watch 监视时 inotify 只给一个 wd，
+        // 因此路径随 owner 分别记录，事件按各自的写法上报
+        vector<InotifyDirOwner> owners;
+    };
+
+    // IN_MOVED_FROM 等待与同 cookie 的 IN_MOVED_TO 配对
+    struct InotifyMoveFrom
+    {
+        string name;
+        bool isDirectory = false;
+        vector<InotifyDirOwner> owners;
+    };
+
+    // 不持锁遍历得到的子树：内核 watch 已经添加，尚未登记到 dirsByWd
+    struct InotifySubtree
+    {
+        vector<pair<int, string>> dirs;                 // (wd, 以 '/' 结尾的目录路径)，先序
+        vector<pair<string, bool>> existingEntries;     // (路径, 是否目录)，用于补发 Created
+    };
+
+    // 监视线程上新出现的子目录：先记下，释放 stateMutex 后再遍历
+    struct InotifySubtreeScan
+    {
+        shared_ptr<FileWatchState> watch;
+        string dirPath;             // 以 '/' 结尾
+    };
+
+    static const InotifyDirOwner* FindDirOwner(const vector<InotifyDirOwner>& owners, int64_t watchId)
+    {
+        for (size_t i = 0; i < owners.size(); i++)
+        {
+            if (owners[i].watchId == watchId)
+            {
+                return &owners[i];
+            }
+        }
+        return nullptr;
+    }
+#elif defined(_WIN32)
+    struct WinWatchedDir
+    {
+        shared_ptr<FileWatchState> watch;
+        HANDLE dirHandle = INVALID_HANDLE_VALUE;
+        HANDLE eventHandle = nullptr;
+        OVERLAPPED overlapped;
+        vector<DWORD> buffer;       // ReadDirectoryChangesW 要求 DWORD 对齐
+
+        WinWatchedDir() : buffer(16 * 1024)
+        {
+            ZeroMemory(&overlapped, sizeof(overlapped));
+        }
+
+        ~WinWatchedDir()
+        {
+            if (dirHandle != INVALID_HANDLE_VALUE)
+            {
+                if (CancelIoEx(dirHandle, &overlapped))
+                {
+                    DWORD ignored = 0;
+                    GetOverlappedResult(dirHandle, &overlapped, &ignored, TRUE);
+                }
+                CloseHandle(dirHandle);
+            }
+            if (eventHandle)
+            {
+                CloseHandle(eventHandle);
+            }
+        }
+
+        bool IssueRead()
+        {
+            const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE |
+                FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_CREATION;
+            ResetEvent(eventHandle);
+            ZeroMemory(&overlapped, sizeof(overlapped));
+            overlapped.hEvent = eventHandle;
+            return ReadDirectoryChangesW(dirHandle, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                watch->recursive ? TRUE : FALSE, filter, nullptr, &overlapped, nullptr) != 0;
+        }
+    };
+
+    // WaitForMultipleObjects 最多 64 个句柄，其中一个是唤醒事件
+    static const size_t maxWinWatchCount = MAXIMUM_WAIT_OBJECTS - 1;
+#endif
+}
+
+using internal::FileWatchState;
+
+struct GB_FileWatcher::Impl
+{
+    GB_ThreadPool* callbackPool = nullptr;
+    chrono::milliseconds coalesceWindow;
+    size_t maxQueuedEvents = 0;
+
+    mutable mutex stateMutex;
+    unordered_map<int64_t, shared_ptr<FileWatchState>> watches;
+    int64_t nextWatchId = 1;
+
+    atomic<bool> stopRequested{ false };
+    thread watcherThread;
+
+    // 以下仅由监视线程访问
+    vector<shared_ptr<FileWatchState>> dirtyWatches;
+    bool hasPending = false;
+    chrono::steady_clock::time_point firstPendingTime;
+
+    mutex dispatchMutex;
+    condition_variable dispatchCond;
+    size_t activeDispatchTasks = 0;
+
+#if defined(__linux__)
+    int inotifyFd = -1;
+    int wakePipe[2] = { -1, -1 };
+    unordered_map<int, internal::InotifyWatchedDir> dirsByWd;
+    vector<internal::InotifySubtreeScan> pendingScans;          // 仅监视线程访问
+#elif defined(_WIN32)
+    HANDLE wakeEvent = nullptr;
+    vector<unique_ptr<internal::WinWatchedDir>> activeDirs;     // 仅监视线程访问
+    vector<unique_ptr<internal::WinWatchedDir>> addedDirs;      // 受 stateMutex 保护，等待监视线程接管
+    vector<int64_t> removedWatchIds;                            // 受 stateMutex 保护
+#endif
+
+    Impl(GB_ThreadPool* callbackPool, unsigned int coalesceMs, size_t maxQueuedEvents)
+        : callbackPool(callbackPool), coalesceWindow(coalesceMs), maxQueuedEvents((std::max)(maxQueuedEvents, static_cast<size_t>(1)))
+    {
+    }
+
+    shared_ptr<FileWatchState> FindWatchLocked(int64_t watchId) const
+    {
+        unordered_map<int64_t, shared_ptr<FileWatchState>>::const_iterator it = watches.find(watchId);
+        return it == watches.end() ? shared_ptr<FileWatchState>() : it->second;
+    }
+
+    // 监视线程：事件进入合并窗口
+    void Emit(const shared_ptr<FileWatchState>& watch, GB_FileEvent&& event)
+    {
+        if (!watch || watch->removed.load(memory_order_relaxed))
+        {
+            return;
+        }
+        if (watch->pending.empty())
+        {
+            dirtyWatches.push_back(watch);
+        }
+        internal::CoalesceEvent(*watch, std::move(event), maxQueuedEvents);
+        if (!hasPending)
+        {
+            hasPending = true;
+            firstPendingTime = chrono::steady_clock::now();
+        }
+    }
+
+    void Emit(const shared_ptr<FileWatchState>& watch, GB_FileEventType type, const string& pathUtf8, bool isDirectory)
+    {
+        GB_FileEvent event;
+        event.type = type;
+        event.pathUtf8 = pathUtf8;
+        event.isDirectory = isDirectory;
+        Emit(watch, std::move(event));
+    }
+
+    int GetWaitTimeoutMs() const
+    {
+        if (!hasPending)
+        {
+            return -1;
+        }
+        const chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - firstPendingTime;
+        const int64_t remaining = static_cast<int64_t>(chrono::duration_cast<chrono::milliseconds>(coalesceWindow - elapsed).count());
+        return remaining > 0 ? static_cast<int>(remaining) : 0;
+    }
+
+    // 监视线程：时间窗到期，交付各 watch 合并后的批次（调用时不得持有 stateMutex）
+    void FlushIfDue()
+    {
+        if (!hasPending || GetWaitTimeoutMs() > 0)
+        {
+            return;
+        }
+
+        vector<shared_ptr<FileWatchState>> flushing;
+        flushing.swap(dirtyWatches);
+        hasPending = false;
+        for (size_t i = 0; i < flushing.size(); i++)
+        {
+            vector<GB_FileEvent> batch = internal::TakePendingEvents(*flushing[i]);
+            if (!batch.empty() && !flushing[i]->removed.load(memory_order_relaxed))
+            {
+                Dispatch(flushing[i], std::move(batch));
+            }
+        }
+    }
+
+    void Dispatch(const shared_ptr<FileWatchState>& watch, vector<GB_FileEvent>&& batch)
+    {
+        if (!callbackPool)
+        {
+            Invoke(*watch, batch);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(watch->queueMutex);
+            if (watch->queuedEvents + batch.size() > maxQueuedEvents)
+            {
+                // 回调跟不上：丢弃积压，只告诉调用方需要重新扫描
+                watch->queue.clear();
+                watch->queue.push_back(vector<GB_FileEvent>(1, internal::MakeOverflowEvent(*watch)));
+                watch->queuedEvents = 1;
+            }
+            else
+            {
+                watch->queuedEvents += batch.size();
+                watch->queue.push_back(std::move(batch));
+            }
+            if (watch->dispatching)
+            {
+                return;
+            }
+            watch->dispatching = true;
+        }
+
+        {
+            lock_guard<mutex> lock(dispatchMutex);
+            activeDispatchTasks++;
+        }
+        if (!callbackPool->TryPost(&Impl::DrainQueue, this, watch))
+        {
+            DrainQueue(this, watch);
+        }
+    }
+
+    static void DrainQueue(Impl* impl, const shared_ptr<FileWatchState>& watch)
+    {
+        for (;;)
+        {
+            vector<GB_FileEvent> batch;
+            {
+                lock_guard<mutex> lock(watch->queueMutex);
+                if (watch->queue.empty())
+                {
+                    watch->dispatching = false;
+                    break;
+                }
+                batch = std::move(watch->queue.front());
+                watch->queue.pop_front();
+                watch->queuedEvents -= batch.size();
+            }
+            impl->Invoke(*watch, batch);
+        }
+
+        {
+            lock_guard<mutex> lock(impl->dispatchMutex);
+            impl->activeDispatchTasks--;
+        }
+        impl->dispatchCond.notify_all();
+    }
+
+    void Invoke(FileWatchState& watch, const vector<GB_FileEvent>& batch)
+    {
+        lock_guard<mutex> lock(watch.callbackMutex);
+        if (watch.removed.load(memory_order_acquire) || !watch.callback)
+        {
+            return;
+        }
+
+        const int64_t previousWatchId = internal::tlsCallbackWatchId;
+        internal::tlsCallbackWatchId = watch.id;
+        try
+        {
+            watch.callback(batch);
+        }
+        catch (...)
+        {
+            // 回调异常不能让监视线程或线程池 worker 退出
+        }
+        internal::tlsCallbackWatchId = previousWatchId;
+    }
+
+    void Wake()
+    {
+#if defined(__linux__)
+        if (wakePipe[1] >= 0)
+        {
+            const char byte = 1;
+            const ssize_t ignored = ::write(wakePipe[1], &byte, 1);
+            (void)ignored;
+        }
+#elif defined(_WIN32)
+        if (wakeEvent)
+        {
+            SetEvent(wakeEvent);
+        }
+#endif
+    }
+
+#if defined(__linux__)
+    bool AddDirWatchLocked(const string& dirPath, int64_t ownerId)
+    {
+        const int wd = ::inotify_add_watch(inotifyFd, dirPath.c_str(), internal::inotifyWatchMask);
+        if (wd < 0)
+        {
+            return false;
+        }
+        vector<internal::InotifyDirOwner>& owners = dirsByWd[wd].owners;
+        for (size_t i = 0; i < owners.size(); i++)
+        {
+            if (owners[i].watchId == ownerId)
+            {
+                owners[i].dirPath = dirPath; // 同一 inode 会返回已有 wd，目录被改名后以新路径为准
+                return true;
+            }
+        }
+        internal::InotifyDirOwner owner;
+        owner.watchId = ownerId;
+        owner.dirPath = dirPath;
+        owners.push_back(std::move(owner));
+        return true;
+    }
+
+    // 不持有 stateMutex：为 dirPath 及其全部子目录添加内核 watch，collectEntries 时记下遍历到的全部条目，登记由 RegisterSubtreeLocked 完成。
+    // 先序遍历：子目录的 watch 在列举其内容之前就已生效，两者之间出现的条目不会遗漏（至多重复，由合并去重）
+    bool ScanSubtree(const string& dirPath, bool collectEntries, internal::InotifySubtree& subtree)
+    {
+        const int rootWd = ::inotify_add_watch(inotifyFd, dirPath.c_str(), internal::inotifyWatchMask);
+        if (rootWd < 0)
+        {
+            return false;
+        }
+        subtree.dirs.push_back(make_pair(rootWd, dirPath));
+
+        GB_DirectoryWalkOptions options;
+        options.includeDirectories = true;
+        options.includeFiles = collectEntries;
+        GB_DirectoryWalker(options).Walk(dirPath, [&](const GB_DirectoryEntry& entry) {
+            const bool isDir = entry.type == GB_FileType::Directory;
+            if (isDir)
+            {
+                const string childDir = entry.pathUtf8 + '/';
+                const int wd = ::inotify_add_watch(inotifyFd, childDir.c_str(), internal::inotifyWatchMask);
+                if (wd >= 0)
+                {
+                    subtree.dirs.push_back(make_pair(wd, childDir));
+                }
+            }
+            if (collectEntries)
+            {
+                subtree.existingEntries.push_back(make_pair(entry.pathUtf8, isDir));
+            }
+            return true;
+        });
+        return true;
+    }
+
+    // 把 ScanSubtree 的结果登记到 watch 名下；emitExisting 时对已存在的条目补发 Created（仅监视线程）。
+    // 遍历期间其它 watch 可能已移除了同一 wd 上的内核 watch，这里重新 add 一次（已存在时只返回原 wd）
+    bool RegisterSubtreeLocked(const shared_ptr<FileWatchState>& watch, const internal::InotifySubtree& subtree, bool emitExisting)
+    {
+        if (subtree.dirs.empty() || !AddDirWatchLocked(subtree.dirs[0].second, watch->id))
+        {
+            DiscardSubtreeLocked(subtree);
+            return false;
+        }
+        for (size_t i = 1; i < subtree.dirs.size(); i++)
+        {
+            AddDirWatchLocked(subtree.dirs[i].second, watch->id);
+        }
+        if (emitExisting)
+        {
+            for (size_t i = 0; i < subtree.existingEntries.size(); i++)
+            {
+                Emit(watch, GB_FileEventType::Created, subtree.existingEntries[i].first, subtree.existingEntries[i].second);
+            }
+        }
+        return true;
+    }
+
+    // 不再需要的子树：没有任何 owner 的内核 watch 要移除，否则会一直占用 inotify 配额
+    void DiscardSubtreeLocked(const internal::InotifySubtree& subtree)
+    {
+        for (size_t i = 0; i < subtree.dirs.size(); i++)
+        {
+            if (dirsByWd.find(subtree.dirs[i].first) == dirsByWd.end())
+            {
+                ::inotify_rm_watch(inotifyFd, subtree.dirs[i].first);
+            }
+        }
+    }
+
+    // 监视线程：遍历 pendingScans 中的新目录（不持有 stateMutex），再持锁登记
+    void RunPendingScans()
+    {
+        vector<internal::InotifySubtreeScan> scans;
+        scans.swap(pendingScans);
+        for (size_t i = 0; i < scans.size(); i++)
+        {
+            internal::InotifySubtree subtree;
+            const bool scanned = ScanSubtree(scans[i].dirPath, true, subtree);
+            lock_guard<mutex> lock(stateMutex);
+            if (!scanned)
+            {
+                continue;
+            }
+            if (FindWatchLocked(scans[i].watch->id) == scans[i].watch)
+            {
+                RegisterSubtreeLocked(scans[i].watch, subtree, true);
+            }
+            else
+            {
+                DiscardSubtreeLocked(subtree); // 遍历期间 watch 已被移除
+            }
+        }
+    }
+
+    // 移除 ownerId 在 prefix（为空表示全部）之下的目录 watch
+    void RemoveOwnerLocked(int64_t ownerId, const string& prefix)
+    {
+        for (unordered_map<int, internal::InotifyWatchedDir>::iterator it = dirsByWd.begin(); it != dirsByWd.end();)
+        {
+            vector<internal::InotifyDirOwner>& owners = it->second.owners;
+            for (size_t i = 0; i < owners.size();)
+            {
+                if (owners[i].watchId == ownerId && (prefix.empty() || owners[i].dirPath.compare(0, prefix.size(), prefix) == 0))
+                {
+                    owners.erase(owners.begin() + static_cast<ptrdiff_t>(i));
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            if (owners.empty())
+            {
+                ::inotify_rm_watch(inotifyFd, it->first);
+                it = dirsByWd.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // 目录改名后 inode 与 wd 不变，只需更新记录的路径；先删后加会丢掉两者之间的事件
+    void RenamePrefixLocked(const string& oldPrefix, const string& newPrefix)
+    {
+        for (unordered_map<int, internal::InotifyWatchedDir>::iterator it = dirsByWd.begin(); it != dirsByWd.end(); ++it)
+        {
+            vector<internal::InotifyDirOwner>& owners = it->second.owners;
+            for (size_t i = 0; i < owners.size(); i++)
+            {
+                string& dirPath = owners[i].dirPath;
+                if (dirPath.compare(0, oldPrefix.size(), oldPrefix) == 0)
+                {
+                    dirPath = newPrefix + dirPath.substr(oldPrefix.size());
+                }
+            }
+        }
+        // 同一批事件里新建后又被改名的目录还在等待遍历
+        for (size_t i = 0; i < pendingScans.size(); i++)
+        {
+            string& dirPath = pendingScans[i].dirPath;
+            if (dirPath.compare(0, oldPrefix.size(), oldPrefix) == 0)
+            {
+                dirPath = newPrefix + dirPath.substr(oldPrefix.size());
+            }
+        }
+    }
+
+    void HandleCreatedLocked(const vector<internal::InotifyDirOwner>& owners, const string& name, bool isDir)
+    {
+        for (size_t i = 0; i < owners.size(); i++)
+        {
+            shared_ptr<FileWatchState> watch = FindWatchLocked(owners[i].watchId);
+            if (!watch || !watch->MatchesName(name))
+            {
+                continue;
+            }
+            const string path = owners[i].dirPath + name;
+            Emit(watch, GB_FileEventType::Created, path, isDir);
+            if (isDir && watch->recursive)
+            {
+                internal::InotifySubtreeScan scan;
+                scan.watch = watch;
+                scan.dirPath = path + '/';
+                pendingScans.push_back(std::move(scan));
+            }
+        }
+    }
+
+    void HandleDeletedLocked(const vector<internal::InotifyDirOwner>& owners, const string& name, bool isDir)
+    {
+        for (size_t i = 0; i < owners.size(); i++)
+        {
+            shared_ptr<FileWatchState> watch = FindWatchLocked(owners[i].watchId);
+            if (!watch || !watch->MatchesName(name))
+            {
+                continue;
+            }
+            const string path = owners[i].dirPath + name;
+            Emit(watch, GB_FileEventType::Deleted, path, isDir);
+            if (isDir && watch->recursive)
+            {
+                RemoveOwnerLocked(watch->id, path + '/');
+            }
+        }
+    }
+
+    void HandleRenamedLocked(const internal::InotifyMoveFrom& from, const vector<internal::InotifyDirOwner>& toOwners, const string& toName)
+    {
+        vector<int64_t> watchIds;
+        for (size_t i = 0; i < from.owners.size(); i++)
+        {
+            watchIds.push_back(from.owners[i].watchId);
+        }
+        for (size_t i = 0; i < toOwners.size(); i++)
+        {
+            if (find(watchIds.begin(), watchIds.end(), toOwners[i].watchId) == watchIds.end())
+            {
+                watchIds.push_back(toOwners[i].watchId);
+            }
+        }
+
+        // 路径前缀的改写放到最后：移出某个 watch 的子树要先按旧路径摘掉
+        vector<pair<string, string>> renamedPrefixes;
+        for (size_t i = 0; i < watchIds.size(); i++)
+        {
+            shared_ptr<FileWatchState> watch = FindWatchLocked(watchIds[i]);
+            if (!watch)
+            {
+                continue;
+            }
+            const internal::InotifyDirOwner* fromOwner = internal::FindDirOwner(from.owners, watchIds[i]);
+            const internal::InotifyDirOwner* toOwner = internal::FindDirOwner(toOwners, watchIds[i]);
+            const string oldPath = fromOwner ? fromOwner->dirPath + from.name : string();
+            const string newPath = toOwner ? toOwner->dirPath + toName : string();
+            const bool ownsOld = fromOwner && watch->MatchesName(from.name);
+            const bool ownsNew = toOwner && watch->MatchesName(toName);
+
+            if (fromOwner && toOwner && (ownsOld || ownsNew))
+            {
+                // 监视单个文件时，“临时文件 rename 覆盖目标”也报告为 Renamed
+                GB_FileEvent event;
+                event.type = GB_FileEventType::Renamed;
+                event.pathUtf8 = newPath;
+                event.oldPathUtf8 = oldPath;
+                event.isDirectory = from.isDirectory;
+                Emit(watch, std::move(event));
+            }
+            else if (ownsOld)
+            {
+                Emit(watch, GB_FileEventType::Deleted, oldPath, from.isDirectory);
+            }
+            else if (ownsNew)
+            {
+                Emit(watch, GB_FileEventType::Created, newPath, from.isDirectory);
+            }
+
+            if (!from.isDirectory)
+            {
+                continue;
+            }
+            if (fromOwner && toOwner)
+            {
+                renamedPrefixes.push_back(make_pair(oldPath + '/', newPath + '/'));
+            }
+            else if (fromOwner && watch->recursive)
+            {
+                RemoveOwnerLocked(watch->id, oldPath + '/');
+            }
+            else if (toOwner && watch->recursive)
+            {
+                internal::InotifySubtreeScan scan;
+                scan.watch = watch;
+                scan.dirPath = newPath + '/';
+                pendingScans.push_back(std::move(scan));
+            }
+        }
+
+        for (size_t i = 0; i < renamedPrefixes.size(); i++)
+        {
+            RenamePrefixLocked(renamedPrefixes[i].first, renamedPrefixes[i].second);
+        }
+    }
+
+    void ProcessInotifyBufferLocked(const char* data, size_t length, unordered_map<uint32_t, internal::InotifyMoveFrom>& moves)
+    {
+        size_t offset = 0;
+        while (offset + sizeof(inotify_event) <= length)
+        {
+            const inotify_event* ev = reinterpret_cast<const inotify_event*>(data + offset);
+            offset += sizeof(inotify_event) + ev->len;
+
+            if ((ev->mask & IN_Q_OVERFLOW) != 0)
+            {
+                for (unordered_map<int64_t, shared_ptr<FileWatchState>>::iterator it = watches.begin(); it != watches.end(); ++it)
+                {
+                    Emit(it->second, internal::MakeOverflowEvent(*it->second));
+                }
+                continue;
+            }
+
+            unordered_map<int, internal::InotifyWatchedDir>::iterator dirIt = dirsByWd.find(ev->wd);
+            if (dirIt == dirsByWd.end())
+            {
+                continue;
+            }
+            if ((ev->mask & IN_IGNORED) != 0)
+            {
+                dirsByWd.erase(dirIt);
+                continue;
+            }
+
+            // 处理过程中可能增删 dirsByWd，这里先复制
+            const vector<internal::InotifyDirOwner> owners = dirIt->second.owners;
+            const bool isDir = (ev->mask & IN_ISDIR) != 0;
+            const string name = ev->len > 0 ? string(ev->name) : string();
+
+            if ((ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0)
+            {
+                for (size_t i = 0; i < owners.size(); i++)
+                {
+                    shared_ptr<FileWatchState> watch = FindWatchLocked(owners[i].watchId);
+                    if (watch && watch->fileName.empty() && watch->rootDir == owners[i].dirPath)
+                    {
+                        Emit(watch, GB_FileEventType::Deleted, watch->rootPath, true);
+                    }
+                }
+                continue;
+            }
+
+            if ((ev->mask & IN_MOVED_FROM) != 0)
+            {
+                internal::InotifyMoveFrom& from = moves[ev->cookie];
+                from.name = name;
+                from.isDirectory = isDir;
+                from.owners = owners;
+                continue;
+            }
+            if ((ev->mask & IN_MOVED_TO) != 0)
+            {
+                unordered_map<uint32_t, internal::InotifyMoveFrom>::iterator moveIt = moves.find(ev->cookie);
+                if (moveIt != moves.end())
+                {
+                    const internal::InotifyMoveFrom from = moveIt->second;
+                    moves.erase(moveIt);
+                    HandleRenamedLocked(from, owners, name);
+                }
+                else
+                {
+                    HandleCreatedLocked(owners, name, isDir); // 从监视范围外移入
+                }
+                continue;
+            }
+
+            if ((ev->mask & IN_CREATE) != 0)
+            {
+                HandleCreatedLocked(owners, name, isDir);
+            }
+            else if ((ev->mask & IN_DELETE) != 0)
+            {
+                HandleDeletedLocked(owners, name, isDir);
+            }
+            else if ((ev->mask & (IN_MODIFY | IN_CLOSE_WRITE)) != 0 && !isDir)
+            {
+                for (size_t i = 0; i < owners.size(); i++)
+                {
+                    shared_ptr<FileWatchState> watch = FindWatchLocked(owners[i].watchId);
+                    if (watch && watch->MatchesName(name))
+                    {
+                        Emit(watch, GB_FileEventType::Modified, owners[i].dirPath + name, false);
+                    }
+                }
+            }
+        }
+    }
+
+    void ThreadLoop()
+    {
+        alignas(inotify_event) char buffer[64 * 1024];
+        pollfd fds[2];
+        fds[0].fd = inotifyFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakePipe[0];
+        fds[1].events = POLLIN;
+
+        while (!stopRequested.load(memory_order_acquire))
+        {
+            fds[0].revents = 0;
+            fds[1].revents = 0;
+            const int rc = ::poll(fds, 2, GetWaitTimeoutMs());
+            if (rc < 0 && errno != EINTR)
+            {
+                break;
+            }
+            if ((fds[1].revents & POLLIN) != 0)
+            {
+                char drain[64];
+                while (::read(wakePipe[0], drain, sizeof(drain)) > 0)
+                {
+                }
+            }
+            if (stopRequested.load(memory_order_acquire))
+            {
+                break;
+            }
+
+            if ((fds[0].revents & POLLIN) != 0)
+            {
+                // 一次读空内核队列，使成对的 MOVED_FROM / MOVED_TO 尽量落在同一轮里
+                unordered_map<uint32_t, internal::InotifyMoveFrom> moves;
+                lock_guard<mutex> lock(stateMutex);
+                for (;;)
+                {
+                    const ssize_t n = ::read(inotifyFd, buffer, sizeof(buffer));
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    ProcessInotifyBufferLocked(buffer, static_cast<size_t>(n), moves);
+                }
+                // 没等到 MOVED_TO：移出了监视范围
+                for (unordered_map<uint32_t, internal::InotifyMoveFrom>::iterator it = moves.begin(); it != moves.end(); ++it)
+                {
+                    HandleDeletedLocked(it->second.owners, it->second.name, it->second.isDirectory);
+                }
+            }
+
+            RunPendingScans();
+            FlushIfDue();
+        }
+    }
+#elif defined(_WIN32)
+    void ProcessWinBuffer(internal::WinWatchedDir& dir, DWORD bytes)
+    {
+        const shared_ptr<FileWatchState>& watch = dir.watch;
+        const char* base = reinterpret_cast<const char*>(dir.buffer.data());
+        string renamedFrom;
+        bool hasRenamedFrom = false;
+
+        DWORD offset = 0;
+        for (;;)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(base + offset);
+            string name = GB_WStringToUtf8(wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+            replace(name.begin(), name.end(), '\\', '/');
+            const string path = watch->rootDir + name;
+
+            switch (info->Action)
+            {
+            case FILE_ACTION_ADDED:
+            case FILE_ACTION_MODIFIED:
+                if (watch->MatchesName(name))
+                {
+                    const DWORD attrs = GetFileAttributesW(GB_Utf8ToWString(path).c_str());
+                    const bool isDir = attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+                    if (info->Action == FILE_ACTION_ADDED)
+                    {
+                        Emit(watch, GB_FileEventType::Created, path, isDir);
+                    }
+                    else if (!isDir)
+                    {
+                        Emit(watch, GB_FileEventType::Modified, path, false);
+                    }
+                }
+                break;
+            case FILE_ACTION_REMOVED:
+                if (watch->MatchesName(name))
+                {
+                    Emit(watch, GB_FileEventType::Deleted, path, false);
+                }
+                break;
+            case FILE_ACTION_RENAMED_OLD_NAME:
+                renamedFrom = name;
+                hasRenamedFrom = true;
+                break;
+            case FILE_ACTION_RENAMED_NEW_NAME:
+                if (hasRenamedFrom && (watch->MatchesName(renamedFrom) || watch->MatchesName(name)))
+                {
+                    GB_FileEvent event;
+                    event.type = GB_FileEventType::Renamed;
+                    event.pathUtf8 = path;
+                    event.oldPathUtf8 = watch->rootDir + renamedFrom;
+                    Emit(watch, std::move(event));
+                }
+                else if (!hasRenamedFrom && watch->MatchesName(name))
+                {
+                    Emit(watch, GB_FileEventType::Created, path, false);
+                }
+                hasRenamedFrom = false;
+                break;
+            default:
+                break;
+            }
+
+            if (info->NextEntryOffset == 0 || offset + info->NextEntryOffset >= bytes)
+            {
+                break;
+            }
+            offset += info->NextEntryOffset;
+        }
+    }
+
+    void ApplyWinCommands()
+    {
+        lock_guard<mutex> lock(stateMutex);
+        for (size_t i = 0; i < addedDirs.size(); i++)
+        {
+            activeDirs.push_back(std::move(addedDirs[i]));
+        }
+        addedDirs.clear();
+        for (size_t i = 0; i < removedWatchIds.size(); i++)
+        {
+            for (size_t j = 0; j < activeDirs.size(); j++)
+            {
+                if (activeDirs[j]->watch->id == removedWatchIds[i])
+                {
+                    activeDirs.erase(activeDirs.begin() + static_cast<ptrdiff_t>(j));
+                    break;
+                }
+            }
+        }
+        removedWatchIds.clear();
+    }
+
+    void ThreadLoop()
+    {
+        vector<HANDLE> handles;
+        while (!stopRequested.load(memory_order_acquire))
+        {
+            ApplyWinCommands();
+
+            handles.clear();
+            handles.push_back(wakeEvent);
+            for (size_t i = 0; i < activeDirs.size(); i++)
+            {
+                handles.push_back(activeDirs[i]->eventHandle);
+            }
+
+            const int timeoutMs = GetWaitTimeoutMs();
+            const DWORD rc = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE,
+                timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+            if (stopRequested.load(memory_order_acquire))
+            {
+                break;
+            }
+
+            if (rc > WAIT_OBJECT_0 && rc < WAIT_OBJECT_0 + handles.size())
+            {
+                const size_t index = rc - WAIT_OBJECT_0 - 1;
+                internal::WinWatchedDir& dir = *activeDirs[index];
+                DWORD bytes = 0;
+                const BOOL ok = GetOverlappedResult(dir.dirHandle, &dir.overlapped, &bytes, FALSE);
+                {
+                    lock_guard<mutex> lock(stateMutex);
+                    if (ok && bytes > 0)
+                    {
+                        ProcessWinBuffer(dir, bytes);
+                    }
+                    else
+                    {
+                        Emit(dir.watch, internal::MakeOverflowEvent(*dir.watch)); // 缓冲区溢出（bytes 为 0）或出错
+                    }
+                }
+
+                if (!dir.IssueRead())
+                {
+                    // 通常是被监视的目录已被删除
+                    {
+                        lock_guard<mutex> lock(stateMutex);
+                        if (dir.watch->fileName.empty())
+                        {
+                            Emit(dir.watch, GB_FileEventType::Deleted, dir.watch->rootPath, true);
+                        }
+                    }
+                    activeDirs.erase(activeDirs.begin() + static_cast<ptrdiff_t>(index));
+                }
+            }
+
+            FlushIfDue();
+        }
+        activeDirs.clear();
+    }
+#endif
+};
+
+GB_FileWatcher::GB_FileWatcher(GB_ThreadPool* callbackPool, unsigned int coalesceMs, size_t maxQueuedEvents)
+    : impl(new Impl(callbackPool, coalesceMs, maxQueuedEvents))
+{
+#if defined(__linux__)
+    impl->inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (impl->inotifyFd < 0)
+    {
+        return;
+    }
+    if (::pipe2(impl->wakePipe, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        ::close(impl->inotifyFd);
+        impl->inotifyFd = -1;
+        return;
+    }
+    impl->watcherThread = thread(&Impl::ThreadLoop, impl.get());
+#elif defined(_WIN32)
+    impl->wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!impl->wakeEvent)
+    {
+        return;
+    }
+    impl->watcherThread = thread(&Impl::ThreadLoop, impl.get());
+#endif
+}
+
+GB_FileWatcher::~GB_FileWatcher()
+{
+    impl->stopRequested.store(true, memory_order_release);
+    impl->Wake();
+    if (impl->watcherThread.joinable())
+    {
+        impl->watcherThread.join();
+    }
+
+    {
+        unique_lock<mutex> lock(impl->dispatchMutex);
+        impl->dispatchCond.wait(lock, [&]() {
+            return impl->activeDispatchTasks == 0;
+        });
+    }
+
+#if defined(__linux__)
+    if (impl->inotifyFd >= 0)
+    {
+        ::close(impl->inotifyFd);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (impl->wakePipe[i] >= 0)
+        {
+            ::close(impl->wakePipe[i]);
+        }
+    }
+#elif defined(_WIN32)
+    impl->addedDirs.clear();
+    if (impl->wakeEvent)
+    {
+        CloseHandle(impl->wakeEvent);
+    }
+#endif
+}
+
+bool GB_FileWatcher::IsSupported()
+{
+#if defined(__linux__) || defined(_WIN32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+int64_t GB_FileWatcher::AddWatch(const string& pathUtf8, bool recursive, Callback callback)
+{
+    if (pathUtf8.empty() || !callback || !impl->watcherThread.joinable())
+    {
+        return -1;
+    }
+
+    shared_ptr<FileWatchState> watch = make_shared<FileWatchState>();
+    watch->rootPath = internal::NormalizeWatchPath(pathUtf8);
+    watch->callback = std::move(callback);
+
+    GB_FileStat stat;
+    if (GB_GetFileStat(watch->rootPath, stat) && stat.IsDirectory())
+    {
+        watch->rootDir = watch->rootPath == "/" ? watch->rootPath : watch->rootPath + '/';
+        watch->recursive = recursive;
+    }
+    else
+    {
+        // 文件（可以尚不存在）：监视其所在目录，按文件名过滤
+        watch->rootDir = GB_GetDirectoryPath(watch->rootPath);
+        watch->fileName = GB_GetFileName(watch->rootPath, true);
+        if (watch->rootDir.empty())
+        {
+            watch->rootDir = "./";
+        }
+        if (watch->fileName.empty() || !GB_IsDirectoryExists(watch->rootDir))
+        {
+            return -1;
+        }
+    }
+
+#if defined(__linux__)
+    // 遍历大目录树耗时，放在加锁之前，避免期间阻塞监视线程和其它 AddWatch/RemoveWatch
+    internal::InotifySubtree subtree;
+    if (watch->recursive && !impl->ScanSubtree(watch->rootDir, false, subtree))
+    {
+        return -1;
+    }
+#endif
+
+    lock_guard<mutex> lock(impl->stateMutex);
+    watch->id = impl->nextWatchId++;
+
+#if defined(__linux__)
+    const bool added = watch->recursive ? impl->RegisterSubtreeLocked(watch, subtree, false) : impl->AddDirWatchLocked(watch->rootDir, watch->id);
+    if (!added)
+    {
+        impl->RemoveOwnerLocked(watch->id, string());
+        return -1;
+    }
+#elif defined(_WIN32)
+    if (impl->watches.size() >= internal::maxWinWatchCount)
+    {
+        return -1;
+    }
+    unique_ptr<internal::WinWatchedDir> dir(new internal::WinWatchedDir());
+    dir->watch = watch;
+    dir->dirHandle = CreateFileW(GB_Utf8ToWString(watch->rootDir).c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    dir->eventHandle = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (dir->dirHandle == INVALID_HANDLE_VALUE || !dir->eventHandle || !dir->IssueRead())
+    {
+        return -1;
+    }
+    impl->addedDirs.push_back(std::move(dir));
+    impl->Wake();
+#else
+    return -1;
+#endif
+
+    impl->watches[watch->id] = watch;
+    return watch->id;
+}
+
+bool GB_FileWatcher::RemoveWatch(int64_t watchId)
+{
+    shared_ptr<FileWatchState> watch;
+    {
+        lock_guard<mutex> lock(impl->stateMutex);
+        unordered_map<int64_t, shared_ptr<FileWatchState>>::iterator it = impl->watches.find(watchId);
+        if (it == impl->watches.end())
+        {
+            return false;
+        }
+        watch = it->second;
+        impl->watches.erase(it);
+
+#if defined(__linux__)
+        impl->RemoveOwnerLocked(watchId, string());
+#elif defined(_WIN32)
+        impl->removedWatchIds.push_back(watchId);
+        impl->Wake();
+#endif
+    }
+
+    watch->removed.store(true, memory_order_release);
+    if (internal::tlsCallbackWatchId != watchId)
+    {
+        // 等待可能正在执行的回调结束
+        lock_guard<mutex> wait(watch->callbackMutex);
+    }
+    return true;
+}
+
+size_t GB_FileWatcher::GetWatchCount() const
+{
+    lock_guard<mutex> lock(impl->stateMutex);
+    return impl->watches.size();
+}
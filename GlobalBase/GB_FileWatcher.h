@@ -0,0 +1,77 @@
+﻿#ifndef GLOBALBASE_FILE_WATCHER_H_H
+#define GLOBALBASE_FILE_WATCHER_H_H
+
+#include "GlobalBasePort.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GB_ThreadPool;
+
+enum class GB_FileEventType
+{
+    Created,
+    Modified,
+    Deleted,
+    Renamed,    // oldPathUtf8 -> pathUtf8
+    Overflow    // 内核或本地队列溢出，有事件丢失，调用方应重新扫描被监视的目录
+};
+
+struct GB_FileEvent
+{
+    GB_FileEventType type = GB_FileEventType::Created;
+    std::string pathUtf8;           // 统一使用“/”；Overflow 时为被监视的路径
+    std::string oldPathUtf8;        // 仅 Renamed 有效
+    bool isDirectory = false;       // Windows 上 Deleted / Renamed 事件无法得知，总为 false
+    int64_t watchId = 0;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+/*
+    文件系统变更监视器：目录内容发生变化时回调，代替对大目录的周期性 GB_GetFilesList 全量扫描。
+    - Linux 使用 inotify（一个后台线程 poll 所有 watch）；recursive 时为每个子目录添加 watch，新建/移入的子目录会自动加入，
+      新目录中在 watch 生效前已经出现的条目会补发 Created。
+    - Windows 使用 ReadDirectoryChangesW（recursive 由系统的 bWatchSubtree 实现），最多同时 63 个 watch。
+    - 合并：coalesceMs 时间窗内同一路径的事件会合并（Created + Modified -> Created，Modified 多次 -> 一次，
+      Created + Deleted -> 无，Deleted + Created -> Modified），之后按 watch 成批回调。
+    - 有界：单个 watch 待合并或待回调的事件超过 maxQueuedEvents 时丢弃它们，改为回调一个 Overflow 事件。
+    - 回调默认在后台线程上执行；构造时传入 callbackPool 则投递到该线程池执行。同一 watch 的回调总是串行且保持顺序。
+      回调不应抛出异常（被吞掉）。
+    - 监视单个文件（例如 config.kv）时实际监视其所在目录并按文件名过滤；“写临时文件再 rename 覆盖”的保存方式会得到 Renamed 事件。
+    - RemoveWatch 返回后该 watch 不会再有回调（在其自身回调中调用时除外）；析构时等待所有回调结束。
+*/
+class GLOBALBASE_PORT GB_FileWatcher
+{
+public:
+    using Callback = std::function<void(const std::vector<GB_FileEvent>& events)>;
+
+    explicit GB_FileWatcher(GB_ThreadPool* callbackPool = nullptr, unsigned int coalesceMs = 50, size_t maxQueuedEvents = 65536);
+    ~GB_FileWatcher();
+
+    GB_FileWatcher(const GB_FileWatcher&) = delete;
+    GB_FileWatcher& operator=(const GB_FileWatcher&) = delete;
+
+    // 当前平台是否支持（Linux、Windows）
+    static bool IsSupported();
+
+    // pathUtf8 可以是目录或文件（文件时 recursive 被忽略）。成功返回 watch id（> 0），失败返回 -1
+    int64_t AddWatch(const std::string& pathUtf8, bool recursive, Callback callback);
+    bool RemoveWatch(int64_t watchId);
+    size_t GetWatchCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,800 @@
+﻿#include "GB_Gzip.h"
+#include "GB_IO.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace internal
+{
+    static const uint32_t* GetCrc32Table()
+    {
+        struct Crc32Table
+        {
+            uint32_t values[256];
+
+            Crc32Table()
+            {
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; bit++)
+                    {
+                        crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+                    }
+                    values[i] = crc;
+                }
+            }
+        };
+        static const Crc32Table table;
+        return table.values;
+    }
+
+    // crc 为上一次的返回值，首次传 0
+    static uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, size_t size)
+    {
+        const uint32_t* table = GetCrc32Table();
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    // RFC 1951 3.2.5：长度码 257~285 与距离码 0~29 的基值与附加位数
+    static const uint16_t lengthBase[29] =
+    {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const uint8_t lengthExtraBits[29] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const uint16_t distanceBase[30] =
+    {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+        4097, 6145, 8193, 12289, 16385, 24577
+    };
+    static const uint8_t distanceExtraBits[30] =
+    {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+    // 码长码的发送顺序
+    static const uint8_t codeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    static int LengthSymbolIndex(size_t length)
+    {
+        return static_cast<int>(upper_bound(lengthBase, lengthBase + 29, static_cast<uint16_t>(length)) - lengthBase) - 1;
+    }
+
+    static int DistanceSymbolIndex(size_t distance)
+    {
+        return static_cast<int>(upper_bound(distanceBase, distanceBase + 30, static_cast<uint16_t>(distance)) - distanceBase) - 1;
+    }
+
+    /*
+        按频率构造码长不超过 maxBits 的 Huffman 码长。
+        超长时把频率减半（非零的保持非零）后重建，直到满足限制；对 DEFLATE 的码表规模几轮内即可收敛。
+        至少需要两个非零频率，保证得到完整的前缀码（部分解码器拒绝不完整的码表）。
+    */
+    static void BuildHuffmanLengths(const uint32_t* freq, size_t count, int maxBits, uint8_t* lengths)
+    {
+        vector<uint32_t> weights(freq, freq + count);
+        for (;;)
+        {
+            memset(lengths, 0, count);
+
+            // 节点：前 count 个为叶子，其后为内部节点
+            vector<int> parent(2 * count, -1);
+            typedef pair<uint64_t, int> HeapItem;
+            priority_queue<HeapItem, vector<HeapItem>, greater<HeapItem>> heap;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (weights[i] > 0)
+                {
+                    heap.push(HeapItem(weights[i], static_cast<int>(i)));
+                }
+            }
+
+            int nextNode = static_cast<int>(count);
+            while (heap.size() > 1)
+            {
+                const HeapItem a = heap.top();
+                heap.pop();
+                const HeapItem b = heap.top();
+                heap.pop();
+                parent[a.second] = nextNode;
+                parent[b.second] = nextNode;
+                heap.push(HeapItem(a.first + b.first, nextNode));
+                nextNode++;
+            }
+
+            int maxLength = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (weights[i] == 0)
+                {
+                    continue;
+                }
+                int depth = 0;
+                for (int node = static_cast<int>(i); parent[node] >= 0; node = parent[node])
+                {
+                    depth++;
+                }
+                lengths[i] = static_cast<uint8_t>(depth);
+                maxLength = (std::max)(maxLength, depth);
+            }
+
+            if (maxLength <= maxBits)
+            {
+                return;
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                if (weights[i] > 0)
+                {
+                    weights[i] = (weights[i] + 1) / 2;
+                }
+            }
+        }
+    }
+
+    // 由码长生成规范 Huffman 码（已按位反转，可直接按 LSB 先行写出）
+    static void BuildHuffmanCodes(const uint8_t* lengths, size_t count, uint16_t* codes)
+    {
+        uint16_t lengthCount[16] = { 0 };
+        for (size_t i = 0; i < count; i++)
+        {
+            lengthCount[lengths[i]]++;
+        }
+        lengthCount[0] = 0;
+
+        uint16_t nextCode[16] = { 0 };
+        uint16_t code = 0;
+        for (int bits = 1; bits < 16; bits++)
+        {
+            code = static_cast<uint16_t>((code + lengthCount[bits - 1]) << 1);
+            nextCode[bits] = code;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const int length = lengths[i];
+            if (length == 0)
+            {
+                codes[i] = 0;
+                continue;
+            }
+            uint16_t value = nextCode[length]++;
+            uint16_t reversed = 0;
+            for (int bit = 0; bit < length; bit++)
+            {
+                reversed = static_cast<uint16_t>((reversed << 1) | (value & 1));
+                value >>= 1;
+            }
+            codes[i] = reversed;
+        }
+    }
+
+    // 至少保留两个非零频率，见 BuildHuffmanLengths
+    static void EnsureTwoSymbols(uint32_t* freq, size_t count)
+    {
+        size_t used = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            used += freq[i] > 0 ? 1 : 0;
+        }
+        for (size_t i = 0; i < count && used < 2; i++)
+        {
+            if (freq[i] == 0)
+            {
+                freq[i] = 1;
+                used++;
+            }
+        }
+    }
+
+    /*
+        DEFLATE 编码器：Write 追加原始数据，压缩结果追加到构造时传入的 output；Finish 写出最后一个块并补齐到字节边界。
+        缓冲区为两个窗口大小，前半部分写满后整体前移一个窗口，哈希表中的位置随之调整。
+    */
+    class DeflateEncoder
+    {
+    public:
+        explicit DeflateEncoder(string& outputBytes) : output(outputBytes), buffer(bufferSize), head(hashSize, 0), prev(windowSize, 0)
+        {
+            tokens.reserve(maxBlockTokens);
+        }
+
+        void Write(const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                if (bufferEnd == bufferSize)
+                {
+                    SlideWindow();
+                }
+                const size_t space = bufferSize - bufferEnd;
+                const size_t n = size < space ? size : space;
+                memcpy(buffer.data() + bufferEnd, data, n);
+                bufferEnd += n;
+                data += n;
+                size -= n;
+                Compress(false);
+            }
+        }
+
+        void Finish()
+        {
+            Compress(true);
+            FlushBlock(true);
+            if (bitCount > 0)
+            {
+                output.push_back(static_cast<char>(bitBuffer & 0xFF));
+                bitBuffer = 0;
+                bitCount = 0;
+            }
+        }
+
+    private:
+        static const size_t windowSize = 32768;
+        static const size_t bufferSize = 2 * windowSize;
+        static const size_t minMatch = 3;
+        static const size_t maxMatch = 258;
+        static const size_t minLookahead = maxMatch + minMatch + 1;
+        static const size_t maxDistance = windowSize - minLookahead;
+        static const size_t hashSize = 1 << 15;
+        static const int maxChainLength = 128;
+        static const size_t niceMatchLength = 128;  // 找到这么长的匹配就不再继续找
+        static const size_t maxBlockTokens = 16384;
+
+        struct Token
+        {
+            uint16_t literalOrLength;
+            uint16_t distance;  // 0 表示字面量
+        };
+
+        size_t HashAt(size_t pos) const
+        {
+            const uint8_t* p = buffer.data() + pos;
+            return ((static_cast<size_t>(p[0]) << 10) ^ (static_cast<size_t>(p[1]) << 5) ^ p[2]) & (hashSize - 1);
+        }
+
+        // head/prev 中保存“位置 + 1”，0 表示空
+        void InsertHash(size_t pos)
+        {
+            if (pos + minMatch > bufferEnd)
+            {
+                return;
+            }
+            const size_t hash = HashAt(pos);
+            prev[pos & (windowSize - 1)] = head[hash];
+            head[hash] = static_cast<uint32_t>(pos + 1);
+        }
+
+        size_t FindMatch(size_t pos, size_t& distance) const
+        {
+            if (pos + minMatch > bufferEnd)
+            {
+                return 0;
+            }
+            const size_t available = bufferEnd - pos;
+            const size_t maxLength = available < maxMatch ? available : maxMatch;
+            const size_t limit = pos > maxDistance ? pos - maxDistance : 0;
+            const uint8_t* current = buffer.data() + pos;
+
+            size_t bestLength = minMatch - 1;
+            uint32_t entry = head[HashAt(pos)];
+            for (int chain = 0; entry != 0 && chain < maxChainLength; chain++)
+            {
+                const size_t candidate = entry - 1;
+                if (candidate < limit || candidate >= pos)
+                {
+                    break;
+                }
+                const uint8_t* match = buffer.data() + candidate;
+                if (match[bestLength] == current[bestLength] && match[0] == current[0] && match[1] == current[1])
+                {
+                    size_t length = 2;
+                    while (length < maxLength && match[length] == current[length])
+                    {
+                        length++;
+                    }
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        distance = pos - candidate;
+                        if (length >= niceMatchLength || length == maxLength)
+                        {
+                            break;
+                        }
+                    }
+                }
+                entry = prev[candidate & (windowSize - 1)];
+            }
+            return bestLength >= minMatch ? bestLength : 0;
+        }
+
+        void SlideWindow()
+        {
+            memmove(buffer.data(), buffer.data() + windowSize, bufferEnd - windowSize);
+            bufferEnd -= windowSize;
+            position -= windowSize;
+            for (size_t i = 0; i < head.size(); i++)
+            {
+                head[i] = head[i] > windowSize ? static_cast<uint32_t>(head[i] - windowSize) : 0;
+            }
+            for (size_t i = 0; i < prev.size(); i++)
+            {
+                prev[i] = prev[i] > windowSize ? static_cast<uint32_t>(prev[i] - windowSize) : 0;
+            }
+        }
+
+        // 非 flushing 时保留至少 minLookahead 字节的前瞻，保证匹配不会因数据尚未到达而被截短
+        void Compress(bool isFlushing)
+        {
+            while (position < bufferEnd && (isFlushing || bufferEnd - position >= minLookahead))
+            {
+                size_t distance = 0;
+                const size_t length = FindMatch(position, distance);
+                InsertHash(position);
+
+                // 一步惰性匹配：下一个位置的匹配更长时，当前位置只输出字面量
+                size_t nextDistance = 0;
+                if (length > 0 && length < niceMatchLength && FindMatch(position + 1, nextDistance) > length)
+                {
+                    AddLiteral(buffer[position]);
+                    position++;
+                }
+                else if (length > 0)
+                {
+                    AddMatch(length, distance);
+                    for (size_t i = 1; i < length; i++)
+                    {
+                        InsertHash(position + i);
+                    }
+                    position += length;
+                }
+                else
+                {
+                    AddLiteral(buffer[position]);
+                    position++;
+                }
+
+                if (tokens.size() >= maxBlockTokens)
+                {
+                    FlushBlock(false);
+                }
+            }
+        }
+
+        void AddLiteral(uint8_t value)
+        {
+            Token token = { value, 0 };
+            tokens.push_back(token);
+        }
+
+        void AddMatch(size_t length, size_t distance)
+        {
+            Token token = { static_cast<uint16_t>(length), static_cast<uint16_t>(distance) };
+            tokens.push_back(token);
+        }
+
+        void PutBits(uint32_t value, int count)
+        {
+            bitBuffer |= static_cast<uint64_t>(value) << bitCount;
+            bitCount += count;
+            while (bitCount >= 8)
+            {
+                output.push_back(static_cast<char>(bitBuffer & 0xFF));
+                bitBuffer >>= 8;
+                bitCount -= 8;
+            }
+        }
+
+        void WriteTokens(const uint16_t* literalCodes, const uint8_t* literalLengths, const uint16_t* distanceCodes, const uint8_t* distanceLengths)
+        {
+            for (size_t i = 0; i < tokens.size(); i++)
+            {
+                const Token& token = tokens[i];
+                if (token.distance == 0)
+                {
+                    PutBits(literalCodes[token.literalOrLength], literalLengths[token.literalOrLength]);
+                    continue;
+                }
+
+                const int lengthIndex = LengthSymbolIndex(token.literalOrLength);
+                PutBits(literalCodes[257 + lengthIndex], literalLengths[257 + lengthIndex]);
+                PutBits(token.literalOrLength - lengthBase[lengthIndex], lengthExtraBits[lengthIndex]);
+
+                const int distanceIndex = DistanceSymbolIndex(token.distance);
+                PutBits(distanceCodes[distanceIndex], distanceLengths[distanceIndex]);
+                PutBits(token.distance - distanceBase[distanceIndex], distanceExtraBits[distanceIndex]);
+            }
+            PutBits(literalCodes[256], literalLengths[256]);
+        }
+
+        // 把当前积累的 token 编码为一个块：分别估算动态与固定 Huffman 的位数，取较短者
+        void FlushBlock(bool isFinal)
+        {
+            uint32_t literalFreq[286] = { 0 };
+            uint32_t distanceFreq[30] = { 0 };
+            uint64_t extraBits = 0;
+            for (size_t i = 0; i < tokens.size(); i++)
+            {
+                const Token& token = tokens[i];
+                if (token.distance == 0)
+                {
+                    literalFreq[token.literalOrLength]++;
+                    continue;
+                }
+                const int lengthIndex = LengthSymbolIndex(token.literalOrLength);
+                const int distanceIndex = DistanceSymbolIndex(token.distance);
+                literalFreq[257 + lengthIndex]++;
+                distanceFreq[distanceIndex]++;
+                extraBits += lengthExtraBits[lengthIndex] + distanceExtraBits[distanceIndex];
+            }
+            literalFreq[256] = 1;
+
+            // 动态 Huffman
+            uint32_t literalTreeFreq[286];
+            uint32_t distanceTreeFreq[30];
+            memcpy(literalTreeFreq, literalFreq, sizeof(literalFreq));
+            memcpy(distanceTreeFreq, distanceFreq, sizeof(distanceFreq));
+            EnsureTwoSymbols(literalTreeFreq, 286);
+            EnsureTwoSymbols(distanceTreeFreq, 30);
+
+            uint8_t literalLengths[286];
+            uint8_t distanceLengths[30];
+            BuildHuffmanLengths(literalTreeFreq, 286, 15, literalLengths);
+            BuildHuffmanLengths(distanceTreeFreq, 30, 15, distanceLengths);
+
+            size_t literalCount = 286;
+            while (literalCount > 257 && literalLengths[literalCount - 1] == 0)
+            {
+                literalCount--;
+            }
+            size_t distanceCount = 30;
+            while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0)
+            {
+                distanceCount--;
+            }
+
+            // 码长序列的游程编码：16 重复前一个码长 3~6 次，17 / 18 分别表示 3~10 / 11~138 个 0
+            vector<uint8_t> allLengths(literalLengths, literalLengths + literalCount);
+            allLengths.insert(allLengths.end(), distanceLengths, distanceLengths + distanceCount);
+            vector<pair<uint8_t, uint8_t>> codeLengthSymbols; // (符号, 附加值)
+            for (size_t i = 0; i < allLengths.size();)
+            {
+                const uint8_t value = allLengths[i];
+                size_t run = 1;
+                while (i + run < allLengths.size() && allLengths[i + run] == value)
+                {
+                    run++;
+                }
+                i += run;
+
+                if (value == 0)
+                {
+                    while (run >= 11)
+                    {
+                        const size_t n = (std::min)(run, static_cast<size_t>(138));
+                        codeLengthSymbols.push_back(make_pair(static_cast<uint8_t>(18), static_cast<uint8_t>(n - 11)));
+                        run -= n;
+                    }
+                    if (run >= 3)
+                    {
+                        codeLengthSymbols.push_back(make_pair(static_cast<uint8_t>(17), static_cast<uint8_t>(run - 3)));
+                        run = 0;
+                    }
+                }
+                else
+                {
+                    codeLengthSymbols.push_back(make_pair(value, static_cast<uint8_t>(0)));
+                    run--;
+                    while (run >= 3)
+                    {
+                        const size_t n = (std::min)(run, static_cast<size_t>(6));
+                        codeLengthSymbols.push_back(make_pair(static_cast<uint8_t>(16), static_cast<uint8_t>(n - 3)));
+                        run -= n;
+                    }
+                }
+                for (; run > 0; run--)
+                {
+                    codeLengthSymbols.push_back(make_pair(value, static_cast<uint8_t>(0)));
+                }
+            }
+
+            uint32_t codeLengthFreq[19] = { 0 };
+            for (size_t i = 0; i < codeLengthSymbols.size(); i++)
+            {
+                codeLengthFreq[codeLengthSymbols[i].first]++;
+            }
+            uint32_t codeLengthTreeFreq[19];
+            memcpy(codeLengthTreeFreq, codeLengthFreq, sizeof(codeLengthFreq));
+            EnsureTwoSymbols(codeLengthTreeFreq, 19);
+            uint8_t codeLengthLengths[19];
+            BuildHuffmanLengths(codeLengthTreeFreq, 19, 7, codeLengthLengths);
+
+            size_t codeLengthCount = 19;
+            while (codeLengthCount > 4 && codeLengthLengths[codeLengthOrder[codeLengthCount - 1]] == 0)
+            {
+                codeLengthCount--;
+            }
+
+            uint64_t dynamicBits = 5 + 5 + 4 + 3 * codeLengthCount;
+            for (int i = 0; i < 19; i++)
+            {
+                dynamicBits += static_cast<uint64_t>(codeLengthFreq[i]) * codeLengthLengths[i];
+            }
+            dynamicBits += 2ull * codeLengthFreq[16] + 3ull * codeLengthFreq[17] + 7ull * codeLengthFreq[18];
+            for (int i = 0; i < 286; i++)
+            {
+                dynamicBits += static_cast<uint64_t>(literalFreq[i]) * literalLengths[i];
+            }
+            for (int i = 0; i < 30; i++)
+            {
+                dynamicBits += static_cast<uint64_t>(distanceFreq[i]) * distanceLengths[i];
+            }
+
+            // 固定 Huffman（RFC 1951 3.2.6）
+            uint8_t fixedLiteralLengths[288];
+            for (int i = 0; i < 288; i++)
+            {
+                fixedLiteralLengths[i] = static_cast<uint8_t>(i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8)));
+            }
+            uint8_t fixedDistanceLengths[30];
+            memset(fixedDistanceLengths, 5, sizeof(fixedDistanceLengths));
+            uint64_t fixedBits = 0;
+            for (int i = 0; i < 286; i++)
+            {
+                fixedBits += static_cast<uint64_t>(literalFreq[i]) * fixedLiteralLengths[i];
+            }
+            for (int i = 0; i < 30; i++)
+            {
+                fixedBits += 5ull * distanceFreq[i];
+            }
+
+            PutBits(isFinal ? 1 : 0, 1);
+            if (fixedBits <= dynamicBits)
+            {
+                uint16_t literalCodes[288];
+                uint16_t distanceCodes[30];
+                BuildHuffmanCodes(fixedLiteralLengths, 288, literalCodes);
+                BuildHuffmanCodes(fixedDistanceLengths, 30, distanceCodes);
+                PutBits(1, 2);
+                WriteTokens(literalCodes, fixedLiteralLengths, distanceCodes, fixedDistanceLengths);
+            }
+            else
+            {
+                uint16_t literalCodes[286];
+                uint16_t distanceCodes[30];
+                uint16_t codeLengthCodes[19];
+                BuildHuffmanCodes(literalLengths, 286, literalCodes);
+                BuildHuffmanCodes(distanceLengths, 30, distanceCodes);
+                BuildHuffmanCodes(codeLengthLengths, 19, codeLengthCodes);
+
+                PutBits(2, 2);
+                PutBits(static_cast<uint32_t>(literalCount - 257), 5);
+                PutBits(static_cast<uint32_t>(distanceCount - 1), 5);
+                PutBits(static_cast<uint32_t>(codeLengthCount - 4), 4);
+                for (size_t i = 0; i < codeLengthCount; i++)
+                {
+                    PutBits(codeLengthLengths[codeLengthOrder[i]], 3);
+                }
+                for (size_t i = 0; i < codeLengthSymbols.size(); i++)
+                {
+                    const uint8_t symbol = codeLengthSymbols[i].first;
+                    PutBits(codeLengthCodes[symbol], codeLengthLengths[symbol]);
+                    if (symbol == 16)
+                    {
+                        PutBits(codeLengthSymbols[i].second, 2);
+                    }
+                    else if (symbol == 17)
+                    {
+                        PutBits(codeLengthSymbols[i].second, 3);
+                    }
+                    else if (symbol == 18)
+                    {
+                        PutBits(codeLengthSymbols[i].second, 7);
+                    }
+                }
+                WriteTokens(literalCodes, literalLengths, distanceCodes, distanceLengths);
+            }
+            tokens.clear();
+        }
+
+        string& output;
+        vector<uint8_t> buffer;
+        size_t bufferEnd = 0;
+        size_t position = 0;            // 下一个待编码的字节
+        vector<uint32_t> head;
+        vector<uint32_t> prev;
+        vector<Token> tokens;
+        uint64_t bitBuffer = 0;
+        int bitCount = 0;
+    };
+
+    static void AppendGzipHeader(string& out)
+    {
+        // ID1 ID2 CM=8(deflate) FLG=0 MTIME=0 XFL=0 OS=255(未知)
+        static const unsigned char header[10] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+        out.append(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    static void AppendGzipTrailer(string& out, uint32_t crc, uint64_t inputBytes)
+    {
+        const uint32_t size = static_cast<uint32_t>(inputBytes); // ISIZE 为长度对 2^32 取模
+        for (int i = 0; i < 4; i++)
+        {
+            out.push_back(static_cast<char>((crc >> (8 * i)) & 0xFF));
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static const size_t gzipOutputFlushBytes = 256 * 1024;
+    static const size_t gzipReadBufferBytes = 1024 * 1024;
+}
+
+struct GB_GzipWriter::Impl
+{
+    Impl() : encoder(pending)
+    {
+    }
+
+    GB_AtomicFileWriter file;
+    string pending;                 // 已压缩、尚未交给 file 的字节
+    internal::DeflateEncoder encoder;
+    uint32_t crc = 0;
+    uint64_t inputBytes = 0;
+    bool failed = false;
+};
+
+GB_GzipWriter::GB_GzipWriter()
+{
+}
+
+GB_GzipWriter::GB_GzipWriter(const string& filePathUtf8)
+{
+    Open(filePathUtf8);
+}
+
+GB_GzipWriter::~GB_GzipWriter()
+{
+    Abort();
+}
+
+bool GB_GzipWriter::Open(const string& filePathUtf8)
+{
+    Abort();
+
+    unique_ptr<Impl> newImpl(new Impl());
+    if (!newImpl->file.Open(filePathUtf8))
+    {
+        return false;
+    }
+    internal::AppendGzipHeader(newImpl->pending);
+    impl = std::move(newImpl);
+    return true;
+}
+
+bool GB_GzipWriter::IsOpen() const
+{
+    return impl != nullptr;
+}
+
+bool GB_GzipWriter::Write(const void* data, size_t bytes)
+{
+    if (!impl || impl->failed)
+    {
+        return false;
+    }
+
+    const uint8_t* bytePtr = static_cast<const uint8_t*>(data);
+    impl->crc = internal::UpdateCrc32(impl->crc, bytePtr, bytes);
+    impl->inputBytes += bytes;
+    impl->encoder.Write(bytePtr, bytes);
+    if (impl->pending.size() >= internal::gzipOutputFlushBytes)
+    {
+        impl->failed = !impl->file.Write(impl->pending);
+        impl->pending.clear();
+    }
+    return !impl->failed;
+}
+
+bool GB_GzipWriter::Write(const string& data)
+{
+    return Write(data.data(), data.size());
+}
+
+bool GB_GzipWriter::Close()
+{
+    if (!impl)
+    {
+        return false;
+    }
+
+    unique_ptr<Impl> current = std::move(impl);
+    if (current->failed)
+    {
+        current->file.Abort();
+        return false;
+    }
+    current->encoder.Finish();
+    internal::AppendGzipTrailer(current->pending, current->crc, current->inputBytes);
+    if (!current->file.Write(current->pending))
+    {
+        current->file.Abort();
+        return false;
+    }
+    return current->file.Commit();
+}
+
+void GB_GzipWriter::Abort()
+{
+    if (impl)
+    {
+        impl->file.Abort();
+        impl.reset();
+    }
+}
+
+string GB_GzipCompress(const void* data, size_t bytes)
+{
+    string out;
+    internal::AppendGzipHeader(out);
+    internal::DeflateEncoder encoder(out);
+    encoder.Write(static_cast<const uint8_t*>(data), bytes);
+    encoder.Finish();
+    internal::AppendGzipTrailer(out, internal::UpdateCrc32(0, static_cast<const uint8_t*>(data), bytes), bytes);
+    return out;
+}
+
+string GB_GzipCompress(const string& data)
+{
+    return GB_GzipCompress(data.data(), data.size());
+}
+
+bool GB_GzipCompressFile(const string& srcPathUtf8, const string& dstPathUtf8)
+{
+    GB_FileReader reader;
+    if (!reader.Open(srcPathUtf8))
+    {
+        return false;
+    }
+    GB_GzipWriter writer;
+    if (!writer.Open(dstPathUtf8))
+    {
+        return false;
+    }
+
+    vector<unsigned char> buffer(internal::gzipReadBufferBytes);
+    const uint64_t fileSize = reader.GetFileSize();
+    uint64_t total = 0;
+    for (;;)
+    {
+        const size_t n = reader.Read(buffer.data(), buffer.size());
+        if (n == 0)
+        {
+            break;
+        }
+        if (!writer.Write(buffer.data(), n))
+        {
+            return false;
+        }
+        total += n;
+    }
+    if (total != fileSize)
+    {
+        return false;
+    }
+    return writer.Close();
+}
@@ -0,0 +1,61 @@
+﻿#ifndef GLOBALBASE_GZIP_H_H
+#define GLOBALBASE_GZIP_H_H
+
+#include "GlobalBasePort.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*
+    gzip（RFC 1952）压缩，DEFLATE（RFC 1951）编码为自带实现，不依赖 zlib 或外部 gzip 程序。
+    - LZ77 使用 32 KiB 窗口、哈希链与一步惰性匹配；每个块在动态与固定 Huffman 编码中取较短者。
+    - 压缩率与 gzip -6 接近，输出可被任何标准 gzip / zlib 解压。
+*/
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+/*
+    流式写出 .gz 文件：内容经 GB_AtomicFileWriter 写入临时文件，Close 成功后才原子替换目标文件。
+    未 Close 就析构（或调用 Abort）时目标文件不变。非线程安全。
+*/
+class GLOBALBASE_PORT GB_GzipWriter
+{
+public:
+    GB_GzipWriter();
+    // 打开失败时 IsOpen() 为 false
+    explicit GB_GzipWriter(const std::string& filePathUtf8);
+    ~GB_GzipWriter();
+
+    GB_GzipWriter(const GB_GzipWriter&) = delete;
+    GB_GzipWriter& operator=(const GB_GzipWriter&) = delete;
+
+    // 若已打开另一个文件，先 Abort 它
+    bool Open(const std::string& filePathUtf8);
+    bool IsOpen() const;
+
+    bool Write(const void* data, size_t bytes);
+    bool Write(const std::string& data);
+
+    // 写出剩余数据与 gzip 尾部并提交。无论成败，之后 IsOpen() 为 false
+    bool Close();
+    void Abort();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+// 把内存中的数据压缩为完整的 gzip 字节流
+GLOBALBASE_PORT std::string GB_GzipCompress(const void* data, size_t bytes);
+GLOBALBASE_PORT std::string GB_GzipCompress(const std::string& data);
+
+// 把 srcPathUtf8 压缩为 dstPathUtf8（原子替换）；读取失败或读取期间文件长度变化时返回 false，此时 dstPathUtf8 不变
+GLOBALBASE_PORT bool GB_GzipCompressFile(const std::string& srcPathUtf8, const std::string& dstPathUtf8);
+
+#endif
@@ -1,5 +1,8 @@
 ﻿#include "GB_IO.h"
 #include "GB_FileSystem.h"
+#include "GB_Utf8String.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <limits>
 #include <cstring>
@@ -10,8 +13,11 @@
 #else
 #include <cerrno>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <climits>
 #include <unistd.h>
 #endif
 
@@ -532,28 +538,23 @@ bool GB_WriteBinaryToFile(const GB_ByteBuffer& data, const std::string& filePath
 
 void GB_ByteBufferIO::AppendUInt16LE(GB_ByteBuffer& buffer, uint16_t value)
 {
-    buffer.push_back(static_cast<unsigned char>((value >> 0) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(value));
+    byteio_detail::StoreLE(buffer.data() + offset, value);
 }
 
 void GB_ByteBufferIO::AppendUInt32LE(GB_ByteBuffer& buffer, uint32_t value)
 {
-    buffer.push_back(static_cast<unsigned char>((value >> 0) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 24) & 0xFF));
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(value));
+    byteio_detail::StoreLE(buffer.data() + offset, value);
 }
 
 void GB_ByteBufferIO::AppendUInt64LE(GB_ByteBuffer& buffer, uint64_t value)
 {
-    buffer.push_back(static_cast<unsigned char>((value >> 0) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 24) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 32) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 40) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 48) & 0xFF));
-    buffer.push_back(static_cast<unsigned char>((value >> 56) & 0xFF));
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(value));
+    byteio_detail::StoreLE(buffer.data() + offset, value);
 }
 
 void GB_ByteBufferIO::AppendDoubleLE(GB_ByteBuffer& buffer, double value)
@@ -566,54 +567,61 @@ void GB_ByteBufferIO::AppendDoubleLE(GB_ByteBuffer& buffer, double value)
 
 bool GB_ByteBufferIO::ReadUInt16LE(const GB_ByteBuffer& buffer, size_t& offset, uint16_t& value)
 {
-    if (offset + 2 > buffer.size())
+    return ReadUInt16LE(GB_ByteSpan(buffer), offset, value);
+}
+
+bool GB_ByteBufferIO::ReadUInt16LE(GB_ByteSpan buffer, size_t& offset, uint16_t& value)
+{
+    if (offset > buffer.size() || buffer.size() - offset < sizeof(value))
     {
         return false;
     }
 
-    value = static_cast<uint16_t>(buffer[offset]) | (static_cast<uint16_t>(buffer[offset + 1]) << 8);
-
-    offset += 2;
+    value = byteio_detail::LoadLE<uint16_t>(buffer.data() + offset);
+    offset += sizeof(value);
     return true;
 }
 
 bool GB_ByteBufferIO::ReadUInt32LE(const GB_ByteBuffer& buffer, size_t& offset, uint32_t& value)
 {
-    if (offset + 4 > buffer.size())
+    return ReadUInt32LE(GB_ByteSpan(buffer), offset, value);
+}
+
+bool GB_ByteBufferIO::ReadUInt32LE(GB_ByteSpan buffer, size_t& offset, uint32_t& value)
+{
+    if (offset > buffer.size() || buffer.size() - offset < sizeof(value))
     {
         return false;
     }
 
-    value = static_cast<uint32_t>(buffer[offset]) 
-        | (static_cast<uint32_t>(buffer[offset + 1]) << 8) 
-        | (static_cast<uint32_t>(buffer[offset + 2]) << 16) 
-        | (static_cast<uint32_t>(buffer[offset + 3]) << 24);
-
-    offset += 4;
+    value = byteio_detail::LoadLE<uint32_t>(buffer.data() + offset);
+    offset += sizeof(value);
     return true;
 }
 
 bool GB_ByteBufferIO::ReadUInt64LE(const GB_ByteBuffer& buffer, size_t& offset, uint64_t& value)
 {
-    if (offset + 8 > buffer.size())
+    return ReadUInt64LE(GB_ByteSpan(buffer), offset, value);
+}
+
+bool GB_ByteBufferIO::ReadUInt64LE(GB_ByteSpan buffer, size_t& offset, uint64_t& value)
+{
+    if (offset > buffer.size() || buffer.size() - offset < sizeof(value))
     {
         return false;
     }
 
-    value = static_cast<uint64_t>(buffer[offset])
-        | (static_cast<uint64_t>(buffer[offset + 1]) << 8)
-        | (static_cast<uint64_t>(buffer[offset + 2]) << 16)
-        | (static_cast<uint64_t>(buffer[offset + 3]) << 24)
-        | (static_cast<uint64_t>(buffer[offset + 4]) << 32)
-        | (static_cast<uint64_t>(buffer[offset + 5]) << 40)
-        | (static_cast<uint64_t>(buffer[offset + 6]) << 48)
-        | (static_cast<uint64_t>(buffer[offset + 7]) << 56);
-
-    offset += 8;
+    value = byteio_detail::LoadLE<uint64_t>(buffer.data() + offset);
+    offset += sizeof(value);
     return true;
 }
 
 bool GB_ByteBufferIO::ReadDoubleLE(const GB_ByteBuffer& buffer, size_t& offset, double& value)
+{
+    return ReadDoubleLE(GB_ByteSpan(buffer), offset, value);
+}
+
+bool GB_ByteBufferIO::ReadDoubleLE(GB_ByteSpan buffer, size_t& offset, double& value)
 {
     uint64_t bits = 0;
     if (!ReadUInt64LE(buffer, offset, bits))
@@ -625,6 +633,1519 @@ bool GB_ByteBufferIO::ReadDoubleLE(const GB_ByteBuffer& buffer, size_t& offset,
     return true;
 }
 
+namespace internal
+{
+#ifdef _WIN32
+    // 回退路径：读到 EOF 为止（适用于管道等无法映射的句柄）
+    static bool ReadAllFromHandle(HANDLE fileHandle, GB_ByteBuffer& buffer)
+    {
+        buffer.clear();
+        const DWORD chunkBytes = 1024u * 1024u;
+        for (;;)
+        {
+            const size_t oldSize = buffer.size();
+            buffer.resize(oldSize + chunkBytes);
+            DWORD readBytes = 0;
+            if (!::ReadFile(fileHandle, buffer.data() + oldSize, chunkBytes, &readBytes, nullptr))
+            {
+                if (::GetLastError() == ERROR_BROKEN_PIPE)
+                {
+                    buffer.resize(oldSize);
+                    return true;
+                }
+                buffer.clear();
+                return false;
+            }
+            buffer.resize(oldSize + readBytes);
+            if (readBytes == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    static void PrefetchMappedRange(const void* address, size_t bytes)
+    {
+        // PrefetchVirtualMemory 仅 Windows 8 及以上提供，动态获取以保持对旧系统的兼容
+        // 与 WIN32_MEMORY_RANGE_ENTRY 布局相同；该类型只在 _WIN32_WINNT >= 0x0602 时声明
+        struct MemoryRangeEntry
+        {
+            PVOID VirtualAddress;
+            SIZE_T NumberOfBytes;
+        };
+        typedef BOOL(WINAPI* PrefetchVirtualMemoryFunc)(HANDLE, ULONG_PTR, MemoryRangeEntry*, ULONG);
+        static const PrefetchVirtualMemoryFunc prefetchFunc = reinterpret_cast<PrefetchVirtualMemoryFunc>(
+            reinterpret_cast<void*>(::GetProcAddress(::GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory")));
+        if (prefetchFunc == nullptr || bytes == 0)
+        {
+            return;
+        }
+        MemoryRangeEntry range;
+        range.VirtualAddress = const_cast<void*>(address);
+        range.NumberOfBytes = bytes;
+        (void)prefetchFunc(::GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    static bool ReadAllFromFd(int fd, GB_ByteBuffer& buffer)
+    {
+        buffer.clear();
+        const size_t chunkBytes = 1024u * 1024u;
+        for (;;)
+        {
+            const size_t oldSize = buffer.size();
+            buffer.resize(oldSize + chunkBytes);
+            const ssize_t n = ::read(fd, buffer.data() + oldSize, chunkBytes);
+            if (n < 0)
+            {
+                buffer.resize(oldSize);
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                buffer.clear();
+                return false;
+            }
+            buffer.resize(oldSize + static_cast<size_t>(n));
+            if (n == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    static int AccessHintToMadvise(GB_MappedFile::AccessHint hint)
+    {
+        switch (hint)
+        {
+        case GB_MappedFile::AccessHint::Sequential:
+            return MADV_SEQUENTIAL;
+        case GB_MappedFile::AccessHint::Random:
+            return MADV_RANDOM;
+        case GB_MappedFile::AccessHint::WillNeed:
+            return MADV_WILLNEED;
+        default:
+            return MADV_NORMAL;
+        }
+    }
+#endif
+}
+
+GB_MappedFile::GB_MappedFile()
+{
+}
+
+GB_MappedFile::GB_MappedFile(const std::string& filePathUtf8, AccessHint hint, bool useHugePages)
+{
+    Open(filePathUtf8, hint, useHugePages);
+}
+
+GB_MappedFile::~GB_MappedFile()
+{
+    Close();
+}
+
+GB_MappedFile::GB_MappedFile(GB_MappedFile&& other) noexcept
+{
+    MoveFrom(other);
+}
+
+GB_MappedFile& GB_MappedFile::operator=(GB_MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        MoveFrom(other);
+    }
+    return *this;
+}
+
+void GB_MappedFile::MoveFrom(GB_MappedFile& other)
+{
+    fallbackBuffer.swap(other.fallbackBuffer);
+    isOpen = other.isOpen;
+    size = other.size;
+    mappedAddress = other.mappedAddress;
+    mappingHandle = other.mappingHandle;
+    // vector 交换后内部指针保持不变，data 仍然有效
+    data = other.data;
+
+    other.data = nullptr;
+    other.size = 0;
+    other.isOpen = false;
+    other.mappedAddress = nullptr;
+    other.mappingHandle = nullptr;
+}
+
+bool GB_MappedFile::Open(const std::string& filePathUtf8, AccessHint hint, bool useHugePages)
+{
+    Close();
+    if (filePathUtf8.empty())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    (void)useHugePages; // 文件映射不支持大页
+
+    const std::wstring pathW = GB_Utf8ToWString(filePathUtf8);
+    if (pathW.empty())
+    {
+        return false;
+    }
+
+    DWORD flagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+    if (hint == AccessHint::Sequential)
+    {
+        flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    else if (hint == AccessHint::Random)
+    {
+        flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    HANDLE fileHandle = ::CreateFileW(pathW.c_str(), GENERIC_READ, shareMode, nullptr, OPEN_EXISTING, flagsAndAttributes, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    if (::GetFileType(fileHandle) != FILE_TYPE_DISK)
+    {
+        const bool ok = internal::ReadAllFromHandle(fileHandle, fallbackBuffer);
+        ::CloseHandle(fileHandle);
+        if (!ok)
+        {
+            return false;
+        }
+        data = fallbackBuffer.data();
+        size = fallbackBuffer.size();
+        isOpen = true;
+        return true;
+    }
+
+    LARGE_INTEGER fileSizeLi;
+    if (!::GetFileSizeEx(fileHandle, &fileSizeLi) || fileSizeLi.QuadPart < 0
+        || static_cast<uint64_t>(fileSizeLi.QuadPart) > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+    {
+        ::CloseHandle(fileHandle);
+        return false;
+    }
+
+    if (fileSizeLi.QuadPart == 0)
+    {
+        // 长度为 0 的文件无法创建映射
+        ::CloseHandle(fileHandle);
+        isOpen = true;
+        return true;
+    }
+
+    HANDLE mapping = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(fileHandle); // 映射对象持有文件引用
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        ::CloseHandle(mapping);
+        return false;
+    }
+
+    mappingHandle = mapping;
+    mappedAddress = view;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(fileSizeLi.QuadPart);
+    isOpen = true;
+
+    if (hint == AccessHint::WillNeed)
+    {
+        internal::PrefetchMappedRange(view, size);
+    }
+    return true;
+
+#else
+    int openFlags = O_RDONLY;
+#ifdef O_CLOEXEC
+    openFlags |= O_CLOEXEC;
+#endif
+    const int fd = ::open(filePathUtf8.c_str(), openFlags);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // 特殊文件（管道、字符设备、/proc 下大小为 0 的伪文件）：回退为 read()
+    if (!S_ISREG(st.st_mode) || st.st_size == 0)
+    {
+        const bool ok = internal::ReadAllFromFd(fd, fallbackBuffer);
+        ::close(fd);
+        if (!ok)
+        {
+            return false;
+        }
+        data = fallbackBuffer.data();
+        size = fallbackBuffer.size();
+        isOpen = true;
+        return true;
+    }
+
+    if (static_cast<uint64_t>(st.st_size) > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    void* address = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        // 部分文件系统（如某些 FUSE）不支持 mmap：同样回退为 read()
+        const bool ok = internal::ReadAllFromFd(fd, fallbackBuffer);
+        ::close(fd);
+        if (!ok)
+        {
+            return false;
+        }
+        data = fallbackBuffer.data();
+        size = fallbackBuffer.size();
+        isOpen = true;
+        return true;
+    }
+    ::close(fd); // 映射建立后即可关闭 fd
+
+    mappedAddress = address;
+    data = static_cast<const unsigned char*>(address);
+    size = fileSize;
+    isOpen = true;
+
+#if defined(MADV_HUGEPAGE)
+    if (useHugePages)
+    {
+        (void)::madvise(address, fileSize, MADV_HUGEPAGE);
+    }
+#else
+    (void)useHugePages;
+#endif
+    if (hint != AccessHint::Normal)
+    {
+        (void)::madvise(address, fileSize, internal::AccessHintToMadvise(hint));
+    }
+    return true;
+#endif
+}
+
+void GB_MappedFile::Close()
+{
+#ifdef _WIN32
+    if (mappedAddress != nullptr)
+    {
+        ::UnmapViewOfFile(mappedAddress);
+    }
+    if (mappingHandle != nullptr)
+    {
+        ::CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+#else
+    if (mappedAddress != nullptr)
+    {
+        ::munmap(mappedAddress, size);
+    }
+#endif
+    mappedAddress = nullptr;
+    mappingHandle = nullptr;
+    data = nullptr;
+    size = 0;
+    isOpen = false;
+    GB_ByteBuffer().swap(fallbackBuffer);
+}
+
+bool GB_MappedFile::IsOpen() const
+{
+    return isOpen;
+}
+
+bool GB_MappedFile::IsMapped() const
+{
+    return mappedAddress != nullptr;
+}
+
+const unsigned char* GB_MappedFile::Data() const
+{
+    return data;
+}
+
+size_t GB_MappedFile::Size() const
+{
+    return size;
+}
+
+GB_ByteSpan GB_MappedFile::Span() const
+{
+    return GB_ByteSpan(data, size);
+}
+
+bool GB_MappedFile::Advise(AccessHint hint, size_t offset, size_t length) const
+{
+    if (mappedAddress == nullptr)
+    {
+        return isOpen; // 回退模式下数据已在内存中，提示无意义
+    }
+    if (offset >= size)
+    {
+        return false;
+    }
+    if (length > size - offset)
+    {
+        length = size - offset;
+    }
+
+#ifdef _WIN32
+    if (hint == AccessHint::WillNeed)
+    {
+        internal::PrefetchMappedRange(data + offset, length);
+    }
+    return true;
+#else
+    // madvise 要求起始地址按页对齐
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = offset - offset % pageSize;
+    return ::madvise(const_cast<unsigned char*>(data) + alignedOffset, length + (offset - alignedOffset), internal::AccessHintToMadvise(hint)) == 0;
+#endif
+}
+
+namespace internal
+{
+#ifdef _WIN32
+    // 定位读取：同步句柄上带 OVERLAPPED 偏移的 ReadFile 不依赖文件指针，可并发调用
+    static size_t ReadAtOffset(HANDLE fileHandle, uint64_t offset, void* buffer, size_t bytes)
+    {
+        size_t totalRead = 0;
+        const DWORD chunkBytes = 64u * 1024u * 1024u;
+        while (totalRead < bytes)
+        {
+            const size_t remaining = bytes - totalRead;
+            const DWORD toRead = static_cast<DWORD>(remaining > chunkBytes ? chunkBytes : remaining);
+            const uint64_t readOffset = offset + totalRead;
+
+            OVERLAPPED overlapped;
+            memset(&overlapped, 0, sizeof(overlapped));
+            overlapped.Offset = static_cast<DWORD>(readOffset & 0xFFFFFFFFull);
+            overlapped.OffsetHigh = static_cast<DWORD>(readOffset >> 32);
+
+            DWORD readBytes = 0;
+            if (!::ReadFile(fileHandle, static_cast<unsigned char*>(buffer) + totalRead, toRead, &readBytes, &overlapped) || readBytes == 0)
+            {
+                break; // ERROR_HANDLE_EOF 或其它错误
+            }
+            totalRead += readBytes;
+        }
+        return totalRead;
+    }
 
+    // totalWritten 非空时返回实际写出的字节数（失败时为部分写入的长度）
+    static bool WriteAllToHandle(HANDLE fileHandle, const unsigned char* data, size_t bytes, size_t* totalWritten = nullptr)
+    {
+        const DWORD chunkBytes = 64u * 1024u * 1024u;
+        if (totalWritten)
+        {
+            *totalWritten = 0;
+        }
+        while (bytes > 0)
+        {
+            const DWORD toWrite = static_cast<DWORD>(bytes > chunkBytes ? chunkBytes : bytes);
+            DWORD writtenBytes = 0;
+            if (!::WriteFile(fileHandle, data, toWrite, &writtenBytes, nullptr) || writtenBytes == 0)
+            {
+                return false;
+            }
+            data += writtenBytes;
+            bytes -= writtenBytes;
+            if (totalWritten)
+            {
+                *totalWritten += writtenBytes;
+            }
+        }
+        return true;
+    }
+#else
+    static size_t ReadAtOffset(int fd, uint64_t offset, void* buffer, size_t bytes)
+    {
+        size_t totalRead = 0;
+        const size_t chunkBytes = 64u * 1024u * 1024u;
+        while (totalRead < bytes)
+        {
+            const size_t remaining = bytes - totalRead;
+            const size_t toRead = remaining > chunkBytes ? chunkBytes : remaining;
+            const ssize_t n = ::pread(fd, static_cast<unsigned char*>(buffer) + totalRead, toRead, static_cast<off_t>(offset + totalRead));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            totalRead += static_cast<size_t>(n);
+        }
+        return totalRead;
+    }
 
+    // writev 允许部分写入：按已写字节数推进 iovec 后继续，直到全部写完
+    // totalWritten 非空时返回实际写出的字节数（失败时为部分写入的长度）
+    static bool WriteAllVectored(int fd, iovec* iovs, size_t iovCount, size_t* totalWritten = nullptr)
+    {
+        if (totalWritten)
+        {
+            *totalWritten = 0;
+        }
+#ifdef IOV_MAX
+        const size_t maxIovPerCall = IOV_MAX;
+#else
+        const size_t maxIovPerCall = 1024;
+#endif
+        while (iovCount > 0)
+        {
+            if (iovs->iov_len == 0)
+            {
+                iovs++;
+                iovCount--;
+                continue;
+            }
 
+            const int count = static_cast<int>(iovCount < maxIovPerCall ? iovCount : maxIovPerCall);
+            ssize_t n = ::writev(fd, iovs, count);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (n == 0)
+            {
+                return false;
+            }
+            if (totalWritten)
+            {
+                *totalWritten += static_cast<size_t>(n);
+            }
+
+            while (n > 0 && iovCount > 0)
+            {
+                if (static_cast<size_t>(n) >= iovs->iov_len)
+                {
+                    n -= static_cast<ssize_t>(iovs->iov_len);
+                    iovs++;
+                    iovCount--;
+                }
+                else
+                {
+                    iovs->iov_base = static_cast<char*>(iovs->iov_base) + n;
+                    iovs->iov_len -= static_cast<size_t>(n);
+                    n = 0;
+                }
+            }
+        }
+        return true;
+    }
+#endif
+}
+
+GB_FileReader::GB_FileReader()
+{
+}
+
+GB_FileReader::GB_FileReader(const std::string& filePathUtf8, AccessHint hint, size_t bufferSize)
+{
+    Open(filePathUtf8, hint, bufferSize);
+}
+
+GB_FileReader::~GB_FileReader()
+{
+    Close();
+}
+
+bool GB_FileReader::Open(const std::string& filePathUtf8, AccessHint hint, size_t bufferSize)
+{
+    Close();
+    if (filePathUtf8.empty())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    const std::wstring pathW = GB_Utf8ToWString(filePathUtf8);
+    if (pathW.empty())
+    {
+        return false;
+    }
+
+    DWORD flagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+    if (hint == AccessHint::Sequential)
+    {
+        flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    else if (hint == AccessHint::Random)
+    {
+        flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    HANDLE handle = ::CreateFileW(pathW.c_str(), GENERIC_READ, shareMode, nullptr, OPEN_EXISTING, flagsAndAttributes, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    fileHandle = handle;
+#else
+    int openFlags = O_RDONLY;
+#ifdef O_CLOEXEC
+    openFlags |= O_CLOEXEC;
+#endif
+    fd = ::open(filePathUtf8.c_str(), openFlags);
+    if (fd < 0)
+    {
+        fd = -1;
+        return false;
+    }
+    if (hint != AccessHint::Normal)
+    {
+        (void)Advise(hint);
+    }
+#endif
+
+    buffer.resize(bufferSize);
+    return true;
+}
+
+void GB_FileReader::Close()
+{
+#ifdef _WIN32
+    if (fileHandle != nullptr)
+    {
+        ::CloseHandle(static_cast<HANDLE>(fileHandle));
+        fileHandle = nullptr;
+    }
+#else
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+    GB_ByteBuffer().swap(buffer);
+    bufferFileOffset = 0;
+    bufferPos = 0;
+    bufferLength = 0;
+    position = 0;
+}
+
+bool GB_FileReader::IsOpen() const
+{
+#ifdef _WIN32
+    return fileHandle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+uint64_t GB_FileReader::GetFileSize() const
+{
+#ifdef _WIN32
+    LARGE_INTEGER fileSizeLi;
+    if (fileHandle == nullptr || !::GetFileSizeEx(static_cast<HANDLE>(fileHandle), &fileSizeLi) || fileSizeLi.QuadPart < 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(fileSizeLi.QuadPart);
+#else
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0 || st.st_size < 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(st.st_size);
+#endif
+}
+
+size_t GB_FileReader::Read(void* dst, size_t bytes)
+{
+    if (!IsOpen() || dst == nullptr)
+    {
+        return 0;
+    }
+
+    unsigned char* out = static_cast<unsigned char*>(dst);
+    size_t totalRead = 0;
+    while (totalRead < bytes)
+    {
+        if (bufferPos < bufferLength)
+        {
+            const size_t n = std::min(bytes - totalRead, bufferLength - bufferPos);
+            memcpy(out + totalRead, buffer.data() + bufferPos, n);
+            bufferPos += n;
+            totalRead += n;
+            position += n;
+            continue;
+        }
+
+        const size_t remaining = bytes - totalRead;
+        if (remaining >= buffer.size())
+        {
+            // 大块读取绕过缓冲，直接读入调用方内存
+            const size_t n = ReadAt(position, out + totalRead, remaining);
+            totalRead += n;
+            position += n;
+            break;
+        }
+
+        bufferFileOffset = position;
+        bufferPos = 0;
+        bufferLength = ReadAt(position, buffer.data(), buffer.size());
+        if (bufferLength == 0)
+        {
+            break;
+        }
+    }
+    return totalRead;
+}
+
+bool GB_FileReader::ReadExact(void* dst, size_t bytes)
+{
+    return Read(dst, bytes) == bytes;
+}
+
+bool GB_FileReader::Seek(uint64_t offset)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    // 目标仍在缓冲范围内时只移动缓冲位置
+    if (offset >= bufferFileOffset && offset <= bufferFileOffset + bufferLength)
+    {
+        bufferPos = static_cast<size_t>(offset - bufferFileOffset);
+    }
+    else
+    {
+        bufferFileOffset = offset;
+        bufferPos = 0;
+        bufferLength = 0;
+    }
+    position = offset;
+    return true;
+}
+
+uint64_t GB_FileReader::Tell() const
+{
+    return position;
+}
+
+size_t GB_FileReader::ReadAt(uint64_t offset, void* dst, size_t bytes) const
+{
+    if (!IsOpen() || dst == nullptr || bytes == 0)
+    {
+        return 0;
+    }
+#ifdef _WIN32
+    return internal::ReadAtOffset(static_cast<HANDLE>(fileHandle), offset, dst, bytes);
+#else
+    return internal::ReadAtOffset(fd, offset, dst, bytes);
+#endif
+}
+
+bool GB_FileReader::Advise(AccessHint hint, uint64_t offset, uint64_t length) const
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+#if defined(_WIN32) || !defined(POSIX_FADV_SEQUENTIAL)
+    (void)hint;
+    (void)offset;
+    (void)length;
+    return true;
+#else
+    int advice = POSIX_FADV_NORMAL;
+    switch (hint)
+    {
+    case AccessHint::Sequential:
+        advice = POSIX_FADV_SEQUENTIAL;
+        break;
+    case AccessHint::Random:
+        advice = POSIX_FADV_RANDOM;
+        break;
+    case AccessHint::WillNeed:
+        advice = POSIX_FADV_WILLNEED;
+        break;
+    default:
+        break;
+    }
+    return ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), advice) == 0;
+#endif
+}
+
+GB_FileWriter::GB_FileWriter()
+{
+}
+
+GB_FileWriter::GB_FileWriter(const std::string& filePathUtf8, bool appendMode, size_t bufferSize)
+{
+    Open(filePathUtf8, appendMode, bufferSize);
+}
+
+GB_FileWriter::~GB_FileWriter()
+{
+    Close();
+}
+
+bool GB_FileWriter::Open(const std::string& filePathUtf8, bool appendMode, size_t bufferSize)
+{
+    Close();
+    if (filePathUtf8.empty())
+    {
+        return false;
+    }
+
+    const char lastChar = filePathUtf8.back();
+    if (lastChar == '/' || lastChar == '\\')
+    {
+        return false;
+    }
+
+    const std::string dirPathUtf8 = GB_GetDirectoryPath(filePathUtf8);
+    if (!dirPathUtf8.empty() && !GB_CreateDirectory(dirPathUtf8))
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    const std::wstring pathW = GB_Utf8ToWString(filePathUtf8);
+    if (pathW.empty())
+    {
+        return false;
+    }
+
+    const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    HANDLE handle = ::CreateFileW(pathW.c_str(), GENERIC_WRITE, shareMode, nullptr,
+        appendMode ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    if (appendMode)
+    {
+        LARGE_INTEGER zero;
+        zero.QuadPart = 0;
+        if (!::SetFilePointerEx(handle, zero, nullptr, FILE_END))
+        {
+            ::CloseHandle(handle);
+            return false;
+        }
+    }
+    fileHandle = handle;
+#else
+    int openFlags = O_WRONLY | O_CREAT | (appendMode ? O_APPEND : O_TRUNC);
+#ifdef O_CLOEXEC
+    openFlags |= O_CLOEXEC;
+#endif
+    fd = ::open(filePathUtf8.c_str(), openFlags, 0644);
+    if (fd < 0)
+    {
+        fd = -1;
+        return false;
+    }
+#endif
+
+    buffer.resize(bufferSize);
+    bufferUsed = 0;
+    writtenBytes = 0;
+    return true;
+}
+
+bool GB_FileWriter::Close()
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    bool ok = Flush();
+#ifdef _WIN32
+    if (!::CloseHandle(static_cast<HANDLE>(fileHandle)))
+    {
+        ok = false;
+    }
+    fileHandle = nullptr;
+#else
+    // POSIX：close() 若因信号中断返回 EINTR，fd 状态 unspecified，不应盲目重试
+    if (::close(fd) != 0)
+    {
+        ok = false;
+    }
+    fd = -1;
+#endif
+    GB_ByteBuffer().swap(buffer);
+    bufferUsed = 0;
+    return ok;
+}
+
+bool GB_FileWriter::IsOpen() const
+{
+#ifdef _WIN32
+    return fileHandle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+bool GB_FileWriter::Write(const void* data, size_t bytes)
+{
+    const GB_ByteSpan span(static_cast<const unsigned char*>(data), bytes);
+    return WriteV(&span, 1);
+}
+
+bool GB_FileWriter::Write(const std::string& data)
+{
+    return Write(data.data(), data.size());
+}
+
+bool GB_FileWriter::WriteV(const GB_ByteSpan* spans, size_t spanCount)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < spanCount; i++)
+    {
+        totalBytes += spans[i].size();
+    }
+
+    if (bufferUsed + totalBytes <= buffer.size())
+    {
+        for (size_t i = 0; i < spanCount; i++)
+        {
+            if (!spans[i].empty())
+            {
+                memcpy(buffer.data() + bufferUsed, spans[i].data(), spans[i].size());
+                bufferUsed += spans[i].size();
+            }
+        }
+        writtenBytes += totalBytes;
+        return true;
+    }
+
+    if (!WriteBufferedAndSpans(spans, spanCount))
+    {
+        return false;
+    }
+    writtenBytes += totalBytes;
+    return true;
+}
+
+// 缓冲内容在前、spans 在后，一次性写出；成功后清空缓冲。
+// 失败时已写出的那部分缓冲从缓冲中去掉，之后的 Flush 不会把它们再写一遍
+bool GB_FileWriter::WriteBufferedAndSpans(const GB_ByteSpan* spans, size_t spanCount)
+{
+    size_t writtenBytesThisCall = 0;
+#ifdef _WIN32
+    // 普通缓冲句柄不支持 WriteFileGather，逐段写出
+    bool ok = bufferUsed == 0 || internal::WriteAllToHandle(static_cast<HANDLE>(fileHandle), buffer.data(), bufferUsed, &writtenBytesThisCall);
+    if (ok)
+    {
+        writtenBytesThisCall = bufferUsed;
+    }
+    for (size_t i = 0; ok && i < spanCount; i++)
+    {
+        ok = internal::WriteAllToHandle(static_cast<HANDLE>(fileHandle), spans[i].data(), spans[i].size());
+    }
+#else
+    std::vector<iovec> iovs;
+    iovs.reserve(spanCount + 1);
+    if (bufferUsed > 0)
+    {
+        iovec iov;
+        iov.iov_base = buffer.data();
+        iov.iov_len = bufferUsed;
+        iovs.push_back(iov);
+    }
+    for (size_t i = 0; i < spanCount; i++)
+    {
+        iovec iov;
+        iov.iov_base = const_cast<unsigned char*>(spans[i].data());
+        iov.iov_len = spans[i].size();
+        iovs.push_back(iov);
+    }
+    const bool ok = iovs.empty() || internal::WriteAllVectored(fd, iovs.data(), iovs.size(), &writtenBytesThisCall);
+#endif
+    if (ok || writtenBytesThisCall >= bufferUsed)
+    {
+        bufferUsed = 0;
+    }
+    else if (writtenBytesThisCall > 0)
+    {
+        bufferUsed -= writtenBytesThisCall;
+        memmove(buffer.data(), buffer.data() + writtenBytesThisCall, bufferUsed);
+    }
+    return ok;
+}
+
+bool GB_FileWriter::Flush()
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+    if (bufferUsed == 0)
+    {
+        return true;
+    }
+    return WriteBufferedAndSpans(nullptr, 0);
+}
+
+bool GB_FileWriter::Sync(bool dataOnly)
+{
+    if (!Flush())
+    {
+        return false;
+    }
+#ifdef _WIN32
+    (void)dataOnly;
+    return ::FlushFileBuffers(static_cast<HANDLE>(fileHandle)) != FALSE;
+#elif defined(__linux__)
+    return (dataOnly ? ::fdatasync(fd) : ::fsync(fd)) == 0;
+#else
+    (void)dataOnly;
+    return ::fsync(fd) == 0;
+#endif
+}
+
+uint64_t GB_FileWriter::GetWrittenBytes() const
+{
+    return writtenBytes;
+}
+
+
+namespace internal
+{
+    // O_DIRECT / FILE_FLAG_NO_BUFFERING 要求缓冲地址、长度、偏移按扇区对齐，4 KiB 覆盖常见设备
+    static const size_t directIoAlignment = 4096;
+
+    static std::atomic<uint64_t> atomicWriteSequence(0);
+
+    // 同目录下的临时文件名：进程号 + 进程内序号，多线程并发写同一目标也不会冲突
+    static std::string MakeAtomicTempPath(const std::string& targetPath)
+    {
+#ifdef _WIN32
+        const unsigned long processId = static_cast<unsigned long>(::GetCurrentProcessId());
+#else
+        const unsigned long processId = static_cast<unsigned long>(::getpid());
+#endif
+        const unsigned long long sequence = static_cast<unsigned long long>(atomicWriteSequence.fetch_add(1, std::memory_order_relaxed));
+        return targetPath + ".tmp." + std::to_string(processId) + "." + std::to_string(sequence);
+    }
+
+    static std::string GetParentDirectory(const std::string& filePathUtf8)
+    {
+        std::string dirPath = GB_GetDirectoryPath(filePathUtf8);
+        if (dirPath.empty())
+        {
+            return ".";
+        }
+        while (dirPath.size() > 1 && dirPath.back() == '/')
+        {
+            dirPath.pop_back();
+        }
+        return dirPath;
+    }
+
+    static bool SyncDirectory(const std::string& dirPath)
+    {
+#ifdef _WIN32
+        (void)dirPath; // NTFS 的目录项随 MOVEFILE_WRITE_THROUGH 落盘，没有目录 fsync
+        return true;
+#else
+        int openFlags = O_RDONLY;
+#ifdef O_DIRECTORY
+        openFlags |= O_DIRECTORY;
+#endif
+#ifdef O_CLOEXEC
+        openFlags |= O_CLOEXEC;
+#endif
+        const int dirFd = ::open(dirPath.c_str(), openFlags);
+        if (dirFd < 0)
+        {
+            return false;
+        }
+        const bool ok = ::fsync(dirFd) == 0;
+        ::close(dirFd);
+        return ok;
+#endif
+    }
+}
+
+GB_AtomicCommitGroup::GB_AtomicCommitGroup()
+{
+}
+
+GB_AtomicCommitGroup::~GB_AtomicCommitGroup()
+{
+    if (!pendingDirectories.empty())
+    {
+        Commit();
+    }
+}
+
+bool GB_AtomicCommitGroup::Commit()
+{
+    bool ok = true;
+    for (size_t i = 0; i < pendingDirectories.size(); i++)
+    {
+        if (!internal::SyncDirectory(pendingDirectories[i]))
+        {
+            ok = false;
+        }
+    }
+    pendingDirectories.clear();
+    return ok;
+}
+
+size_t GB_AtomicCommitGroup::GetPendingDirectoryCount() const
+{
+    return pendingDirectories.size();
+}
+
+void GB_AtomicCommitGroup::AddDirectory(const std::string& dirPath)
+{
+    if (std::find(pendingDirectories.begin(), pendingDirectories.end(), dirPath) == pendingDirectories.end())
+    {
+        pendingDirectories.push_back(dirPath);
+    }
+}
+
+GB_AtomicFileWriter::GB_AtomicFileWriter()
+{
+}
+
+GB_AtomicFileWriter::GB_AtomicFileWriter(const std::string& filePathUtf8, const GB_AtomicWriteOptions& options)
+{
+    Open(filePathUtf8, options);
+}
+
+GB_AtomicFileWriter::~GB_AtomicFileWriter()
+{
+    Abort();
+}
+
+bool GB_AtomicFileWriter::Open(const std::string& filePathUtf8, const GB_AtomicWriteOptions& options)
+{
+    Abort();
+    if (filePathUtf8.empty())
+    {
+        return false;
+    }
+
+    const char lastChar = filePathUtf8.back();
+    if (lastChar == '/' || lastChar == '\\')
+    {
+        return false;
+    }
+
+    const std::string dirPathUtf8 = GB_GetDirectoryPath(filePathUtf8);
+    if (!dirPathUtf8.empty() && !GB_CreateDirectory(dirPathUtf8))
+    {
+        return false;
+    }
+
+    const std::string tempPathUtf8 = internal::MakeAtomicTempPath(filePathUtf8);
+    bool directIo = options.directIo;
+
+#ifdef _WIN32
+    const std::wstring tempPathW = GB_Utf8ToWString(tempPathUtf8);
+    if (tempPathW.empty())
+    {
+        return false;
+    }
+
+    const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_DELETE;
+    const DWORD baseFlags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    if (directIo)
+    {
+        handle = ::CreateFileW(tempPathW.c_str(), GENERIC_WRITE, shareMode, nullptr, CREATE_NEW,
+            baseFlags | FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, nullptr);
+    }
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        directIo = false;
+        handle = ::CreateFileW(tempPathW.c_str(), GENERIC_WRITE, shareMode, nullptr, CREATE_NEW, baseFlags, nullptr);
+    }
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    fileHandle = handle;
+#else
+    // 显式权限（或沿用目标原有权限）用 fchmod 设置，不受 umask 影响；否则按 0666 & ~umask 创建
+    bool hasExplicitMode = false;
+    mode_t explicitMode = 0;
+    if (options.permissions >= 0)
+    {
+        hasExplicitMode = true;
+        explicitMode = static_cast<mode_t>(options.permissions) & 07777;
+    }
+    else
+    {
+        struct stat targetStat;
+        if (::stat(filePathUtf8.c_str(), &targetStat) == 0 && S_ISREG(targetStat.st_mode))
+        {
+            hasExplicitMode = true;
+            explicitMode = targetStat.st_mode & 07777;
+        }
+    }
+
+    int openFlags = O_WRONLY | O_CREAT | O_EXCL;
+#ifdef O_CLOEXEC
+    openFlags |= O_CLOEXEC;
+#endif
+    const mode_t createMode = hasExplicitMode ? 0600 : 0666;
+    int newFd = -1;
+#ifdef O_DIRECT
+    if (directIo)
+    {
+        newFd = ::open(tempPathUtf8.c_str(), openFlags | O_DIRECT, createMode);
+    }
+#endif
+    if (newFd < 0)
+    {
+        // tmpfs 等不支持 O_DIRECT 时返回 EINVAL，退回普通写入
+        directIo = false;
+        newFd = ::open(tempPathUtf8.c_str(), openFlags, createMode);
+    }
+    if (newFd < 0)
+    {
+        return false;
+    }
+    if (hasExplicitMode && ::fchmod(newFd, explicitMode) != 0)
+    {
+        ::close(newFd);
+        ::unlink(tempPathUtf8.c_str());
+        return false;
+    }
+    fd = newFd;
+#endif
+
+    targetPath = filePathUtf8;
+    tempPath = tempPathUtf8;
+    this->options = options;
+    usingDirectIo = directIo;
+
+    const size_t alignment = internal::directIoAlignment;
+    size_t capacity = options.bufferSize > 0 ? options.bufferSize : alignment;
+    if (usingDirectIo)
+    {
+        capacity = (capacity + alignment - 1) / alignment * alignment;
+    }
+    bufferStorage.resize(capacity + (usingDirectIo ? alignment : 0));
+    buffer = bufferStorage.data();
+    if (usingDirectIo)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(buffer);
+        buffer += (alignment - address % alignment) % alignment;
+    }
+    bufferCapacity = capacity;
+    bufferUsed = 0;
+    writtenBytes = 0;
+    failed = false;
+    return true;
+}
+
+bool GB_AtomicFileWriter::IsOpen() const
+{
+#ifdef _WIN32
+    return fileHandle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+bool GB_AtomicFileWriter::Write(const void* data, size_t bytes)
+{
+    if (!IsOpen() || failed)
+    {
+        return false;
+    }
+    if (bytes == 0)
+    {
+        return true;
+    }
+    if (!data)
+    {
+        return false;
+    }
+
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    writtenBytes += bytes;
+    while (bytes > 0)
+    {
+        // 普通模式下的大块写入绕过缓冲，直接交给系统
+        if (!usingDirectIo && bufferUsed == 0 && bytes >= bufferCapacity)
+        {
+            if (!WriteToFile(src, bytes))
+            {
+                failed = true;
+                return false;
+            }
+            return true;
+        }
+
+        const size_t copyBytes = (std::min)(bytes, bufferCapacity - bufferUsed);
+        memcpy(buffer + bufferUsed, src, copyBytes);
+        bufferUsed += copyBytes;
+        src += copyBytes;
+        bytes -= copyBytes;
+
+        if (bufferUsed == bufferCapacity && !FlushBuffer(false))
+        {
+            failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GB_AtomicFileWriter::Write(const std::string& data)
+{
+    return Write(data.data(), data.size());
+}
+
+bool GB_AtomicFileWriter::FlushBuffer(bool finalFlush)
+{
+    if (bufferUsed == 0)
+    {
+        return true;
+    }
+
+    size_t bytes = bufferUsed;
+    if (usingDirectIo && finalFlush)
+    {
+        // 最后一块补零到对齐长度，Commit 时再截回真实长度
+        const size_t alignment = internal::directIoAlignment;
+        const size_t padded = (bytes + alignment - 1) / alignment * alignment;
+        memset(buffer + bytes, 0, padded - bytes);
+        bytes = padded;
+    }
+
+    const bool ok = WriteToFile(buffer, bytes);
+    bufferUsed = 0;
+    return ok;
+}
+
+bool GB_AtomicFileWriter::WriteToFile(const unsigned char* data, size_t bytes)
+{
+    // 有的文件系统打开时接受 O_DIRECT / FILE_FLAG_NO_BUFFERING，第一次写入才因对齐要求报错。
+    // 此时文件里还没有任何数据，换成普通写入重试；已写过数据后再失败则照常返回 false
+#ifdef _WIN32
+    HANDLE handle = static_cast<HANDLE>(fileHandle);
+    if (internal::WriteAllToHandle(handle, data, bytes))
+    {
+        return true;
+    }
+
+    LARGE_INTEGER zero;
+    zero.QuadPart = 0;
+    LARGE_INTEGER position;
+    if (!usingDirectIo || ::GetLastError() != ERROR_INVALID_PARAMETER ||
+        !::SetFilePointerEx(handle, zero, &position, FILE_CURRENT) || position.QuadPart != 0)
+    {
+        return false;
+    }
+
+    // 无缓冲标志不能在已有句柄上去掉，关闭后按普通方式重新创建临时文件
+    ::CloseHandle(handle);
+    fileHandle = nullptr;
+    const std::wstring tempPathW = GB_Utf8ToWString(tempPath);
+    handle = ::CreateFileW(tempPathW.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        GB_DeleteFile(tempPath);
+        return false;
+    }
+    fileHandle = handle;
+    usingDirectIo = false;
+    return internal::WriteAllToHandle(handle, data, bytes);
+#else
+    iovec iov;
+    iov.iov_base = const_cast<unsigned char*>(data);
+    iov.iov_len = bytes;
+    if (internal::WriteAllVectored(fd, &iov, 1))
+    {
+        return true;
+    }
+
+#ifdef O_DIRECT
+    if (usingDirectIo && errno == EINVAL && ::lseek(fd, 0, SEEK_CUR) == 0)
+    {
+        const int statusFlags = ::fcntl(fd, F_GETFL);
+        if (statusFlags >= 0 && ::fcntl(fd, F_SETFL, statusFlags & ~O_DIRECT) == 0)
+        {
+            usingDirectIo = false;
+            iov.iov_base = const_cast<unsigned char*>(data);
+            iov.iov_len = bytes;
+            return internal::WriteAllVectored(fd, &iov, 1);
+        }
+    }
+#endif
+    return false;
+#endif
+}
+
+void GB_AtomicFileWriter::CloseFile()
+{
+#ifdef _WIN32
+    if (fileHandle)
+    {
+        ::CloseHandle(static_cast<HANDLE>(fileHandle));
+        fileHandle = nullptr;
+    }
+#else
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+bool GB_AtomicFileWriter::Commit(GB_AtomicCommitGroup* group)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    // FlushBuffer 在直接 I/O 下会把尾块补零，即使写入途中退回了普通模式也要截回真实长度
+    const bool paddedTail = usingDirectIo;
+    bool ok = !failed && FlushBuffer(true);
+
+#ifdef _WIN32
+    HANDLE handle = static_cast<HANDLE>(fileHandle);
+    if (ok && paddedTail)
+    {
+        FILE_END_OF_FILE_INFO endOfFile;
+        endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(writtenBytes);
+        ok = ::SetFileInformationByHandle(handle, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile)) != FALSE;
+    }
+    if (ok && options.syncMode != GB_FileSyncMode::None)
+    {
+        ok = ::FlushFileBuffers(handle) != FALSE;
+    }
+    ok = (::CloseHandle(handle) != FALSE) && ok;
+    fileHandle = nullptr;
+#else
+    if (ok && paddedTail)
+    {
+        ok = ::ftruncate(fd, static_cast<off_t>(writtenBytes)) == 0;
+    }
+    if (ok && options.syncMode == GB_FileSyncMode::DataOnly)
+    {
+#if defined(__linux__)
+        ok = ::fdatasync(fd) == 0;
+#else
+        ok = ::fsync(fd) == 0;
+#endif
+    }
+    else if (ok && options.syncMode == GB_FileSyncMode::Full)
+    {
+        ok = ::fsync(fd) == 0;
+    }
+    ok = (::close(fd) == 0) && ok;
+    fd = -1;
+#endif
+
+    if (ok)
+    {
+#ifdef _WIN32
+        const std::wstring tempPathW = GB_Utf8ToWString(tempPath);
+        const std::wstring targetPathW = GB_Utf8ToWString(targetPath);
+        ok = ::MoveFileExW(tempPathW.c_str(), targetPathW.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+        ok = ::rename(tempPath.c_str(), targetPath.c_str()) == 0;
+#endif
+    }
+
+    if (!ok)
+    {
+        GB_DeleteFile(tempPath);
+    }
+    else if (options.syncMode != GB_FileSyncMode::None && options.syncDirectory)
+    {
+        // 目录同步失败不影响新内容已经可见的事实，这里按尽力而为处理；分组提交时由 GB_AtomicCommitGroup::Commit 报告
+        const std::string dirPath = internal::GetParentDirectory(targetPath);
+        if (group)
+        {
+            group->AddDirectory(dirPath);
+        }
+        else
+        {
+            internal::SyncDirectory(dirPath);
+        }
+    }
+
+    tempPath.clear();
+    bufferUsed = 0;
+    return ok;
+}
+
+void GB_AtomicFileWriter::Abort()
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+    CloseFile();
+    GB_DeleteFile(tempPath);
+    tempPath.clear();
+    bufferUsed = 0;
+}
+
+uint64_t GB_AtomicFileWriter::GetWrittenBytes() const
+{
+    return writtenBytes;
+}
+
+const std::string& GB_AtomicFileWriter::GetTempFilePath() const
+{
+    return tempPath;
+}
+
+bool GB_AtomicFileWriter::WriteFile(const std::string& filePathUtf8, const void* data, size_t bytes, const GB_AtomicWriteOptions& options, GB_AtomicCommitGroup* group)
+{
+    GB_AtomicFileWriter writer(filePathUtf8, options);
+    return writer.IsOpen() && writer.Write(data, bytes) && writer.Commit(group);
+}
+
+bool GB_WriteBinaryToFileAtomic(const GB_ByteBuffer& data, const std::string& filePathUtf8, const GB_AtomicWriteOptions& options)
+{
+    return GB_AtomicFileWriter::WriteFile(filePathUtf8, data.data(), data.size(), options);
+}
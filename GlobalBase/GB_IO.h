@@ -3,7 +3,9 @@
 
 #include "GlobalBasePort.h"
 #include "GB_BaseTypes.h"
+#include <cstring>
 #include <string>
+#include <vector>
 
 GLOBALBASE_PORT bool GB_WriteUtf8ToFile(const std::string& filePathUtf8, const std::string& utf8Content, bool appendMode = true, bool addBomIfNewFile = false);
 
@@ -23,9 +25,651 @@ public:
 	static bool ReadUInt32LE(const GB_ByteBuffer& buffer, size_t& offset, uint32_t& value);
 	static bool ReadUInt64LE(const GB_ByteBuffer& buffer, size_t& offset, uint64_t& value);
 	static bool ReadDoubleLE(const GB_ByteBuffer& buffer, size_t& offset, double& value);
+
+	// 从只读视图读取（如 GB_MappedFile::Span()），不拷贝数据
+	static bool ReadUInt16LE(GB_ByteSpan buffer, size_t& offset, uint16_t& value);
+	static bool ReadUInt32LE(GB_ByteSpan buffer, size_t& offset, uint32_t& value);
+	static bool ReadUInt64LE(GB_ByteSpan buffer, size_t& offset, uint64_t& value);
+	static bool ReadDoubleLE(GB_ByteSpan buffer, size_t& offset, double& value);
+};
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#  define GB_BIG_ENDIAN_HOST 1
+#else
+#  define GB_BIG_ENDIAN_HOST 0 // MSVC 支持的目标平台均为小端
+#endif
+
+// 小端编码的底层工具：小端主机上就是 memcpy，大端主机上额外做一次字节交换
+namespace byteio_detail
+{
+	inline uint16_t ByteSwap(uint16_t value)
+	{
+		return static_cast<uint16_t>((value >> 8) | (value << 8));
+	}
+
+	inline uint32_t ByteSwap(uint32_t value)
+	{
+		return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) | ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+	}
+
+	inline uint64_t ByteSwap(uint64_t value)
+	{
+		return (static_cast<uint64_t>(ByteSwap(static_cast<uint32_t>(value))) << 32) | ByteSwap(static_cast<uint32_t>(value >> 32));
+	}
+
+	template <typename T>
+	inline void StoreLE(unsigned char* dst, T value)
+	{
+#if GB_BIG_ENDIAN_HOST
+		value = ByteSwap(value);
+#endif
+		memcpy(dst, &value, sizeof(value));
+	}
+
+	template <typename T>
+	inline T LoadLE(const unsigned char* src)
+	{
+		T value;
+		memcpy(&value, src, sizeof(value));
+#if GB_BIG_ENDIAN_HOST
+		value = ByteSwap(value);
+#endif
+		return value;
+	}
+
+	// 批量 double：小端主机上整体 memcpy；大端主机上逐个交换（简单循环，编译器可向量化）
+	inline void StoreDoubleArrayLE(unsigned char* dst, const double* values, size_t count)
+	{
+#if GB_BIG_ENDIAN_HOST
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t bits;
+			memcpy(&bits, values + i, sizeof(bits));
+			StoreLE(dst + i * sizeof(bits), bits);
+		}
+#else
+		if (count > 0)
+		{
+			memcpy(dst, values, count * sizeof(double));
+		}
+#endif
+	}
+
+	inline void LoadDoubleArrayLE(const unsigned char* src, double* values, size_t count)
+	{
+#if GB_BIG_ENDIAN_HOST
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint64_t bits = LoadLE<uint64_t>(src + i * sizeof(bits));
+			memcpy(values + i, &bits, sizeof(bits));
+		}
+#else
+		if (count > 0)
+		{
+			memcpy(values, src, count * sizeof(double));
+		}
+#endif
+	}
+}
+
+/*
+	基于游标的小端写入器，追加到调用方的 GB_ByteBuffer 末尾。
+	- 写入期间把缓冲 resize 到容量大小，每次追加只比较一次游标，再 memcpy；容量不足时按倍数扩容。
+	- Finish()（或析构）把缓冲截到实际写入的长度；在此之前不要直接使用目标缓冲。
+	- 变长整数为 LEB128（每字节 7 位，最高位表示后续还有字节），有符号数先做 zigzag 变换，绝对值小的数编码更短。
+*/
+class GB_ByteWriter
+{
+public:
+	explicit GB_ByteWriter(GB_ByteBuffer& target, size_t reserveBytes = 0) : buffer(target), position(target.size())
+	{
+		Reserve(reserveBytes);
+	}
+
+	~GB_ByteWriter()
+	{
+		Finish();
+	}
+
+	GB_ByteWriter(const GB_ByteWriter&) = delete;
+	GB_ByteWriter& operator=(const GB_ByteWriter&) = delete;
+
+	// 确保还能再写入 additionalBytes 字节而不扩容
+	void Reserve(size_t additionalBytes)
+	{
+		if (position + additionalBytes > buffer.size())
+		{
+			Grow(position + additionalBytes);
+		}
+	}
+
+	void AppendUInt8(uint8_t value)
+	{
+		unsigned char* dst = Claim(1);
+		*dst = value;
+	}
+
+	void AppendUInt16LE(uint16_t value)
+	{
+		byteio_detail::StoreLE(Claim(sizeof(value)), value);
+	}
+
+	void AppendUInt32LE(uint32_t value)
+	{
+		byteio_detail::StoreLE(Claim(sizeof(value)), value);
+	}
+
+	void AppendUInt64LE(uint64_t value)
+	{
+		byteio_detail::StoreLE(Claim(sizeof(value)), value);
+	}
+
+	void AppendDoubleLE(double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		AppendUInt64LE(bits);
+	}
+
+	void AppendDoubleArrayLE(const double* values, size_t count)
+	{
+		byteio_detail::StoreDoubleArrayLE(Claim(count * sizeof(double)), values, count);
+	}
+
+	void AppendBytes(const void* data, size_t bytes)
+	{
+		if (bytes > 0)
+		{
+			memcpy(Claim(bytes), data, bytes);
+		}
+	}
+
+	// LEB128 变长无符号整数，1~10 字节
+	void AppendVarUInt64(uint64_t value)
+	{
+		unsigned char* dst = Claim(10);
+		size_t n = 0;
+		while (value >= 0x80)
+		{
+			dst[n++] = static_cast<unsigned char>(value | 0x80);
+			value >>= 7;
+		}
+		dst[n++] = static_cast<unsigned char>(value);
+		position -= 10 - n; // 退回未用到的字节
+	}
+
+	void AppendVarInt64(int64_t value)
+	{
+		AppendVarUInt64(ZigZagEncode(value));
+	}
+
+	static uint64_t ZigZagEncode(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	// 已写入的总长度（含构造前目标缓冲中已有的内容）
+	size_t Size() const
+	{
+		return position;
+	}
+
+	// 把目标缓冲截到实际长度，可重复调用；之后仍可继续写入
+	void Finish()
+	{
+		buffer.resize(position);
+	}
+
+private:
+	unsigned char* Claim(size_t bytes)
+	{
+		if (position + bytes > buffer.size())
+		{
+			Grow(position + bytes);
+		}
+		unsigned char* dst = buffer.data() + position;
+		position += bytes;
+		return dst;
+	}
+
+	void Grow(size_t minSize)
+	{
+		size_t newSize = buffer.capacity() < 64 ? 64 : buffer.capacity() * 2;
+		while (newSize < minSize)
+		{
+			newSize *= 2;
+		}
+		buffer.resize(newSize);
+	}
+
+	GB_ByteBuffer& buffer;
+	size_t position;
+};
+
+/*
+	基于游标的小端读取器，直接在只读视图上解析，不拷贝。
+	- 每次读取只做一次越界检查；失败时不移动游标、不修改输出参数。
+*/
+class GB_ByteReader
+{
+public:
+	explicit GB_ByteReader(GB_ByteSpan data) : data(data), position(0)
+	{
+	}
+
+	size_t GetOffset() const
+	{
+		return position;
+	}
+
+	size_t GetRemaining() const
+	{
+		return data.size() - position;
+	}
+
+	bool Skip(size_t bytes)
+	{
+		if (bytes > GetRemaining())
+		{
+			return false;
+		}
+		position += bytes;
+		return true;
+	}
+
+	bool ReadUInt8(uint8_t& value)
+	{
+		if (GetRemaining() < 1)
+		{
+			return false;
+		}
+		value = data[position++];
+		return true;
+	}
+
+	bool ReadUInt16LE(uint16_t& value)
+	{
+		return ReadScalar(value);
+	}
+
+	bool ReadUInt32LE(uint32_t& value)
+	{
+		return ReadScalar(value);
+	}
+
+	bool ReadUInt64LE(uint64_t& value)
+	{
+		return ReadScalar(value);
+	}
+
+	bool ReadDoubleLE(double& value)
+	{
+		uint64_t bits = 0;
+		if (!ReadScalar(bits))
+		{
+			return false;
+		}
+		memcpy(&value, &bits, sizeof(value));
+		return true;
+	}
+
+	bool ReadDoubleArrayLE(double* values, size_t count)
+	{
+		if (count > GetRemaining() / sizeof(double))
+		{
+			return false;
+		}
+		byteio_detail::LoadDoubleArrayLE(data.data() + position, values, count);
+		position += count * sizeof(double);
+		return true;
+	}
+
+	bool ReadBytes(void* out, size_t bytes)
+	{
+		if (bytes > GetRemaining())
+		{
+			return false;
+		}
+		if (bytes > 0)
+		{
+			memcpy(out, data.data() + position, bytes);
+		}
+		position += bytes;
+		return true;
+	}
+
+	// 截断或超过 64 位的编码返回 false
+	bool ReadVarUInt64(uint64_t& value)
+	{
+		uint64_t result = 0;
+		size_t offset = position;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			if (offset >= data.size())
+			{
+				return false;
+			}
+			const unsigned char byte = data[offset++];
+			if (shift == 63 && byte > 1)
+			{
+				return false;
+			}
+			result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				value = result;
+				position = offset;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ReadVarInt64(int64_t& value)
+	{
+		uint64_t encoded = 0;
+		if (!ReadVarUInt64(encoded))
+		{
+			return false;
+		}
+		value = ZigZagDecode(encoded);
+		return true;
+	}
+
+	static int64_t ZigZagDecode(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+private:
+	template <typename T>
+	bool ReadScalar(T& value)
+	{
+		if (GetRemaining() < sizeof(T))
+		{
+			return false;
+		}
+		value = byteio_detail::LoadLE<T>(data.data() + position);
+		position += sizeof(T);
+		return true;
+	}
+
+	GB_ByteSpan data;
+	size_t position;
+};
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+/*
+	只读内存映射文件（RAII）：Span() 直接指向映射内存，读取大文件不占用等量的堆内存，也不做整体拷贝。
+	- 普通文件使用 mmap（Windows: CreateFileMapping + MapViewOfFile）。
+	- 管道、字符设备、/proc 等无法映射或大小未知的特殊文件，自动回退为 read() 读入内部缓冲，接口不变。
+	- 空文件打开成功，Size() 为 0。
+	- 映射期间文件若被其它进程截断，访问越界部分会触发 SIGBUS（Windows 上为访问异常），这是 mmap 的固有语义。
+*/
+class GLOBALBASE_PORT GB_MappedFile
+{
+public:
+	enum class AccessHint
+	{
+		Normal,      // 不做提示
+		Sequential,  // 顺序读取：加大预读，读过的页可尽快回收（MADV_SEQUENTIAL / FILE_FLAG_SEQUENTIAL_SCAN）
+		Random,      // 随机读取：关闭预读（MADV_RANDOM / FILE_FLAG_RANDOM_ACCESS）
+		WillNeed     // 即将读取全部内容：异步预取到页缓存（MADV_WILLNEED / PrefetchVirtualMemory）
+	};
+
+	GB_MappedFile();
+	// 打开失败时 IsOpen() 为 false
+	explicit GB_MappedFile(const std::string& filePathUtf8, AccessHint hint = AccessHint::Normal, bool useHugePages = false);
+	~GB_MappedFile();
+
+	GB_MappedFile(const GB_MappedFile&) = delete;
+	GB_MappedFile& operator=(const GB_MappedFile&) = delete;
+	GB_MappedFile(GB_MappedFile&& other) noexcept;
+	GB_MappedFile& operator=(GB_MappedFile&& other) noexcept;
+
+	// useHugePages：提示内核以透明大页映射（MADV_HUGEPAGE，需内核支持文件页大页），不支持时忽略
+	bool Open(const std::string& filePathUtf8, AccessHint hint = AccessHint::Normal, bool useHugePages = false);
+	void Close();
+
+	bool IsOpen() const;
+	// true：数据来自内存映射；false：特殊文件回退为读入内部缓冲
+	bool IsMapped() const;
+
+	const unsigned char* Data() const;
+	size_t Size() const;
+	GB_ByteSpan Span() const;
+
+	// 对 [offset, offset + length) 追加访问提示（按页对齐），length 超出文件末尾时截到末尾
+	bool Advise(AccessHint hint, size_t offset = 0, size_t length = static_cast<size_t>(-1)) const;
+
+private:
+	void MoveFrom(GB_MappedFile& other);
+
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+	bool isOpen = false;
+	void* mappedAddress = nullptr;   // 映射起始地址；回退模式下为空
+	void* mappingHandle = nullptr;   // Windows 文件映射对象句柄
+	GB_ByteBuffer fallbackBuffer;
 };
 
+/*
+	带缓冲的顺序读取器，打开一次后多次读取。
+	- Read/ReadExact 为顺序读，经内部缓冲（默认 1 MiB），大块读取直接读入调用方内存。
+	- ReadAt 为定位读取（pread / 带 OVERLAPPED 偏移的 ReadFile），不使用也不改变顺序读的位置和缓冲，可从多个线程并发调用。
+	- 同一对象上的顺序读、Seek 等其它操作不是线程安全的。
+*/
+class GLOBALBASE_PORT GB_FileReader
+{
+public:
+	using AccessHint = GB_MappedFile::AccessHint;
+	static const size_t defaultBufferSize = 1024 * 1024;
+
+	GB_FileReader();
+	// 打开失败时 IsOpen() 为 false
+	explicit GB_FileReader(const std::string& filePathUtf8, AccessHint hint = AccessHint::Sequential, size_t bufferSize = defaultBufferSize);
+	~GB_FileReader();
+
+	GB_FileReader(const GB_FileReader&) = delete;
+	GB_FileReader& operator=(const GB_FileReader&) = delete;
+
+	// hint 为 Sequential 时加大内核预读（POSIX_FADV_SEQUENTIAL / FILE_FLAG_SEQUENTIAL_SCAN）；bufferSize 为 0 时不做用户态缓冲
+	bool Open(const std::string& filePathUtf8, AccessHint hint = AccessHint::Sequential, size_t bufferSize = defaultBufferSize);
+	void Close();
+	bool IsOpen() const;
+
+	uint64_t GetFileSize() const;
+
+	// 顺序读取，返回实际读到的字节数；到达文件末尾或出错时小于 bytes
+	size_t Read(void* buffer, size_t bytes);
+	// 恰好读满 bytes 字节才返回 true
+	bool ReadExact(void* buffer, size_t bytes);
+	bool Seek(uint64_t offset);
+	uint64_t Tell() const;
+
+	// 定位读取，线程安全；返回实际读到的字节数
+	size_t ReadAt(uint64_t offset, void* buffer, size_t bytes) const;
+
+	// 对 [offset, offset + length) 给出访问提示（posix_fadvise），如 WillNeed 可提前触发预读；length 为 0 表示到文件末尾。
+	// Windows 上只有打开时的提示有效，此处直接返回 true。
+	bool Advise(AccessHint hint, uint64_t offset = 0, uint64_t length = 0) const;
+
+private:
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+#else
+	int fd = -1;
+#endif
+	GB_ByteBuffer buffer;
+	uint64_t bufferFileOffset = 0; // buffer[0] 对应的文件偏移
+	size_t bufferPos = 0;          // 下一个待返回字节在 buffer 中的位置
+	size_t bufferLength = 0;       // buffer 中的有效字节数
+	uint64_t position = 0;         // 顺序读的逻辑位置
+};
+
+/*
+	带缓冲的写入器，适合反复追加大量小记录：文件只打开一次，小写入先攒在内部缓冲（默认 1 MiB）里。
+	- 缓冲放不下时，把缓冲内容与新数据用一次 writev 写出，不做额外拷贝。
+	- Flush 只把缓冲交给操作系统；Sync 额外做 fdatasync / FlushFileBuffers，保证数据落盘。
+	- 析构（或 Close）时会 Flush，但不会 Sync。
+	- 非线程安全。
+*/
+class GLOBALBASE_PORT GB_FileWriter
+{
+public:
+	static const size_t defaultBufferSize = 1024 * 1024;
+
+	GB_FileWriter();
+	// 打开失败时 IsOpen() 为 false
+	explicit GB_FileWriter(const std::string& filePathUtf8, bool appendMode = true, size_t bufferSize = defaultBufferSize);
+	~GB_FileWriter();
+
+	GB_FileWriter(const GB_FileWriter&) = delete;
+	GB_FileWriter& operator=(const GB_FileWriter&) = delete;
+
+	// 父目录不存在时自动创建；appendMode 为 false 时截断已有文件；bufferSize 为 0 时每次写入直接交给系统
+	bool Open(const std::string& filePathUtf8, bool appendMode = true, size_t bufferSize = defaultBufferSize);
+	// 先 Flush 再关闭，任一步失败返回 false
+	bool Close();
+	bool IsOpen() const;
+
+	bool Write(const void* data, size_t bytes);
+	bool Write(const std::string& data);
+	// 向量写：一次提交多段数据
+	bool WriteV(const GB_ByteSpan* spans, size_t spanCount);
+
+	bool Flush();
+	// Flush 后把数据（dataOnly 为 false 时连同元数据）同步到存储设备
+	bool Sync(bool dataOnly = true);
+
+	// 已写入（含缓冲中尚未写出）的字节数，从打开时算起
+	uint64_t GetWrittenBytes() const;
+
+private:
+	bool WriteBufferedAndSpans(const GB_ByteSpan* spans, size_t spanCount);
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+#else
+	int fd = -1;
+#endif
+	GB_ByteBuffer buffer;
+	size_t bufferUsed = 0;
+	uint64_t writtenBytes = 0;
+};
+
+enum class GB_FileSyncMode
+{
+	None,       // 不主动同步，只依赖 rename 的原子性（断电后可能得到空文件或旧文件）
+	DataOnly,   // fdatasync：只刷数据及读取所需的元数据（如长度）
+	Full        // fsync / FlushFileBuffers
+};
+
+struct GB_AtomicWriteOptions
+{
+	GB_FileSyncMode syncMode = GB_FileSyncMode::Full;
+	// 绕过页缓存写临时文件（O_DIRECT / FILE_FLAG_NO_BUFFERING）。适合大文件且写完不会很快再读的场景；
+	// 文件系统不支持时自动退回普通写入
+	bool directIo = false;
+	// rename 之后同步父目录，使目录项本身也落盘（Windows 上无此操作）。加入 GB_AtomicCommitGroup 时由分组统一处理
+	bool syncDirectory = true;
+	// 新文件的权限位；-1 表示沿用目标文件原有权限，目标不存在时为 0666 & ~umask（仅 POSIX）
+	int permissions = -1;
+	size_t bufferSize = 256 * 1024;
+};
+
+class GB_AtomicFileWriter;
+
+/*
+	原子写入的分组提交：组内各文件各自同步数据并 rename，父目录的同步推迟到 Commit 时按目录去重只做一次。
+	大量小文件写入同一目录时，把每个文件一次目录 fsync 降为整组一次。
+	Commit 返回之前，组内文件的新内容已经可见，但只有 Commit 成功后目录项才保证落盘。析构时若仍有未同步的目录会自动 Commit。
+*/
+class GLOBALBASE_PORT GB_AtomicCommitGroup
+{
+public:
+	GB_AtomicCommitGroup();
+	~GB_AtomicCommitGroup();
+
+	GB_AtomicCommitGroup(const GB_AtomicCommitGroup&) = delete;
+	GB_AtomicCommitGroup& operator=(const GB_AtomicCommitGroup&) = delete;
+
+	// 同步所有待同步的目录，任一失败返回 false
+	bool Commit();
+	size_t GetPendingDirectoryCount() const;
+
+private:
+	friend class GB_AtomicFileWriter;
+	void AddDirectory(const std::string& dirPath);
+
+	std::vector<std::string> pendingDirectories;
+};
+
+/*
+	原子替换文件：内容先流式写入同目录下的临时文件，Commit 时按选项同步数据，再 rename 覆盖目标，最后同步父目录。
+	- 任何时刻其它进程看到的目标文件要么是旧内容，要么是完整的新内容；崩溃最多留下一个临时文件（*.tmp.*）。
+	- 未 Commit 就析构（或调用 Abort）时删除临时文件，目标文件不变。
+	- 父目录不存在时自动创建。非线程安全。
+*/
+class GLOBALBASE_PORT GB_AtomicFileWriter
+{
+public:
+	GB_AtomicFileWriter();
+	// 打开失败时 IsOpen() 为 false
+	explicit GB_AtomicFileWriter(const std::string& filePathUtf8, const GB_AtomicWriteOptions& options = GB_AtomicWriteOptions());
+	~GB_AtomicFileWriter();
+
+	GB_AtomicFileWriter(const GB_AtomicFileWriter&) = delete;
+	GB_AtomicFileWriter& operator=(const GB_AtomicFileWriter&) = delete;
+
+	// 若已打开另一个文件，先 Abort 它
+	bool Open(const std::string& filePathUtf8, const GB_AtomicWriteOptions& options = GB_AtomicWriteOptions());
+	bool IsOpen() const;
+
+	bool Write(const void* data, size_t bytes);
+	bool Write(const std::string& data);
+
+	// 写出缓冲、同步、rename。group 非空时父目录的同步交给 group。无论成败，之后 IsOpen() 为 false
+	bool Commit(GB_AtomicCommitGroup* group = nullptr);
+	void Abort();
+
+	uint64_t GetWrittenBytes() const;
+	const std::string& GetTempFilePath() const;
+
+	// 便捷接口：一次性原子写入整块数据
+	static bool WriteFile(const std::string& filePathUtf8, const void* data, size_t bytes, const GB_AtomicWriteOptions& options = GB_AtomicWriteOptions(), GB_AtomicCommitGroup* group = nullptr);
+
+private:
+	bool FlushBuffer(bool finalFlush);
+	bool WriteToFile(const unsigned char* data, size_t bytes);
+	void CloseFile();
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+#else
+	int fd = -1;
+#endif
+	std::string targetPath;
+	std::string tempPath;
+	GB_AtomicWriteOptions options;
+	bool usingDirectIo = false;
+	std::vector<unsigned char> bufferStorage;
+	unsigned char* buffer = nullptr;   // bufferStorage 内按 directIoAlignment 对齐的起点
+	size_t bufferCapacity = 0;
+	size_t bufferUsed = 0;
+	uint64_t writtenBytes = 0;
+	bool failed = false;
+};
 
+// 经 GB_AtomicFileWriter 整块写入：读者要么看到旧内容、要么看到完整的新内容，且（默认选项下）返回前已落盘
+GLOBALBASE_PORT bool GB_WriteBinaryToFileAtomic(const GB_ByteBuffer& data, const std::string& filePathUtf8, const GB_AtomicWriteOptions& options = GB_AtomicWriteOptions());
 
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+﻿#include "GB_LockProfiler.h"
+#include <map>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+namespace internal
+{
+	static std::atomic<bool>& GetLockProfilingFlag()
+	{
+		static std::atomic<bool> isEnabled(false);
+		return isEnabled;
+	}
+
+	struct LockProfileRegistry
+	{
+		std::mutex mtx;
+		std::map<std::string, std::unique_ptr<GB_LockProfile>> profiles;
+	};
+
+	// 注册表故意不析构：全局对象（如 GB_Logger 单例）在进程退出阶段仍可能加锁
+	static LockProfileRegistry& GetLockProfileRegistry()
+	{
+		static LockProfileRegistry* registry = new LockProfileRegistry();
+		return *registry;
+	}
+
+	static void AppendJsonEscapedName(std::string& out, const std::string& s)
+	{
+		for (size_t i = 0; i < s.size(); i++)
+		{
+			const unsigned char ch = static_cast<unsigned char>(s[i]);
+			if (ch == '\"' || ch == '\\')
+			{
+				out += '\\';
+				out += static_cast<char>(ch);
+			}
+			else if (ch < 0x20)
+			{
+				static const char* hex = "0123456789ABCDEF";
+				out += "\\u00";
+				out += hex[(ch >> 4) & 0xF];
+				out += hex[ch & 0xF];
+			}
+			else
+			{
+				out += static_cast<char>(ch);
+			}
+		}
+	}
+
+	static void AppendStatsJson(std::ostringstream& oss, const GB_LockProfile::Stats& stats)
+	{
+		const uint64_t avgWaitNs = stats.contended > 0 ? stats.totalWaitNs / stats.contended : 0;
+		oss << "{\"acquisitions\":" << stats.acquisitions
+			<< ",\"contended\":" << stats.contended
+			<< ",\"totalWaitNs\":" << stats.totalWaitNs
+			<< ",\"maxWaitNs\":" << stats.maxWaitNs
+			<< ",\"avgContendedWaitNs\":" << avgWaitNs << "}";
+	}
+}
+
+GB_LockProfile::GB_LockProfile(const string& nameUtf8) : name(nameUtf8)
+{
+}
+
+const string& GB_LockProfile::GetName() const
+{
+	return name;
+}
+
+void GB_LockProfile::RecordAcquire(GB_LockMode mode, bool contended, uint64_t waitNs)
+{
+	AtomicStats& stats = (mode == GB_LockMode::Shared) ? sharedStats : exclusiveStats;
+	stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+	if (!contended)
+	{
+		return;
+	}
+
+	stats.contended.fetch_add(1, std::memory_order_relaxed);
+	stats.totalWaitNs.fetch_add(waitNs, std::memory_order_relaxed);
+
+	uint64_t oldMax = stats.maxWaitNs.load(std::memory_order_relaxed);
+	while (waitNs > oldMax && !stats.maxWaitNs.compare_exchange_weak(oldMax, waitNs, std::memory_order_relaxed))
+	{
+	}
+}
+
+GB_LockProfile::Stats GB_LockProfile::GetStats(GB_LockMode mode) const
+{
+	const AtomicStats& stats = (mode == GB_LockMode::Shared) ? sharedStats : exclusiveStats;
+	Stats result;
+	result.acquisitions = stats.acquisitions.load(std::memory_order_relaxed);
+	result.contended = stats.contended.load(std::memory_order_relaxed);
+	result.totalWaitNs = stats.totalWaitNs.load(std::memory_order_relaxed);
+	result.maxWaitNs = stats.maxWaitNs.load(std::memory_order_relaxed);
+	return result;
+}
+
+void GB_LockProfile::Reset()
+{
+	AtomicStats* allStats[2] = { &sharedStats, &exclusiveStats };
+	for (size_t i = 0; i < 2; i++)
+	{
+		allStats[i]->acquisitions.store(0, std::memory_order_relaxed);
+		allStats[i]->contended.store(0, std::memory_order_relaxed);
+		allStats[i]->totalWaitNs.store(0, std::memory_order_relaxed);
+		allStats[i]->maxWaitNs.store(0, std::memory_order_relaxed);
+	}
+}
+
+string GB_LockProfile::ToJsonString() const
+{
+	string escapedName;
+	internal::AppendJsonEscapedName(escapedName, name);
+
+	std::ostringstream oss;
+	oss << "{\"name\":\"" << escapedName << "\",\"shared\":";
+	internal::AppendStatsJson(oss, GetStats(GB_LockMode::Shared));
+	oss << ",\"exclusive\":";
+	internal::AppendStatsJson(oss, GetStats(GB_LockMode::Exclusive));
+	oss << "}";
+	return oss.str();
+}
+
+void GB_SetLockProfilingEnabled(bool enable)
+{
+	internal::GetLockProfilingFlag().store(enable, std::memory_order_relaxed);
+}
+
+bool GB_IsLockProfilingEnabled()
+{
+	return internal::GetLockProfilingFlag().load(std::memory_order_relaxed);
+}
+
+GB_LockProfile* GB_GetLockProfile(const string& nameUtf8)
+{
+	internal::LockProfileRegistry& registry = internal::GetLockProfileRegistry();
+	std::lock_guard<std::mutex> lock(registry.mtx);
+
+	std::unique_ptr<GB_LockProfile>& profile = registry.profiles[nameUtf8];
+	if (!profile)
+	{
+		profile.reset(new GB_LockProfile(nameUtf8));
+	}
+	return profile.get();
+}
+
+string GB_DumpLockProfilesJson()
+{
+	internal::LockProfileRegistry& registry = internal::GetLockProfileRegistry();
+	std::lock_guard<std::mutex> lock(registry.mtx);
+
+	string out = GB_IsLockProfilingEnabled() ? "{\"enabled\":true,\"locks\":[" : "{\"enabled\":false,\"locks\":[";
+	bool isFirst = true;
+	for (std::map<std::string, std::unique_ptr<GB_LockProfile>>::const_iterator it = registry.profiles.begin(); it != registry.profiles.end(); ++it)
+	{
+		if (!isFirst)
+		{
+			out += ",";
+		}
+		isFirst = false;
+		out += it->second->ToJsonString();
+	}
+	out += "]}";
+	return out;
+}
+
+void GB_ResetLockProfiles()
+{
+	internal::LockProfileRegistry& registry = internal::GetLockProfileRegistry();
+	std::lock_guard<std::mutex> lock(registry.mtx);
+
+	for (std::map<std::string, std::unique_ptr<GB_LockProfile>>::iterator it = registry.profiles.begin(); it != registry.profiles.end(); ++it)
+	{
+		it->second->Reset();
+	}
+}
@@ -0,0 +1,161 @@
+﻿#ifndef GLOBALBASE_LOCK_PROFILER_H_H
+#define GLOBALBASE_LOCK_PROFILER_H_H
+
+#include "GlobalBasePort.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+
+/*
+	锁竞争统计（Lock Contention Profiler）
+
+	用途：
+	- 按“锁名字”统计每把锁的获取次数、发生竞争的次数、等待总时长与最大等待时长，
+	  共享（读）与独占（写）两种模式分别统计。
+	- 全局注册表可以一次性导出为 JSON，便于在压测时定位热点锁。
+
+	约定：
+	- 默认关闭。关闭时每次加锁只多一次 relaxed 原子读，不取时间戳。
+	- 同名的锁共享同一份统计（例如所有 GB_ThreadPool 实例的 queueMutex 会累计到一起）。
+	- GB_LockProfile 对象由注册表持有，进程生命周期内不会释放，指针可长期缓存。
+	- “竞争”指一次获取没能立刻成功（try_lock 失败或需要在条件变量上等待）；只有竞争时才计入等待时长。
+*/
+enum class GB_LockMode : int
+{
+	Shared = 0,
+	Exclusive = 1
+};
+
+class GLOBALBASE_PORT GB_LockProfile
+{
+public:
+	struct Stats
+	{
+		uint64_t acquisitions = 0;  // 成功获取次数
+		uint64_t contended = 0;     // 其中发生竞争的次数
+		uint64_t totalWaitNs = 0;   // 竞争时的等待总时长（纳秒）
+		uint64_t maxWaitNs = 0;     // 单次最大等待时长（纳秒）
+	};
+
+	explicit GB_LockProfile(const std::string& nameUtf8);
+	GB_LockProfile(const GB_LockProfile&) = delete;
+	GB_LockProfile& operator=(const GB_LockProfile&) = delete;
+
+	const std::string& GetName() const;
+
+	// 记录一次成功的获取；contended == false 时 waitNs 被忽略
+	void RecordAcquire(GB_LockMode mode, bool contended, uint64_t waitNs);
+
+	Stats GetStats(GB_LockMode mode) const;
+	void Reset();
+
+	std::string ToJsonString() const;
+
+private:
+	struct AtomicStats
+	{
+		std::atomic<uint64_t> acquisitions{ 0 };
+		std::atomic<uint64_t> contended{ 0 };
+		std::atomic<uint64_t> totalWaitNs{ 0 };
+		std::atomic<uint64_t> maxWaitNs{ 0 };
+	};
+
+	const std::string name;
+	AtomicStats sharedStats;
+	AtomicStats exclusiveStats;
+};
+
+// 运行时开关（默认关闭）
+GLOBALBASE_PORT void GB_SetLockProfilingEnabled(bool enable);
+GLOBALBASE_PORT bool GB_IsLockProfilingEnabled();
+
+// 按名字获取（不存在则创建）统计对象，返回值永不为 nullptr
+GLOBALBASE_PORT GB_LockProfile* GB_GetLockProfile(const std::string& nameUtf8);
+
+// 导出所有锁的统计：{"enabled":true,"locks":[{"name":"...","shared":{...},"exclusive":{...}}, ...]}
+GLOBALBASE_PORT std::string GB_DumpLockProfilesJson();
+
+// 清零所有锁的统计（不删除注册项）
+GLOBALBASE_PORT void GB_ResetLockProfiles();
+
+/*
+	一次加锁过程的等待计时器（仅供内部加锁代码使用）。
+	- 构造时若 profile 为空或统计未开启，则整个对象为空操作。
+	- 调用者在发现需要等待时调用 MarkContended()，拿到锁后调用 Commit()。
+*/
+class GB_LockWaitRecorder
+{
+public:
+	GB_LockWaitRecorder(GB_LockProfile* profile, GB_LockMode mode)
+		: profile_((profile != nullptr && GB_IsLockProfilingEnabled()) ? profile : nullptr), mode_(mode), contended_(false)
+	{
+	}
+
+	bool IsActive() const
+	{
+		return profile_ != nullptr;
+	}
+
+	void MarkContended()
+	{
+		if (profile_ != nullptr && !contended_)
+		{
+			contended_ = true;
+			startTime_ = std::chrono::steady_clock::now();
+		}
+	}
+
+	void Commit()
+	{
+		if (profile_ == nullptr)
+		{
+			return;
+		}
+
+		uint64_t waitNs = 0;
+		if (contended_)
+		{
+			waitNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_).count());
+		}
+		profile_->RecordAcquire(mode_, contended_, waitNs);
+		profile_ = nullptr;
+	}
+
+private:
+	GB_LockProfile* profile_;
+	GB_LockMode mode_;
+	bool contended_;
+	std::chrono::steady_clock::time_point startTime_;
+};
+
+// 对普通 std::mutex 加锁并记录（独占模式）。先 try_lock，失败才计时并阻塞。
+inline std::unique_lock<std::mutex> GB_ProfiledLock(std::mutex& mutex, GB_LockProfile* profile)
+{
+	GB_LockWaitRecorder recorder(profile, GB_LockMode::Exclusive);
+	if (!recorder.IsActive())
+	{
+		return std::unique_lock<std::mutex>(mutex);
+	}
+
+	std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+	{
+		recorder.MarkContended();
+		lock.lock();
+	}
+	recorder.Commit();
+	return lock;
+}
+
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
+#endif
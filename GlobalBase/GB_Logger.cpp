@@ -1,12 +1,34 @@
 ﻿#include "GB_Logger.h"
 #include "GB_Config.h"
 #include "GB_FileSystem.h"
+#include "GB_Gzip.h"
 #include "GB_IO.h"
 #include "GB_Utility.h"
-#include "GB_Timer.h"
+#include "GB_ThreadPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <unordered_map>
 
 #if defined(_WIN32)
 #  include <windows.h>
+#else
+#  include <signal.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <execinfo.h>
+#  include <poll.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <cerrno>
+#  if defined(__linux__)
+#    include <sys/inotify.h>
+#  endif
 #endif
 
 using namespace std;
@@ -195,380 +217,2801 @@ string LogLevelToString(GB_LogLevel level)
 	}
 }
 
-string GB_LogItem::ToJsonString() const
+namespace internal
 {
-	string out;
-	const size_t reserveGuess = 64 + message.size() + threadId.size() + file.size();
-	out.reserve(reserveGuess);
+	// 以追加方式格式化，日志线程可把一整批记录直接拼进同一个缓冲区
+	static void AppendLogItemJson(string& out, const GB_LogItem& item)
+	{
+		out += GB_STR("{");
 
-	out += GB_STR("{");
+		out += GB_STR("\"ts\":\"");
+		AppendJsonEscaped(out, item.timestamp);
+		out += GB_STR("\"");
 
-	out += GB_STR("\"ts\":\"");
-	internal::AppendJsonEscaped(out, timestamp);
-	out += GB_STR("\"");
+		out += GB_STR(",\"level\":\"");
+		out += LogLevelToString(item.level);
+		out += GB_STR("\"");
 
-	out += GB_STR(",\"level\":\"");
-	out += LogLevelToString(level);
-	out += GB_STR("\"");
 
+		out += GB_STR(",\"thread\":\"");
+		AppendJsonEscaped(out, item.threadId);
+		out += GB_STR("\"");
 
-	out += GB_STR(",\"thread\":\"");
-	internal::AppendJsonEscaped(out, threadId);
-	out += GB_STR("\"");
+		out += GB_STR(",\"file\":\"");
+		AppendJsonEscaped(out, item.file);
+		out += GB_STR("\"");
 
-	out += GB_STR(",\"file\":\"");
-	internal::AppendJsonEscaped(out, file);
-	out += GB_STR("\"");
+		out += GB_STR(",\"line\":");
+		out += std::to_string(item.line);
 
-	out += GB_STR(",\"line\":");
-	{
-		std::ostringstream oss;
-		oss << line;
-		out += oss.str();
-	}
+		out += GB_STR(",\"msg\":\"");
+		AppendJsonEscaped(out, item.message);
+		out += GB_STR("\"");
 
-	out += GB_STR(",\"msg\":\"");
-	internal::AppendJsonEscaped(out, message);
-	out += GB_STR("\"");
+		for (size_t i = 0; i < item.fields.size(); i++)
+		{
+			out += GB_STR(",\"");
+			AppendJsonEscaped(out, item.fields[i].key);
+			out += GB_STR("\":");
+			out += item.fields[i].jsonValue;
+		}
 
-	out += GB_STR("}\n");
-	return out;
-}
+		out += GB_STR("}\n");
+	}
 
-string GB_LogItem::ToPlainTextString() const
-{
-	string out;
-	const size_t reserveGuess = 64 + message.size() + threadId.size() + file.size();
-	out.reserve(reserveGuess);
+	static void AppendLogItemPlainText(string& out, const GB_LogItem& item)
+	{
+		out += GB_STR("[");
+		out += item.timestamp;
+		out += GB_STR("] [");
 
-	out += GB_STR("[");
-	out += timestamp;
-	out += GB_STR("] [");
+		out += LogLevelToString(item.level);
+		out += GB_STR("] [");
 
-	out += LogLevelToString(level);
-	out += GB_STR("] [");
+		out += item.threadId;
+		out += GB_STR("] [");
 
-	out += threadId;
-	out += GB_STR("] [");
+		out += item.file;
+		out += GB_STR(":");
+		out += std::to_string(item.line);
 
-	out += file;
-	out += GB_STR(":");
-	{
-		std::ostringstream oss;
-		oss << line;
-		out += oss.str();
+		out += GB_STR("] ");
+		out += item.message;
+		for (size_t i = 0; i < item.fields.size(); i++)
+		{
+			out += GB_STR(" ");
+			out += item.fields[i].key;
+			out += GB_STR("=");
+			out += item.fields[i].jsonValue;
+		}
+		out += GB_STR("\n");
 	}
+}
 
-	out += GB_STR("] ");
-	out += message;
-	out += GB_STR("\n");
-
+string GB_LogItem::ToJsonString() const
+{
+	string out;
+	const size_t reserveGuess = 64 + message.size() + threadId.size() + file.size();
+	out.reserve(reserveGuess);
+	internal::AppendLogItemJson(out, *this);
 	return out;
 }
 
-GB_Logger& GB_Logger::GetInstance()
+string GB_LogItem::ToPlainTextString() const
 {
-	static GB_Logger instance;
-	return instance;
+	string out;
+	const size_t reserveGuess = 64 + message.size() + threadId.size() + file.size();
+	out.reserve(reserveGuess);
+	internal::AppendLogItemPlainText(out, *this);
+	return out;
 }
 
-void GB_Logger::Log(GB_LogLevel level, const string& msgUtf8, const string& fileUtf8, int line)
+namespace internal
 {
-	GB_LogItem logItem;
-	logItem.timestamp = GetLocalTimeStr();
-	logItem.level = level;
-	logItem.message = msgUtf8;
+	// 二进制日志记录头。紧跟其后依次是 线程 ID、文件名、消息 的原始字节，整条记录按 8 字节对齐。
+	struct LogRecordHeader
 	{
-		std::ostringstream oss;
-		oss << std::this_thread::get_id();
-		logItem.threadId = oss.str();
-	}
-	logItem.file = fileUtf8;
-	logItem.line = line;
+		uint32_t recordBytes;   // 整条记录（含头部与对齐填充）的字节数
+		uint8_t kind;           // LogRecordKind
+		uint8_t level;          // GB_LogLevel
+		uint8_t flags;          // LogRecordFlags
+		uint8_t reserved;
+		int32_t line;
+		uint16_t threadIdBytes; // 0 表示使用所属 ThreadRing 缓存的线程 ID
+		uint16_t reserved2;
+		uint32_t fileBytes;
+		uint32_t messageBytes;
+		int64_t timestampNs;    // system_clock 纪元以来的纳秒数，由日志线程格式化
+	};
+
+	enum LogRecordKind : uint8_t
 	{
-		std::lock_guard<std::mutex> lock(logQueueMtx);
-		logQueue.push(logItem);
-	}
-	logQueueCv.notify_one();
-}
+		LOG_RECORD_KIND_ENTRY = 0,
+		LOG_RECORD_KIND_PADDING = 1 // 环形缓冲尾部放不下整条记录时的填充，读到后直接跳到缓冲区开头
+	};
 
-void GB_Logger::LogTrace(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	enum LogRecordFlags : uint8_t
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_TRACE, msgUtf8, "", line);
-		return;
-	}
+		LOG_RECORD_FLAG_NATIVE_FILE = 0x01, // 文件名是 __FILE__ 原始字节（Windows 下为 ANSI），需要在日志线程转为 UTF-8
+		LOG_RECORD_FLAG_DEFERRED_FORMAT = 0x02 // 消息部分是 logger_detail::LogArgBuffer（格式串地址 + 参数编码），由日志线程格式化
+	};
 
-#if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
-#else
-	string fileStrUtf8 = file;
-#endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_TRACE, msgUtf8, fileStrUtf8, line);
-}
+	static const size_t threadRingBytes = 256 * 1024; // 每线程环形缓冲大小（必须是 2 的幂）
+	static const size_t maxRingRecordBytes = threadRingBytes / 4; // 超过此大小的记录直接走溢出队列
 
-void GB_Logger::LogDebug(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	static size_t AlignLogRecordBytes(size_t bytes)
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_DEBUG, msgUtf8, "", line);
-		return;
+		return (bytes + 7) & ~static_cast<size_t>(7);
 	}
 
-#if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
-#else
-	string fileStrUtf8 = file;
-#endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_DEBUG, msgUtf8, fileStrUtf8, line);
-}
+	static void WriteLogRecord(unsigned char* dest, const LogRecordHeader& header, const char* threadIdData, const char* fileData, const char* msgData)
+	{
+		memcpy(dest, &header, sizeof(header));
+		dest += sizeof(header);
+		if (header.threadIdBytes > 0)
+		{
+			memcpy(dest, threadIdData, header.threadIdBytes);
+			dest += header.threadIdBytes;
+		}
+		if (header.fileBytes > 0)
+		{
+			memcpy(dest, fileData, header.fileBytes);
+			dest += header.fileBytes;
+		}
+		if (header.messageBytes > 0)
+		{
+			memcpy(dest, msgData, header.messageBytes);
+		}
+	}
 
-void GB_Logger::LogInfo(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	static string ThreadIdToString(const std::thread::id& threadId)
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_INFO, msgUtf8, "", line);
-		return;
+		std::ostringstream oss;
+		oss << threadId;
+		return oss.str();
 	}
 
+	static string NativeFileToUtf8(const string& file)
+	{
 #if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
+		const string fileUtf8 = GB_AnsiToUtf8(file);
 #else
-	string fileStrUtf8 = file;
+		const string& fileUtf8 = file;
 #endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_INFO, msgUtf8, fileStrUtf8, line);
-}
+		return GB_Utf8Replace(fileUtf8, GB_STR("\\"), GB_STR("/"));
+	}
 
-void GB_Logger::LogWarning(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	// 解析配置中的日志级别（级别名或 0~6 的数字），无法识别时返回 defaultLevel
+	static GB_LogLevel ParseLogLevel(const string& value, GB_LogLevel defaultLevel)
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_WARNING, msgUtf8, "", line);
-		return;
+		if (value == GB_STR("TRACE") || value == GB_STR("0"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_TRACE;
+		}
+		else if (value == GB_STR("DEBUG") || value == GB_STR("1"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_DEBUG;
+		}
+		else if (value == GB_STR("INFO") || value == GB_STR("2"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_INFO;
+		}
+		else if (value == GB_STR("WARNING") || value == GB_STR("3"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_WARNING;
+		}
+		else if (value == GB_STR("ERROR") || value == GB_STR("4"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_ERROR;
+		}
+		else if (value == GB_STR("FATAL") || value == GB_STR("5"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_FATAL;
+		}
+		else if (value == GB_STR("DISABLELOG") || value == GB_STR("6"))
+		{
+			return GB_LogLevel::GBLOGLEVEL_DISABLELOG;
+		}
+		return defaultLevel;
 	}
 
-#if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
-#else
-	string fileStrUtf8 = file;
-#endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_WARNING, msgUtf8, fileStrUtf8, line);
-}
+	// 日志相关的配置项
+	struct LogConfigValues
+	{
+		bool isEnabled = false;
+		bool isToConsole = false;
+		GB_LogLevel filterLevel = GB_LogLevel::GBLOGLEVEL_TRACE;
+		GB_LogLevel allLogLevel = GB_LogLevel::GBLOGLEVEL_TRACE;
+	};
 
-void GB_Logger::LogError(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	static LogConfigValues ReadLogConfig()
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_ERROR, msgUtf8, "", line);
-		return;
+		const unordered_map<string, string> allConfig = GB_GetAllGbConfig();
+		LogConfigValues values;
+
+		unordered_map<string, string>::const_iterator it = allConfig.find(GB_STR("GB_EnableLog"));
+		values.isEnabled = (it != allConfig.end() && it->second == GB_STR("1"));
+
+		it = allConfig.find(GB_STR("GB_IsLogToConsole"));
+		values.isToConsole = (it != allConfig.end() && it->second == GB_STR("1"));
+
+		it = allConfig.find(GB_STR("GB_LogLevel"));
+		values.filterLevel = (it == allConfig.end()) ? GB_LogLevel::GBLOGLEVEL_TRACE : ParseLogLevel(it->second, GB_LogLevel::GBLOGLEVEL_TRACE);
+
+		it = allConfig.find(GB_STR("GB_AllLogLevel"));
+		values.allLogLevel = (it == allConfig.end()) ? GB_LogLevel::GBLOGLEVEL_TRACE : ParseLogLevel(it->second, GB_LogLevel::GBLOGLEVEL_TRACE);
+		return values;
 	}
 
-#if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
-#else
-	string fileStrUtf8 = file;
-#endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_ERROR, msgUtf8, fileStrUtf8, line);
-}
+	// 已构造且尚未析构的 GB_Logger 实例。GB_IsLogEnabled 等查询函数据此决定读缓存还是直接读配置，
+	// 避免仅为查询配置就创建单例并启动日志线程
+	static std::atomic<GB_Logger*> liveLogger{ nullptr };
 
-void GB_Logger::LogFatal(const std::string& msgUtf8, const char* file, int line)
-{
-	if (!file)
+	// 读取 logger_detail::LogArgBuffer 编码的参数
+	class LogArgReader
 	{
-		Log(GB_LogLevel::GBLOGLEVEL_FATAL, msgUtf8, "", line);
-		return;
-	}
+	public:
+		LogArgReader(const char* data, size_t bytes) : cursor(data), end(data + bytes)
+		{
+		}
 
-#if defined(_WIN32)
-	string fileStrUtf8 = GB_AnsiToUtf8(file);
-#else
-	string fileStrUtf8 = file;
-#endif
-	fileStrUtf8 = GB_Utf8Replace(fileStrUtf8, GB_STR("\\"), GB_STR("/"));
-	Log(GB_LogLevel::GBLOGLEVEL_FATAL, msgUtf8, fileStrUtf8, line);
-}
+		bool HasMore() const
+		{
+			return cursor < end;
+		}
 
-const static string allLogFilePath = GB_GetExeDirectory() + GB_STR("GB_Logs/GB_AllLog.log");
-const static string outputLogFilePath = GB_GetExeDirectory() + GB_STR("GB_Logs/GB_OutputLog.log");
+		unsigned char ReadTag()
+		{
+			return static_cast<unsigned char>(*cursor++);
+		}
 
-bool GB_Logger::ClearLogFiles() const
-{
-	const bool success1 = GB_CreateFileRecursive(allLogFilePath);
-	const bool success2 = GB_CreateFileRecursive(outputLogFilePath);
-	return success1 && success2;
-}
+		template <typename T>
+		T Read()
+		{
+			T value;
+			memcpy(&value, cursor, sizeof(value));
+			cursor += sizeof(value);
+			return value;
+		}
 
-GB_Logger::GB_Logger()
-{
-	isStop.store(false, std::memory_order_release);
+		string ReadString()
+		{
+			const uint32_t length = Read<uint32_t>();
+			string value(cursor, length);
+			cursor += length;
+			return value;
+		}
 
-	logThread = std::thread(&GB_Logger::LogThreadFunc, this);
-	logThread.detach();
-}
+	private:
+		const char* cursor;
+		const char* end;
+	};
 
-GB_Logger::~GB_Logger()
-{
-	isStop.store(true, std::memory_order_release);
-	logQueueCv.notify_all();
+	static string FormatLogDouble(double value)
+	{
+		char text[32] = { 0 };
+		snprintf(text, sizeof(text), "%.15g", value);
+		if (strtod(text, nullptr) != value)
+		{
+			snprintf(text, sizeof(text), "%.17g", value);
+		}
+		return text;
+	}
 
-	if (logThread.joinable())
+	static string FormatLogPointer(uint64_t value)
 	{
-		logThread.join();
+		char text[32] = { 0 };
+		snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(value));
+		return text;
 	}
 
-	std::queue<GB_LogItem> emptyQueue;
-	std::swap(logQueue, emptyQueue);
-}
+	// 读取一个参数（标签已读出），同时给出消息中的文本与 JSON 值
+	static void ReadLogArgValue(LogArgReader& reader, unsigned char tag, string& text, string& jsonValue)
+	{
+		switch (tag)
+		{
+		case logger_detail::LOG_ARG_BOOL:
+			text = reader.Read<unsigned char>() ? GB_STR("true") : GB_STR("false");
+			jsonValue = text;
+			return;
+		case logger_detail::LOG_ARG_INT64:
+			text = std::to_string(reader.Read<int64_t>());
+			jsonValue = text;
+			return;
+		case logger_detail::LOG_ARG_UINT64:
+			text = std::to_string(reader.Read<uint64_t>());
+			jsonValue = text;
+			return;
+		case logger_detail::LOG_ARG_DOUBLE:
+		{
+			const double value = reader.Read<double>();
+			text = FormatLogDouble(value);
+			// NaN/Inf 不是合法的 JSON 数字，按字符串输出
+			jsonValue = (value == value && value - value == 0) ? text : GB_STR("\"") + text + GB_STR("\"");
+			return;
+		}
+		case logger_detail::LOG_ARG_CHAR:
+			text.assign(1, reader.Read<char>());
+			break;
+		case logger_detail::LOG_ARG_STRING:
+			text = reader.ReadString();
+			break;
+		case logger_detail::LOG_ARG_POINTER:
+			text = FormatLogPointer(reader.Read<uint64_t>());
+			break;
+		default:
+			text.clear();
+			break;
+		}
 
-void GB_Logger::LogThreadFunc()
-{
-	while (!isStop.load(std::memory_order_acquire))
+		jsonValue = GB_STR("\"");
+		AppendJsonEscaped(jsonValue, text);
+		jsonValue += GB_STR("\"");
+	}
+
+	// 与 JSON 输出中内置键同名的字段会覆盖/混淆这些键
+	static bool IsReservedLogFieldKey(const string& key)
 	{
-		std::queue<GB_LogItem> localQueue;
+		static const char* const reservedKeys[] = { "ts", "level", "thread", "file", "line", "msg" };
+		for (size_t i = 0; i < sizeof(reservedKeys) / sizeof(reservedKeys[0]); i++)
 		{
-			std::unique_lock<std::mutex> lock(logQueueMtx);
-			logQueueCv.wait(lock, [this] {
-				return !logQueue.empty() || isStop.load(std::memory_order_acquire); });
-			if (isStop.load(std::memory_order_acquire))
-			{
-				return;
-			}
-			while (!logQueue.empty())
+			if (key == reservedKeys[i])
 			{
-				localQueue.push(logQueue.front());
-				logQueue.pop();
+				return true;
 			}
 		}
+		return false;
+	}
+
+	// 把 "{}" 依次替换为普通参数，GB_LogField 参数收集到 item.fields
+	static void FormatDeferredLogMessage(const char* data, size_t bytes, GB_LogItem& item)
+	{
+		const char* formatPtr = nullptr;
+		memcpy(&formatPtr, data, sizeof(formatPtr));
 
-		if (localQueue.empty())
+		LogArgReader reader(data + sizeof(formatPtr), bytes - sizeof(formatPtr));
+		string inlineFormat;
+		if (!formatPtr)
 		{
-			continue;
+			// 非字面量的格式串随记录一起拷贝
+			inlineFormat = reader.ReadString();
 		}
+		const char* formatUtf8 = formatPtr ? formatPtr : inlineFormat.c_str();
 
-		while (!localQueue.empty())
+		vector<string> args;
+		string text;
+		string jsonValue;
+		while (reader.HasMore())
 		{
-			const GB_LogItem logItem = localQueue.front();
-			localQueue.pop();
-
-			if (isStop)
+			const unsigned char tag = reader.ReadTag();
+			if (tag == logger_detail::LOG_ARG_FIELD)
 			{
-				return;
+				GB_LogItemField field;
+				field.key = reader.ReadString();
+				if (IsReservedLogFieldKey(field.key))
+				{
+					field.key.insert(0, GB_STR("field."));
+				}
+				ReadLogArgValue(reader, reader.ReadTag(), text, field.jsonValue);
+				item.fields.push_back(std::move(field));
+				continue;
 			}
+			ReadLogArgValue(reader, tag, text, jsonValue);
+			args.push_back(std::move(text));
+		}
 
-			if (!GB_IsLogEnabled())
+		string& message = item.message;
+		size_t argIndex = 0;
+		for (const char* p = formatUtf8; *p != '\0'; p++)
+		{
+			if (p[0] == '{' && p[1] == '{')
 			{
-				continue;
+				message += '{';
+				p++;
+			}
+			else if (p[0] == '}' && p[1] == '}')
+			{
+				message += '}';
+				p++;
+			}
+			else if (p[0] == '{' && p[1] == '}' && argIndex < args.size())
+			{
+				message += args[argIndex++];
+				p++;
+			}
+			else
+			{
+				message += *p;
 			}
+		}
+		for (; argIndex < args.size(); argIndex++)
+		{
+			message += GB_STR(" ");
+			message += args[argIndex];
+		}
+	}
 
-			const string logJsonUtf8 = logItem.ToJsonString();
-			GB_WriteUtf8ToFile(allLogFilePath, logJsonUtf8);
+	/*
+		日志线程私有的时间戳格式化器，输出与 GetLocalTimeStr() 相同的 "YYYY-MM-DDTHH:MM:SS.mmm"。
+		同一秒内的记录只改写末尾 3 位毫秒，本地时间换算与日期格式化每秒最多做一次。
+	*/
+	class LogTimestampFormatter
+	{
+	public:
+		void Format(int64_t timestampNs, string& out)
+		{
+			int64_t seconds = timestampNs / 1000000000;
+			int64_t subSecondNs = timestampNs % 1000000000;
+			if (subSecondNs < 0)
+			{
+				seconds--;
+				subSecondNs += 1000000000;
+			}
 
-			if (GB_CheckLogLevel(logItem.level))
+			if (!hasCachedSecond || seconds != cachedSecond)
 			{
-				GB_WriteUtf8ToFile(outputLogFilePath, logJsonUtf8);
-				if (GB_IsLogToConsole())
-				{
-					const string logTextUtf8 = logItem.ToPlainTextString();
-					internal::ConsoleWriteColoredUtf8(logTextUtf8, logItem.level);
-				}
+				const time_t tt = static_cast<time_t>(seconds);
+				tm localTm;
+#if defined(_WIN32)
+				localtime_s(&localTm, &tt);
+#else
+				localtime_r(&tt, &localTm);
+#endif
+				char prefix[32] = { 0 };
+				const size_t prefixBytes = strftime(prefix, sizeof(prefix), "%Y-%m-%dT%H:%M:%S.", &localTm);
+				cachedPrefix.assign(prefix, prefixBytes);
+				cachedSecond = seconds;
+				hasCachedSecond = true;
 			}
+
+			const int ms = static_cast<int>(subSecondNs / 1000000);
+			out.assign(cachedPrefix);
+			out += static_cast<char>('0' + ms / 100);
+			out += static_cast<char>('0' + ms / 10 % 10);
+			out += static_cast<char>('0' + ms % 10);
 		}
-	}
-}
 
-bool GB_IsLogEnabled()
-{
-	const static string targetKey = GB_STR("GB_EnableLog");
+	private:
+		bool hasCachedSecond = false;
+		int64_t cachedSecond = 0;
+		string cachedPrefix;
+	};
 
-	if (!GB_IsExistsGbConfig(targetKey))
+	/*
+		DropOldest 策略：从溢出队列头部丢弃整条记录，直到能放下 incomingBytes。
+		为避免日志风暴时每条记录都搬移整个缓冲区，一次至少腾出 maxBytes 的 1/8。
+		按级别累加到 droppedCounts，返回丢弃条数。
+	*/
+	static uint64_t DropOldestLogRecords(vector<unsigned char>& records, size_t incomingBytes, size_t maxBytes, uint64_t* droppedCounts)
 	{
-		return false;
+		const size_t targetBytes = maxBytes > incomingBytes ? maxBytes - incomingBytes : 0;
+		const size_t minFreeBytes = maxBytes / 8;
+
+		uint64_t droppedCount = 0;
+		size_t dropBytes = 0;
+		while (dropBytes + sizeof(LogRecordHeader) <= records.size() &&
+			(records.size() - dropBytes > targetBytes || dropBytes < minFreeBytes))
+		{
+			LogRecordHeader header;
+			memcpy(&header, records.data() + dropBytes, sizeof(header));
+			droppedCounts[header.level]++;
+			droppedCount++;
+			dropBytes += header.recordBytes;
+		}
+		records.erase(records.begin(), records.begin() + dropBytes);
+		return droppedCount;
 	}
 
-	string value;
-	return (GB_GetGbConfig(targetKey, value) && "1" == value);
-}
+	// 日志线程解码后的记录。timestampNs 用于多个线程缓冲之间按时间归并。
+	struct DecodedLogRecord
+	{
+		int64_t timestampNs = 0;
+		GB_LogItem item;
+	};
 
-bool GB_SetLogEnabled(bool enable)
-{
-	const static string targetKey = GB_STR("GB_EnableLog");
-	const string value = enable ? GB_STR("1") : GB_STR("0");
-	return GB_SetGbConfig(targetKey, value);
-}
+	// 日志线程私有的解码器：缓存 __FILE__ -> UTF-8 的转换结果（调用点数量有限，缓存命中率很高）与当前秒的时间戳前缀
+	class LogRecordDecoder
+	{
+	public:
+		void Decode(const unsigned char* data, const LogRecordHeader& header, const string& ringThreadId, vector<DecodedLogRecord>& out)
+		{
+			const char* cursor = reinterpret_cast<const char*>(data) + sizeof(LogRecordHeader);
 
-bool GB_IsLogToConsole()
-{
-	const static string targetKey = GB_STR("GB_IsLogToConsole");
+			out.push_back(DecodedLogRecord());
+			DecodedLogRecord& record = out.back();
+			record.timestampNs = header.timestampNs;
 
-	if (!GB_IsExistsGbConfig(targetKey))
-	{
-		return false;
-	}
+			GB_LogItem& item = record.item;
+			timestampFormatter.Format(header.timestampNs, item.timestamp);
+			item.level = static_cast<GB_LogLevel>(header.level);
+			item.line = header.line;
 
-	string value;
-	return (GB_GetGbConfig(targetKey, value) && "1" == value);
-}
+			if (header.threadIdBytes > 0)
+			{
+				item.threadId.assign(cursor, header.threadIdBytes);
+				cursor += header.threadIdBytes;
+			}
+			else
+			{
+				item.threadId = ringThreadId;
+			}
 
-bool GB_SetLogToConsole(bool enable)
-{
-	const static string targetKey = GB_STR("GB_IsLogToConsole");
-	const string value = enable ? GB_STR("1") : GB_STR("0");
-	return GB_SetGbConfig(targetKey, value);
-}
+			const string file(cursor, header.fileBytes);
+			cursor += header.fileBytes;
+			if ((header.flags & LOG_RECORD_FLAG_NATIVE_FILE) != 0)
+			{
+				unordered_map<string, string>::const_iterator it = fileNameCache.find(file);
+				if (it == fileNameCache.end())
+				{
+					it = fileNameCache.insert(make_pair(file, NativeFileToUtf8(file))).first;
+				}
+				item.file = it->second;
+			}
+			else
+			{
+				item.file = file;
+			}
 
-GB_LogLevel GB_GetLogFilterLevel()
-{
-	const static string targetKey = GB_STR("GB_LogLevel");
+			if ((header.flags & LOG_RECORD_FLAG_DEFERRED_FORMAT) != 0)
+			{
+				FormatDeferredLogMessage(cursor, header.messageBytes, item);
+			}
+			else
+			{
+				item.message.assign(cursor, header.messageBytes);
+			}
+		}
 
-	if (!GB_IsLogEnabled())
-	{
-		return GB_LogLevel::GBLOGLEVEL_DISABLELOG;
-	}
+	private:
+		unordered_map<string, string> fileNameCache;
+		LogTimestampFormatter timestampFormatter;
+	};
 
-	if (!GB_IsExistsGbConfig(targetKey))
-	{
-		return GB_LogLevel::GBLOGLEVEL_TRACE;
-	}
-	string value;
-	if (!GB_GetGbConfig(targetKey, value))
+	// 溢出丢弃汇总日志：总数写在消息里，各级别条数作为结构化字段
+	static DecodedLogRecord MakeDroppedLogReport(const uint64_t* droppedCounts, int levelCount, uint64_t droppedCount)
 	{
-		return GB_LogLevel::GBLOGLEVEL_TRACE;
+		DecodedLogRecord record;
+		record.timestampNs = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+		GB_LogItem& item = record.item;
+		LogTimestampFormatter().Format(record.timestampNs, item.timestamp);
+		item.level = GB_LogLevel::GBLOGLEVEL_WARNING;
+		item.threadId = GB_STR("GB_Logger");
+		item.file = GB_STR("GB_Logger.cpp");
+		item.line = 0;
+		item.message = GB_STR("GB_Logger dropped ") + std::to_string(droppedCount) + GB_STR(" log records because the log queue was full");
+		for (int level = 0; level < levelCount; level++)
+		{
+			if (droppedCounts[level] == 0)
+			{
+				continue;
+			}
+			GB_LogItemField field;
+			field.key = GB_STR("dropped") + LogLevelToString(static_cast<GB_LogLevel>(level));
+			field.jsonValue = std::to_string(droppedCounts[level]);
+			item.fields.push_back(std::move(field));
+		}
+		return record;
+	}
+}
+
+namespace internal
+{
+	/*
+		飞行记录器：始终开启，每个写日志的线程各有一个定长槽位环，保存该线程最近 flightRecorderSlotCount 条记录的原始内容（不格式化）。
+		- 生产者在 Push 时只写自己的槽位环（序号也只由自己递增），按 seqlock 方式写槽位，线程之间不共享任何缓存行、不加锁、不分配内存。
+		- 槽位环登记在定长的 flightRecorders 表中，只分配不释放：线程退出时归还，表满后供新线程复用，因此崩溃处理函数随时读取都是安全的。
+		- 崩溃处理函数在信号上下文中按时间戳归并各线程的记录，写到预先打开的崩溃日志，仍在线程缓冲/溢出队列里、尚未落盘的记录也不会丢失。
+		- 同时写日志的线程超过 maxFlightRecorders 时，多出的线程不做飞行记录。
+		- 槽位大小固定，过长的文件名保留末尾，过长的消息截断。
+	*/
+	static const size_t flightRecorderSlotCount = 128; // 必须是 2 的幂
+	static const size_t maxFlightRecorders = 64;
+
+	struct FlightRecordSlot
+	{
+		std::atomic<uint64_t> sequence; // 0：从未写入；2*序号+1：写入中；2*序号+2：已完成
+		int64_t timestampNs;
+		int32_t line;
+		uint8_t level;
+		uint8_t flags;           // LogRecordFlags
+		uint8_t threadIdBytes;
+		uint8_t fileBytes;
+		uint16_t payloadBytes;
+		char threadId[32];
+		char file[64];
+		char payload[256];       // 消息；延迟格式化的记录为 格式串地址 + 参数编码
+	};
+
+	struct FlightRecorder
+	{
+		FlightRecorder() : nextTicket(0), isInUse(true)
+		{
+			for (size_t i = 0; i < flightRecorderSlotCount; i++)
+			{
+				slots[i].sequence.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		FlightRecordSlot slots[flightRecorderSlotCount];
+		std::atomic<uint64_t> nextTicket; // 只由当前持有者递增
+		std::atomic<bool> isInUse;
+	};
+
+	static std::atomic<FlightRecorder*> flightRecorders[maxFlightRecorders];
+
+	/*
+		表未满时为新线程分配新的槽位环，使已退出线程的最后记录尽量保留到崩溃时；
+		表已满时复用已归还的槽位环中最久没有写入的一个；都不可用时返回 nullptr。
+	*/
+	static FlightRecorder* AcquireFlightRecorder()
+	{
+		for (size_t i = 0; i < maxFlightRecorders; i++)
+		{
+			if (flightRecorders[i].load(std::memory_order_acquire) != nullptr)
+			{
+				continue;
+			}
+
+			FlightRecorder* newRecorder = new (std::nothrow) FlightRecorder();
+			if (!newRecorder)
+			{
+				break;
+			}
+			for (; i < maxFlightRecorders; i++)
+			{
+				FlightRecorder* expected = nullptr;
+				if (flightRecorders[i].compare_exchange_strong(expected, newRecorder, std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					return newRecorder;
+				}
+			}
+			delete newRecorder;
+			break;
+		}
+
+		for (;;)
+		{
+			FlightRecorder* oldest = nullptr;
+			int64_t oldestTimestampNs = 0;
+			for (size_t i = 0; i < maxFlightRecorders; i++)
+			{
+				FlightRecorder* recorder = flightRecorders[i].load(std::memory_order_acquire);
+				if (!recorder || recorder->isInUse.load(std::memory_order_relaxed))
+				{
+					continue;
+				}
+				const uint64_t nextTicket = recorder->nextTicket.load(std::memory_order_acquire);
+				const int64_t lastTimestampNs = nextTicket == 0 ? 0 : recorder->slots[(nextTicket - 1) & (flightRecorderSlotCount - 1)].timestampNs;
+				if (!oldest || lastTimestampNs < oldestTimestampNs)
+				{
+					oldest = recorder;
+					oldestTimestampNs = lastTimestampNs;
+				}
+			}
+			if (!oldest)
+			{
+				return nullptr;
+			}
+
+			bool isInUse = false;
+			if (oldest->isInUse.compare_exchange_strong(isInUse, true, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return oldest;
+			}
+		}
+	}
+
+	static void ReleaseFlightRecorder(FlightRecorder* recorder)
+	{
+		if (recorder)
+		{
+			recorder->isInUse.store(false, std::memory_order_release);
+		}
+	}
+
+	// 仅由 recorder 的持有线程调用
+	static void RecordFlight(FlightRecorder& recorder, const LogRecordHeader& header, const string& threadId, const char* fileData, const char* payloadData)
+	{
+		const uint64_t ticket = recorder.nextTicket.load(std::memory_order_relaxed);
+		FlightRecordSlot& slot = recorder.slots[ticket & (flightRecorderSlotCount - 1)];
+		slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.timestampNs = header.timestampNs;
+		slot.line = header.line;
+		slot.level = header.level;
+		slot.flags = header.flags;
+
+		const size_t threadIdBytes = std::min(threadId.size(), sizeof(slot.threadId));
+		memcpy(slot.threadId, threadId.data(), threadIdBytes);
+		slot.threadIdBytes = static_cast<uint8_t>(threadIdBytes);
+
+		const size_t fileBytes = std::min<size_t>(header.fileBytes, sizeof(slot.file));
+		if (fileBytes > 0)
+		{
+			memcpy(slot.file, fileData + header.fileBytes - fileBytes, fileBytes);
+		}
+		slot.fileBytes = static_cast<uint8_t>(fileBytes);
+
+		const size_t payloadBytes = std::min<size_t>(header.messageBytes, sizeof(slot.payload));
+		if (payloadBytes > 0)
+		{
+			memcpy(slot.payload, payloadData, payloadBytes);
+		}
+		slot.payloadBytes = static_cast<uint16_t>(payloadBytes);
+
+		slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+		recorder.nextTicket.store(ticket + 1, std::memory_order_release);
+	}
+}
+
+/*
+	每线程 SPSC 环形缓冲：
+	- 生产者（所属线程）只写 writePos，日志线程只写 readPos，二者都是单调递增的字节序号，取模得到缓冲区偏移。
+	- 一条记录总是在缓冲区内连续存放；尾部空间不足时先写一条填充记录（或尾部连头都放不下时隐式跳过）再回绕。
+*/
+struct GB_Logger::ThreadRing
+{
+	explicit ThreadRing(size_t capacityBytes)
+		: buffer(new unsigned char[capacityBytes]), capacity(capacityBytes), threadId(internal::ThreadIdToString(std::this_thread::get_id())),
+		flightRecorder(internal::AcquireFlightRecorder()), cachedReadPos(0), writePos(0), readPos(0), isOwnerAlive(true)
+	{
+	}
+
+	// 仅由所属线程调用
+	bool TryWrite(const internal::LogRecordHeader& header, const char* fileData, const char* msgData)
+	{
+		const size_t recordBytes = header.recordBytes;
+		uint64_t start = writePos.load(std::memory_order_relaxed);
+		const size_t offset = static_cast<size_t>(start & (capacity - 1));
+		const size_t tailRoom = capacity - offset;
+		const size_t neededBytes = (tailRoom < recordBytes) ? tailRoom + recordBytes : recordBytes;
+
+		if (start + neededBytes - cachedReadPos > capacity)
+		{
+			cachedReadPos = readPos.load(std::memory_order_acquire);
+			if (start + neededBytes - cachedReadPos > capacity)
+			{
+				return false;
+			}
+		}
+
+		if (tailRoom < recordBytes)
+		{
+			if (tailRoom >= sizeof(internal::LogRecordHeader))
+			{
+				internal::LogRecordHeader padding;
+				memset(&padding, 0, sizeof(padding));
+				padding.recordBytes = static_cast<uint32_t>(tailRoom);
+				padding.kind = internal::LOG_RECORD_KIND_PADDING;
+				memcpy(buffer.get() + offset, &padding, sizeof(padding));
+			}
+			start += tailRoom;
+		}
+
+		internal::WriteLogRecord(buffer.get() + static_cast<size_t>(start & (capacity - 1)), header, "", fileData, msgData);
+		writePos.store(start + recordBytes, std::memory_order_release);
+		return true;
+	}
+
+	// 仅由日志线程调用
+	void Drain(internal::LogRecordDecoder& decoder, vector<internal::DecodedLogRecord>& out)
+	{
+		uint64_t pos = readPos.load(std::memory_order_relaxed);
+		const uint64_t end = writePos.load(std::memory_order_acquire);
+		while (pos < end)
+		{
+			const size_t offset = static_cast<size_t>(pos & (capacity - 1));
+			const size_t tailRoom = capacity - offset;
+			if (tailRoom < sizeof(internal::LogRecordHeader))
+			{
+				pos += tailRoom;
+				continue;
+			}
+
+			internal::LogRecordHeader header;
+			memcpy(&header, buffer.get() + offset, sizeof(header));
+			if (header.kind == internal::LOG_RECORD_KIND_ENTRY)
+			{
+				decoder.Decode(buffer.get() + offset, header, threadId, out);
+			}
+			pos += header.recordBytes;
+		}
+		readPos.store(pos, std::memory_order_release);
+	}
+
+	bool HasPending() const
+	{
+		return readPos.load(std::memory_order_acquire) != writePos.load(std::memory_order_acquire);
+	}
+
+	const std::unique_ptr<unsigned char[]> buffer;
+	const size_t capacity;
+	const std::string threadId; // 注册时格式化一次
+	internal::FlightRecorder* const flightRecorder; // 飞行记录槽位环，登记表已满时为 nullptr；所属线程退出时归还
+
+	uint64_t cachedReadPos; // 生产者私有：上次看到的 readPos，减少对共享缓存行的读取
+	char producerPadding[64];
+	std::atomic<uint64_t> writePos;
+	char consumerPadding[64];
+	std::atomic<uint64_t> readPos;
+	std::atomic<bool> isOwnerAlive; // 所属线程退出后置 false，日志线程读空后注销
+};
+
+namespace internal
+{
+	// 下一个轮转时刻（本地时间的下一个整点/零点）；interval 为 None 时返回 0
+	static time_t NextRotationBoundary(time_t base, GB_LogRotationInterval interval)
+	{
+		if (interval == GB_LogRotationInterval::None)
+		{
+			return 0;
+		}
+
+		tm localTm;
+#if defined(_WIN32)
+		localtime_s(&localTm, &base);
+#else
+		localtime_r(&base, &localTm);
+#endif
+		localTm.tm_min = 0;
+		localTm.tm_sec = 0;
+		if (interval == GB_LogRotationInterval::Daily)
+		{
+			localTm.tm_hour = 0;
+			localTm.tm_mday += 1;
+		}
+		else
+		{
+			localTm.tm_hour += 1;
+		}
+		localTm.tm_isdst = -1;
+		return mktime(&localTm);
+	}
+
+	// "<dir>/<name>.<YYYYMMDD-HHMMSS-mmm>[_N]<ext>"：文件名按字典序即按时间先后排列，过期清理直接按名字排序
+	static string MakeRotatedLogPath(const string& pathUtf8, const chrono::system_clock::time_point& when)
+	{
+		const time_t seconds = chrono::system_clock::to_time_t(when);
+		tm localTm;
+#if defined(_WIN32)
+		localtime_s(&localTm, &seconds);
+#else
+		localtime_r(&seconds, &localTm);
+#endif
+		char stamp[32] = { 0 };
+		const size_t stampBytes = strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &localTm);
+		const long long msPart = chrono::duration_cast<chrono::milliseconds>(when.time_since_epoch()).count() % 1000;
+		snprintf(stamp + stampBytes, sizeof(stamp) - stampBytes, "-%03lld", msPart);
+
+		const string ext = GB_GetFileExt(pathUtf8);
+		const string stem = pathUtf8.substr(0, pathUtf8.size() - ext.size());
+		string rotatedPath = stem + GB_STR(".") + stamp + ext;
+		for (int i = 1; GB_IsFileExists(rotatedPath) || GB_IsFileExists(rotatedPath + GB_STR(".gz")); i++)
+		{
+			rotatedPath = stem + GB_STR(".") + stamp + GB_STR("_") + std::to_string(i) + ext;
+		}
+		return rotatedPath;
+	}
+
+	static bool RenameLogFile(const string& fromUtf8, const string& toUtf8)
+	{
+#if defined(_WIN32)
+		return ::MoveFileExW(GB_Utf8ToWString(fromUtf8).c_str(), GB_Utf8ToWString(toUtf8).c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+		return ::rename(fromUtf8.c_str(), toUtf8.c_str()) == 0;
+#endif
+	}
+
+	/*
+		轮转后的后台维护（在维护线程池中执行）：
+		1) 用内置的 gzip 写入器把刚轮转出来的文件压缩为 .gz，成功后删除原文件；失败时保留原文件并记一条错误日志；
+		2) 按文件名（内含时间戳，字典序即时间序）只保留最新的 maxRotatedFiles 个历史文件。
+	*/
+	static void MaintainRotatedLogs(const string& activePathUtf8, const string& rotatedPathUtf8, const GB_LogRotationOptions& options)
+	{
+		// 文件可能已被更早的清理任务删除
+		if (options.compressRotatedFiles && GB_IsFileExists(rotatedPathUtf8))
+		{
+			const string compressedPathUtf8 = rotatedPathUtf8 + GB_STR(".gz");
+			if (GB_GzipCompressFile(rotatedPathUtf8, compressedPathUtf8))
+			{
+				GB_DeleteFile(rotatedPathUtf8);
+			}
+			else
+			{
+				GB_Logger* logger = liveLogger.load(std::memory_order_acquire);
+				if (logger)
+				{
+					logger->LogError(GB_STR("GB_Logger failed to compress rotated log file, keeping it uncompressed: ") + rotatedPathUtf8, __FILE__, __LINE__);
+				}
+			}
+		}
+
+		if (options.maxRotatedFiles == 0)
+		{
+			return;
+		}
+
+		const string ext = GB_GetFileExt(activePathUtf8);
+		const string prefix = GB_GetFileName(activePathUtf8, false) + GB_STR(".");
+		const string activeName = GB_GetFileName(activePathUtf8, true);
+		const vector<string> files = GB_GetFilesList(GB_GetDirectoryPath(activePathUtf8), false);
+
+		vector<string> rotatedFiles;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			const string name = GB_GetFileName(files[i], true);
+			if (name == activeName || name.compare(0, prefix.size(), prefix) != 0)
+			{
+				continue;
+			}
+
+			const string gzExt = ext + GB_STR(".gz");
+			const bool isPlain = name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+			const bool isCompressed = name.size() > gzExt.size() && name.compare(name.size() - gzExt.size(), gzExt.size(), gzExt) == 0;
+			if (isPlain || isCompressed)
+			{
+				rotatedFiles.push_back(files[i]);
+			}
+		}
+
+		if (rotatedFiles.size() <= options.maxRotatedFiles)
+		{
+			return;
+		}
+
+		std::sort(rotatedFiles.begin(), rotatedFiles.end());
+		const size_t deleteCount = rotatedFiles.size() - options.maxRotatedFiles;
+		for (size_t i = 0; i < deleteCount; i++)
+		{
+			GB_DeleteFile(rotatedFiles[i]);
+		}
+	}
+
+	/*
+		日志文件：常驻打开的追加写句柄。
+		- 每批日志只调用一次 Append（内部循环处理短写）。
+		- 以追加模式打开：外部截断（ClearLogFiles）后继续写在新的文件末尾。
+		- 每秒最多检查一次文件是否被删除/替换，是则重新打开，避免一直写进已被删除的 inode。
+		- 轮转：写入前若超过大小上限或跨过时间边界，则关闭、改名、重新打开，再通过 onRotated 通知调用方做后台维护。
+	*/
+	class LogFile
+	{
+	public:
+		explicit LogFile(const string& filePathUtf8) : pathUtf8(filePathUtf8)
+		{
+		}
+
+		~LogFile()
+		{
+			Close();
+		}
+
+		LogFile(const LogFile&) = delete;
+		LogFile& operator=(const LogFile&) = delete;
+
+		void SetRotationOptions(const GB_LogRotationOptions& options)
+		{
+			rotationOptions = options;
+			nextRotationTime = 0;
+			if (IsOpen())
+			{
+				nextRotationTime = NextRotationBoundary(fileTimeBase, rotationOptions.interval);
+			}
+		}
+
+		const string& GetPath() const
+		{
+			return pathUtf8;
+		}
+
+		bool Append(const string& data)
+		{
+			if (data.empty())
+			{
+				return true;
+			}
+
+			CheckReopen();
+			if (!EnsureOpen())
+			{
+				return false;
+			}
+
+			if (ShouldRotate(data.size()))
+			{
+				Rotate();
+				if (!EnsureOpen())
+				{
+					return false;
+				}
+			}
+
+			const char* cursor = data.data();
+			size_t remaining = data.size();
+#if defined(_WIN32)
+			const DWORD chunkBytes = 64 * 1024 * 1024;
+			while (remaining > 0)
+			{
+				const DWORD toWrite = static_cast<DWORD>(remaining > chunkBytes ? chunkBytes : remaining);
+				DWORD written = 0;
+				if (!::WriteFile(fileHandle, cursor, toWrite, &written, nullptr) || written == 0)
+				{
+					Close();
+					return false;
+				}
+				cursor += written;
+				remaining -= written;
+			}
+#else
+			while (remaining > 0)
+			{
+				const ssize_t written = ::write(fd, cursor, remaining);
+				if (written < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					Close();
+					return false;
+				}
+				cursor += written;
+				remaining -= static_cast<size_t>(written);
+			}
+#endif
+			currentBytes += data.size();
+			hasUnsyncedData = true;
+			return true;
+		}
+
+		void Sync()
+		{
+			if (!hasUnsyncedData || !IsOpen())
+			{
+				return;
+			}
+#if defined(_WIN32)
+			::FlushFileBuffers(fileHandle);
+#else
+			::fsync(fd);
+#endif
+			hasUnsyncedData = false;
+		}
+
+		bool HasUnsyncedData() const
+		{
+			return hasUnsyncedData;
+		}
+
+		void Close()
+		{
+#if defined(_WIN32)
+			if (fileHandle != INVALID_HANDLE_VALUE)
+			{
+				::CloseHandle(fileHandle);
+				fileHandle = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (fd >= 0)
+			{
+				::close(fd);
+				fd = -1;
+			}
+#endif
+			hasUnsyncedData = false;
+		}
+
+		// 轮转完成后在日志线程上回调，参数为历史文件路径
+		std::function<void(const string&)> onRotated;
+
+	private:
+		bool IsOpen() const
+		{
+#if defined(_WIN32)
+			return fileHandle != INVALID_HANDLE_VALUE;
+#else
+			return fd >= 0;
+#endif
+		}
+
+		bool EnsureOpen()
+		{
+			if (IsOpen())
+			{
+				return true;
+			}
+
+			const string dirPathUtf8 = GB_GetDirectoryPath(pathUtf8);
+			if (!dirPathUtf8.empty() && !GB_IsDirectoryExists(dirPathUtf8))
+			{
+				GB_CreateDirectory(dirPathUtf8);
+			}
+
+			const time_t now = time(nullptr);
+			fileTimeBase = now;
+			currentBytes = 0;
+#if defined(_WIN32)
+			const std::wstring pathW = GB_Utf8ToWString(pathUtf8);
+			fileHandle = ::CreateFileW(pathW.c_str(), FILE_APPEND_DATA | FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+			{
+				LARGE_INTEGER size;
+				FILETIME lastWriteTime;
+				if (::GetFileSizeEx(fileHandle, &size) && size.QuadPart > 0)
+				{
+					currentBytes = static_cast<uint64_t>(size.QuadPart);
+					if (::GetFileTime(fileHandle, nullptr, nullptr, &lastWriteTime))
+					{
+						ULARGE_INTEGER ticks;
+						ticks.LowPart = lastWriteTime.dwLowDateTime;
+						ticks.HighPart = lastWriteTime.dwHighDateTime;
+						fileTimeBase = static_cast<time_t>((ticks.QuadPart - 116444736000000000ULL) / 10000000ULL);
+					}
+				}
+			}
+#else
+			fd = ::open(pathUtf8.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+			struct stat fdStat;
+			if (fd >= 0 && ::fstat(fd, &fdStat) == 0 && fdStat.st_size > 0)
+			{
+				// 已有内容：按最后写入时间计算时间边界，进程重启跨天后第一批日志就会触发轮转
+				currentBytes = static_cast<uint64_t>(fdStat.st_size);
+				fileTimeBase = fdStat.st_mtime;
+			}
+#endif
+			nextRotationTime = NextRotationBoundary(fileTimeBase, rotationOptions.interval);
+			lastCheckTime = chrono::steady_clock::now();
+			return IsOpen();
+		}
+
+		bool ShouldRotate(size_t incomingBytes) const
+		{
+			if (currentBytes == 0)
+			{
+				return false;
+			}
+			if (rotationOptions.maxFileBytes > 0 && currentBytes + incomingBytes > rotationOptions.maxFileBytes)
+			{
+				return true;
+			}
+			return nextRotationTime != 0 && time(nullptr) >= nextRotationTime;
+		}
+
+		void Rotate()
+		{
+			Sync();
+			Close();
+
+			const string rotatedPath = MakeRotatedLogPath(pathUtf8, chrono::system_clock::now());
+			if (RenameLogFile(pathUtf8, rotatedPath) && onRotated)
+			{
+				onRotated(rotatedPath);
+			}
+		}
+
+		void CheckReopen()
+		{
+			if (!IsOpen())
+			{
+				return;
+			}
+
+			const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+			if (now - lastCheckTime < chrono::seconds(1))
+			{
+				return;
+			}
+			lastCheckTime = now;
+
+#if defined(_WIN32)
+			if (!GB_IsFileExists(pathUtf8))
+			{
+				Close();
+				return;
+			}
+			LARGE_INTEGER size;
+			if (::GetFileSizeEx(fileHandle, &size))
+			{
+				currentBytes = static_cast<uint64_t>(size.QuadPart);
+			}
+#else
+			struct stat pathStat;
+			struct stat fdStat;
+			if (::stat(pathUtf8.c_str(), &pathStat) != 0 || ::fstat(fd, &fdStat) != 0 ||
+				pathStat.st_ino != fdStat.st_ino || pathStat.st_dev != fdStat.st_dev)
+			{
+				Close();
+				return;
+			}
+			// 外部截断（ClearLogFiles）后同步大小
+			currentBytes = static_cast<uint64_t>(fdStat.st_size);
+#endif
+		}
+
+		const string pathUtf8;
+#if defined(_WIN32)
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+#else
+		int fd = -1;
+#endif
+		bool hasUnsyncedData = false;
+		chrono::steady_clock::time_point lastCheckTime;
+
+		GB_LogRotationOptions rotationOptions;
+		uint64_t currentBytes = 0;
+		time_t fileTimeBase = 0;     // 计算时间边界的基准：新文件为打开时刻，已有文件为其最后写入时刻
+		time_t nextRotationTime = 0; // 0 表示不按时间轮转
+	};
+}
+
+namespace internal
+{
+#if !defined(_WIN32)
+	// UNIX 域套接字连接（syslog 用数据报，普通 socket sink 用流）
+	class UnixSocketConnection
+	{
+	public:
+		UnixSocketConnection(const string& socketPathUtf8, int socketType) : pathUtf8(socketPathUtf8), type(socketType)
+		{
+		}
+
+		~UnixSocketConnection()
+		{
+			Close();
+		}
+
+		UnixSocketConnection(const UnixSocketConnection&) = delete;
+		UnixSocketConnection& operator=(const UnixSocketConnection&) = delete;
+
+		bool IsConnected() const
+		{
+			return fd >= 0;
+		}
+
+		// 未连接时尝试连接；失败后 1 秒内不再重试
+		bool EnsureConnected()
+		{
+			if (fd >= 0)
+			{
+				return true;
+			}
+
+			const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+			if (hasTriedConnect && now - lastConnectTime < chrono::seconds(1))
+			{
+				return false;
+			}
+			hasTriedConnect = true;
+			lastConnectTime = now;
+
+			sockaddr_un address;
+			memset(&address, 0, sizeof(address));
+			address.sun_family = AF_UNIX;
+			if (pathUtf8.empty() || pathUtf8.size() >= sizeof(address.sun_path))
+			{
+				return false;
+			}
+			memcpy(address.sun_path, pathUtf8.data(), pathUtf8.size());
+
+			fd = ::socket(AF_UNIX, type | SOCK_CLOEXEC, 0);
+			if (fd < 0)
+			{
+				return false;
+			}
+
+			// 对端长时间不读时 send 超时返回，断开后按重连逻辑处理，避免写线程（以及移除 sink 时的 join）被无限期阻塞
+			timeval sendTimeout;
+			sendTimeout.tv_sec = 1;
+			sendTimeout.tv_usec = 0;
+			::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+			if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+			{
+				Close();
+				return false;
+			}
+			return true;
+		}
+
+		bool Send(const char* data, size_t bytes)
+		{
+			while (bytes > 0)
+			{
+				const ssize_t sent = ::send(fd, data, bytes, MSG_NOSIGNAL);
+				if (sent < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					Close();
+					return false;
+				}
+				data += sent;
+				bytes -= static_cast<size_t>(sent);
+			}
+			return true;
+		}
+
+		void Close()
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+				fd = -1;
+			}
+		}
+
+	private:
+		const string pathUtf8;
+		const int type;
+		int fd = -1;
+		bool hasTriedConnect = false;
+		chrono::steady_clock::time_point lastConnectTime;
+	};
+#endif
+
+	// syslog 严重程度（RFC 5424）
+	static int LogLevelToSyslogSeverity(GB_LogLevel level)
+	{
+		switch (level)
+		{
+		case GB_LogLevel::GBLOGLEVEL_FATAL:   return 2; // crit
+		case GB_LogLevel::GBLOGLEVEL_ERROR:   return 3; // err
+		case GB_LogLevel::GBLOGLEVEL_WARNING: return 4; // warning
+		case GB_LogLevel::GBLOGLEVEL_INFO:    return 6; // info
+		default:                              return 7; // debug
+		}
+	}
+}
+
+GB_LogSink::GB_LogSink(GB_LogLevel minLevel, GB_LogFormat format) : minLevel(static_cast<int>(minLevel)), format(format)
+{
+}
+
+GB_LogSink::~GB_LogSink()
+{
+}
+
+GB_LogLevel GB_LogSink::GetLevel() const
+{
+	return static_cast<GB_LogLevel>(minLevel.load(std::memory_order_relaxed));
+}
+
+void GB_LogSink::SetLevel(GB_LogLevel level)
+{
+	minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+	isLevelOverridden.store(true, std::memory_order_relaxed);
+	GB_Logger::GetInstance().RefreshActiveLevel();
+}
+
+GB_LogFormat GB_LogSink::GetFormat() const
+{
+	return format;
+}
+
+bool GB_LogSink::IsAccepted(GB_LogLevel level) const
+{
+	const int currentLevel = minLevel.load(std::memory_order_relaxed);
+	return currentLevel != static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG) && static_cast<int>(level) >= currentLevel;
+}
+
+uint64_t GB_LogSink::GetDroppedRecordCount() const
+{
+	return droppedRecords.load(std::memory_order_relaxed);
+}
+
+void GB_LogSink::OnIdle()
+{
+}
+
+bool GB_LogSink::IsBlocking() const
+{
+	return false;
+}
+
+void GB_LogSink::AppendFormatted(const GB_LogItem& item, string& out) const
+{
+	if (format == GB_LogFormat::PlainText)
+	{
+		internal::AppendLogItemPlainText(out, item);
+	}
+	else
+	{
+		internal::AppendLogItemJson(out, item);
+	}
+}
+
+struct GB_FileLogSink::Impl
+{
+	explicit Impl(const string& filePathUtf8) : file(filePathUtf8)
+	{
+	}
+
+	internal::LogFile file;
+	string batch;
+
+	GB_LogRotationOptions rotationOptions;
+	mutable std::mutex rotationOptionsMtx;
+	std::atomic<uint64_t> rotationOptionsVersion{ 1 }; // 每次修改递增，写线程据此刷新 LogFile 的设置
+	uint64_t appliedRotationVersion = 0;
+	std::unique_ptr<GB_ThreadPool> maintenancePool; // 轮转后的压缩与过期清理放到单独的线程执行，写线程只负责改名
+
+	std::atomic<int> fsyncPolicy{ static_cast<int>(GB_LogFsyncPolicy::Never) };
+	std::atomic<unsigned int> fsyncIntervalMs{ 1000 };
+	chrono::steady_clock::time_point lastSyncTime = chrono::steady_clock::now();
+
+	// Interval 策略：空闲时也会检查，保证最后一批数据按时落盘
+	void SyncIfDue()
+	{
+		if (static_cast<GB_LogFsyncPolicy>(fsyncPolicy.load(std::memory_order_relaxed)) != GB_LogFsyncPolicy::Interval || !file.HasUnsyncedData())
+		{
+			return;
+		}
+		const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (now - lastSyncTime >= chrono::milliseconds(fsyncIntervalMs.load(std::memory_order_relaxed)))
+		{
+			file.Sync();
+			lastSyncTime = now;
+		}
+	}
+};
+
+GB_FileLogSink::GB_FileLogSink(const string& filePathUtf8, GB_LogLevel minLevel, GB_LogFormat format, const GB_LogRotationOptions& rotationOptions)
+	: GB_LogSink(minLevel, format), impl(new Impl(filePathUtf8))
+{
+	impl->rotationOptions = rotationOptions;
+
+	Impl* const sinkImpl = impl.get();
+	impl->file.onRotated = [sinkImpl](const string& rotatedPathUtf8) {
+		if (!sinkImpl->maintenancePool)
+		{
+			sinkImpl->maintenancePool.reset(new GB_ThreadPool(1));
+		}
+		const string activePathUtf8 = sinkImpl->file.GetPath();
+		GB_LogRotationOptions options;
+		{
+			// SetRotationOptions 可能在其它线程上同时修改
+			std::lock_guard<std::mutex> lock(sinkImpl->rotationOptionsMtx);
+			options = sinkImpl->rotationOptions;
+		}
+		sinkImpl->maintenancePool->TryPost([activePathUtf8, rotatedPathUtf8, options]() {
+			internal::MaintainRotatedLogs(activePathUtf8, rotatedPathUtf8, options);
+			});
+		};
+}
+
+GB_FileLogSink::~GB_FileLogSink()
+{
+}
+
+const string& GB_FileLogSink::GetFilePath() const
+{
+	return impl->file.GetPath();
+}
+
+void GB_FileLogSink::SetRotationOptions(const GB_LogRotationOptions& options)
+{
+	std::lock_guard<std::mutex> lock(impl->rotationOptionsMtx);
+	impl->rotationOptions = options;
+	impl->rotationOptionsVersion.fetch_add(1, std::memory_order_release);
+}
+
+GB_LogRotationOptions GB_FileLogSink::GetRotationOptions() const
+{
+	std::lock_guard<std::mutex> lock(impl->rotationOptionsMtx);
+	return impl->rotationOptions;
+}
+
+void GB_FileLogSink::SetFsyncPolicy(GB_LogFsyncPolicy policy, unsigned int intervalMs)
+{
+	impl->fsyncIntervalMs.store(intervalMs, std::memory_order_relaxed);
+	impl->fsyncPolicy.store(static_cast<int>(policy), std::memory_order_relaxed);
+}
+
+GB_LogFsyncPolicy GB_FileLogSink::GetFsyncPolicy() const
+{
+	return static_cast<GB_LogFsyncPolicy>(impl->fsyncPolicy.load(std::memory_order_relaxed));
+}
+
+void GB_FileLogSink::WriteBatch(const vector<const GB_LogItem*>& items)
+{
+	const uint64_t currentRotationVersion = impl->rotationOptionsVersion.load(std::memory_order_acquire);
+	if (currentRotationVersion != impl->appliedRotationVersion)
+	{
+		impl->file.SetRotationOptions(GetRotationOptions());
+		impl->appliedRotationVersion = currentRotationVersion;
+	}
+
+	impl->batch.clear();
+	bool hasErrorOrFatal = false;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		AppendFormatted(*items[i], impl->batch);
+		if (items[i]->level >= GB_LogLevel::GBLOGLEVEL_ERROR)
+		{
+			hasErrorOrFatal = true;
+		}
+	}
+	impl->file.Append(impl->batch);
+
+	if (hasErrorOrFatal && GetFsyncPolicy() == GB_LogFsyncPolicy::OnErrorOrFatal)
+	{
+		impl->file.Sync();
+		impl->lastSyncTime = chrono::steady_clock::now();
+	}
+	impl->SyncIfDue();
+}
+
+void GB_FileLogSink::OnIdle()
+{
+	impl->SyncIfDue();
+}
+
+GB_ConsoleLogSink::GB_ConsoleLogSink(GB_LogLevel minLevel, GB_LogFormat format) : GB_LogSink(minLevel, format)
+{
+}
+
+void GB_ConsoleLogSink::WriteBatch(const vector<const GB_LogItem*>& items)
+{
+	// 相邻的同级别日志合并为一次控制台输出
+	GB_LogLevel runLevel = GB_LogLevel::GBLOGLEVEL_TRACE;
+	run.clear();
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (!run.empty() && runLevel != items[i]->level)
+		{
+			internal::ConsoleWriteColoredUtf8(run, runLevel);
+			run.clear();
+		}
+		runLevel = items[i]->level;
+		AppendFormatted(*items[i], run);
+	}
+	if (!run.empty())
+	{
+		internal::ConsoleWriteColoredUtf8(run, runLevel);
+		run.clear();
+	}
+}
+
+struct GB_SyslogLogSink::Impl
+{
+#if !defined(_WIN32)
+	explicit Impl(const string& socketPathUtf8) : connection(socketPathUtf8, SOCK_DGRAM)
+	{
+	}
+
+	internal::UnixSocketConnection connection;
+#else
+	explicit Impl(const string&)
+	{
+	}
+#endif
+	string header;
+	string datagram;
+};
+
+GB_SyslogLogSink::GB_SyslogLogSink(const string& identUtf8, GB_LogLevel minLevel, GB_LogFormat format, const string& socketPathUtf8)
+	: GB_LogSink(minLevel, format), impl(new Impl(socketPathUtf8))
+{
+#if defined(_WIN32)
+	(void)identUtf8;
+#else
+	impl->header = identUtf8 + GB_STR("[") + std::to_string(static_cast<long long>(::getpid())) + GB_STR("]: ");
+#endif
+}
+
+GB_SyslogLogSink::~GB_SyslogLogSink()
+{
+}
+
+void GB_SyslogLogSink::WriteBatch(const vector<const GB_LogItem*>& items)
+{
+#if defined(_WIN32)
+	(void)items;
+#else
+	if (!impl->connection.EnsureConnected())
+	{
+		droppedRecords.fetch_add(items.size(), std::memory_order_relaxed);
+		return;
+	}
+
+	const int facilityUser = 1;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		string& datagram = impl->datagram;
+		datagram = GB_STR("<") + std::to_string(facilityUser * 8 + internal::LogLevelToSyslogSeverity(items[i]->level)) + GB_STR(">");
+		datagram += impl->header;
+		AppendFormatted(*items[i], datagram);
+		if (!datagram.empty() && datagram.back() == '\n')
+		{
+			datagram.pop_back();
+		}
+		if (!impl->connection.Send(datagram.data(), datagram.size()))
+		{
+			droppedRecords.fetch_add(items.size() - i, std::memory_order_relaxed);
+			return;
+		}
+	}
+#endif
+}
+
+bool GB_SyslogLogSink::IsBlocking() const
+{
+	return true;
+}
+
+struct GB_UnixSocketLogSink::Impl
+{
+#if !defined(_WIN32)
+	explicit Impl(const string& socketPathUtf8) : connection(socketPathUtf8, SOCK_STREAM)
+	{
+	}
+
+	internal::UnixSocketConnection connection;
+#else
+	explicit Impl(const string&)
+	{
+	}
+#endif
+	string batch;
+};
+
+GB_UnixSocketLogSink::GB_UnixSocketLogSink(const string& socketPathUtf8, GB_LogLevel minLevel, GB_LogFormat format)
+	: GB_LogSink(minLevel, format), impl(new Impl(socketPathUtf8))
+{
+}
+
+GB_UnixSocketLogSink::~GB_UnixSocketLogSink()
+{
+}
+
+void GB_UnixSocketLogSink::WriteBatch(const vector<const GB_LogItem*>& items)
+{
+#if defined(_WIN32)
+	(void)items;
+#else
+	if (!impl->connection.EnsureConnected())
+	{
+		droppedRecords.fetch_add(items.size(), std::memory_order_relaxed);
+		return;
+	}
+
+	impl->batch.clear();
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		AppendFormatted(*items[i], impl->batch);
+	}
+	if (!impl->connection.Send(impl->batch.data(), impl->batch.size()))
+	{
+		droppedRecords.fetch_add(items.size(), std::memory_order_relaxed);
+	}
+#endif
+}
+
+void GB_UnixSocketLogSink::OnIdle()
+{
+#if !defined(_WIN32)
+	impl->connection.EnsureConnected();
+#endif
+}
+
+bool GB_UnixSocketLogSink::IsBlocking() const
+{
+	return true;
+}
+
+GB_MemoryLogSink::GB_MemoryLogSink(size_t maxRecords, GB_LogLevel minLevel, GB_LogFormat format)
+	: GB_LogSink(minLevel, format), maxRecords(maxRecords > 0 ? maxRecords : 1)
+{
+}
+
+vector<string> GB_MemoryLogSink::GetRecentRecords() const
+{
+	std::lock_guard<std::mutex> lock(recordsMtx);
+	vector<string> result;
+	result.reserve(records.size());
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		result.push_back(records[(nextIndex + i) % records.size()]);
+	}
+	return result;
+}
+
+string GB_MemoryLogSink::DumpRecentRecords() const
+{
+	std::lock_guard<std::mutex> lock(recordsMtx);
+	string result;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		result += records[(nextIndex + i) % records.size()];
+	}
+	return result;
+}
+
+void GB_MemoryLogSink::Clear()
+{
+	std::lock_guard<std::mutex> lock(recordsMtx);
+	records.clear();
+	nextIndex = 0;
+}
+
+void GB_MemoryLogSink::WriteBatch(const vector<const GB_LogItem*>& items)
+{
+	std::lock_guard<std::mutex> lock(recordsMtx);
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (records.size() < maxRecords)
+		{
+			records.push_back(string());
+			AppendFormatted(*items[i], records.back());
+			continue;
+		}
+
+		string& slot = records[nextIndex];
+		slot.clear();
+		AppendFormatted(*items[i], slot);
+		nextIndex = (nextIndex + 1) % maxRecords;
+	}
+}
+
+/*
+	sink 条目：IsBlocking() 的 sink 带一个独立写线程。
+	日志线程只把记录拷贝进有界队列（超过 maxPendingRecords 时丢弃最早的），写线程每次取走全部积压，作为一批交给 sink。
+	写线程用到的状态放在 WorkerState 中，由条目与写线程共同持有：sink 回调里调用 RemoveSink 时条目可能在写线程上析构，
+	这时不能 join 自己，改为 detach，写线程写完剩余记录后自行退出。
+*/
+struct GB_Logger::SinkEntry
+{
+	static const size_t maxPendingRecords = 64 * 1024;
+
+	struct WorkerState
+	{
+		explicit WorkerState(const std::shared_ptr<GB_LogSink>& logSink) : sink(logSink)
+		{
+		}
+
+		const std::shared_ptr<GB_LogSink> sink;
+		std::mutex pendingMtx;
+		std::condition_variable pendingCv;
+		std::deque<GB_LogItem> pending;
+		bool isStopping = false;
+	};
+
+	explicit SinkEntry(const std::shared_ptr<GB_LogSink>& logSink) : sink(logSink)
+	{
+		if (sink->IsBlocking())
+		{
+			workerState = std::make_shared<WorkerState>(sink);
+			worker = std::thread(&SinkEntry::WorkerFunc, workerState);
+		}
+	}
+
+	~SinkEntry()
+	{
+		if (worker.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(workerState->pendingMtx);
+				workerState->isStopping = true;
+			}
+			workerState->pendingCv.notify_one();
+			if (worker.get_id() == std::this_thread::get_id())
+			{
+				worker.detach();
+			}
+			else
+			{
+				worker.join();
+			}
+		}
+	}
+
+	bool IsDecoupled() const
+	{
+		return worker.joinable();
+	}
+
+	void Enqueue(const vector<const GB_LogItem*>& items)
+	{
+		uint64_t droppedCount = 0;
+		{
+			std::lock_guard<std::mutex> lock(workerState->pendingMtx);
+			for (size_t i = 0; i < items.size(); i++)
+			{
+				if (workerState->pending.size() >= maxPendingRecords)
+				{
+					workerState->pending.pop_front();
+					droppedCount++;
+				}
+				workerState->pending.push_back(*items[i]);
+			}
+		}
+		if (droppedCount > 0)
+		{
+			sink->droppedRecords.fetch_add(droppedCount, std::memory_order_relaxed);
+		}
+		workerState->pendingCv.notify_one();
+	}
+
+	static void WorkerFunc(const std::shared_ptr<WorkerState> state)
+	{
+		std::deque<GB_LogItem> localPending;
+		vector<const GB_LogItem*> items;
+		for (;;)
+		{
+			bool shouldExit = false;
+			{
+				std::unique_lock<std::mutex> lock(state->pendingMtx);
+				if (state->pending.empty() && !state->isStopping)
+				{
+					state->pendingCv.wait_for(lock, std::chrono::milliseconds(200));
+				}
+				localPending.swap(state->pending);
+				shouldExit = state->isStopping;
+			}
+
+			if (localPending.empty())
+			{
+				if (shouldExit)
+				{
+					return;
+				}
+				state->sink->OnIdle();
+				continue;
+			}
+
+			items.clear();
+			for (size_t i = 0; i < localPending.size(); i++)
+			{
+				items.push_back(&localPending[i]);
+			}
+			try
+			{
+				state->sink->WriteBatch(items);
+			}
+			catch (...)
+			{
+				// 用户实现的 sink 抛出的异常不能终止写线程
+			}
+			localPending.clear();
+		}
+	}
+
+	const std::shared_ptr<GB_LogSink> sink;
+	std::shared_ptr<WorkerState> workerState;
+	std::thread worker;
+};
+
+/*
+	配置监视线程：配置变化时调用 GB_Logger::ReloadConfig() 刷新缓存的日志状态。
+	- Windows：对 HKCU\Software\GlobalBase 注册 RegNotifyChangeKeyValue。
+	- Linux：inotify 监视 config.kv 所在目录（GB_Config 以“写临时文件 + rename”方式落盘，只监视文件本身会丢事件）。
+	- 目录尚不存在或 inotify 不可用时，退化为按固定间隔比较文件的 mtime/size/inode。
+*/
+struct GB_Logger::ConfigWatcher
+{
+	explicit ConfigWatcher(GB_Logger& logger) : owner(logger)
+	{
+#if defined(_WIN32)
+		stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+#else
+		stopPipe[0] = -1;
+		stopPipe[1] = -1;
+		if (pipe(stopPipe) == 0)
+		{
+			fcntl(stopPipe[0], F_SETFD, FD_CLOEXEC);
+			fcntl(stopPipe[1], F_SETFD, FD_CLOEXEC);
+		}
+#endif
+		watchThread = std::thread(&ConfigWatcher::Run, this);
+	}
+
+	~ConfigWatcher()
+	{
+#if defined(_WIN32)
+		if (stopEvent != nullptr)
+		{
+			SetEvent(stopEvent);
+		}
+#else
+		if (stopPipe[1] >= 0)
+		{
+			const char ch = 0;
+			const ssize_t ignored = write(stopPipe[1], &ch, 1);
+			(void)ignored;
+		}
+#endif
+		if (watchThread.joinable())
+		{
+			watchThread.join();
+		}
+#if defined(_WIN32)
+		if (stopEvent != nullptr)
+		{
+			CloseHandle(stopEvent);
+		}
+#else
+		for (int i = 0; i < 2; i++)
+		{
+			if (stopPipe[i] >= 0)
+			{
+				close(stopPipe[i]);
+			}
+		}
+#endif
+	}
+
+	void Run()
+	{
+		const int pollIntervalMs = 1000;
+#if defined(_WIN32)
+		if (stopEvent == nullptr)
+		{
+			return;
+		}
+
+		HANDLE changeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		HKEY key = nullptr;
+		for (;;)
+		{
+			if (key == nullptr && changeEvent != nullptr)
+			{
+				if (RegOpenKeyExW(HKEY_CURRENT_USER, L"Software\\GlobalBase", 0, KEY_NOTIFY, &key) != ERROR_SUCCESS)
+				{
+					key = nullptr;
+				}
+			}
+			if (key != nullptr && RegNotifyChangeKeyValue(key, FALSE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET, changeEvent, TRUE) != ERROR_SUCCESS)
+			{
+				RegCloseKey(key);
+				key = nullptr;
+			}
+
+			HANDLE handles[2] = { stopEvent, changeEvent };
+			const DWORD waitResult = WaitForMultipleObjects(key != nullptr ? 2 : 1, handles, FALSE, key != nullptr ? INFINITE : static_cast<DWORD>(pollIntervalMs));
+			if (waitResult == WAIT_OBJECT_0 || waitResult == WAIT_FAILED)
+			{
+				break;
+			}
+			owner.ReloadConfig();
+		}
+
+		if (key != nullptr)
+		{
+			RegCloseKey(key);
+		}
+		if (changeEvent != nullptr)
+		{
+			CloseHandle(changeEvent);
+		}
+#else
+		if (stopPipe[0] < 0)
+		{
+			return;
+		}
+
+		const string configPath = GB_GetGbConfigPath();
+		const size_t slashPos = configPath.find_last_of('/');
+		const string configDir = (slashPos == string::npos) ? string(".") : configPath.substr(0, slashPos);
+		const string configName = (slashPos == string::npos) ? configPath : configPath.substr(slashPos + 1);
+
+		struct stat lastStat;
+		bool hasLastStat = (stat(configPath.c_str(), &lastStat) == 0);
+
+#if defined(__linux__)
+		int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+		int inotifyFd = -1;
+#endif
+		int watchDescriptor = -1;
+
+		for (;;)
+		{
+#if defined(__linux__)
+			if (inotifyFd >= 0 && watchDescriptor < 0)
+			{
+				watchDescriptor = inotify_add_watch(inotifyFd, configDir.c_str(),
+					IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF);
+			}
+#endif
+
+			pollfd fds[2];
+			fds[0].fd = stopPipe[0];
+			fds[0].events = POLLIN;
+			fds[0].revents = 0;
+			fds[1].fd = inotifyFd;
+			fds[1].events = POLLIN;
+			fds[1].revents = 0;
+			const nfds_t fdCount = (watchDescriptor >= 0) ? 2 : 1;
+			const int ready = poll(fds, fdCount, (watchDescriptor >= 0) ? -1 : pollIntervalMs);
+			if (ready < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				break;
+			}
+			if (fds[0].revents != 0)
+			{
+				break;
+			}
+
+			bool isChanged = false;
+#if defined(__linux__)
+			if (fdCount == 2 && (fds[1].revents & POLLIN) != 0)
+			{
+				alignas(inotify_event) char eventBuffer[4096];
+				for (;;)
+				{
+					const ssize_t bytes = read(inotifyFd, eventBuffer, sizeof(eventBuffer));
+					if (bytes <= 0)
+					{
+						break;
+					}
+					for (ssize_t offset = 0; offset < bytes; )
+					{
+						const inotify_event* event = reinterpret_cast<const inotify_event*>(eventBuffer + offset);
+						if ((event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF | IN_Q_OVERFLOW)) != 0)
+						{
+							// 目录本身被删/移走或事件溢出：重新建立监视并无条件刷新一次
+							if ((event->mask & IN_Q_OVERFLOW) == 0 && watchDescriptor >= 0)
+							{
+								inotify_rm_watch(inotifyFd, watchDescriptor);
+								watchDescriptor = -1;
+							}
+							isChanged = true;
+						}
+						else if (event->len > 0 && configName == event->name)
+						{
+							isChanged = true;
+						}
+						offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+					}
+				}
+			}
+#endif
+			if (ready == 0)
+			{
+				struct stat currentStat;
+				const bool hasCurrentStat = (stat(configPath.c_str(), &currentStat) == 0);
+				if (hasCurrentStat != hasLastStat || (hasCurrentStat &&
+					(currentStat.st_mtime != lastStat.st_mtime || currentStat.st_size != lastStat.st_size || currentStat.st_ino != lastStat.st_ino)))
+				{
+					isChanged = true;
+				}
+				hasLastStat = hasCurrentStat;
+				if (hasCurrentStat)
+				{
+					lastStat = currentStat;
+				}
+			}
+
+			if (isChanged)
+			{
+				owner.ReloadConfig();
+			}
+		}
+
+		if (inotifyFd >= 0)
+		{
+			close(inotifyFd);
+		}
+#endif
+	}
+
+	GB_Logger& owner;
+	std::thread watchThread;
+#if defined(_WIN32)
+	HANDLE stopEvent = nullptr;
+#else
+	int stopPipe[2];
+#endif
+};
+
+GB_Logger& GB_Logger::GetInstance()
+{
+	static GB_Logger instance;
+	return instance;
+}
+
+GB_Logger::ThreadRing& GB_Logger::GetThreadRing()
+{
+	struct ThreadRingHolder
+	{
+		std::shared_ptr<ThreadRing> ring;
+
+		~ThreadRingHolder()
+		{
+			if (ring)
+			{
+				internal::ReleaseFlightRecorder(ring->flightRecorder);
+				ring->isOwnerAlive.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	thread_local ThreadRingHolder holder;
+	if (!holder.ring)
+	{
+		holder.ring = std::make_shared<ThreadRing>(internal::threadRingBytes);
+
+		std::lock_guard<std::mutex> lock(threadRingsMtx);
+		threadRings.push_back(holder.ring);
+		threadRingsVersion.fetch_add(1, std::memory_order_release);
+	}
+	return *holder.ring;
+}
+
+void GB_Logger::WakeLogThread()
+{
+	{
+		// 持锁再通知：避免日志线程在“检查完无数据”与“进入等待”之间错过这次通知
+		std::unique_lock<std::mutex> lock = GB_ProfiledLock(logQueueMtx, logQueueMtxProfile);
+	}
+	logQueueCv.notify_one();
+}
+
+void GB_Logger::Push(GB_LogLevel level, const char* msgData, size_t msgBytes, const char* fileData, size_t fileBytes, bool isFileNative, int line, bool isDeferredFormat)
+{
+	ThreadRing& ring = GetThreadRing();
+
+	internal::LogRecordHeader header;
+	memset(&header, 0, sizeof(header));
+	header.kind = internal::LOG_RECORD_KIND_ENTRY;
+	header.level = static_cast<uint8_t>(level);
+	header.flags = static_cast<uint8_t>((isFileNative ? internal::LOG_RECORD_FLAG_NATIVE_FILE : 0) | (isDeferredFormat ? internal::LOG_RECORD_FLAG_DEFERRED_FORMAT : 0));
+	header.line = line;
+	header.fileBytes = static_cast<uint32_t>(fileBytes);
+	header.messageBytes = static_cast<uint32_t>(msgBytes);
+	header.timestampNs = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	header.recordBytes = static_cast<uint32_t>(internal::AlignLogRecordBytes(sizeof(header) + fileBytes + msgBytes));
+
+	if (ring.flightRecorder)
+	{
+		internal::RecordFlight(*ring.flightRecorder, header, ring.threadId, fileData, msgData);
+	}
+
+	if (header.recordBytes <= internal::maxRingRecordBytes && ring.TryWrite(header, fileData, msgData))
+	{
+		// 与 LogThreadFunc 中“置 isWriterSleeping 后再检查缓冲”的 fence 配对，保证不会出现双方都错过对方。
+		// 用 exchange 清掉标志：日志线程真正被调度之前，后续调用不再重复唤醒。
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (isWriterSleeping.load(std::memory_order_relaxed) && isWriterSleeping.exchange(false, std::memory_order_relaxed))
+		{
+			WakeLogThread();
+		}
+		return;
+	}
+
+	// 慢路径：缓冲已满或记录过大，写入溢出队列（记录中自带线程 ID）
+	header.threadIdBytes = static_cast<uint16_t>(ring.threadId.size());
+	header.recordBytes = static_cast<uint32_t>(internal::AlignLogRecordBytes(sizeof(header) + header.threadIdBytes + fileBytes + msgBytes));
+	{
+		std::unique_lock<std::mutex> lock = GB_ProfiledLock(logQueueMtx, logQueueMtxProfile);
+
+		// 已请求停止：日志线程退出后不再有人读取溢出队列，继续写入只会让它无限增长
+		if (isStop.load(std::memory_order_acquire))
+		{
+			pendingDroppedCounts[header.level]++;
+			totalDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		const size_t maxBytes = maxOverflowBytes.load(std::memory_order_relaxed);
+		if (overflowRecords.size() + header.recordBytes > maxBytes)
+		{
+			const GB_LogOverflowPolicy policy = static_cast<GB_LogOverflowPolicy>(overflowPolicy.load(std::memory_order_relaxed));
+			const bool isBelowKeepLevel = static_cast<int>(level) < overflowKeepLevel.load(std::memory_order_relaxed);
+			if (policy == GB_LogOverflowPolicy::DropNewest || (policy == GB_LogOverflowPolicy::DropBelowLevel && isBelowKeepLevel))
+			{
+				pendingDroppedCounts[header.level]++;
+				totalDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			if (policy == GB_LogOverflowPolicy::DropOldest)
+			{
+				const uint64_t droppedCount = internal::DropOldestLogRecords(overflowRecords, header.recordBytes, maxBytes, pendingDroppedCounts);
+				totalDroppedRecords.fetch_add(droppedCount, std::memory_order_relaxed);
+			}
+			else
+			{
+				// 单条记录超过上限时，等到溢出队列清空再写入
+				overflowWaiterCount++;
+				overflowSpaceCv.wait(lock, [&]() {
+					return isStop.load(std::memory_order_acquire) || overflowRecords.empty() || overflowRecords.size() + header.recordBytes <= maxBytes;
+					});
+				overflowWaiterCount--;
+
+				if (isStop.load(std::memory_order_acquire))
+				{
+					pendingDroppedCounts[header.level]++;
+					totalDroppedRecords.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+		}
+
+		const size_t oldSize = overflowRecords.size();
+		overflowRecords.resize(oldSize + header.recordBytes);
+		internal::WriteLogRecord(overflowRecords.data() + oldSize, header, ring.threadId.data(), fileData, msgData);
+	}
+	logQueueCv.notify_one();
+}
+
+void GB_Logger::Log(GB_LogLevel level, const string& msgUtf8, const string& fileUtf8, int line)
+{
+	Push(level, msgUtf8.data(), msgUtf8.size(), fileUtf8.data(), fileUtf8.size(), false, line);
+}
+
+void GB_Logger::LogTrace(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_TRACE, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+void GB_Logger::LogDebug(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_DEBUG, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+void GB_Logger::LogInfo(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_INFO, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+void GB_Logger::LogWarning(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_WARNING, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+void GB_Logger::LogError(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_ERROR, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+void GB_Logger::LogFatal(const std::string& msgUtf8, const char* file, int line)
+{
+	Push(GB_LogLevel::GBLOGLEVEL_FATAL, msgUtf8.data(), msgUtf8.size(), file, file ? strlen(file) : 0, true, line);
+}
+
+// 函数内静态变量：其它编译单元的静态初始化期间写日志时也能拿到正确的路径
+static const string& GetAllLogFilePath()
+{
+	static const string allLogFilePath = GB_GetExeDirectory() + GB_STR("GB_Logs/GB_AllLog.log");
+	return allLogFilePath;
+}
+
+static const string& GetOutputLogFilePath()
+{
+	static const string outputLogFilePath = GB_GetExeDirectory() + GB_STR("GB_Logs/GB_OutputLog.log");
+	return outputLogFilePath;
+}
+
+bool GB_Logger::ClearLogFiles() const
+{
+	const bool success1 = GB_CreateFileRecursive(allLogSink->GetFilePath());
+	const bool success2 = GB_CreateFileRecursive(outputLogSink->GetFilePath());
+	return success1 && success2;
+}
+
+GB_Logger::GB_Logger() : logQueueMtxProfile(GB_GetLockProfile(GB_STR("GB_Logger.logQueueMtx"))),
+	allLogSink(std::make_shared<GB_FileLogSink>(GetAllLogFilePath())), outputLogSink(std::make_shared<GB_FileLogSink>(GetOutputLogFilePath())),
+	consoleSink(std::make_shared<GB_ConsoleLogSink>(GB_LogLevel::GBLOGLEVEL_DISABLELOG))
+{
+	isStop.store(false, std::memory_order_release);
+
+	sinkEntries.push_back(std::make_shared<SinkEntry>(allLogSink));
+	sinkEntries.push_back(std::make_shared<SinkEntry>(outputLogSink));
+	sinkEntries.push_back(std::make_shared<SinkEntry>(consoleSink));
+	sinksVersion.fetch_add(1, std::memory_order_release);
+
+	ReloadConfig();
+	configWatcher.reset(new ConfigWatcher(*this));
+
+	logThread = std::thread(&GB_Logger::LogThreadFunc, this);
+	internal::liveLogger.store(this, std::memory_order_release);
+}
+
+GB_Logger::~GB_Logger()
+{
+	internal::liveLogger.store(nullptr, std::memory_order_release);
+	Shutdown(shutdownDrainTimeoutMs.load(std::memory_order_relaxed));
+}
+
+void GB_Logger::Shutdown(unsigned int drainTimeoutMs)
+{
+	std::lock_guard<std::mutex> shutdownLock(shutdownMtx);
+	if (!logThread.joinable())
+	{
+		return;
+	}
+
+	configWatcher.reset();
+
+	shutdownDrainTimeoutMs.store(drainTimeoutMs, std::memory_order_relaxed);
+	{
+		// 持锁设置，保证在 overflowSpaceCv 上等待的线程不会错过通知
+		std::lock_guard<std::mutex> lock(logQueueMtx);
+		isStop.store(true, std::memory_order_release);
+	}
+	logQueueCv.notify_all();
+	overflowSpaceCv.notify_all();
+
+	logThread.join();
+}
+
+void GB_Logger::ReloadConfig()
+{
+	// 串行化：避免较早读到的旧配置覆盖较晚读到的新配置
+	std::lock_guard<std::mutex> lock(configReloadMtx);
+
+	const internal::LogConfigValues config = internal::ReadLogConfig();
+	const bool isEnabled = config.isEnabled;
+	const bool isToConsole = config.isToConsole;
+	const GB_LogLevel newFilterLevel = config.filterLevel;
+	const GB_LogLevel newAllLogLevel = config.allLogLevel;
+
+	isLogEnabled.store(isEnabled, std::memory_order_relaxed);
+	isLogToConsole.store(isToConsole, std::memory_order_relaxed);
+	filterLevel.store(static_cast<int>(newFilterLevel), std::memory_order_relaxed);
+	allLogLevel.store(static_cast<int>(newAllLogLevel), std::memory_order_relaxed);
+
+	// 默认 sink 的级别跟随配置（直接写入，不经 SetLevel，避免构造期间回调 GetInstance）；用户已用 SetLevel 指定级别的保持不变
+	auto applyConfigLevel = [](GB_LogSink& sink, GB_LogLevel level) {
+		if (!sink.isLevelOverridden.load(std::memory_order_relaxed))
+		{
+			sink.minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+		}
+		};
+	applyConfigLevel(*allLogSink, newAllLogLevel);
+	applyConfigLevel(*outputLogSink, newFilterLevel);
+	applyConfigLevel(*consoleSink, isToConsole ? newFilterLevel : GB_LogLevel::GBLOGLEVEL_DISABLELOG);
+
+	RefreshActiveLevel();
+}
+
+void GB_Logger::RefreshActiveLevel()
+{
+	int newMinActiveLevel = static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG);
+	if (isLogEnabled.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(sinksMtx);
+		for (size_t i = 0; i < sinkEntries.size(); i++)
+		{
+			newMinActiveLevel = std::min(newMinActiveLevel, sinkEntries[i]->sink->minLevel.load(std::memory_order_relaxed));
+		}
+	}
+	minActiveLevel.store(newMinActiveLevel, std::memory_order_relaxed);
+}
+
+void GB_Logger::AddSink(const std::shared_ptr<GB_LogSink>& sink)
+{
+	if (!sink)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sinksMtx);
+		for (size_t i = 0; i < sinkEntries.size(); i++)
+		{
+			if (sinkEntries[i]->sink == sink)
+			{
+				return;
+			}
+		}
+		sinkEntries.push_back(std::make_shared<SinkEntry>(sink));
+		sinksVersion.fetch_add(1, std::memory_order_release);
+	}
+	RefreshActiveLevel();
+}
+
+bool GB_Logger::RemoveSink(const std::shared_ptr<GB_LogSink>& sink)
+{
+	std::shared_ptr<SinkEntry> removedEntry; // 在锁外释放：独立写线程的 join 可能需要一些时间
+	uint64_t removedVersion = 0;
+	{
+		std::lock_guard<std::mutex> lock(sinksMtx);
+		for (size_t i = 0; i < sinkEntries.size(); i++)
+		{
+			if (sinkEntries[i]->sink == sink)
+			{
+				removedEntry = sinkEntries[i];
+				sinkEntries.erase(sinkEntries.begin() + i);
+				removedVersion = sinksVersion.fetch_add(1, std::memory_order_release) + 1;
+				break;
+			}
+		}
+	}
+	if (!removedEntry)
+	{
+		return false;
 	}
-	if (value == GB_STR("TRACE") || value == GB_STR("0"))
+	RefreshActiveLevel();
+
+	// 等日志线程换掉仍引用该 sink 的快照，使最终释放发生在本线程而不是日志线程上。
+	// 在日志线程上（sink 回调中）调用时不能等待自己，由日志线程刷新快照时释放。
+	if (std::this_thread::get_id() != logThread.get_id())
+	{
+		WakeLogThread();
+		std::unique_lock<std::mutex> lock(sinksMtx);
+		sinksAppliedCv.wait(lock, [&]() { return sinksAppliedVersion >= removedVersion || isLogThreadExited; });
+	}
+	return true;
+}
+
+vector<std::shared_ptr<GB_LogSink>> GB_Logger::GetSinks() const
+{
+	std::lock_guard<std::mutex> lock(sinksMtx);
+	vector<std::shared_ptr<GB_LogSink>> sinks;
+	sinks.reserve(sinkEntries.size());
+	for (size_t i = 0; i < sinkEntries.size(); i++)
 	{
-		return GB_LogLevel::GBLOGLEVEL_TRACE;
+		sinks.push_back(sinkEntries[i]->sink);
 	}
-	else if (value == GB_STR("DEBUG") || value == GB_STR("1"))
+	return sinks;
+}
+
+void GB_Logger::SetFsyncPolicy(GB_LogFsyncPolicy policy, unsigned int intervalMs)
+{
+	allLogSink->SetFsyncPolicy(policy, intervalMs);
+	outputLogSink->SetFsyncPolicy(policy, intervalMs);
+}
+
+GB_LogFsyncPolicy GB_Logger::GetFsyncPolicy() const
+{
+	return allLogSink->GetFsyncPolicy();
+}
+
+void GB_Logger::SetOverflowPolicy(GB_LogOverflowPolicy policy, size_t maxQueueBytes, GB_LogLevel keepLevel)
+{
 	{
-		return GB_LogLevel::GBLOGLEVEL_DEBUG;
+		std::lock_guard<std::mutex> lock(logQueueMtx);
+		overflowPolicy.store(static_cast<int>(policy), std::memory_order_relaxed);
+		maxOverflowBytes.store(maxQueueBytes, std::memory_order_relaxed);
+		overflowKeepLevel.store(static_cast<int>(keepLevel), std::memory_order_relaxed);
 	}
-	else if (value == GB_STR("INFO") || value == GB_STR("2"))
+	// 上限调大后，阻塞中的线程可能可以继续
+	overflowSpaceCv.notify_all();
+}
+
+GB_LogOverflowPolicy GB_Logger::GetOverflowPolicy() const
+{
+	return static_cast<GB_LogOverflowPolicy>(overflowPolicy.load(std::memory_order_relaxed));
+}
+
+uint64_t GB_Logger::GetDroppedRecordCount() const
+{
+	return totalDroppedRecords.load(std::memory_order_relaxed);
+}
+
+void GB_Logger::SetRotationOptions(const GB_LogRotationOptions& options)
+{
+	allLogSink->SetRotationOptions(options);
+	outputLogSink->SetRotationOptions(options);
+}
+
+GB_LogRotationOptions GB_Logger::GetRotationOptions() const
+{
+	return allLogSink->GetRotationOptions();
+}
+
+void GB_Logger::LogThreadFunc()
+{
+	vector<std::shared_ptr<ThreadRing>> localRings; // threadRings 的本地快照
+	uint64_t localRingsVersion = 0;
+	vector<unsigned char> localOverflow;
+	vector<internal::DecodedLogRecord> batch;
+	internal::LogRecordDecoder decoder;
+
+	const int levelCount = static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG);
+	uint64_t unreportedDroppedCounts[static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG)] = {};
+	chrono::steady_clock::time_point lastDropReportTime;
+
+	vector<std::shared_ptr<SinkEntry>> localSinks; // sinkEntries 的本地快照
+	uint64_t localSinksVersion = 0;
+	vector<const GB_LogItem*> sinkItems;
+
+	// 用户实现的 sink 抛出的异常不能终止日志线程
+	auto callSink = [](GB_LogSink& sink, const vector<const GB_LogItem*>* items) {
+		try
+		{
+			if (items)
+			{
+				sink.WriteBatch(*items);
+			}
+			else
+			{
+				sink.OnIdle();
+			}
+		}
+		catch (...)
+		{
+		}
+		};
+
+	auto idleSinks = [&]() {
+		for (size_t i = 0; i < localSinks.size(); i++)
+		{
+			if (!localSinks[i]->IsDecoupled())
+			{
+				callSink(*localSinks[i]->sink, nullptr);
+			}
+		}
+		};
+
+	// 取出溢出队列并读空各线程缓冲，解码到 batch；返回有记录的来源数
+	auto collectBatch = [&]() -> size_t {
+		const uint64_t currentSinksVersion = sinksVersion.load(std::memory_order_acquire);
+		if (currentSinksVersion != localSinksVersion)
+		{
+			vector<std::shared_ptr<SinkEntry>> newSinks;
+			{
+				std::lock_guard<std::mutex> lock(sinksMtx);
+				newSinks = sinkEntries;
+				localSinksVersion = sinksVersion.load(std::memory_order_acquire);
+			}
+			// 先释放旧快照再通知 RemoveSink，被移除的 sink 由 RemoveSink 的调用线程做最终释放
+			localSinks.swap(newSinks);
+			newSinks.clear();
+			{
+				std::lock_guard<std::mutex> lock(sinksMtx);
+				sinksAppliedVersion = localSinksVersion;
+			}
+			sinksAppliedCv.notify_all();
+		}
+
+		const uint64_t currentVersion = threadRingsVersion.load(std::memory_order_acquire);
+		if (currentVersion != localRingsVersion)
+		{
+			std::lock_guard<std::mutex> lock(threadRingsMtx);
+			localRings = threadRings;
+			localRingsVersion = threadRingsVersion.load(std::memory_order_acquire);
+		}
+
+		// 先取溢出队列再读各线程缓冲：同一线程先写入缓冲的记录一定对日志线程可见
+		localOverflow.clear();
+		bool hasOverflowWaiter = false;
+		{
+			std::unique_lock<std::mutex> lock = GB_ProfiledLock(logQueueMtx, logQueueMtxProfile);
+			localOverflow.swap(overflowRecords);
+			hasOverflowWaiter = overflowWaiterCount > 0;
+			for (int level = 0; level < levelCount; level++)
+			{
+				unreportedDroppedCounts[level] += pendingDroppedCounts[level];
+				pendingDroppedCounts[level] = 0;
+			}
+		}
+		if (hasOverflowWaiter)
+		{
+			overflowSpaceCv.notify_all();
+		}
+
+		// 每秒最多汇报一次丢弃条数，作为一条 WARNING 日志插入本批次
+		const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (now - lastDropReportTime >= chrono::seconds(1))
+		{
+			uint64_t droppedCount = 0;
+			for (int level = 0; level < levelCount; level++)
+			{
+				droppedCount += unreportedDroppedCounts[level];
+			}
+			if (droppedCount > 0)
+			{
+				batch.push_back(internal::MakeDroppedLogReport(unreportedDroppedCounts, levelCount, droppedCount));
+				memset(unreportedDroppedCounts, 0, sizeof(unreportedDroppedCounts));
+				lastDropReportTime = now;
+			}
+		}
+		for (size_t pos = 0; pos + sizeof(internal::LogRecordHeader) <= localOverflow.size(); )
+		{
+			internal::LogRecordHeader header;
+			memcpy(&header, localOverflow.data() + pos, sizeof(header));
+			decoder.Decode(localOverflow.data() + pos, header, string(), batch);
+			pos += header.recordBytes;
+		}
+
+		size_t sourceCount = batch.empty() ? 0 : 1;
+		bool hasExitedRing = false;
+		for (size_t i = 0; i < localRings.size(); i++)
+		{
+			const size_t oldCount = batch.size();
+			localRings[i]->Drain(decoder, batch);
+			if (batch.size() != oldCount)
+			{
+				sourceCount++;
+			}
+			if (!localRings[i]->isOwnerAlive.load(std::memory_order_acquire) && !localRings[i]->HasPending())
+			{
+				hasExitedRing = true;
+			}
+		}
+
+		// 注销已退出且已读空的线程缓冲
+		if (hasExitedRing)
+		{
+			std::lock_guard<std::mutex> lock(threadRingsMtx);
+			for (size_t i = 0; i < threadRings.size(); )
+			{
+				if (!threadRings[i]->isOwnerAlive.load(std::memory_order_acquire) && !threadRings[i]->HasPending())
+				{
+					threadRings.erase(threadRings.begin() + i);
+				}
+				else
+				{
+					i++;
+				}
+			}
+			threadRingsVersion.fetch_add(1, std::memory_order_release);
+		}
+
+		return sourceCount;
+		};
+
+	// 按时间归并后分发给各 sink
+	auto writeBatch = [&](size_t sourceCount) {
+		// 多个线程的记录按时间戳归并；同一线程内本来就是有序的
+		if (sourceCount > 1)
+		{
+			std::stable_sort(batch.begin(), batch.end(), [](const internal::DecodedLogRecord& a, const internal::DecodedLogRecord& b) {
+				return a.timestampNs < b.timestampNs;
+				});
+		}
+
+		// 每个 sink 收到按其级别过滤后的整批记录；独立线程驱动的 sink 只在这里入队
+		if (IsLogEnabled())
+		{
+			for (size_t sinkIndex = 0; sinkIndex < localSinks.size(); sinkIndex++)
+			{
+				SinkEntry& entry = *localSinks[sinkIndex];
+				sinkItems.clear();
+				for (size_t i = 0; i < batch.size(); i++)
+				{
+					if (entry.sink->IsAccepted(batch[i].item.level))
+					{
+						sinkItems.push_back(&batch[i].item);
+					}
+				}
+
+				if (sinkItems.empty())
+				{
+					continue;
+				}
+				if (entry.IsDecoupled())
+				{
+					entry.Enqueue(sinkItems);
+				}
+				else
+				{
+					callSink(*entry.sink, &sinkItems);
+				}
+			}
+		}
+
+		batch.clear();
+		};
+
+	while (!isStop.load(std::memory_order_acquire))
 	{
-		return GB_LogLevel::GBLOGLEVEL_INFO;
+		const size_t sourceCount = collectBatch();
+		if (batch.empty())
+		{
+			std::unique_lock<std::mutex> lock = GB_ProfiledLock(logQueueMtx, logQueueMtxProfile);
+			isWriterSleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			bool hasPending = !overflowRecords.empty() || threadRingsVersion.load(std::memory_order_relaxed) != localRingsVersion ||
+				sinksVersion.load(std::memory_order_relaxed) != localSinksVersion;
+			for (size_t i = 0; i < localRings.size() && !hasPending; i++)
+			{
+				hasPending = localRings[i]->HasPending();
+			}
+			if (!hasPending && !isStop.load(std::memory_order_acquire))
+			{
+				// 带超时兜底：即便错过通知，最迟也会在超时后处理
+				logQueueCv.wait_for(lock, std::chrono::milliseconds(200));
+			}
+			isWriterSleeping.store(false, std::memory_order_relaxed);
+			lock.unlock();
+
+			idleSinks();
+			continue;
+		}
+
+		writeBatch(sourceCount);
 	}
-	else if (value == GB_STR("WARNING") || value == GB_STR("3"))
+
+	// 退出前限时排空：把各线程缓冲与溢出队列中剩余的记录写完，最长 shutdownDrainTimeoutMs
+	const chrono::steady_clock::time_point drainDeadline = chrono::steady_clock::now() + chrono::milliseconds(shutdownDrainTimeoutMs.load(std::memory_order_relaxed));
+	for (;;)
 	{
-		return GB_LogLevel::GBLOGLEVEL_WARNING;
+		const size_t sourceCount = collectBatch();
+		if (batch.empty())
+		{
+			break;
+		}
+		writeBatch(sourceCount);
+		if (chrono::steady_clock::now() >= drainDeadline)
+		{
+			break;
+		}
 	}
-	else if (value == GB_STR("ERROR") || value == GB_STR("4"))
+	idleSinks();
+
+	localSinks.clear();
 	{
-		return GB_LogLevel::GBLOGLEVEL_ERROR;
+		std::lock_guard<std::mutex> lock(sinksMtx);
+		isLogThreadExited = true;
 	}
-	else if (value == GB_STR("FATAL") || value == GB_STR("5"))
+	sinksAppliedCv.notify_all();
+}
+
+bool GB_IsLogEnabled()
+{
+	const GB_Logger* logger = internal::liveLogger.load(std::memory_order_acquire);
+	return logger ? logger->IsLogEnabled() : internal::ReadLogConfig().isEnabled;
+}
+
+namespace internal
+{
+	// 配置已写入：日志器已在运行时立即刷新其缓存，尚未创建时无需处理（创建时会读取配置）
+	static void ReloadLiveLoggerConfig()
 	{
-		return GB_LogLevel::GBLOGLEVEL_FATAL;
+		GB_Logger* logger = liveLogger.load(std::memory_order_acquire);
+		if (logger)
+		{
+			logger->ReloadConfig();
+		}
 	}
-	else if (value == GB_STR("DISABLELOG") || value == GB_STR("6"))
+}
+
+bool GB_SetLogEnabled(bool enable)
+{
+	const static string targetKey = GB_STR("GB_EnableLog");
+	const string value = enable ? GB_STR("1") : GB_STR("0");
+	const bool isOk = GB_SetGbConfig(targetKey, value);
+	internal::ReloadLiveLoggerConfig();
+	return isOk;
+}
+
+bool GB_IsLogToConsole()
+{
+	const GB_Logger* logger = internal::liveLogger.load(std::memory_order_acquire);
+	return logger ? logger->IsLogToConsole() : internal::ReadLogConfig().isToConsole;
+}
+
+bool GB_SetLogToConsole(bool enable)
+{
+	const static string targetKey = GB_STR("GB_IsLogToConsole");
+	const string value = enable ? GB_STR("1") : GB_STR("0");
+	const bool isOk = GB_SetGbConfig(targetKey, value);
+	internal::ReloadLiveLoggerConfig();
+	return isOk;
+}
+
+GB_LogLevel GB_GetLogFilterLevel()
+{
+	const GB_Logger* logger = internal::liveLogger.load(std::memory_order_acquire);
+	if (logger)
 	{
-		return GB_LogLevel::GBLOGLEVEL_DISABLELOG;
+		return logger->IsLogEnabled() ? logger->GetFilterLevel() : GB_LogLevel::GBLOGLEVEL_DISABLELOG;
 	}
-	return GB_LogLevel::GBLOGLEVEL_TRACE;
+
+	const internal::LogConfigValues config = internal::ReadLogConfig();
+	return config.isEnabled ? config.filterLevel : GB_LogLevel::GBLOGLEVEL_DISABLELOG;
+}
+
+bool GB_SetLogFilterLevel(GB_LogLevel level)
+{
+	const static string targetKey = GB_STR("GB_LogLevel");
+	const bool isOk = GB_SetGbConfig(targetKey, LogLevelToString(level));
+	internal::ReloadLiveLoggerConfig();
+	return isOk;
 }
 
 bool GB_CheckLogLevel(GB_LogLevel level)
@@ -577,6 +3020,20 @@ bool GB_CheckLogLevel(GB_LogLevel level)
 	return (level >= filterLevel && filterLevel != GB_LogLevel::GBLOGLEVEL_DISABLELOG);
 }
 
+GB_LogLevel GB_GetAllLogLevel()
+{
+	const GB_Logger* logger = internal::liveLogger.load(std::memory_order_acquire);
+	return logger ? logger->GetAllLogLevel() : internal::ReadLogConfig().allLogLevel;
+}
+
+bool GB_SetAllLogLevel(GB_LogLevel level)
+{
+	const static string targetKey = GB_STR("GB_AllLogLevel");
+	const bool isOk = GB_SetGbConfig(targetKey, LogLevelToString(level));
+	internal::ReloadLiveLoggerConfig();
+	return isOk;
+}
+
 namespace crashlog
 {
 #if defined(_WIN32)
@@ -585,6 +3042,7 @@ namespace crashlog
 	static int crashFd = -1;
 #endif
 	static std::atomic<bool> installed{ false };
+	static std::atomic<bool> isFlightRecorderDumped{ false }; // std::terminate 之后还会进入 SIGABRT 处理，飞行记录器只输出一次
 
 	// 十进制/十六进制安全拼接（无malloc）
 	static size_t AppendStr(char* buf, size_t cap, const char* s)
@@ -680,6 +3138,357 @@ namespace crashlog
 #endif
 	}
 
+	// 只写崩溃日志文件（飞行记录内容较多，不再重复输出到 stderr）
+	static void CrashFileWrite(const char* s, size_t n)
+	{
+#if defined(_WIN32)
+		DWORD w = 0;
+		if (crashFile != INVALID_HANDLE_VALUE)
+		{
+			WriteFile(crashFile, s, (DWORD)n, &w, NULL);
+		}
+#else
+		if (crashFd >= 0)
+		{
+			(void)::write(crashFd, s, n);
+		}
+#endif
+	}
+
+	static const char* LevelName(uint8_t level)
+	{
+		static const char* names[] = { "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL" };
+		return level < sizeof(names) / sizeof(names[0]) ? names[level] : "UNKNOWN";
+	}
+
+	// 飞行记录中参数编码的有界读取（记录可能被截断）
+	struct FlightArgCursor
+	{
+		const char* p;
+		const char* end;
+
+		bool Read(void* out, size_t bytes)
+		{
+			if (static_cast<size_t>(end - p) < bytes)
+			{
+				p = end;
+				return false;
+			}
+			memcpy(out, p, bytes);
+			p += bytes;
+			return true;
+		}
+
+		// 读取 uint32 长度 + 字节，返回可用部分
+		bool ReadString(const char*& data, size_t& bytes)
+		{
+			uint32_t length = 0;
+			if (!Read(&length, sizeof(length)))
+			{
+				return false;
+			}
+			data = p;
+			bytes = std::min<size_t>(length, static_cast<size_t>(end - p));
+			p += bytes;
+			return true;
+		}
+	};
+
+	// 信号安全地渲染一个参数（标签已读出）；out 为 nullptr 时只跳过
+	static size_t AppendFlightArg(char* out, size_t cap, FlightArgCursor& cursor, unsigned char tag)
+	{
+		char scratch[1];
+		char* buf = out ? out : scratch;
+		const size_t bufCap = out ? cap : 0;
+		switch (tag)
+		{
+		case logger_detail::LOG_ARG_BOOL:
+		{
+			unsigned char v = 0;
+			cursor.Read(&v, sizeof(v));
+			return AppendStr(buf, bufCap, v ? "true" : "false");
+		}
+		case logger_detail::LOG_ARG_INT64:
+		{
+			int64_t v = 0;
+			cursor.Read(&v, sizeof(v));
+			size_t n = 0;
+			if (v < 0 && bufCap > 0)
+			{
+				buf[n++] = '-';
+				return n + AppendDec(buf + n, bufCap - n, static_cast<uint64_t>(0) - static_cast<uint64_t>(v));
+			}
+			return AppendDec(buf, bufCap, static_cast<uint64_t>(v));
+		}
+		case logger_detail::LOG_ARG_UINT64:
+		{
+			uint64_t v = 0;
+			cursor.Read(&v, sizeof(v));
+			return AppendDec(buf, bufCap, v);
+		}
+		case logger_detail::LOG_ARG_DOUBLE:
+		{
+			double v = 0;
+			cursor.Read(&v, sizeof(v));
+			if (v != v)
+			{
+				return AppendStr(buf, bufCap, "nan");
+			}
+			size_t n = 0;
+			if (v < 0 && bufCap > 0)
+			{
+				buf[n++] = '-';
+				v = -v;
+			}
+			if (v >= 1e18)
+			{
+				return n + AppendStr(buf + n, bufCap - n, "(large)");
+			}
+			const uint64_t integerPart = static_cast<uint64_t>(v);
+			const uint64_t fraction = static_cast<uint64_t>((v - static_cast<double>(integerPart)) * 1000000.0);
+			n += AppendDec(buf + n, bufCap - n, integerPart);
+			n += AppendStr(buf + n, bufCap - n, ".");
+			char digits[6];
+			uint64_t f = fraction;
+			for (int i = 5; i >= 0; i--)
+			{
+				digits[i] = static_cast<char>('0' + f % 10);
+				f /= 10;
+			}
+			for (int i = 0; i < 6 && n < bufCap; i++)
+			{
+				buf[n++] = digits[i];
+			}
+			return n;
+		}
+		case logger_detail::LOG_ARG_CHAR:
+		{
+			char v = 0;
+			cursor.Read(&v, sizeof(v));
+			if (bufCap == 0)
+			{
+				return 0;
+			}
+			buf[0] = v;
+			return 1;
+		}
+		case logger_detail::LOG_ARG_STRING:
+		{
+			const char* data = nullptr;
+			size_t bytes = 0;
+			cursor.ReadString(data, bytes);
+			bytes = std::min(bytes, bufCap);
+			if (bytes > 0)
+			{
+				memcpy(buf, data, bytes);
+			}
+			return bytes;
+		}
+		case logger_detail::LOG_ARG_POINTER:
+		{
+			uint64_t v = 0;
+			cursor.Read(&v, sizeof(v));
+			return AppendHexPtr(buf, bufCap, reinterpret_cast<const void*>(static_cast<uintptr_t>(v)));
+		}
+		default:
+			cursor.p = cursor.end;
+			return 0;
+		}
+	}
+
+	// 信号安全地把延迟格式化的记录渲染为文本：按格式串替换 "{}"，结构化字段以 key=value 追加在末尾
+	static size_t AppendFlightDeferredMessage(char* out, size_t cap, const char* payload, size_t payloadBytes)
+	{
+		const char* format = nullptr;
+		if (payloadBytes < sizeof(format))
+		{
+			return 0;
+		}
+		memcpy(&format, payload, sizeof(format));
+
+		size_t n = 0;
+		FlightArgCursor args = { payload + sizeof(format), payload + payloadBytes };
+		const char* formatEnd = nullptr;
+		if (!format)
+		{
+			// 非字面量的格式串随记录拷贝，可能被槽位大小截断
+			size_t formatBytes = 0;
+			args.ReadString(format, formatBytes);
+			formatEnd = format + formatBytes;
+		}
+		const char* const argsBegin = args.p;
+		for (const char* f = format; f && (formatEnd ? f < formatEnd : *f != '\0') && n < cap; f++)
+		{
+			if ((f[0] == '{' && f[1] == '{') || (f[0] == '}' && f[1] == '}'))
+			{
+				out[n++] = *f++;
+				continue;
+			}
+			if (f[0] == '{' && f[1] == '}' && args.p < args.end)
+			{
+				// 跳过字段，取下一个普通参数
+				unsigned char tag = static_cast<unsigned char>(logger_detail::LOG_ARG_FIELD);
+				while (args.p < args.end && tag == logger_detail::LOG_ARG_FIELD)
+				{
+					args.Read(&tag, 1);
+					if (tag == logger_detail::LOG_ARG_FIELD)
+					{
+						const char* key = nullptr;
+						size_t keyBytes = 0;
+						args.ReadString(key, keyBytes);
+						unsigned char valueTag = 0;
+						args.Read(&valueTag, 1);
+						AppendFlightArg(nullptr, 0, args, valueTag);
+					}
+				}
+				if (tag != logger_detail::LOG_ARG_FIELD)
+				{
+					n += AppendFlightArg(out + n, cap - n, args, tag);
+				}
+				f++;
+				continue;
+			}
+			out[n++] = *f;
+		}
+
+		FlightArgCursor fields = { argsBegin, payload + payloadBytes };
+		while (fields.p < fields.end && n < cap)
+		{
+			unsigned char tag = 0;
+			fields.Read(&tag, 1);
+			if (tag != logger_detail::LOG_ARG_FIELD)
+			{
+				AppendFlightArg(nullptr, 0, fields, tag);
+				continue;
+			}
+			const char* key = nullptr;
+			size_t keyBytes = 0;
+			fields.ReadString(key, keyBytes);
+			n += AppendStr(out + n, cap - n, " ");
+			keyBytes = std::min(keyBytes, cap - n);
+			memcpy(out + n, key, keyBytes);
+			n += keyBytes;
+			n += AppendStr(out + n, cap - n, "=");
+			unsigned char valueTag = 0;
+			fields.Read(&valueTag, 1);
+			n += AppendFlightArg(out + n, cap - n, fields, valueTag);
+		}
+		return n;
+	}
+
+	// 把各线程飞行记录器中的记录按时间戳归并后写入崩溃日志。只用栈缓冲与 write，可在信号处理函数中调用。
+	static void DumpFlightRecorder()
+	{
+		if (isFlightRecorderDumped.exchange(true))
+		{
+			return;
+		}
+
+		uint64_t cursors[internal::maxFlightRecorders];
+		uint64_t endTickets[internal::maxFlightRecorders];
+		uint64_t totalRecords = 0;
+		for (size_t i = 0; i < internal::maxFlightRecorders; i++)
+		{
+			const internal::FlightRecorder* recorder = internal::flightRecorders[i].load(std::memory_order_acquire);
+			endTickets[i] = recorder ? recorder->nextTicket.load(std::memory_order_acquire) : 0;
+			cursors[i] = endTickets[i] > internal::flightRecorderSlotCount ? endTickets[i] - internal::flightRecorderSlotCount : 0;
+			totalRecords += endTickets[i] - cursors[i];
+		}
+
+		char line[640];
+		size_t p = 0;
+		p += AppendStr(line + p, sizeof(line) - p, "Last log records (");
+		p += AppendDec(line + p, sizeof(line) - p, totalRecords);
+		p += AppendStr(line + p, sizeof(line) - p, "):\n");
+		CrashFileWrite(line, p);
+
+		internal::FlightRecordSlot snapshot;
+		for (;;)
+		{
+			// 取各线程当前游标处时间戳最早的记录（时间戳只用于排序，读到正在改写的值也无妨，下面会校验序号）
+			size_t pick = internal::maxFlightRecorders;
+			int64_t pickTimestamp = 0;
+			for (size_t i = 0; i < internal::maxFlightRecorders; i++)
+			{
+				if (cursors[i] >= endTickets[i])
+				{
+					continue;
+				}
+				const internal::FlightRecorder* recorder = internal::flightRecorders[i].load(std::memory_order_relaxed);
+				const int64_t timestampNs = recorder->slots[cursors[i] & (internal::flightRecorderSlotCount - 1)].timestampNs;
+				if (pick == internal::maxFlightRecorders || timestampNs < pickTimestamp)
+				{
+					pick = i;
+					pickTimestamp = timestampNs;
+				}
+			}
+			if (pick == internal::maxFlightRecorders)
+			{
+				break;
+			}
+
+			const uint64_t ticket = cursors[pick]++;
+			const internal::FlightRecordSlot& slot = internal::flightRecorders[pick].load(std::memory_order_relaxed)->slots[ticket & (internal::flightRecorderSlotCount - 1)];
+			const uint64_t sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+			if (sequenceBefore != ticket * 2 + 2)
+			{
+				continue; // 正在写入或已被更新的记录覆盖
+			}
+			snapshot.timestampNs = slot.timestampNs;
+			snapshot.line = slot.line;
+			snapshot.level = slot.level;
+			snapshot.flags = slot.flags;
+			snapshot.threadIdBytes = std::min<uint8_t>(slot.threadIdBytes, sizeof(snapshot.threadId));
+			snapshot.fileBytes = std::min<uint8_t>(slot.fileBytes, sizeof(snapshot.file));
+			snapshot.payloadBytes = std::min<uint16_t>(slot.payloadBytes, sizeof(snapshot.payload));
+			memcpy(snapshot.threadId, slot.threadId, snapshot.threadIdBytes);
+			memcpy(snapshot.file, slot.file, snapshot.fileBytes);
+			memcpy(snapshot.payload, slot.payload, snapshot.payloadBytes);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) != sequenceBefore)
+			{
+				continue;
+			}
+
+			// [秒.毫秒] [级别] [线程] [文件:行] 消息（时间戳为 UTC 纪元秒，信号上下文中不做本地时间换算）
+			const uint64_t ms = static_cast<uint64_t>(snapshot.timestampNs / 1000000);
+			p = 0;
+			p += AppendStr(line + p, sizeof(line) - p, "[");
+			p += AppendDec(line + p, sizeof(line) - p, ms / 1000);
+			p += AppendStr(line + p, sizeof(line) - p, ".");
+			const char msDigits[3] = { static_cast<char>('0' + ms % 1000 / 100), static_cast<char>('0' + ms % 100 / 10), static_cast<char>('0' + ms % 10) };
+			for (int i = 0; i < 3 && p < sizeof(line); i++)
+			{
+				line[p++] = msDigits[i];
+			}
+			p += AppendStr(line + p, sizeof(line) - p, "] [");
+			p += AppendStr(line + p, sizeof(line) - p, LevelName(snapshot.level));
+			p += AppendStr(line + p, sizeof(line) - p, "] [");
+			memcpy(line + p, snapshot.threadId, snapshot.threadIdBytes);
+			p += snapshot.threadIdBytes;
+			p += AppendStr(line + p, sizeof(line) - p, "] [");
+			memcpy(line + p, snapshot.file, snapshot.fileBytes);
+			p += snapshot.fileBytes;
+			p += AppendStr(line + p, sizeof(line) - p, ":");
+			p += AppendDec(line + p, sizeof(line) - p, static_cast<uint64_t>(snapshot.line < 0 ? 0 : snapshot.line));
+			p += AppendStr(line + p, sizeof(line) - p, "] ");
+
+			const size_t messageCap = sizeof(line) - 1 - p;
+			if ((snapshot.flags & internal::LOG_RECORD_FLAG_DEFERRED_FORMAT) != 0)
+			{
+				p += AppendFlightDeferredMessage(line + p, messageCap, snapshot.payload, snapshot.payloadBytes);
+			}
+			else
+			{
+				const size_t bytes = std::min<size_t>(snapshot.payloadBytes, messageCap);
+				memcpy(line + p, snapshot.payload, bytes);
+				p += bytes;
+			}
+			line[p++] = '\n';
+			CrashFileWrite(line, p);
+		}
+	}
+
 #if !defined(_WIN32)
 	static void LogBacktraceLinux()
 	{
@@ -741,6 +3550,7 @@ void GB_InstallCrashHandlers()
 			p += crashlog::AppendDec(buf + p, sizeof(buf) - p, (uint64_t)time(nullptr));
 			p += crashlog::AppendStr(buf + p, sizeof(buf) - p, "\n");
 			crashlog::EmergencyWrite(buf, p);
+			crashlog::DumpFlightRecorder();
 
 			std::abort(); // 维持标准行为
 		});
@@ -760,6 +3570,7 @@ void GB_InstallCrashHandlers()
 			p += crashlog::AppendDec(head + p, sizeof(head) - p, (uint64_t)time(nullptr));
 			p += crashlog::AppendStr(head + p, sizeof(head) - p, "\r\n");
 			crashlog::EmergencyWrite(head, p);
+			crashlog::DumpFlightRecorder();
 
 			// 栈
 			void* frames[62];
@@ -801,6 +3612,7 @@ void GB_InstallCrashHandlers()
 					p += crashlog::AppendDec(head + p, sizeof(head) - p, (uint64_t)time(nullptr));
 					p += crashlog::AppendStr(head + p, sizeof(head) - p, "\n");
 					crashlog::EmergencyWrite(head, p);
+					crashlog::DumpFlightRecorder();
 
 					crashlog::LogBacktraceLinux();
 
@@ -4,9 +4,19 @@
 #include "GB_Utility.h"
 #include "GB_Utf8String.h"
 #include "GlobalBasePort.h"
+#include "GB_LockProfiler.h"
 #include <mutex>
+#include <string>
+#include <thread>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // 可自愈或已回退=WARNING；关键业务事件=INFO；实现细节=DEBUG；逐步跟踪=TRACE
 enum class GB_LogLevel : int
@@ -20,6 +30,13 @@ enum class GB_LogLevel : int
     GBLOGLEVEL_DISABLELOG = 6
 };
 
+// 结构化字段（由 GB_LogField() 产生）
+struct GB_LogItemField
+{
+    std::string key;
+    std::string jsonValue; // 已编码好的 JSON 值：数字/true/false 原样，字符串已加引号并转义，输出时直接拼接
+};
+
 struct GB_LogItem
 {
     std::string timestamp; // 时间戳
@@ -28,6 +45,7 @@ struct GB_LogItem
     std::string threadId; // 线程 ID
     std::string file; // 文件名
     int line; // 行号
+    std::vector<GB_LogItemField> fields; // 结构化字段，JSON 输出时作为与 "msg" 并列的顶层键
 
     std::string ToJsonString() const;
     std::string ToPlainTextString() const;
@@ -35,12 +53,402 @@ struct GB_LogItem
 
 std::string LogLevelToString(GB_LogLevel level);
 
+// 日志文件的 fsync 策略（日志线程每批只做一次 write，此策略只决定何时额外 fsync）
+enum class GB_LogFsyncPolicy : int
+{
+    Never = 0,          // 不主动 fsync，交给操作系统回写（默认）
+    Interval = 1,       // 有未落盘数据且距上次 fsync 超过 intervalMs 时 fsync
+    OnErrorOrFatal = 2  // 本批次写入了 ERROR/FATAL 时立即 fsync
+};
+
+// 线程缓冲写满后，溢出队列达到上限时的处理策略
+enum class GB_LogOverflowPolicy : int
+{
+    Block = 0,          // 阻塞调用线程，直到日志线程取走溢出队列（默认，不丢日志）
+    DropNewest = 1,     // 丢弃当前这条
+    DropOldest = 2,     // 丢弃溢出队列中最早的记录，为当前这条腾出空间
+    DropBelowLevel = 3  // 丢弃低于 keepLevel 的记录；不低于 keepLevel 的按 Block 处理
+};
+
+// 日志文件按时间轮转的周期（以本地时间的整点/零点为界）
+enum class GB_LogRotationInterval : int
+{
+    None = 0,
+    Hourly = 1,
+    Daily = 2
+};
+
+// 日志文件轮转设置（默认不轮转）。
+// 轮转后的历史文件命名为 "<文件名>.<YYYYMMDD-HHMMSS-毫秒>.log"，压缩与过期清理都在后台线程完成，不阻塞日志线程。
+struct GB_LogRotationOptions
+{
+    uint64_t maxFileBytes = 0; // 当前文件超过此大小即轮转，0 表示不按大小轮转
+    GB_LogRotationInterval interval = GB_LogRotationInterval::None;
+    unsigned int maxRotatedFiles = 10; // 每个日志文件最多保留的历史文件数，0 表示不清理
+    bool compressRotatedFiles = true; // 历史文件是否用 gzip 压缩为 .gz（进程内压缩，不依赖外部程序；失败时保留原文件）
+};
+
+// 日志输出格式
+enum class GB_LogFormat : int
+{
+    Json = 0,       // 与 GB_LogItem::ToJsonString() 相同，每条一行
+    PlainText = 1   // 与 GB_LogItem::ToPlainTextString() 相同
+};
+
+#ifdef _MSC_VER
+#  pragma warning(push)
+#  pragma warning(disable: 4251)
+#endif
+/*
+    日志输出目标（sink）基类：每个 sink 有自己的最低级别与输出格式。
+    - WriteBatch 每批调用一次，items 已按本 sink 的级别过滤并按时间排序；WriteBatch/OnIdle 总在同一个线程上调用，实现无需加锁。
+    - 普通 sink 由日志线程直接驱动；IsBlocking() 返回 true 的 sink（socket 等可能长时间阻塞的目标）由各自独立的线程驱动，
+      积压超过上限时丢弃最早的记录（计入 GetDroppedRecordCount），不会拖慢其它 sink。
+*/
+class GLOBALBASE_PORT GB_LogSink
+{
+public:
+    GB_LogSink(GB_LogLevel minLevel, GB_LogFormat format);
+    virtual ~GB_LogSink();
+
+    GB_LogSink(const GB_LogSink&) = delete;
+    GB_LogSink& operator=(const GB_LogSink&) = delete;
+
+    GB_LogLevel GetLevel() const;
+    void SetLevel(GB_LogLevel level); // 同时刷新 GB_Logger::ShouldLog() 的判断；默认 sink 调用后其级别不再跟随配置
+    GB_LogFormat GetFormat() const;
+    bool IsAccepted(GB_LogLevel level) const;
+
+    // 独立线程驱动时，因积压过多被丢弃的条数
+    uint64_t GetDroppedRecordCount() const;
+
+    virtual void WriteBatch(const std::vector<const GB_LogItem*>& items) = 0;
+    virtual void OnIdle(); // 没有新日志时约每 200ms 调用一次，可用于定时刷盘、重连等
+    virtual bool IsBlocking() const;
+
+protected:
+    // 按本 sink 的格式把一条记录追加到 out
+    void AppendFormatted(const GB_LogItem& item, std::string& out) const;
+
+    std::atomic<uint64_t> droppedRecords{ 0 };
+
+private:
+    friend class GB_Logger;
+
+    std::atomic<int> minLevel;
+    std::atomic<bool> isLevelOverridden{ false }; // 调用过 SetLevel
+    const GB_LogFormat format;
+};
+
+// 文件 sink：常驻打开的追加写句柄，每批只 write 一次；传入 rotationOptions 即为按大小/时间轮转的文件 sink
+class GLOBALBASE_PORT GB_FileLogSink : public GB_LogSink
+{
+public:
+    explicit GB_FileLogSink(const std::string& filePathUtf8, GB_LogLevel minLevel = GB_LogLevel::GBLOGLEVEL_TRACE, GB_LogFormat format = GB_LogFormat::Json,
+        const GB_LogRotationOptions& rotationOptions = GB_LogRotationOptions());
+    ~GB_FileLogSink() override;
+
+    const std::string& GetFilePath() const;
+
+    // 下一批写入时生效
+    void SetRotationOptions(const GB_LogRotationOptions& options);
+    GB_LogRotationOptions GetRotationOptions() const;
+
+    void SetFsyncPolicy(GB_LogFsyncPolicy policy, unsigned int intervalMs = 1000);
+    GB_LogFsyncPolicy GetFsyncPolicy() const;
+
+    void WriteBatch(const std::vector<const GB_LogItem*>& items) override;
+    void OnIdle() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+// 控制台 sink：按级别着色，ERROR 及以上写 stderr；相邻同级别记录合并为一次输出
+class GLOBALBASE_PORT GB_ConsoleLogSink : public GB_LogSink
+{
+public:
+    explicit GB_ConsoleLogSink(GB_LogLevel minLevel = GB_LogLevel::GBLOGLEVEL_TRACE, GB_LogFormat format = GB_LogFormat::PlainText);
+
+    void WriteBatch(const std::vector<const GB_LogItem*>& items) override;
+
+private:
+    std::string run;
+};
+
+// syslog sink：每条记录一个 "<PRI>ident[pid]: 文本" 数据报发往本机 syslog 套接字（仅 POSIX，Windows 下不输出）
+class GLOBALBASE_PORT GB_SyslogLogSink : public GB_LogSink
+{
+public:
+    explicit GB_SyslogLogSink(const std::string& identUtf8, GB_LogLevel minLevel = GB_LogLevel::GBLOGLEVEL_INFO, GB_LogFormat format = GB_LogFormat::PlainText,
+        const std::string& socketPathUtf8 = "/dev/log");
+    ~GB_SyslogLogSink() override;
+
+    void WriteBatch(const std::vector<const GB_LogItem*>& items) override;
+    bool IsBlocking() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+// UNIX 流式套接字 sink：每批写一次，断开后最多每秒重连一次，未连接期间的记录计入丢弃（仅 POSIX，Windows 下不输出）
+class GLOBALBASE_PORT GB_UnixSocketLogSink : public GB_LogSink
+{
+public:
+    explicit GB_UnixSocketLogSink(const std::string& socketPathUtf8, GB_LogLevel minLevel = GB_LogLevel::GBLOGLEVEL_TRACE, GB_LogFormat format = GB_LogFormat::Json);
+    ~GB_UnixSocketLogSink() override;
+
+    void WriteBatch(const std::vector<const GB_LogItem*>& items) override;
+    void OnIdle() override;
+    bool IsBlocking() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+// 内存 sink：保留最近 maxRecords 条已格式化的记录，供崩溃转储或诊断接口读取
+class GLOBALBASE_PORT GB_MemoryLogSink : public GB_LogSink
+{
+public:
+    explicit GB_MemoryLogSink(size_t maxRecords = 1024, GB_LogLevel minLevel = GB_LogLevel::GBLOGLEVEL_TRACE, GB_LogFormat format = GB_LogFormat::Json);
+
+    std::vector<std::string> GetRecentRecords() const; // 从旧到新
+    std::string DumpRecentRecords() const;
+    void Clear();
+
+    void WriteBatch(const std::vector<const GB_LogItem*>& items) override;
+
+private:
+    const size_t maxRecords;
+    mutable std::mutex recordsMtx;
+    std::vector<std::string> records; // 环形存放，nextIndex 指向最旧的一条
+    size_t nextIndex = 0;
+};
+#ifdef _MSC_VER
+#  pragma warning(pop)
+#endif
+
+// 结构化字段参数：GBLOG_INFOF("order created", GB_LogField("orderId", id), GB_LogField("user", name))
+// key 与 value 都在调用时拷贝，调用返回后即可释放。与内置键（ts、level、thread、file、line、msg）同名的 key 输出时加前缀 "field."。
+template <typename T>
+struct GB_LogFieldArg
+{
+    const char* key;
+    const T& value;
+};
+
+template <typename T>
+GB_LogFieldArg<T> GB_LogField(const char* keyUtf8, const T& value)
+{
+    return GB_LogFieldArg<T>{ keyUtf8, value };
+}
+
+// 延迟格式化参数的紧凑二进制编码：调用线程只做 memcpy，数字转文本、"{}" 替换都在日志线程完成
+namespace logger_detail
+{
+    enum LogArgType : unsigned char
+    {
+        LOG_ARG_BOOL = 0,
+        LOG_ARG_INT64 = 1,
+        LOG_ARG_UINT64 = 2,
+        LOG_ARG_DOUBLE = 3,
+        LOG_ARG_CHAR = 4,
+        LOG_ARG_STRING = 5,  // uint32 长度 + UTF-8 字节
+        LOG_ARG_POINTER = 6,
+        LOG_ARG_FIELD = 7    // key（同 LOG_ARG_STRING 的长度 + 字节）后紧跟一个参数
+    };
+
+    // 由 GB_LOG_FMT 产生，只能包裹字符串字面量
+    struct LogFormatLiteral
+    {
+        const char* formatUtf8;
+    };
+
+    /*
+        开头预留格式串指针的位置，之后依次是各参数；小于 inlineBytes 时不分配内存。
+        格式串为字面量时只保存其地址；否则指针位置为 nullptr，格式串以 uint32 长度 + 字节紧随其后。
+    */
+    class LogArgBuffer
+    {
+    public:
+        static const size_t inlineBytes = 256;
+
+        LogArgBuffer() : data(inlineData), size(sizeof(const char*)), capacity(inlineBytes)
+        {
+        }
+
+        ~LogArgBuffer()
+        {
+            if (data != inlineData)
+            {
+                delete[] data;
+            }
+        }
+
+        LogArgBuffer(const LogArgBuffer&) = delete;
+        LogArgBuffer& operator=(const LogArgBuffer&) = delete;
+
+        void SetFormat(LogFormatLiteral format)
+        {
+            memcpy(data, &format.formatUtf8, sizeof(format.formatUtf8));
+        }
+
+        void SetFormat(const char* formatUtf8)
+        {
+            const char* inlineMarker = nullptr;
+            memcpy(data, &inlineMarker, sizeof(inlineMarker));
+            const size_t bytes = formatUtf8 ? strlen(formatUtf8) : 0;
+            const uint32_t length = static_cast<uint32_t>(bytes);
+            Append(&length, sizeof(length));
+            Append(formatUtf8, bytes);
+        }
+
+        void Append(const void* src, size_t bytes)
+        {
+            if (size + bytes > capacity)
+            {
+                Grow(size + bytes);
+            }
+            memcpy(data + size, src, bytes);
+            size += bytes;
+        }
+
+        template <typename T>
+        void AppendTyped(LogArgType type, const T& value)
+        {
+            const unsigned char tag = type;
+            Append(&tag, 1);
+            Append(&value, sizeof(value));
+        }
+
+        void AppendString(LogArgType type, const char* str, size_t bytes)
+        {
+            const unsigned char tag = type;
+            const uint32_t length = static_cast<uint32_t>(bytes);
+            Append(&tag, 1);
+            Append(&length, sizeof(length));
+            Append(str, bytes);
+        }
+
+        const char* Data() const
+        {
+            return reinterpret_cast<const char*>(data);
+        }
+
+        size_t Size() const
+        {
+            return size;
+        }
+
+    private:
+        void Grow(size_t minCapacity)
+        {
+            size_t newCapacity = capacity * 2;
+            while (newCapacity < minCapacity)
+            {
+                newCapacity *= 2;
+            }
+            unsigned char* newData = new unsigned char[newCapacity];
+            memcpy(newData, data, size);
+            if (data != inlineData)
+            {
+                delete[] data;
+            }
+            data = newData;
+            capacity = newCapacity;
+        }
+
+        unsigned char inlineData[inlineBytes];
+        unsigned char* data;
+        size_t size;
+        size_t capacity;
+    };
+
+    inline void EncodeLogArg(LogArgBuffer& buffer, bool value)
+    {
+        buffer.AppendTyped(LOG_ARG_BOOL, static_cast<unsigned char>(value ? 1 : 0));
+    }
+
+    inline void EncodeLogArg(LogArgBuffer& buffer, char value)
+    {
+        buffer.AppendTyped(LOG_ARG_CHAR, value);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type EncodeLogArg(LogArgBuffer& buffer, T value)
+    {
+        buffer.AppendTyped(LOG_ARG_INT64, static_cast<int64_t>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type EncodeLogArg(LogArgBuffer& buffer, T value)
+    {
+        buffer.AppendTyped(LOG_ARG_UINT64, static_cast<uint64_t>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type EncodeLogArg(LogArgBuffer& buffer, T value)
+    {
+        EncodeLogArg(buffer, static_cast<typename std::underlying_type<T>::type>(value));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type EncodeLogArg(LogArgBuffer& buffer, T value)
+    {
+        buffer.AppendTyped(LOG_ARG_DOUBLE, static_cast<double>(value));
+    }
+
+    inline void EncodeLogArg(LogArgBuffer& buffer, const char* value)
+    {
+        if (value == nullptr)
+        {
+            buffer.AppendString(LOG_ARG_STRING, "(null)", 6);
+            return;
+        }
+        buffer.AppendString(LOG_ARG_STRING, value, strlen(value));
+    }
+
+    inline void EncodeLogArg(LogArgBuffer& buffer, const std::string& value)
+    {
+        buffer.AppendString(LOG_ARG_STRING, value.data(), value.size());
+    }
+
+    inline void EncodeLogArg(LogArgBuffer& buffer, const void* value)
+    {
+        buffer.AppendTyped(LOG_ARG_POINTER, reinterpret_cast<uint64_t>(value));
+    }
+
+    template <typename T>
+    void EncodeLogArg(LogArgBuffer& buffer, const GB_LogFieldArg<T>& field)
+    {
+        const char* key = field.key ? field.key : "";
+        buffer.AppendString(LOG_ARG_FIELD, key, strlen(key));
+        EncodeLogArg(buffer, field.value);
+    }
+
+    inline void EncodeLogArgs(LogArgBuffer&)
+    {
+    }
+
+    template <typename First, typename... Rest>
+    void EncodeLogArgs(LogArgBuffer& buffer, const First& first, const Rest&... rest)
+    {
+        EncodeLogArg(buffer, first);
+        EncodeLogArgs(buffer, rest...);
+    }
+}
+
 #ifdef _MSC_VER
 #  pragma warning(push)
 #  pragma warning(disable: 4251)
 #endif
 class GLOBALBASE_PORT GB_Logger
 {
+    friend class GB_LogSink;
+
 public:
     static GB_Logger& GetInstance();
 
@@ -52,14 +460,161 @@ public:
     void LogError(const std::string& msgUtf8, const char* file, int line);
     void LogFatal(const std::string& msgUtf8, const char* file, int line);
 
+    /*
+        延迟格式化：调用线程只把格式串与参数的二进制副本写入缓冲，由日志线程完成 "{}" 替换。
+        - 格式串按字节拷贝进记录，调用返回后即可释放；用 GB_LOG_FMT("...") 包裹字面量时只保存其地址，省去拷贝。
+          "{{" 与 "}}" 输出字面的花括号。
+        - 支持 bool、char、整数、枚举、浮点、const char*、std::string、指针，以及 GB_LogField(key, value) 结构化字段；
+          字段不占用 "{}"，多余的普通参数以空格分隔追加到消息末尾。
+    */
+    template <typename... Args>
+    void LogFormat(GB_LogLevel level, const char* file, int line, const char* formatUtf8, const Args&... args)
+    {
+        logger_detail::LogArgBuffer argBuffer;
+        argBuffer.SetFormat(formatUtf8);
+        logger_detail::EncodeLogArgs(argBuffer, args...);
+        Push(level, argBuffer.Data(), argBuffer.Size(), file, file ? strlen(file) : 0, true, line, true);
+    }
+
+    template <typename... Args>
+    void LogFormat(GB_LogLevel level, const char* file, int line, logger_detail::LogFormatLiteral formatUtf8, const Args&... args)
+    {
+        logger_detail::LogArgBuffer argBuffer;
+        argBuffer.SetFormat(formatUtf8);
+        logger_detail::EncodeLogArgs(argBuffer, args...);
+        Push(level, argBuffer.Data(), argBuffer.Size(), file, file ? strlen(file) : 0, true, line, true);
+    }
+
     bool ClearLogFiles() const;
 
+    // 日志开关、级别、控制台输出等状态缓存在原子变量中，由后台监视线程在配置变化时刷新（Linux: inotify 监视 config.kv；Windows: 注册表变更通知），
+    // 热路径上不再读取配置。GBLOG_* 宏先调用 ShouldLog()，被过滤的日志连消息都不会构造。
+    bool ShouldLog(GB_LogLevel level) const
+    {
+        return static_cast<int>(level) >= minActiveLevel.load(std::memory_order_relaxed);
+    }
+
+    bool IsLogEnabled() const
+    {
+        return isLogEnabled.load(std::memory_order_relaxed);
+    }
+
+    bool IsLogToConsole() const
+    {
+        return isLogToConsole.load(std::memory_order_relaxed);
+    }
+
+    // 写入 GB_OutputLog.log 与控制台的最低级别
+    GB_LogLevel GetFilterLevel() const
+    {
+        return static_cast<GB_LogLevel>(filterLevel.load(std::memory_order_relaxed));
+    }
+
+    // 写入 GB_AllLog.log 的最低级别（默认 TRACE，即全部记录）
+    GB_LogLevel GetAllLogLevel() const
+    {
+        return static_cast<GB_LogLevel>(allLogLevel.load(std::memory_order_relaxed));
+    }
+
+    /*
+        停止日志线程：先把各线程缓冲与溢出队列中剩余的记录写完（最长 drainTimeoutMs），再返回。
+        析构时会自动以默认时限调用；之后的日志不再输出（崩溃时仍可从飞行记录器中看到）。
+    */
+    void Shutdown(unsigned int drainTimeoutMs = 2000);
+
+    // 立即从配置重新加载上述状态（通常无需手动调用）
+    void ReloadConfig();
+
+    /*
+        输出目标。默认有三个 sink：GB_AllLog.log（级别取 GB_AllLogLevel）、GB_OutputLog.log 与控制台（级别取 GB_LogLevel，
+        控制台另受 GB_IsLogToConsole 控制），它们的级别随配置自动更新，除非已对其调用过 SetLevel；可通过 RemoveSink 移除。
+        日志关闭（GB_EnableLog）时所有 sink 都不输出。
+        RemoveSink 等日志线程丢弃对该 sink 的引用后才返回：返回后不会再调用该 sink，且 sink 的最终释放（包括独立写线程的 join）
+        发生在调用 RemoveSink 的线程上。在 sink 的回调中（即日志线程上）调用时不等待，此时由日志线程在下一批之前释放。
+        IsBlocking() 的 sink 回调运行在它自己的写线程上，在其中调用 RemoveSink 时写线程不会 join 自己：
+        该线程改为分离，写完已入队的记录后退出，因此 RemoveSink 返回后该 sink 仍可能收到这些剩余记录。
+    */
+    void AddSink(const std::shared_ptr<GB_LogSink>& sink);
+    bool RemoveSink(const std::shared_ptr<GB_LogSink>& sink);
+    std::vector<std::shared_ptr<GB_LogSink>> GetSinks() const;
+
+    // 设置两个默认日志文件的 fsync 策略；intervalMs 仅对 GB_LogFsyncPolicy::Interval 有效
+    void SetFsyncPolicy(GB_LogFsyncPolicy policy, unsigned int intervalMs = 1000);
+    GB_LogFsyncPolicy GetFsyncPolicy() const;
+
+    /*
+        设置溢出队列的上限与满时策略。每个线程先写自己的环形缓冲（固定大小），缓冲写满后才进入共享的溢出队列，
+        maxQueueBytes 限制的是溢出队列中尚未被日志线程取走的字节数。
+        被丢弃的条数按级别累计，日志线程每秒最多输出一条 WARNING 级别的汇总日志（见 GetDroppedRecordCount）。
+        Shutdown 开始后，需要进入溢出队列的记录一律丢弃并计数，不论策略。
+    */
+    void SetOverflowPolicy(GB_LogOverflowPolicy policy, size_t maxQueueBytes = 64 * 1024 * 1024, GB_LogLevel keepLevel = GB_LogLevel::GBLOGLEVEL_WARNING);
+    GB_LogOverflowPolicy GetOverflowPolicy() const;
+
+    // 进程启动以来因溢出被丢弃的日志条数
+    uint64_t GetDroppedRecordCount() const;
+
+    // 设置/获取两个默认日志文件的轮转策略，下一批日志写入时生效
+    void SetRotationOptions(const GB_LogRotationOptions& options);
+    GB_LogRotationOptions GetRotationOptions() const;
+
 private:
-    std::queue<GB_LogItem> logQueue; // 日志队列
+    /*
+        生产者前端：
+        - 每个调用日志的线程首次写日志时注册一个自己的 SPSC 环形缓冲（ThreadRing），之后写日志只做 memcpy + 原子发布，
+          不加锁、不分配内存；线程 ID 字符串在注册时格式化一次并缓存。
+        - 记录是紧凑的二进制格式（级别、行号、原始时间戳、文件名与消息字节），时间戳格式化、文件名转码等工作都在日志线程完成。
+        - 环形缓冲写满或单条记录过大时，退回到受 logQueueMtx 保护的 overflowRecords（同样的二进制格式），保证不丢日志。
+    */
+    struct ThreadRing; // 定义见 GB_Logger.cpp
+
+    std::vector<unsigned char> overflowRecords; // 溢出记录（受 logQueueMtx 保护）
     std::mutex logQueueMtx;
+    GB_LockProfile* const logQueueMtxProfile; // logQueueMtx 的竞争统计
     std::condition_variable logQueueCv;
+    std::condition_variable overflowSpaceCv; // Block 策略下等待溢出队列被取走
+    size_t overflowWaiterCount = 0; // 正在等待 overflowSpaceCv 的线程数（受 logQueueMtx 保护）
+    uint64_t pendingDroppedCounts[static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG)] = {}; // 尚未汇报的丢弃条数，按级别（受 logQueueMtx 保护）
+
+    std::atomic<int> overflowPolicy{ static_cast<int>(GB_LogOverflowPolicy::Block) };
+    std::atomic<size_t> maxOverflowBytes{ 64 * 1024 * 1024 };
+    std::atomic<int> overflowKeepLevel{ static_cast<int>(GB_LogLevel::GBLOGLEVEL_WARNING) };
+    std::atomic<uint64_t> totalDroppedRecords{ 0 };
+
+    std::vector<std::shared_ptr<ThreadRing>> threadRings; // 所有已注册的线程缓冲（受 threadRingsMtx 保护）
+    std::mutex threadRingsMtx;
+    std::atomic<uint64_t> threadRingsVersion{ 0 }; // threadRings 每次增删都会递增，日志线程据此刷新本地快照
+    std::atomic_bool isWriterSleeping{ false }; // 日志线程是否即将/正在等待 logQueueCv
+
+    std::atomic_bool isLogEnabled{ false };
+    std::atomic_bool isLogToConsole{ false };
+    std::atomic<int> filterLevel{ static_cast<int>(GB_LogLevel::GBLOGLEVEL_TRACE) };
+    std::atomic<int> allLogLevel{ static_cast<int>(GB_LogLevel::GBLOGLEVEL_TRACE) };
+    std::atomic<int> minActiveLevel{ static_cast<int>(GB_LogLevel::GBLOGLEVEL_DISABLELOG) }; // 日志关闭时为 DISABLELOG，否则为各 sink 级别的最小值
+
+    std::mutex configReloadMtx;
+
+    /*
+        sink 列表：日志线程按 sinksVersion 刷新本地快照。
+        IsBlocking() 的 sink 在 SinkEntry 中带一个独立的写线程与有界队列。
+    */
+    struct SinkEntry; // 定义见 GB_Logger.cpp
+    std::vector<std::shared_ptr<SinkEntry>> sinkEntries;
+    mutable std::mutex sinksMtx;
+    std::atomic<uint64_t> sinksVersion{ 0 };
+    std::condition_variable sinksAppliedCv;
+    uint64_t sinksAppliedVersion = 0; // 日志线程已换上的快照版本（旧快照已释放），受 sinksMtx 保护
+    bool isLogThreadExited = false;   // 受 sinksMtx 保护
+    const std::shared_ptr<GB_FileLogSink> allLogSink;
+    const std::shared_ptr<GB_FileLogSink> outputLogSink;
+    const std::shared_ptr<GB_ConsoleLogSink> consoleSink;
+
+    struct ConfigWatcher; // 定义见 GB_Logger.cpp
+    std::unique_ptr<ConfigWatcher> configWatcher;
 
     std::atomic_bool isStop{ false };
+    std::atomic<unsigned int> shutdownDrainTimeoutMs{ 2000 };
+    std::mutex shutdownMtx;
     std::thread logThread;
 
     GB_Logger();
@@ -67,18 +622,158 @@ private:
 	GB_Logger(const GB_Logger&) = delete;
     GB_Logger& operator=(const GB_Logger&) = delete;
 
+    void Push(GB_LogLevel level, const char* msgData, size_t msgBytes, const char* fileData, size_t fileBytes, bool isFileNative, int line, bool isDeferredFormat = false);
+    ThreadRing& GetThreadRing();
+    void WakeLogThread();
+    void RefreshActiveLevel(); // 按日志开关与各 sink 的级别重新计算 minActiveLevel
+
 	void LogThreadFunc(); // 日志处理线程函数
 };
 #ifdef _MSC_VER
 #  pragma warning(pop)
 #endif
 
-#define GBLOG_TRACE(msg) do { GB_Logger::GetInstance().LogTrace(msg, __FILE__, __LINE__); } while (0)
-#define GBLOG_DEBUG(msg) do { GB_Logger::GetInstance().LogDebug(msg, __FILE__, __LINE__); } while (0)
-#define GBLOG_INFO(msg) do { GB_Logger::GetInstance().LogInfo(msg, __FILE__, __LINE__); } while (0)
-#define GBLOG_WARNING(msg) do { GB_Logger::GetInstance().LogWarning(msg, __FILE__, __LINE__); } while (0)
-#define GBLOG_ERROR(msg) do { GB_Logger::GetInstance().LogError(msg, __FILE__, __LINE__); } while (0)
-#define GBLOG_FATAL(msg) do { GB_Logger::GetInstance().LogFatal(msg, __FILE__, __LINE__); } while (0)
+#define GBLOG_IMPL(levelValue, logFunc, msg) do { GB_Logger& gbLogger_ = GB_Logger::GetInstance(); if (gbLogger_.ShouldLog(levelValue)) { gbLogger_.logFunc(msg, __FILE__, __LINE__); } } while (0)
+
+#define GBLOG_TRACE(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, LogTrace, msg)
+#define GBLOG_DEBUG(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, LogDebug, msg)
+#define GBLOG_INFO(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, LogInfo, msg)
+#define GBLOG_WARNING(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, LogWarning, msg)
+#define GBLOG_ERROR(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, LogError, msg)
+#define GBLOG_FATAL(msg) GBLOG_IMPL(GB_LogLevel::GBLOGLEVEL_FATAL, LogFatal, msg)
+
+// GBLOG_INFOF("x={} y={}", x, y)：格式串会被拷贝；GBLOG_INFOF(GB_LOG_FMT("x={} y={}"), x, y) 只保存字面量的地址。
+// GB_LOG_FMT 只接受字符串字面量（与 "" 拼接，传入变量时编译失败），该字面量所在的模块在日志输出前不得卸载。
+#define GB_LOG_FMT(literalUtf8) logger_detail::LogFormatLiteral{ "" literalUtf8 "" }
+#define GBLOG_FORMAT_IMPL(levelValue, ...) do { GB_Logger& gbLogger_ = GB_Logger::GetInstance(); if (gbLogger_.ShouldLog(levelValue)) { gbLogger_.LogFormat(levelValue, __FILE__, __LINE__, __VA_ARGS__); } } while (0)
+
+#define GBLOG_TRACEF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, __VA_ARGS__)
+#define GBLOG_DEBUGF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, __VA_ARGS__)
+#define GBLOG_INFOF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, __VA_ARGS__)
+#define GBLOG_WARNINGF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, __VA_ARGS__)
+#define GBLOG_ERRORF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, __VA_ARGS__)
+#define GBLOG_FATALF(...) GBLOG_FORMAT_IMPL(GB_LogLevel::GBLOGLEVEL_FATAL, __VA_ARGS__)
+
+// 调用点级别的采样与限流状态：宏里每个调用点各有一份函数级静态对象（即按 __FILE__/__LINE__ 区分），
+// 构造函数为 constexpr，属于常量初始化，无需线程安全的静态初始化保护；判断只用原子操作，不加锁。
+namespace logger_detail
+{
+    // 每 N 次放行一次：第 1、N+1、2N+1… 次调用返回 true
+    class LogEveryNSampler
+    {
+    public:
+        constexpr LogEveryNSampler() : counter(0)
+        {
+        }
+
+        LogEveryNSampler(const LogEveryNSampler&) = delete;
+        LogEveryNSampler& operator=(const LogEveryNSampler&) = delete;
+
+        // 返回 true 时 suppressed 为自上次放行以来被跳过的次数
+        bool Sample(uint64_t n, uint64_t& suppressed)
+        {
+            const uint64_t count = counter.fetch_add(1, std::memory_order_relaxed);
+            if (n <= 1)
+            {
+                suppressed = 0;
+                return true;
+            }
+            if (count % n != 0)
+            {
+                return false;
+            }
+            suppressed = count == 0 ? 0 : n - 1;
+            return true;
+        }
+
+    private:
+        std::atomic<uint64_t> counter;
+    };
+
+    /*
+        令牌桶限流（以 GCRA 形式实现：只保存"下一个令牌的理论到达时间"，一次 CAS 完成取令牌）。
+        - 平均速率 perSecond 条/秒，允许最多 1 秒的突发；perSecond < 1 时即每 1/perSecond 秒一条。
+        - perSecond <= 0 时全部丢弃。
+    */
+    class LogRateLimiter
+    {
+    public:
+        constexpr LogRateLimiter() : nextTokenNs(0), suppressedCount(0)
+        {
+        }
+
+        LogRateLimiter(const LogRateLimiter&) = delete;
+        LogRateLimiter& operator=(const LogRateLimiter&) = delete;
+
+        // 返回 true 时 suppressed 为自上次放行以来被限流的次数
+        bool Sample(double perSecond, uint64_t& suppressed)
+        {
+            if (!(perSecond > 0))
+            {
+                suppressedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            const int64_t secondNs = 1000000000;
+            const double intervalValue = static_cast<double>(secondNs) / perSecond;
+            const int64_t intervalNs = intervalValue < 1 ? 1 : (intervalValue > static_cast<double>(secondNs) * 3600 ? secondNs * 3600 : static_cast<int64_t>(intervalValue));
+            const int64_t burstToleranceNs = intervalNs < secondNs ? secondNs - intervalNs : 0;
+            const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            int64_t expected = nextTokenNs.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const int64_t base = expected > nowNs ? expected : nowNs;
+                if (base - nowNs > burstToleranceNs)
+                {
+                    suppressedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (nextTokenNs.compare_exchange_weak(expected, base + intervalNs, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            suppressed = suppressedCount.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        std::atomic<int64_t> nextTokenNs;
+        std::atomic<uint64_t> suppressedCount;
+    };
+}
+
+// 级别过滤之后再采样：被过滤的调用不计数。放行时若之前有被跳过的记录，被跳过的条数作为 suppressedCount 字段附在这条记录上。
+#define GBLOG_SAMPLED_IMPL(levelValue, samplerType, limit, logStatement, logWithSuppressedStatement) do { GB_Logger& gbLogger_ = GB_Logger::GetInstance(); if (gbLogger_.ShouldLog(levelValue)) { static logger_detail::samplerType gbLogSampler_; uint64_t gbLogSuppressed_ = 0; if (gbLogSampler_.Sample(limit, gbLogSuppressed_)) { if (gbLogSuppressed_ > 0) { logWithSuppressedStatement; } else { logStatement; } } } } while (0)
+
+// GBLOG_WARNING_EVERY_N(100, msg)：该调用点每 100 次只输出 1 次
+#define GBLOG_TRACE_EVERY_N(n, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogTrace(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_DEBUG_EVERY_N(n, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogDebug(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_INFO_EVERY_N(n, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogInfo(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_WARNING_EVERY_N(n, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogWarning(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_ERROR_EVERY_N(n, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogError(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+
+// GBLOG_INFO_RATE(10, msg)：该调用点平均每秒最多输出 10 次（允许 1 秒的突发）
+#define GBLOG_TRACE_RATE(perSecond, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogTrace(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_DEBUG_RATE(perSecond, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogDebug(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_INFO_RATE(perSecond, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogInfo(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_WARNING_RATE(perSecond, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogWarning(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_ERROR_RATE(perSecond, msg) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogError(msg, __FILE__, __LINE__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, GB_LOG_FMT("{}"), msg, GB_LogField("suppressedCount", gbLogSuppressed_)))
+
+// 延迟格式化版本：GBLOG_WARNINGF_EVERY_N(100, "retry {} failed", id)、GBLOG_INFOF_RATE(10, "x={}", x)
+#define GBLOG_TRACEF_EVERY_N(n, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_DEBUGF_EVERY_N(n, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_INFOF_EVERY_N(n, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_WARNINGF_EVERY_N(n, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_ERRORF_EVERY_N(n, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, LogEveryNSampler, static_cast<uint64_t>(n), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+
+#define GBLOG_TRACEF_RATE(perSecond, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_TRACE, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_DEBUGF_RATE(perSecond, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_DEBUG, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_INFOF_RATE(perSecond, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_INFO, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_WARNINGF_RATE(perSecond, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_WARNING, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
+#define GBLOG_ERRORF_RATE(perSecond, ...) GBLOG_SAMPLED_IMPL(GB_LogLevel::GBLOGLEVEL_ERROR, LogRateLimiter, static_cast<double>(perSecond), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__), gbLogger_.LogFormat(GB_LogLevel::GBLOGLEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__, GB_LogField("suppressedCount", gbLogSuppressed_)))
 
 GLOBALBASE_PORT bool GB_IsLogEnabled();
 GLOBALBASE_PORT bool GB_SetLogEnabled(bool enable);
@@ -87,8 +782,12 @@ GLOBALBASE_PORT bool GB_IsLogToConsole();
 GLOBALBASE_PORT bool GB_SetLogToConsole(bool enable);
 
 GLOBALBASE_PORT GB_LogLevel GB_GetLogFilterLevel();
+GLOBALBASE_PORT bool GB_SetLogFilterLevel(GB_LogLevel level);
 GLOBALBASE_PORT bool GB_CheckLogLevel(GB_LogLevel level);
 
+GLOBALBASE_PORT GB_LogLevel GB_GetAllLogLevel();
+GLOBALBASE_PORT bool GB_SetAllLogLevel(GB_LogLevel level);
+
 GLOBALBASE_PORT void GB_InstallCrashHandlers();
 GLOBALBASE_PORT void GB_RemoveCrashHandlers();
 
@@ -0,0 +1,694 @@
+﻿#include "GB_Path.h"
+#include <cstring>
+#include <utility>
+
+using namespace std;
+
+namespace internal
+{
+    static inline bool IsPathSeparator(char ch)
+    {
+        return ch == '/' || ch == '\\';
+    }
+
+    static inline bool IsDriveLetter(char ch)
+    {
+        return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z');
+    }
+
+    static inline bool IsDotComponent(const char* str, size_t length)
+    {
+        return length == 1 && str[0] == '.';
+    }
+
+    static inline bool IsDotDotComponent(GB_StringView component)
+    {
+        return component.size() == 2 && component[0] == '.' && component[1] == '.';
+    }
+
+    // 输入是否带根（用于 Append 时决定整体替换）
+    static bool HasRootPrefix(const char* str, size_t length)
+    {
+        if (length == 0)
+        {
+            return false;
+        }
+        if (IsPathSeparator(str[0]))
+        {
+            return true;
+        }
+#ifdef _WIN32
+        if (length >= 2 && IsDriveLetter(str[0]) && str[1] == ':')
+        {
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /*
+        把 [str, str + length) 规范化后写入 dst，返回写入字节数（不会超过 length）。
+        dst 与 str 可以是同一块内存（只会向前覆盖）。
+        keepDot 为 true 时，全部由“.”组成的非空输入输出 "."，否则输出空串。
+    */
+    static size_t NormalizePathTo(const char* str, size_t length, char* dst, bool keepDot)
+    {
+        size_t in = 0;
+        size_t out = 0;
+
+        if (length > 2 && IsPathSeparator(str[0]) && IsPathSeparator(str[1]) && !IsPathSeparator(str[2]))
+        {
+            // UNC："//server/share"
+            dst[out++] = '/';
+            dst[out++] = '/';
+            in = 2;
+        }
+        else if (length > 0 && IsPathSeparator(str[0]))
+        {
+            dst[out++] = '/';
+            in = 1;
+        }
+#ifdef _WIN32
+        else if (length >= 2 && IsDriveLetter(str[0]) && str[1] == ':')
+        {
+            dst[out++] = str[0];
+            dst[out++] = ':';
+            in = 2;
+            if (in < length && IsPathSeparator(str[in]))
+            {
+                dst[out++] = '/';
+                in++;
+            }
+        }
+#endif
+        const size_t rootEnd = out;
+
+        bool sawDot = false;
+        while (in < length)
+        {
+            while (in < length && IsPathSeparator(str[in]))
+            {
+                in++;
+            }
+            const size_t begin = in;
+            while (in < length && !IsPathSeparator(str[in]))
+            {
+                in++;
+            }
+            const size_t componentLength = in - begin;
+            if (componentLength == 0)
+            {
+                break;
+            }
+            if (IsDotComponent(str + begin, componentLength))
+            {
+                sawDot = true;
+                continue;
+            }
+
+            if (out > rootEnd)
+            {
+                dst[out++] = '/';
+            }
+            memmove(dst + out, str + begin, componentLength);
+            out += componentLength;
+        }
+
+        if (out == 0 && sawDot && keepDot)
+        {
+            dst[out++] = '.';
+        }
+        return out;
+    }
+}
+
+GB_Path::GB_Path()
+{
+    ResetToInline();
+}
+
+GB_Path::GB_Path(const char* pathUtf8)
+{
+    ResetToInline();
+    if (pathUtf8 != nullptr)
+    {
+        AssignNormalized(pathUtf8, strlen(pathUtf8));
+    }
+}
+
+GB_Path::GB_Path(const string& pathUtf8)
+{
+    ResetToInline();
+    AssignNormalized(pathUtf8.data(), pathUtf8.size());
+}
+
+GB_Path::GB_Path(GB_StringView pathUtf8)
+{
+    ResetToInline();
+    AssignNormalized(pathUtf8.data(), pathUtf8.size());
+}
+
+GB_Path::GB_Path(const GB_Path& other)
+{
+    ResetToInline();
+    Reserve(other.size);
+    memcpy(data, other.data, other.size + 1);
+    size = other.size;
+}
+
+GB_Path::GB_Path(GB_Path&& other) noexcept
+{
+    ResetToInline();
+    *this = std::move(other);
+}
+
+GB_Path& GB_Path::operator=(const GB_Path& other)
+{
+    if (this != &other)
+    {
+        Reserve(other.size);
+        memcpy(data, other.data, other.size + 1);
+        size = other.size;
+    }
+    return *this;
+}
+
+GB_Path& GB_Path::operator=(GB_Path&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if (other.data != other.inlineBuffer)
+    {
+        if (data != inlineBuffer)
+        {
+            delete[] data;
+        }
+        data = other.data;
+        size = other.size;
+        capacity = other.capacity;
+        other.ResetToInline();
+        return *this;
+    }
+
+    // other 在内联缓冲区里，长度一定不超过本对象的容量
+    memcpy(data, other.data, other.size + 1);
+    size = other.size;
+    other.size = 0;
+    other.data[0] = '\0';
+    return *this;
+}
+
+GB_Path::~GB_Path()
+{
+    if (data != inlineBuffer)
+    {
+        delete[] data;
+    }
+}
+
+void GB_Path::ResetToInline()
+{
+    data = inlineBuffer;
+    size = 0;
+    capacity = inlineCapacity - 1;
+    inlineBuffer[0] = '\0';
+}
+
+void GB_Path::Reserve(size_t newCapacity)
+{
+    if (newCapacity <= capacity)
+    {
+        return;
+    }
+
+    size_t grown = capacity * 2;
+    if (grown < newCapacity)
+    {
+        grown = newCapacity;
+    }
+
+    char* newData = new char[grown + 1];
+    memcpy(newData, data, size + 1);
+    if (data != inlineBuffer)
+    {
+        delete[] data;
+    }
+    data = newData;
+    capacity = grown;
+}
+
+void GB_Path::Truncate(size_t newSize)
+{
+    if (newSize < size)
+    {
+        size = newSize;
+        data[size] = '\0';
+    }
+}
+
+void GB_Path::AssignNormalized(const char* str, size_t length)
+{
+    if (str >= data && str <= data + capacity)
+    {
+        // 源在自身缓冲区内：规范化只会向前覆盖，可以原地进行
+        const size_t offset = static_cast<size_t>(str - data);
+        size = internal::NormalizePathTo(data + offset, length, data, true);
+        data[size] = '\0';
+        return;
+    }
+
+    Reserve(length);
+    size = internal::NormalizePathTo(str, length, data, true);
+    data[size] = '\0';
+}
+
+void GB_Path::AppendNormalized(const char* str, size_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    if (size == 0 || internal::HasRootPrefix(str, length) || (size == 1 && data[0] == '.'))
+    {
+        AssignNormalized(str, length);
+        return;
+    }
+    if (str >= data && str <= data + capacity)
+    {
+        // 追加自身的一部分：先拷出来，避免扩容后悬空
+        const GB_Path copy(GB_StringView(str, length));
+        AppendNormalized(copy.data, copy.size);
+        return;
+    }
+
+    const bool needSeparator = size > GetRootLength();
+    Reserve(size + 1 + length);
+    const size_t start = size + (needSeparator ? 1 : 0);
+    const size_t written = internal::NormalizePathTo(str, length, data + start, false);
+    if (written == 0)
+    {
+        data[size] = '\0';
+        return;
+    }
+    if (needSeparator)
+    {
+        data[size] = '/';
+    }
+    size = start + written;
+    data[size] = '\0';
+}
+
+void GB_Path::AppendComponent(GB_StringView component)
+{
+    const bool needSeparator = size > GetRootLength();
+    Reserve(size + 1 + component.size());
+    if (needSeparator)
+    {
+        data[size++] = '/';
+    }
+    memcpy(data + size, component.data(), component.size());
+    size += component.size();
+    data[size] = '\0';
+}
+
+GB_StringView GB_Path::View() const
+{
+    return GB_StringView(data, size);
+}
+
+const char* GB_Path::CStr() const
+{
+    return data;
+}
+
+size_t GB_Path::Size() const
+{
+    return size;
+}
+
+bool GB_Path::Empty() const
+{
+    return size == 0;
+}
+
+string GB_Path::ToString() const
+{
+    return string(data, size);
+}
+
+size_t GB_Path::GetRootLength() const
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (size > 2 && data[0] == '/' && data[1] == '/')
+    {
+        // "//server/share"：根延伸到 share 结束
+        size_t pos = 2;
+        while (pos < size && data[pos] != '/')
+        {
+            pos++;
+        }
+        if (pos < size)
+        {
+            pos++;
+            while (pos < size && data[pos] != '/')
+            {
+                pos++;
+            }
+        }
+        return pos;
+    }
+
+    if (data[0] == '/')
+    {
+        return 1;
+    }
+
+#ifdef _WIN32
+    if (size >= 2 && internal::IsDriveLetter(data[0]) && data[1] == ':')
+    {
+        return (size >= 3 && data[2] == '/') ? 3 : 2;
+    }
+#endif
+    return 0;
+}
+
+size_t GB_Path::GetFileNameOffset() const
+{
+    const size_t rootLength = GetRootLength();
+    if (size <= rootLength)
+    {
+        return size;
+    }
+
+    size_t pos = size;
+    while (pos > rootLength && data[pos - 1] != '/')
+    {
+        pos--;
+    }
+    return pos;
+}
+
+bool GB_Path::IsAbsolute() const
+{
+    const size_t rootLength = GetRootLength();
+    return rootLength > 0 && (data[0] == '/' || data[rootLength - 1] == '/');
+}
+
+bool GB_Path::IsRoot() const
+{
+    return size > 0 && size == GetRootLength();
+}
+
+bool GB_Path::HasRoot() const
+{
+    return GetRootLength() > 0;
+}
+
+GB_StringView GB_Path::GetRoot() const
+{
+    return GB_StringView(data, GetRootLength());
+}
+
+GB_StringView GB_Path::GetFileName() const
+{
+    const size_t offset = GetFileNameOffset();
+    return GB_StringView(data + offset, size - offset);
+}
+
+GB_StringView GB_Path::GetStem() const
+{
+    const GB_StringView fileName = GetFileName();
+    const GB_StringView extension = GetExtension();
+    return fileName.substr(0, fileName.size() - extension.size());
+}
+
+GB_StringView GB_Path::GetExtension() const
+{
+    const GB_StringView fileName = GetFileName();
+    if (internal::IsDotDotComponent(fileName))
+    {
+        return GB_StringView(fileName.end(), 0);
+    }
+
+    const size_t dotPos = fileName.rfind('.');
+    if (dotPos == GB_StringView::npos || dotPos == 0)
+    {
+        return GB_StringView(fileName.end(), 0);
+    }
+    return fileName.substr(dotPos);
+}
+
+GB_StringView GB_Path::GetParentPath() const
+{
+    const size_t rootLength = GetRootLength();
+    size_t end = GetFileNameOffset();
+    if (end >= size)
+    {
+        // 根或空路径
+        return GB_StringView(data, size);
+    }
+    while (end > rootLength && data[end - 1] == '/')
+    {
+        end--;
+    }
+    return GB_StringView(data, end);
+}
+
+bool GB_Path::NextComponent(size_t& cursor, GB_StringView& component) const
+{
+    if (cursor == 0)
+    {
+        const size_t rootLength = GetRootLength();
+        if (rootLength > 0)
+        {
+            component = GB_StringView(data, rootLength);
+            cursor = rootLength;
+            return true;
+        }
+    }
+
+    while (cursor < size && data[cursor] == '/')
+    {
+        cursor++;
+    }
+    if (cursor >= size)
+    {
+        return false;
+    }
+
+    size_t end = cursor;
+    while (end < size && data[end] != '/')
+    {
+        end++;
+    }
+    component = GB_StringView(data + cursor, end - cursor);
+    cursor = end;
+    return true;
+}
+
+GB_Path& GB_Path::Append(GB_StringView relativeUtf8)
+{
+    AppendNormalized(relativeUtf8.data(), relativeUtf8.size());
+    return *this;
+}
+
+GB_Path& GB_Path::Append(const char* relativeUtf8)
+{
+    return Append(GB_StringView(relativeUtf8));
+}
+
+GB_Path& GB_Path::Append(const string& relativeUtf8)
+{
+    return Append(GB_StringView(relativeUtf8));
+}
+
+GB_Path& GB_Path::Append(const GB_Path& relative)
+{
+    AppendNormalized(relative.data, relative.size);
+    return *this;
+}
+
+GB_Path& GB_Path::ReplaceExtension(GB_StringView newExtension)
+{
+    const GB_StringView fileName = GetFileName();
+    if (fileName.empty())
+    {
+        return *this;
+    }
+
+    if (newExtension.data() >= data && newExtension.data() <= data + capacity)
+    {
+        const string copy = newExtension.ToString();
+        return ReplaceExtension(copy);
+    }
+
+    Truncate(size - GetExtension().size());
+    if (newExtension.empty())
+    {
+        return *this;
+    }
+
+    const bool needDot = newExtension[0] != '.';
+    Reserve(size + newExtension.size() + 1);
+    if (needDot)
+    {
+        data[size++] = '.';
+    }
+    memcpy(data + size, newExtension.data(), newExtension.size());
+    size += newExtension.size();
+    data[size] = '\0';
+    return *this;
+}
+
+GB_Path& GB_Path::RemoveFileName()
+{
+    Truncate(GetParentPath().size());
+    return *this;
+}
+
+GB_Path GB_Path::LexicallyNormal() const
+{
+    GB_Path result;
+    const size_t rootLength = GetRootLength();
+    result.Reserve(size);
+    memcpy(result.data, data, rootLength);
+    result.size = rootLength;
+    result.data[rootLength] = '\0';
+
+    size_t cursor = rootLength;
+    GB_StringView component;
+    while (NextComponent(cursor, component))
+    {
+        if (internal::IsDotComponent(component.data(), component.size()))
+        {
+            continue;
+        }
+        if (internal::IsDotDotComponent(component))
+        {
+            const GB_StringView last = result.GetFileName();
+            if (!last.empty() && !internal::IsDotDotComponent(last))
+            {
+                result.RemoveFileName();
+                continue;
+            }
+            if (rootLength > 0)
+            {
+                continue;
+            }
+        }
+        result.AppendComponent(component);
+    }
+
+    if (result.size == 0)
+    {
+        result.data[result.size++] = '.';
+        result.data[result.size] = '\0';
+    }
+    return result;
+}
+
+GB_Path GB_Path::LexicallyRelative(const GB_Path& base) const
+{
+    const size_t rootLength = GetRootLength();
+    const size_t baseRootLength = base.GetRootLength();
+    if (GB_StringView(data, rootLength) != GB_StringView(base.data, baseRootLength))
+    {
+        return GB_Path();
+    }
+
+    size_t cursor = rootLength;
+    size_t baseCursor = baseRootLength;
+    GB_StringView component;
+    GB_StringView baseComponent;
+    bool hasComponent = NextComponent(cursor, component);
+    bool hasBaseComponent = base.NextComponent(baseCursor, baseComponent);
+    while (hasComponent && hasBaseComponent && component == baseComponent)
+    {
+        hasComponent = NextComponent(cursor, component);
+        hasBaseComponent = base.NextComponent(baseCursor, baseComponent);
+    }
+
+    int upCount = 0;
+    while (hasBaseComponent)
+    {
+        if (internal::IsDotDotComponent(baseComponent))
+        {
+            upCount--;
+        }
+        else if (!internal::IsDotComponent(baseComponent.data(), baseComponent.size()))
+        {
+            upCount++;
+        }
+        hasBaseComponent = base.NextComponent(baseCursor, baseComponent);
+    }
+    if (upCount < 0)
+    {
+        return GB_Path();
+    }
+
+    GB_Path result;
+    if (upCount == 0 && !hasComponent)
+    {
+        result.data[result.size++] = '.';
+        result.data[result.size] = '\0';
+        return result;
+    }
+
+    for (int i = 0; i < upCount; i++)
+    {
+        result.AppendComponent(GB_StringView("..", 2));
+    }
+    while (hasComponent)
+    {
+        result.AppendComponent(component);
+        hasComponent = NextComponent(cursor, component);
+    }
+    return result;
+}
+
+bool GB_Path::StartsWith(const GB_Path& prefix) const
+{
+    if (prefix.size == 0)
+    {
+        return true;
+    }
+    if (prefix.size > size || memcmp(data, prefix.data, prefix.size) != 0)
+    {
+        return false;
+    }
+    return prefix.size == size || data[prefix.size] == '/' || prefix.data[prefix.size - 1] == '/';
+}
+
+size_t GB_Path::Hash() const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+bool GB_Path::operator==(const GB_Path& other) const
+{
+    return View() == other.View();
+}
+
+bool GB_Path::operator!=(const GB_Path& other) const
+{
+    return !(*this == other);
+}
+
+bool GB_Path::operator<(const GB_Path& other) const
+{
+    return View() < other.View();
+}
@@ -0,0 +1,272 @@
+﻿#ifndef GLOBALBASE_PATH_H_H
+#define GLOBALBASE_PATH_H_H
+
+#include "GlobalBasePort.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+#if defined(__cpp_lib_string_view) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#endif
+
+// 只读字符串视图（C++11 可用的 std::string_view 子集，GB_Path 的分量访问返回此类型）：不拥有内存，调用方保证所指字符串在使用期间有效。
+// 可由 std::string / 字符串字面量隐式构造；C++17 下可隐式转换为 std::string_view。
+class GB_StringView
+{
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    GB_StringView() : ptr(""), length(0)
+    {
+    }
+
+    GB_StringView(const char* str) : ptr(str ? str : ""), length(str ? strlen(str) : 0)
+    {
+    }
+
+    GB_StringView(const char* str, size_t size) : ptr(str), length(size)
+    {
+    }
+
+    GB_StringView(const std::string& str) : ptr(str.data()), length(str.size())
+    {
+    }
+
+    const char* data() const
+    {
+        return ptr;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    const char* begin() const
+    {
+        return ptr;
+    }
+
+    const char* end() const
+    {
+        return ptr + length;
+    }
+
+    char operator[](size_t index) const
+    {
+        return ptr[index];
+    }
+
+    char front() const
+    {
+        return ptr[0];
+    }
+
+    char back() const
+    {
+        return ptr[length - 1];
+    }
+
+    // 取 [offset, offset + count) 子视图，越界部分被截掉
+    GB_StringView substr(size_t offset, size_t count = npos) const
+    {
+        if (offset >= length)
+        {
+            return GB_StringView(ptr + length, 0);
+        }
+        const size_t available = length - offset;
+        return GB_StringView(ptr + offset, count < available ? count : available);
+    }
+
+    size_t find(char ch, size_t offset = 0) const
+    {
+        for (size_t i = offset; i < length; i++)
+        {
+            if (ptr[i] == ch)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    size_t rfind(char ch, size_t offset = npos) const
+    {
+        if (length == 0)
+        {
+            return npos;
+        }
+        size_t i = offset < length ? offset + 1 : length;
+        while (i > 0)
+        {
+            i--;
+            if (ptr[i] == ch)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    bool StartsWith(GB_StringView prefix) const
+    {
+        return prefix.length <= length && memcmp(ptr, prefix.ptr, prefix.length) == 0;
+    }
+
+    bool EndsWith(GB_StringView suffix) const
+    {
+        return suffix.length <= length && memcmp(ptr + length - suffix.length, suffix.ptr, suffix.length) == 0;
+    }
+
+    int compare(GB_StringView other) const
+    {
+        const size_t common = length < other.length ? length : other.length;
+        const int result = common > 0 ? memcmp(ptr, other.ptr, common) : 0;
+        if (result != 0)
+        {
+            return result;
+        }
+        return length < other.length ? -1 : (length > other.length ? 1 : 0);
+    }
+
+    std::string ToString() const
+    {
+        return std::string(ptr, length);
+    }
+
+#if defined(__cpp_lib_string_view) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+    operator std::string_view() const
+    {
+        return std::string_view(ptr, length);
+    }
+#endif
+
+private:
+    const char* ptr;
+    size_t length;
+};
+
+inline bool operator==(GB_StringView left, GB_StringView right)
+{
+    return left.size() == right.size() && (left.size() == 0 || memcmp(left.data(), right.data(), left.size()) == 0);
+}
+
+inline bool operator!=(GB_StringView left, GB_StringView right)
+{
+    return !(left == right);
+}
+
+inline bool operator<(GB_StringView left, GB_StringView right)
+{
+    return left.compare(right) < 0;
+}
+
+/*
+    路径值类型：构造时规范化一次，之后的分量访问都返回指向内部存储的 GB_StringView，不再分配内存。
+    - 规范化规则：反斜杠统一为“/”；连续分隔符合并（UNC 前缀“//”保留）；去掉“.”分量；去掉末尾“/”（根除外）。
+      “..”不做处理（涉及符号链接时按字面折叠会改变语义），需要时调用 LexicallyNormal。
+    - 根：“/”，Windows 上还有“C:/”、“C:”（驱动器相对路径）与“//server/share”。
+    - 不超过 inlineCapacity 的路径存放在对象内部，不分配堆内存。
+    - 全部操作只做字符串处理，不访问文件系统。
+    - 返回的 GB_StringView 在本对象被修改或析构后失效。
+*/
+class GLOBALBASE_PORT GB_Path
+{
+public:
+    static const size_t inlineCapacity = 112;
+
+    GB_Path();
+    GB_Path(const char* pathUtf8);
+    GB_Path(const std::string& pathUtf8);
+    GB_Path(GB_StringView pathUtf8);
+    GB_Path(const GB_Path& other);
+    GB_Path(GB_Path&& other) noexcept;
+    GB_Path& operator=(const GB_Path& other);
+    GB_Path& operator=(GB_Path&& other) noexcept;
+    ~GB_Path();
+
+    GB_StringView View() const;
+    // 以 '\0' 结尾，可直接传给系统调用
+    const char* CStr() const;
+    size_t Size() const;
+    bool Empty() const;
+    std::string ToString() const;
+
+    bool IsAbsolute() const;
+    bool IsRoot() const;
+    bool HasRoot() const;
+
+    // "/a/b.tar.gz"：Root "/"、FileName "b.tar.gz"、Stem "b.tar"、Extension ".gz"、ParentPath "/a"
+    // 以点开头且没有其它点的文件名（".bashrc"）没有扩展名；根路径的 FileName 为空，ParentPath 为自身
+    GB_StringView GetRoot() const;
+    GB_StringView GetFileName() const;
+    GB_StringView GetStem() const;
+    GB_StringView GetExtension() const;
+    GB_StringView GetParentPath() const;
+
+    /*
+        逐个取分量（根作为第一个分量），不分配内存：
+            size_t cursor = 0;
+            GB_StringView part;
+            while (path.NextComponent(cursor, part)) { ... }
+    */
+    bool NextComponent(size_t& cursor, GB_StringView& component) const;
+
+    // 追加相对路径；relativeUtf8 为绝对路径（或带不同根）时整体替换。追加的部分同样被规范化
+    // const char* / std::string 重载用于消除与 GB_Path 隐式构造之间的二义性
+    GB_Path& Append(GB_StringView relativeUtf8);
+    GB_Path& Append(const char* relativeUtf8);
+    GB_Path& Append(const std::string& relativeUtf8);
+    GB_Path& Append(const GB_Path& relative);
+    template<typename T>
+    GB_Path& operator/=(const T& relative)
+    {
+        return Append(relative);
+    }
+    template<typename T>
+    GB_Path operator/(const T& relative) const
+    {
+        GB_Path result(*this);
+        result.Append(relative);
+        return result;
+    }
+
+    // newExtension 可带或不带前导点；为空时去掉扩展名
+    GB_Path& ReplaceExtension(GB_StringView newExtension);
+    GB_Path& RemoveFileName();
+
+    // 按字面折叠“..”："a/b/../c" -> "a/c"；根之上的“..”被丢弃；结果为空时为 "."
+    GB_Path LexicallyNormal() const;
+    // 相对 base 的路径："/a/b/c" 相对 "/a/d" -> "../b/c"；根不同或 base 含无法抵消的“..”时返回空路径
+    GB_Path LexicallyRelative(const GB_Path& base) const;
+    // 按分量判断前缀："/a/bc" 不以 "/a/b" 开头
+    bool StartsWith(const GB_Path& prefix) const;
+
+    size_t Hash() const;
+
+    bool operator==(const GB_Path& other) const;
+    bool operator!=(const GB_Path& other) const;
+    bool operator<(const GB_Path& other) const;
+
+private:
+    size_t GetRootLength() const;
+    size_t GetFileNameOffset() const;
+    void Reserve(size_t newCapacity);
+    void Truncate(size_t newSize);
+    void AssignNormalized(const char* str, size_t length);
+    void AppendNormalized(const char* str, size_t length);
+    void AppendComponent(GB_StringView component);
+    void ResetToInline();
+
+    char* data;
+    size_t size;
+    size_t capacity;    // 不含结尾 '\0'
+    char inlineBuffer[inlineCapacity];
+};
+
+#endif
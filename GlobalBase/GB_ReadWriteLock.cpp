@@ -1,15 +1,39 @@
 ﻿#include "GB_ReadWriteLock.h"
 
+GB_ReadWriteLock::GB_ReadWriteLock(const std::string& profileNameUtf8)
+    : profile_(GB_GetLockProfile(profileNameUtf8))
+{
+}
+
+std::unique_lock<std::mutex> GB_ReadWriteLock::AcquireInternalMutex(GB_LockWaitRecorder& recorder)
+{
+    if (!recorder.IsActive())
+    {
+        return std::unique_lock<std::mutex>(mutex_);
+    }
+
+    std::unique_lock<std::mutex> lockGuard(mutex_, std::try_to_lock);
+    if (!lockGuard.owns_lock())
+    {
+        recorder.MarkContended();
+        lockGuard.lock();
+    }
+    return lockGuard;
+}
+
 void GB_ReadWriteLock::LockShared()
 {
-    std::unique_lock<std::mutex> lockGuard(mutex_);
+    GB_LockWaitRecorder recorder(profile_, GB_LockMode::Shared);
+    std::unique_lock<std::mutex> lockGuard = AcquireInternalMutex(recorder);
 
     while (writerActive_ || waitingWriters_ > 0)
     {
+        recorder.MarkContended();
         readersCondition_.wait(lockGuard);
     }
 
     activeReaders_++;
+    recorder.Commit();
 }
 
 void GB_ReadWriteLock::UnlockShared()
@@ -32,17 +56,20 @@ void GB_ReadWriteLock::UnlockShared()
 
 void GB_ReadWriteLock::Lock()
 {
-    std::unique_lock<std::mutex> lockGuard(mutex_);
+    GB_LockWaitRecorder recorder(profile_, GB_LockMode::Exclusive);
+    std::unique_lock<std::mutex> lockGuard = AcquireInternalMutex(recorder);
 
     waitingWriters_++;
 
     while (writerActive_ || activeReaders_ > 0)
     {
+        recorder.MarkContended();
         writersCondition_.wait(lockGuard);
     }
 
     waitingWriters_--;
     writerActive_ = true;
+    recorder.Commit();
 }
 
 void GB_ReadWriteLock::Unlock()
@@ -75,6 +102,10 @@ bool GB_ReadWriteLock::TryLockShared()
     }
 
     activeReaders_++;
+    if (profile_ != nullptr && GB_IsLockProfilingEnabled())
+    {
+        profile_->RecordAcquire(GB_LockMode::Shared, false, 0);
+    }
     return true;
 }
 
@@ -92,6 +123,10 @@ bool GB_ReadWriteLock::TryLock()
     }
 
     writerActive_ = true;
+    if (profile_ != nullptr && GB_IsLockProfilingEnabled())
+    {
+        profile_->RecordAcquire(GB_LockMode::Exclusive, false, 0);
+    }
     return true;
 }
 
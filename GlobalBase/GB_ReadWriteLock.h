@@ -2,6 +2,7 @@
 #define GLOBALBASE_READ_WRITE_LOCK_H_H
 
 #include "GlobalBasePort.h"
+#include "GB_LockProfiler.h"
 #include <condition_variable>
 #include <chrono>
 #include <mutex>
@@ -24,6 +25,10 @@
 	  这样可以避免“写者饥饿”（读者源源不断导致写者一直抢不到锁）。
 	  代价是：在持续写压力下，读者可能出现饥饿（读优先/公平实现会更复杂）。
 
+	竞争统计：
+	- 使用带名字的构造函数时，该锁会接入 GB_LockProfiler，在 GB_SetLockProfilingEnabled(true) 后
+	  分别记录读/写两种模式的获取次数、竞争次数与等待时长；默认构造的锁不参与统计。
+
 	限制：
 	- 非递归：同一线程重复持有同一把锁（尤其写锁）再去加锁可能死锁。
 	- 不支持“读锁原子升级为写锁”：如需升级必须释放读锁再抢写锁，并在抢到写锁后重检条件。
@@ -32,6 +37,7 @@ class GLOBALBASE_PORT GB_ReadWriteLock
 {
 public:
 	GB_ReadWriteLock() = default;
+	explicit GB_ReadWriteLock(const std::string& profileNameUtf8);
 	~GB_ReadWriteLock() = default;
 	GB_ReadWriteLock(const GB_ReadWriteLock&) = delete;
 	GB_ReadWriteLock& operator=(const GB_ReadWriteLock&) = delete;
@@ -56,6 +62,10 @@ public:
 	template <class Rep, class Period>
 	bool TryLockFor(const std::chrono::duration<Rep, Period>& timeout);
 
+private:
+	// 获取内部互斥量；拿不到时标记为竞争
+	std::unique_lock<std::mutex> AcquireInternalMutex(GB_LockWaitRecorder& recorder);
+
 private:
 	// 写优先策略：
 	std::mutex mutex_;
@@ -65,6 +75,8 @@ private:
 	int activeReaders_ = 0;
 	int waitingWriters_ = 0;
 	bool writerActive_ = false;
+
+	GB_LockProfile* profile_ = nullptr; // 竞争统计，nullptr 表示不统计
 };
 
 /*
@@ -177,10 +189,12 @@ template <class Rep, class Period>
 bool GB_ReadWriteLock::TryLockSharedFor(const std::chrono::duration<Rep, Period>& timeout)
 {
 	const auto deadline = std::chrono::steady_clock::now() + timeout;
-	std::unique_lock<std::mutex> lockGuard(mutex_);
+	GB_LockWaitRecorder recorder(profile_, GB_LockMode::Shared);
+	std::unique_lock<std::mutex> lockGuard = AcquireInternalMutex(recorder);
 
 	while (writerActive_ || waitingWriters_ > 0)
 	{
+		recorder.MarkContended();
 		if (readersCondition_.wait_until(lockGuard, deadline) == std::cv_status::timeout)
 		{
 			return false;
@@ -188,6 +202,7 @@ bool GB_ReadWriteLock::TryLockSharedFor(const std::chrono::duration<Rep, Period>
 	}
 
 	activeReaders_++;
+	recorder.Commit();
 	return true;
 }
 
@@ -195,11 +210,13 @@ template <class Rep, class Period>
 bool GB_ReadWriteLock::TryLockFor(const std::chrono::duration<Rep, Period>& timeout)
 {
 	const auto deadline = std::chrono::steady_clock::now() + timeout;
-	std::unique_lock<std::mutex> lockGuard(mutex_);
+	GB_LockWaitRecorder recorder(profile_, GB_LockMode::Exclusive);
+	std::unique_lock<std::mutex> lockGuard = AcquireInternalMutex(recorder);
 
 	waitingWriters_++;
 	while (writerActive_ || activeReaders_ > 0)
 	{
+		recorder.MarkContended();
 		if (writersCondition_.wait_until(lockGuard, deadline) == std::cv_status::timeout)
 		{
 			waitingWriters_--;
@@ -216,6 +233,7 @@ bool GB_ReadWriteLock::TryLockFor(const std::chrono::duration<Rep, Period>& time
 
 	waitingWriters_--;
 	writerActive_ = true;
+	recorder.Commit();
 	return true;
 }
 
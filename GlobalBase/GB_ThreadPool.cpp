@@ -6,6 +6,7 @@
 /*
     实现要点：
       - 所有共享状态都受 queueMutex 保护：taskQueue / isAccepting / isStopping / activeTaskCount
+      - queueMutex 一律经 GB_ProfiledLock 获取，开启锁竞争统计后可在 GB_DumpLockProfilesJson() 中看到
       - 条件变量一律使用 predicate 版本 wait()/wait_until()，以正确处理"伪唤醒"（spurious wakeup）。
       - WorkerLoop 只在 isStopping && taskQueue.empty() 时退出：
           * Drain：先跑完队列再退
@@ -29,7 +30,8 @@
       因此这里 catch(...) 后必须主动 Shutdown + Join 再 rethrow。
 */
 GB_ThreadPool::GB_ThreadPool(size_t threadCount, size_t maxQueueSize) : maxQueueSize(maxQueueSize), isAccepting(true),
-isStopping(false), activeTaskCount(0), unhandledExceptionHandler(nullptr)
+isStopping(false), activeTaskCount(0), unhandledExceptionHandler(nullptr),
+queueMutexProfile(GB_GetLockProfile("GB_ThreadPool.queueMutex"))
 {
     if (threadCount == 0)
     {
@@ -80,19 +82,19 @@ size_t GB_ThreadPool::GetMaxQueueSize() const
 
 size_t GB_ThreadPool::GetPendingTaskCount() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
     return taskQueue.size();
 }
 
 size_t GB_ThreadPool::GetActiveTaskCount() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
     return activeTaskCount;
 }
 
 bool GB_ThreadPool::IsShutdown() const
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
     return isStopping;
 }
 
@@ -116,7 +118,7 @@ void GB_ThreadPool::SetUnhandledExceptionHandler(UnhandledExceptionHandler handl
 void GB_ThreadPool::Shutdown(ShutdownMode mode)
 {
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
         if (isStopping)
         {
             return;
@@ -138,7 +140,7 @@ void GB_ThreadPool::Shutdown(ShutdownMode mode)
 
 void GB_ThreadPool::WaitIdle()
 {
-    std::unique_lock<std::mutex> lock(queueMutex);
+    std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
     idleCond.wait(lock, [&](){
         return taskQueue.empty() && activeTaskCount == 0;
     });
@@ -146,7 +148,7 @@ void GB_ThreadPool::WaitIdle()
 
 bool GB_ThreadPool::WaitIdleUntil(const std::chrono::steady_clock::time_point& deadline)
 {
-    std::unique_lock<std::mutex> lock(queueMutex);
+    std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
     return idleCond.wait_until(lock, deadline, [&]() {
         return taskQueue.empty() && activeTaskCount == 0;
     });
@@ -165,7 +167,7 @@ bool GB_ThreadPool::WaitIdleUntil(const std::chrono::steady_clock::time_point& d
 void GB_ThreadPool::EnqueueTaskBlocking(MoveOnlyTask&& task)
 {
     {
-        std::unique_lock<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
 
         if (!isAccepting)
         {
@@ -204,7 +206,7 @@ void GB_ThreadPool::EnqueueTaskBlocking(MoveOnlyTask&& task)
 bool GB_ThreadPool::EnqueueTaskNonBlocking(MoveOnlyTask&& task)
 {
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
 
         if (!isAccepting)
         {
@@ -226,7 +228,7 @@ bool GB_ThreadPool::EnqueueTaskNonBlocking(MoveOnlyTask&& task)
 bool GB_ThreadPool::EnqueueTaskUntil(const std::chrono::steady_clock::time_point& deadline, MoveOnlyTask&& task)
 {
     {
-        std::unique_lock<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
 
         if (!isAccepting)
         {
@@ -289,7 +291,7 @@ void GB_ThreadPool::RunTaskAndFinalize(MoveOnlyTask&& task)
 
     bool shouldNotifyIdle = false;
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
 
         activeTaskCount--;
         if (taskQueue.empty() && activeTaskCount == 0)
@@ -344,7 +346,7 @@ void GB_ThreadPool::WorkerLoop()
         MoveOnlyTask task;
 
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
+            std::unique_lock<std::mutex> lock = GB_ProfiledLock(queueMutex, queueMutexProfile);
 
             notEmptyCond.wait(lock, [&]() {
                 return isStopping || !taskQueue.empty();
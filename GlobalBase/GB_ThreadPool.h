@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 #include "GlobalBasePort.h"
+#include "GB_LockProfiler.h"
 
 // "把 (function, tuple<args...>) 展开调用"的工具
 namespace threadpool_detail
@@ -283,6 +284,9 @@ private:
 
     std::atomic<UnhandledExceptionHandler> unhandledExceptionHandler;
 
+    // queueMutex 的竞争统计（所有线程池实例共用 "GB_ThreadPool.queueMutex"）
+    GB_LockProfile* const queueMutexProfile;
+
     static GB_ThreadPool*& GetTlsWorkerOwner();
 };
 
@@ -9,8 +9,13 @@ using namespace std;
 
 string GetLocalTimeStr(bool withMs, bool withTzSuffix)
 {
-    // 1) 拿到当前时刻
-    const chrono::system_clock::time_point now = chrono::system_clock::now();
+    return GetLocalTimeStr(chrono::system_clock::now(), withMs, withTzSuffix);
+}
+
+string GetLocalTimeStr(const chrono::system_clock::time_point& timePoint, bool withMs, bool withTzSuffix)
+{
+    // 1) 拿到目标时刻
+    const chrono::system_clock::time_point& now = timePoint;
     const time_t tt = chrono::system_clock::to_time_t(now);
 
     // 2) 拆成年月日时分秒（本地 & UTC）——用线程安全版本
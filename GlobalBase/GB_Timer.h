@@ -39,6 +39,13 @@
  */
 GLOBALBASE_PORT std::string GetLocalTimeStr(bool withMs = true, bool withTzSuffix = false);
 
+/**
+ * @brief 与 GetLocalTimeStr(bool, bool) 相同的格式，但格式化的是调用方给定的时刻（而不是“现在”）。
+ *
+ * 主要用于“先记录原始时间、稍后再格式化”的场景（例如日志在后台线程统一格式化时间戳）。
+ */
+GLOBALBASE_PORT std::string GetLocalTimeStr(const std::chrono::system_clock::time_point& timePoint, bool withMs = true, bool withTzSuffix = false);
+
 #ifdef _MSC_VER
 #  pragma warning(push)
 #  pragma warning(disable: 4251)
@@ -309,7 +316,7 @@ std::chrono::nanoseconds GB_Timer::Measure(Func&& func, Args&&... args)
 }
 
 template <typename Func, typename... Args>
-static typename std::enable_if<
+typename std::enable_if<
     !std::is_void<decltype(std::declval<Func>()(std::declval<Args>()...))>::value,
     std::pair<
     typename std::decay<decltype(std::declval<Func>()(std::declval<Args>()...))>::type,
@@ -25,3 +25,8 @@ uint64_t GB_GenerateClassTypeId(const std::string& classType)
     }
     return ComputeFnv1a64(classType.data(), classType.size());
 }
+
+bool GB_SerializableClass::Deserialize(GB_ByteSpan data)
+{
+    return Deserialize(GB_ByteBuffer(data.begin(), data.end()));
+}
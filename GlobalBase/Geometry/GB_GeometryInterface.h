@@ -25,6 +25,9 @@ public:
 	// 反序列化
 	virtual bool Deserialize(const std::string& data) = 0;
 	virtual bool Deserialize(const GB_ByteBuffer& data) = 0;
+
+	// 从只读视图反序列化（如 GB_MappedFile::Span()）。默认实现拷贝为 GB_ByteBuffer 后调用上面的版本，派生类可重写以避免拷贝
+	virtual bool Deserialize(GB_ByteSpan data);
 };
 
 #define GB_GetClassType(ClassName) ClassName().GetClassType()
@@ -1045,20 +1045,15 @@ GB_ByteBuffer GB_Matrix3x3::SerializeToBinary() const
     constexpr static uint16_t payloadVersion = 1;
 
     GB_ByteBuffer buffer;
-    buffer.reserve(96);
+    GB_ByteWriter writer(buffer, 88);
+    writer.AppendUInt32LE(GB_ClassMagicNumber);
+    writer.AppendUInt64LE(GetClassTypeId());
+    writer.AppendUInt16LE(payloadVersion);
+    writer.AppendUInt16LE(0);
 
-    GB_ByteBufferIO::AppendUInt32LE(buffer, GB_ClassMagicNumber);
-    GB_ByteBufferIO::AppendUInt64LE(buffer, GetClassTypeId());
-    GB_ByteBufferIO::AppendUInt16LE(buffer, payloadVersion);
-    GB_ByteBufferIO::AppendUInt16LE(buffer, 0);
-
-    for (size_t rowIndex = 0; rowIndex < 3; rowIndex++)
-    {
-        for (size_t colIndex = 0; colIndex < 3; colIndex++)
-        {
-            GB_ByteBufferIO::AppendDoubleLE(buffer, m[rowIndex][colIndex]);
-        }
-    }
+    // m 按行主序连续存放
+    writer.AppendDoubleArrayLE(&m[0][0], 9);
+    writer.Finish();
 
     return buffer;
 }
@@ -1121,6 +1116,11 @@ bool GB_Matrix3x3::Deserialize(const std::string& data)
 }
 
 bool GB_Matrix3x3::Deserialize(const GB_ByteBuffer& data)
+{
+    return Deserialize(GB_ByteSpan(data));
+}
+
+bool GB_Matrix3x3::Deserialize(GB_ByteSpan data)
 {
     constexpr static uint16_t expectedPayloadVersion = 1;
     constexpr static size_t minSize = 4 + 8 + 2 + 2 + 9 * 8;
@@ -1131,16 +1131,16 @@ bool GB_Matrix3x3::Deserialize(const GB_ByteBuffer& data)
         return false;
     }
 
-    size_t offset = 0;
     uint32_t magic = 0;
     uint64_t typeId = 0;
     uint16_t payloadVersion = 0;
     uint16_t reserved = 0;
 
-    if (!GB_ByteBufferIO::ReadUInt32LE(data, offset, magic)
-        || !GB_ByteBufferIO::ReadUInt64LE(data, offset, typeId)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, payloadVersion)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, reserved))
+    GB_ByteReader reader(data);
+    if (!reader.ReadUInt32LE(magic)
+        || !reader.ReadUInt64LE(typeId)
+        || !reader.ReadUInt16LE(payloadVersion)
+        || !reader.ReadUInt16LE(reserved))
     {
         *this = GB_Matrix3x3();
         return false;
@@ -1153,13 +1153,10 @@ bool GB_Matrix3x3::Deserialize(const GB_ByteBuffer& data)
     }
 
     double values[9] = { GB_QuietNan };
-    for (int i = 0; i < 9; i++)
+    if (!reader.ReadDoubleArrayLE(values, 9))
     {
-        if (!GB_ByteBufferIO::ReadDoubleLE(data, offset, values[i]))
-        {
-            *this = GB_Matrix3x3();
-            return false;
-        }
+        *this = GB_Matrix3x3();
+        return false;
     }
 
     Set(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7], values[8]);
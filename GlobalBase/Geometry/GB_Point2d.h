@@ -87,6 +87,7 @@ public:
 	// 反序列化。
 	virtual bool Deserialize(const std::string& data) override;
 	virtual bool Deserialize(const GB_ByteBuffer& data) override;
+	virtual bool Deserialize(GB_ByteSpan data) override;
 };
 
 GB_Point2d operator*(double scalar, const GB_Point2d& point);
@@ -665,17 +665,15 @@ GB_ByteBuffer GB_Rectangle::SerializeToBinary() const
     constexpr static uint16_t payloadVersion = 1;
 
     GB_ByteBuffer buffer;
-    buffer.reserve(48);
+    GB_ByteWriter writer(buffer, 48);
+    writer.AppendUInt32LE(GB_ClassMagicNumber);
+    writer.AppendUInt64LE(GetClassTypeId());
+    writer.AppendUInt16LE(payloadVersion);
+    writer.AppendUInt16LE(0);
 
-    GB_ByteBufferIO::AppendUInt32LE(buffer, GB_ClassMagicNumber);
-    GB_ByteBufferIO::AppendUInt64LE(buffer, GetClassTypeId());
-    GB_ByteBufferIO::AppendUInt16LE(buffer, payloadVersion);
-    GB_ByteBufferIO::AppendUInt16LE(buffer, 0);
-
-    GB_ByteBufferIO::AppendDoubleLE(buffer, minX);
-    GB_ByteBufferIO::AppendDoubleLE(buffer, minY);
-    GB_ByteBufferIO::AppendDoubleLE(buffer, maxX);
-    GB_ByteBufferIO::AppendDoubleLE(buffer, maxY);
+    const double values[4] = { minX, minY, maxX, maxY };
+    writer.AppendDoubleArrayLE(values, 4);
+    writer.Finish();
 
     return buffer;
 }
@@ -719,6 +717,11 @@ bool GB_Rectangle::Deserialize(const std::string& data)
 }
 
 bool GB_Rectangle::Deserialize(const GB_ByteBuffer& data)
+{
+    return Deserialize(GB_ByteSpan(data));
+}
+
+bool GB_Rectangle::Deserialize(GB_ByteSpan data)
 {
     constexpr static uint16_t expectedPayloadVersion = 1;
     constexpr static size_t minSize = 48;
@@ -729,7 +732,6 @@ bool GB_Rectangle::Deserialize(const GB_ByteBuffer& data)
         return false;
     }
 
-    size_t offset = 0;
     uint32_t magic = 0;
     uint64_t typeId = 0;
     uint16_t payloadVersion = 0;
@@ -740,14 +742,15 @@ bool GB_Rectangle::Deserialize(const GB_ByteBuffer& data)
     double parsedMaxX = GB_QuietNan;
     double parsedMaxY = GB_QuietNan;
 
-    if (!GB_ByteBufferIO::ReadUInt32LE(data, offset, magic)
-        || !GB_ByteBufferIO::ReadUInt64LE(data, offset, typeId)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, payloadVersion)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, reserved)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedMinX)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedMinY)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedMaxX)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedMaxY))
+    GB_ByteReader reader(data);
+    if (!reader.ReadUInt32LE(magic)
+        || !reader.ReadUInt64LE(typeId)
+        || !reader.ReadUInt16LE(payloadVersion)
+        || !reader.ReadUInt16LE(reserved)
+        || !reader.ReadDoubleLE(parsedMinX)
+        || !reader.ReadDoubleLE(parsedMinY)
+        || !reader.ReadDoubleLE(parsedMaxX)
+        || !reader.ReadDoubleLE(parsedMaxY))
     {
         Reset();
         return false;
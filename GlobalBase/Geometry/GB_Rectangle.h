@@ -136,6 +136,7 @@ public:
     // 反序列化。
     virtual bool Deserialize(const std::string& data) override;
     virtual bool Deserialize(const GB_ByteBuffer& data) override;
+    virtual bool Deserialize(GB_ByteSpan data) override;
 };
 
 
@@ -408,15 +408,15 @@ GB_ByteBuffer GB_Vector2d::SerializeToBinary() const
     constexpr static uint16_t payloadVersion = 1;
 
     GB_ByteBuffer buffer;
-    buffer.reserve(32);
+    GB_ByteWriter writer(buffer, 32);
+    writer.AppendUInt32LE(GB_ClassMagicNumber);
+    writer.AppendUInt64LE(GetClassTypeId());
+    writer.AppendUInt16LE(payloadVersion);
+    writer.AppendUInt16LE(0);
 
-    GB_ByteBufferIO::AppendUInt32LE(buffer, GB_ClassMagicNumber);
-    GB_ByteBufferIO::AppendUInt64LE(buffer, GetClassTypeId());
-    GB_ByteBufferIO::AppendUInt16LE(buffer, payloadVersion);
-    GB_ByteBufferIO::AppendUInt16LE(buffer, 0);
-
-    GB_ByteBufferIO::AppendDoubleLE(buffer, x);
-    GB_ByteBufferIO::AppendDoubleLE(buffer, y);
+    const double values[2] = { x, y };
+    writer.AppendDoubleArrayLE(values, 2);
+    writer.Finish();
 
     return buffer;
 }
@@ -454,6 +454,11 @@ bool GB_Vector2d::Deserialize(const std::string& data)
 }
 
 bool GB_Vector2d::Deserialize(const GB_ByteBuffer& data)
+{
+    return Deserialize(GB_ByteSpan(data));
+}
+
+bool GB_Vector2d::Deserialize(GB_ByteSpan data)
 {
     constexpr static uint16_t expectedPayloadVersion = 1;
     constexpr static size_t minSize = 32;
@@ -465,7 +470,6 @@ bool GB_Vector2d::Deserialize(const GB_ByteBuffer& data)
         return false;
     }
 
-    size_t offset = 0;
     uint32_t magic = 0;
     uint64_t typeId = 0;
     uint16_t payloadVersion = 0;
@@ -474,12 +478,13 @@ bool GB_Vector2d::Deserialize(const GB_ByteBuffer& data)
     double parsedX = GB_QuietNan;
     double parsedY = GB_QuietNan;
 
-    if (!GB_ByteBufferIO::ReadUInt32LE(data, offset, magic)
-        || !GB_ByteBufferIO::ReadUInt64LE(data, offset, typeId)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, payloadVersion)
-        || !GB_ByteBufferIO::ReadUInt16LE(data, offset, reserved)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedX)
-        || !GB_ByteBufferIO::ReadDoubleLE(data, offset, parsedY))
+    GB_ByteReader reader(data);
+    if (!reader.ReadUInt32LE(magic)
+        || !reader.ReadUInt64LE(typeId)
+        || !reader.ReadUInt16LE(payloadVersion)
+        || !reader.ReadUInt16LE(reserved)
+        || !reader.ReadDoubleLE(parsedX)
+        || !reader.ReadDoubleLE(parsedY))
     {
         x = GB_QuietNan;
         y = GB_QuietNan;
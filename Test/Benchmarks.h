@@ -0,0 +1,16 @@
+﻿#ifndef GLOBALBASE_TEST_BENCHMARKS_H_H
+#define GLOBALBASE_TEST_BENCHMARKS_H_H
+
+#include <cstddef>
+
+// 性能基准（仅在 Test 程序中使用，不属于 GlobalBase 的导出接口）
+
+// 测量 MD5 / SHA-256 / SHA-512 的单线程吞吐。
+// 对同一块 bytesPerRound 字节的内存数据重复 rounds 轮，取最快一轮，排除首轮缺页等干扰。
+int RunHashBenchmark(size_t bytesPerRound, int rounds);
+
+// 测量日志生产者每次调用的耗时：旧的“构造完整日志项 + 全局锁队列”路径对比 GB_Logger 的每线程环形缓冲。
+// 线程数从 1 翻倍到 maxThreadCount，每个线程调用 callsPerThread 次；测量期间暂时摘掉所有 sink，不写日志文件。
+int RunLogBenchmark(int callsPerThread, int maxThreadCount);
+
+#endif
@@ -0,0 +1,191 @@
+﻿#include "Benchmarks.h"
+#include "GB_Logger.h"
+#include "GB_Timer.h"
+#include "GB_Utf8String.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+using namespace std;
+
+namespace
+{
+	// 引入每线程环形缓冲之前的生产者路径：每次调用构造完整的日志项（时间戳、线程 ID 字符串、文件名替换），
+	// 再持全局锁压入共享队列并通知日志线程。日志线程只负责取走，不做输出。
+	class LegacyLogQueue
+	{
+	public:
+		struct Item
+		{
+			string timestamp;
+			GB_LogLevel level = GB_LogLevel::GBLOGLEVEL_INFO;
+			string message;
+			string threadId;
+			string file;
+			int line = 0;
+		};
+
+		LegacyLogQueue() : consumer(&LegacyLogQueue::ConsumerFunc, this)
+		{
+		}
+
+		~LegacyLogQueue()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				isStop = true;
+			}
+			cv.notify_one();
+			consumer.join();
+		}
+
+		void LogInfo(const string& msgUtf8, const char* file, int line)
+		{
+			Item item;
+			item.timestamp = GetLocalTimeStr();
+			item.level = GB_LogLevel::GBLOGLEVEL_INFO;
+			item.message = msgUtf8;
+			{
+				std::ostringstream oss;
+				oss << std::this_thread::get_id();
+				item.threadId = oss.str();
+			}
+			item.file = GB_Utf8Replace(file, GB_STR("\\"), GB_STR("/"));
+			item.line = line;
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				items.push(item);
+			}
+			cv.notify_one();
+		}
+
+	private:
+		void ConsumerFunc()
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			for (;;)
+			{
+				cv.wait(lock, [this]() { return isStop || !items.empty(); });
+				if (items.empty())
+				{
+					return;
+				}
+				std::queue<Item> localItems;
+				localItems.swap(items);
+				lock.unlock();
+				localItems = std::queue<Item>();
+				lock.lock();
+			}
+		}
+
+		std::mutex mtx;
+		std::condition_variable cv;
+		std::queue<Item> items;
+		bool isStop = false;
+		std::thread consumer;
+	};
+
+	// threadCount 个线程同时开始，各调用 callsPerThread 次，返回各线程平均每次调用的耗时（纳秒）
+	template<typename LogFunc>
+	double MeasureProducerNs(int threadCount, int callsPerThread, LogFunc logFunc)
+	{
+		std::atomic<int> readyCount(0);
+		std::atomic<bool> isGo(false);
+		vector<double> threadNs(threadCount, 0.0);
+		vector<std::thread> threads;
+		for (int t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&, t]() {
+				const string message = "benchmark message " + to_string(t);
+				readyCount.fetch_add(1);
+				while (!isGo.load())
+				{
+					std::this_thread::yield();
+				}
+
+				GB_Timer timer;
+				timer.Restart();
+				for (int i = 0; i < callsPerThread; i++)
+				{
+					logFunc(message, i);
+				}
+				threadNs[t] = static_cast<double>(timer.ElapsedNanoseconds()) / callsPerThread;
+				});
+		}
+		while (readyCount.load() < threadCount)
+		{
+			std::this_thread::yield();
+		}
+		isGo.store(true);
+		for (size_t t = 0; t < threads.size(); t++)
+		{
+			threads[t].join();
+		}
+
+		double totalNs = 0;
+		for (int t = 0; t < threadCount; t++)
+		{
+			totalNs += threadNs[t];
+		}
+		return totalNs / threadCount;
+	}
+}
+
+int RunLogBenchmark(int callsPerThread, int maxThreadCount)
+{
+	if (callsPerThread < 1)
+	{
+		callsPerThread = 1;
+	}
+	if (maxThreadCount < 1)
+	{
+		maxThreadCount = 1;
+	}
+
+	// 测量期间摘掉所有 sink，避免把基准日志写进真实的日志文件；结束后原样装回
+	GB_Logger& logger = GB_Logger::GetInstance();
+	const vector<std::shared_ptr<GB_LogSink>> sinks = logger.GetSinks();
+	for (size_t i = 0; i < sinks.size(); i++)
+	{
+		logger.RemoveSink(sinks[i]);
+	}
+
+	cout << "Producer cost per call, " << callsPerThread << " calls per thread" << endl;
+	for (int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		double legacyNs = 0;
+		{
+			LegacyLogQueue legacy;
+			legacyNs = MeasureProducerNs(threadCount, callsPerThread, [&legacy](const string& message, int line) {
+				legacy.LogInfo(message, __FILE__, line);
+				});
+		}
+
+		const uint64_t droppedBefore = logger.GetDroppedRecordCount();
+		const double ringNs = MeasureProducerNs(threadCount, callsPerThread, [&logger](const string& message, int line) {
+			logger.LogInfo(message, __FILE__, line);
+			});
+		const uint64_t droppedCount = logger.GetDroppedRecordCount() - droppedBefore;
+
+		cout << setw(3) << threadCount << " thread(s)  locked queue " << fixed << setprecision(1) << setw(8) << legacyNs << " ns   ring "
+			<< setw(8) << ringNs << " ns   dropped " << droppedCount << endl;
+
+		// 让日志线程取完积压，下一轮从空缓冲开始
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	}
+
+	for (size_t i = 0; i < sinks.size(); i++)
+	{
+		logger.AddSink(sinks[i]);
+	}
+	return 0;
+}
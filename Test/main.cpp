@@ -1,9 +1,28 @@
 ﻿#include <iostream>
+#include <cstring>
+#include <cstdlib>
 #include "GB_Process.h"
+#include "Benchmarks.h"
 
 using namespace std;
 int main(int argc, char* argv[])
 {
+	// Test.exe --bench-hash [每轮 MiB] [轮数]
+	if (argc > 1 && strcmp(argv[1], "--bench-hash") == 0)
+	{
+		const size_t mebibytes = argc > 2 ? static_cast<size_t>(strtoul(argv[2], nullptr, 10)) : 256;
+		const int rounds = argc > 3 ? atoi(argv[3]) : 3;
+		return RunHashBenchmark(mebibytes * 1024 * 1024, rounds);
+	}
+
+	// Test.exe --bench-log [每线程调用次数] [最大线程数]
+	if (argc > 1 && strcmp(argv[1], "--bench-log") == 0)
+	{
+		const int callsPerThread = argc > 2 ? atoi(argv[2]) : 1000000;
+		const int maxThreadCount = argc > 3 ? atoi(argv[3]) : 4;
+		return RunLogBenchmark(callsPerThread, maxThreadCount);
+	}
+
 	GB_EnsureRunningAsAdmin();
 	cout << "Is running as admin: " << (GB_IsRunningAsAdmin() ? "Yes" : "No") << std::endl;
 	